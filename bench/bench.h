@@ -0,0 +1,460 @@
+#ifndef GEO_BENCH_H
+#define GEO_BENCH_H
+
+/*
+ * shared parts of the benchmark programs. include this before any other
+ * header, clock_gettime needs the POSIX feature macro.
+ */
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* repetitions timed for every function and size */
+#ifndef BENCH_REPETITIONS
+#define BENCH_REPETITIONS 10
+#endif
+
+/* a repetition runs the function until it took at least this long */
+#ifndef BENCH_MIN_REPETITION_NS
+#define BENCH_MIN_REPETITION_NS 10000000.0
+#endif
+
+/* untimed calls made before measuring */
+#ifndef BENCH_WARMUP_NS
+#define BENCH_WARMUP_NS 20000000.0
+#endif
+
+/* most calls timed one by one for the latency histogram, and their budget */
+#ifndef BENCH_LATENCY_CALLS
+#define BENCH_LATENCY_CALLS 200000
+#endif
+#ifndef BENCH_LATENCY_NS
+#define BENCH_LATENCY_NS 200000000.0
+#endif
+
+#define BENCH_MAX_REPETITIONS 1000
+#define BENCH_MAX_SIZE 10000000
+
+/*
+ * log bucketed histogram like HdrHistogram. values under 2^BITS have a
+ * bucket each, above that every power of 2 is split into 2^BITS buckets,
+ * so a bucket is within 1/32 of the values in it.
+ */
+#define BENCH_HISTOGRAM_BITS 5
+#define BENCH_HISTOGRAM_SUB (1U << BENCH_HISTOGRAM_BITS)
+#define BENCH_HISTOGRAM_BUCKETS \
+  ((64 - BENCH_HISTOGRAM_BITS + 1) * BENCH_HISTOGRAM_SUB)
+
+struct BenchHistogram {
+  uint64_t counts[BENCH_HISTOGRAM_BUCKETS];
+  uint64_t total;
+  uint64_t max;
+};
+
+struct BenchOptions {
+  size_t max_size;
+  size_t repetitions;
+  char const* filter;
+  uint64_t seed;
+};
+
+/*
+ * one function at one size. `ns_per_op` is the time of a single call, the
+ * median over the repetitions. `items` is how many inputs a call handles,
+ * throughput is items per second.
+ */
+struct BenchResult {
+  char const* name;
+  size_t size;
+  size_t items;
+  size_t ops;
+  size_t repetitions;
+  double samples[BENCH_MAX_REPETITIONS];
+  double ns_per_op;
+  double ns_per_op_min;
+  double ns_per_op_mean;
+  double ns_per_op_stddev;
+  double items_per_second;
+  /* per call latency, only for cases with `latency` set */
+  size_t latency_calls;
+  double latency_p50;
+  double latency_p90;
+  double latency_p99;
+  double latency_p999;
+  double latency_max;
+};
+
+/*
+ * a benchmarked function. `setup` builds the input of kind `shape` for
+ * `size` into a state that `run` uses for a single call and `teardown`
+ * frees. `max_size` caps the sizes for functions that are too slow on the
+ * large inputs. `latency` also times calls one by one into a histogram.
+ */
+struct BenchCase {
+  char const* name;
+  size_t shape;
+  size_t max_size;
+  bool latency;
+  void* (*setup)(size_t shape, size_t size, uint64_t seed, size_t* items);
+  void (*run)(void* state);
+  void (*teardown)(void* state);
+};
+
+static double bench_now(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec * 1e9 + (double)now.tv_nsec;
+}
+
+/*
+ * cycle counter for timing single calls, the time stamp counter on x86 and
+ * the virtual counter on arm64. anything else falls back to bench_now.
+ */
+static uint64_t bench_cycles(void) {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  uint32_t low = 0;
+  uint32_t high = 0;
+  /* lfence keeps the read from moving around the timed call */
+  __asm__ __volatile__("lfence\n\trdtsc" : "=a"(low), "=d"(high)::"memory");
+  return ((uint64_t)high << 32) | low;
+#elif defined(__GNUC__) && defined(__aarch64__)
+  uint64_t counter = 0;
+  __asm__ __volatile__("isb\n\tmrs %0, cntvct_el0"
+                       : "=r"(counter)::"memory");
+  return counter;
+#else
+  return (uint64_t)bench_now();
+#endif
+}
+
+/* cycles per ns, measured against the monotonic clock */
+static double bench_cycles_per_ns(void) {
+  static double ratio = 0.0;
+  if (ratio > 0.0) {
+    return ratio;
+  }
+  {
+    double start = bench_now();
+    uint64_t cycles = bench_cycles();
+    double elapsed = 0.0;
+    do {
+      elapsed = bench_now() - start;
+    } while (elapsed < 20000000.0);
+    ratio = (double)(bench_cycles() - cycles) / elapsed;
+  }
+  return ratio;
+}
+
+/* cost of reading the counter twice, taken off every single call */
+static uint64_t bench_cycles_overhead(void) {
+  uint64_t overhead = UINT64_MAX;
+  for (size_t iter = 0; iter < 1000; ++iter) {
+    uint64_t start = bench_cycles();
+    uint64_t elapsed = bench_cycles() - start;
+    overhead = elapsed < overhead ? elapsed : overhead;
+  }
+  return overhead;
+}
+
+static size_t bench_histogram_index(uint64_t value) {
+  size_t msb = 0;
+  if (value < BENCH_HISTOGRAM_SUB) {
+    return (size_t)value;
+  }
+  for (uint64_t rest = value; rest > 1; rest >>= 1) {
+    ++msb;
+  }
+  return (msb - BENCH_HISTOGRAM_BITS + 1) * BENCH_HISTOGRAM_SUB +
+         (size_t)((value >> (msb - BENCH_HISTOGRAM_BITS)) &
+                  (BENCH_HISTOGRAM_SUB - 1));
+}
+
+/* the largest value that lands in bucket `index` */
+static uint64_t bench_histogram_value(size_t index) {
+  size_t bucket = index / BENCH_HISTOGRAM_SUB;
+  uint64_t sub = index % BENCH_HISTOGRAM_SUB;
+  size_t shift = 0;
+  if (bucket == 0) {
+    return sub;
+  }
+  shift = bucket - 1;
+  return (((BENCH_HISTOGRAM_SUB + sub + 1) << shift) - 1);
+}
+
+static void bench_histogram_record(struct BenchHistogram* histogram,
+                                   uint64_t value) {
+  histogram->counts[bench_histogram_index(value)] += 1;
+  histogram->total += 1;
+  histogram->max = value > histogram->max ? value : histogram->max;
+}
+
+/* value at or below which `quantile` of the recorded values fall */
+static uint64_t bench_histogram_quantile(
+    struct BenchHistogram const* histogram, double quantile) {
+  double const position = ceil(quantile * (double)histogram->total);
+  uint64_t const rank = (uint64_t)position;
+  uint64_t seen = 0;
+  for (size_t iter = 0; iter < BENCH_HISTOGRAM_BUCKETS; ++iter) {
+    seen += histogram->counts[iter];
+    if (seen >= rank && seen > 0) {
+      uint64_t value = bench_histogram_value(iter);
+      return value < histogram->max ? value : histogram->max;
+    }
+  }
+  return histogram->max;
+}
+
+static double bench_histogram_ns(struct BenchHistogram const* histogram,
+                                 double quantile, double cycles_per_ns) {
+  uint64_t const cycles = bench_histogram_quantile(histogram, quantile);
+  return (double)cycles / cycles_per_ns;
+}
+
+/* xorshift64* never leaves 0, so any seed is mixed into a non zero state */
+static uint64_t bench_random_init(uint64_t seed) {
+  uint64_t state = seed ^ 0x9e3779b97f4a7c15ULL;
+  return state == 0 ? 1 : state;
+}
+
+/* xorshift64*, enough for inputs that have to look random */
+static uint64_t bench_random(uint64_t* state) {
+  *state ^= *state >> 12;
+  *state ^= *state << 25;
+  *state ^= *state >> 27;
+  return *state * 2685821657736338717ULL;
+}
+
+/* benchmarks cannot do anything useful without their input */
+static void* bench_alloc(size_t size) {
+  void* memory = malloc(size);
+  if (memory == NULL) {
+    fprintf(stderr, "bench: out of memory allocating %zu bytes\n", size);
+    exit(1);
+  }
+  return memory;
+}
+
+/* uniform in [0, 1) */
+static double bench_uniform(uint64_t* state) {
+  return (double)(bench_random(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static int bench_compare_doubles(void const* lhs, void const* rhs) {
+  double left = *(double const*)lhs;
+  double right = *(double const*)rhs;
+  return (left > right) - (left < right);
+}
+
+static bool bench_options_parse(struct BenchOptions* options, int argc,
+                                char** argv) {
+  options->max_size = BENCH_MAX_SIZE;
+  options->repetitions = BENCH_REPETITIONS;
+  options->filter = NULL;
+  options->seed = 1;
+  for (int iter = 1; iter < argc; ++iter) {
+    if (strcmp(argv[iter], "--max-size") == 0 && iter + 1 < argc) {
+      options->max_size = (size_t)strtoull(argv[++iter], NULL, 10);
+    } else if (strcmp(argv[iter], "--repetitions") == 0 && iter + 1 < argc) {
+      options->repetitions = (size_t)strtoull(argv[++iter], NULL, 10);
+    } else if (strcmp(argv[iter], "--filter") == 0 && iter + 1 < argc) {
+      options->filter = argv[++iter];
+    } else if (strcmp(argv[iter], "--seed") == 0 && iter + 1 < argc) {
+      options->seed = (uint64_t)strtoull(argv[++iter], NULL, 10);
+    } else {
+      fprintf(stderr,
+              "usage: %s [--max-size N] [--repetitions N] [--filter NAME] "
+              "[--seed N]\n       %s generate <shape> <count> [seed]\n",
+              argv[0], argv[0]);
+      return false;
+    }
+  }
+  if (options->repetitions == 0) {
+    options->repetitions = 1;
+  }
+  if (options->repetitions > BENCH_MAX_REPETITIONS) {
+    options->repetitions = BENCH_MAX_REPETITIONS;
+  }
+  return true;
+}
+
+/*
+ * times single calls with the cycle counter, up to BENCH_LATENCY_CALLS
+ * within BENCH_LATENCY_NS, and reports their percentiles in ns.
+ */
+static void bench_measure_latency(struct BenchCase const* bench, void* state,
+                                  struct BenchResult* result) {
+  static struct BenchHistogram histogram;
+  double const cycles_per_ns = bench_cycles_per_ns();
+  uint64_t const overhead = bench_cycles_overhead();
+  double const budget = bench_now() + BENCH_LATENCY_NS;
+  memset(&histogram, 0, sizeof(histogram));
+  for (size_t iter = 0; iter < BENCH_LATENCY_CALLS; ++iter) {
+    uint64_t start = 0;
+    uint64_t elapsed = 0;
+    /* checking the clock every call would add to the tail */
+    if (iter % 64 == 0 && bench_now() > budget) {
+      break;
+    }
+    start = bench_cycles();
+    bench->run(state);
+    elapsed = bench_cycles() - start;
+    bench_histogram_record(&histogram,
+                           elapsed > overhead ? elapsed - overhead : 0);
+  }
+  result->latency_calls = (size_t)histogram.total;
+  result->latency_p50 = bench_histogram_ns(&histogram, 0.5, cycles_per_ns);
+  result->latency_p90 = bench_histogram_ns(&histogram, 0.9, cycles_per_ns);
+  result->latency_p99 = bench_histogram_ns(&histogram, 0.99, cycles_per_ns);
+  result->latency_p999 = bench_histogram_ns(&histogram, 0.999, cycles_per_ns);
+  result->latency_max = bench_histogram_ns(&histogram, 1.0, cycles_per_ns);
+}
+
+/*
+ * times `bench` at `size`: warm up, find how many calls fill a repetition,
+ * then time every repetition on its own.
+ */
+static void bench_measure(struct BenchCase const* bench, size_t size,
+                          struct BenchOptions const* options,
+                          struct BenchResult* result) {
+  size_t const repetitions = options->repetitions;
+  size_t items = size;
+  void* state = bench->setup(bench->shape, size, options->seed, &items);
+  size_t ops = 1;
+  double start = 0.0;
+  double elapsed = 0.0;
+  double sum = 0.0;
+  double squares = 0.0;
+  double sorted[BENCH_MAX_REPETITIONS];
+
+  start = bench_now();
+  do {
+    bench->run(state);
+  } while (bench_now() - start < BENCH_WARMUP_NS);
+
+  for (;;) {
+    start = bench_now();
+    for (size_t iter = 0; iter < ops; ++iter) {
+      bench->run(state);
+    }
+    elapsed = bench_now() - start;
+    if (elapsed >= BENCH_MIN_REPETITION_NS) {
+      break;
+    }
+    ops *= 2;
+  }
+
+  for (size_t rep = 0; rep < repetitions; ++rep) {
+    start = bench_now();
+    for (size_t iter = 0; iter < ops; ++iter) {
+      bench->run(state);
+    }
+    result->samples[rep] = (bench_now() - start) / (double)ops;
+  }
+  result->latency_calls = 0;
+  if (bench->latency) {
+    bench_measure_latency(bench, state, result);
+  }
+  bench->teardown(state);
+
+  memcpy(sorted, result->samples, repetitions * sizeof(double));
+  qsort(sorted, repetitions, sizeof(double), bench_compare_doubles);
+  for (size_t rep = 0; rep < repetitions; ++rep) {
+    sum += sorted[rep];
+  }
+  result->ns_per_op_mean = sum / (double)repetitions;
+  for (size_t rep = 0; rep < repetitions; ++rep) {
+    double delta = sorted[rep] - result->ns_per_op_mean;
+    squares += delta * delta;
+  }
+  result->name = bench->name;
+  result->size = size;
+  result->items = items;
+  result->ops = ops;
+  result->repetitions = repetitions;
+  result->ns_per_op_min = sorted[0];
+  result->ns_per_op = (repetitions % 2 == 1)
+                          ? sorted[repetitions / 2]
+                          : (sorted[repetitions / 2 - 1] +
+                             sorted[repetitions / 2]) /
+                                2.0;
+  result->ns_per_op_stddev =
+      repetitions > 1 ? sqrt(squares / (double)(repetitions - 1)) : 0.0;
+  result->items_per_second = (double)items * 1e9 / result->ns_per_op;
+}
+
+static void bench_json_result(FILE* out, struct BenchResult const* result,
+                              bool first) {
+  fprintf(out,
+          "%s\n    {\"name\": \"%s\", \"size\": %zu, \"items\": %zu, "
+          "\"ops_per_repetition\": %zu, \"repetitions\": %zu, "
+          "\"ns_per_op\": %.3f, \"ns_per_op_min\": %.3f, "
+          "\"ns_per_op_mean\": %.3f, \"ns_per_op_stddev\": %.3f, "
+          "\"items_per_second\": %.1f, \"samples\": [",
+          first ? "" : ",", result->name, result->size, result->items,
+          result->ops, result->repetitions, result->ns_per_op,
+          result->ns_per_op_min, result->ns_per_op_mean,
+          result->ns_per_op_stddev, result->items_per_second);
+  for (size_t rep = 0; rep < result->repetitions; ++rep) {
+    fprintf(out, "%s%.3f", rep == 0 ? "" : ", ", result->samples[rep]);
+  }
+  fprintf(out, "]");
+  if (result->latency_calls > 0) {
+    fprintf(out,
+            ", \"latency_ns\": {\"calls\": %zu, \"p50\": %.1f, "
+            "\"p90\": %.1f, \"p99\": %.1f, \"p999\": %.1f, "
+            "\"max\": %.1f}",
+            result->latency_calls, result->latency_p50, result->latency_p90,
+            result->latency_p99, result->latency_p999, result->latency_max);
+  }
+  fprintf(out, "}");
+}
+
+/*
+ * runs every case at sizes 10, 100, ... up to the case's and the options'
+ * max size. JSON goes to stdout, one progress line per result to stderr.
+ */
+static int bench_run_all(char const* type, struct BenchCase const* cases,
+                         size_t cases_count, int argc, char** argv) {
+  struct BenchOptions options;
+  struct BenchResult result;
+  bool first = true;
+  if (!bench_options_parse(&options, argc, argv)) {
+    return 1;
+  }
+  printf("{\n  \"type\": \"%s\",\n  \"seed\": %llu,\n  \"benchmarks\": [",
+         type, (unsigned long long)options.seed);
+  for (size_t iter = 0; iter < cases_count; ++iter) {
+    if (options.filter != NULL &&
+        strstr(cases[iter].name, options.filter) == NULL) {
+      continue;
+    }
+    for (size_t size = 10;
+         size <= options.max_size && size <= cases[iter].max_size;
+         size *= 10) {
+      bench_measure(&cases[iter], size, &options, &result);
+      bench_json_result(stdout, &result, first);
+      first = false;
+      fprintf(stderr, "%-40s %10zu %14.1f ns/op %14.0f items/s",
+              result.name, result.size, result.ns_per_op,
+              result.items_per_second);
+      if (result.latency_calls > 0) {
+        fprintf(stderr, " p50 %.1f p99 %.1f p999 %.1f max %.1f ns",
+                result.latency_p50, result.latency_p99, result.latency_p999,
+                result.latency_max);
+      }
+      fprintf(stderr, "\n");
+    }
+  }
+  printf("\n  ]\n}\n");
+  return 0;
+}
+
+#endif
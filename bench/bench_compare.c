@@ -0,0 +1,244 @@
+/*
+ * compares two results of a bench_geo_<type> program, usually the committed
+ * baseline and a fresh run. a function at a size is a regression when its
+ * median got slower by more than the threshold and a one sided Mann-Whitney
+ * U test over the repetitions says it is not noise.
+ *
+ * usage: bench_compare <baseline.json> <current.json> [threshold %] [alpha]
+ * exits 1 when anything regressed, 2 when a file cannot be read.
+ */
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define COMPARE_MAX_SAMPLES 1000
+#define COMPARE_MAX_NAME 128
+
+struct CompareEntry {
+  char name[COMPARE_MAX_NAME];
+  size_t size;
+  double ns_per_op;
+  double samples[COMPARE_MAX_SAMPLES];
+  size_t samples_count;
+};
+
+struct CompareFile {
+  struct CompareEntry* entries;
+  size_t count;
+};
+
+static char* read_file(char const* path) {
+  FILE* file = fopen(path, "rb");
+  char* text = NULL;
+  long size = 0;
+  if (file == NULL) {
+    return NULL;
+  }
+  if (fseek(file, 0, SEEK_END) != 0 || (size = ftell(file)) < 0 ||
+      fseek(file, 0, SEEK_SET) != 0) {
+    fclose(file);
+    return NULL;
+  }
+  text = malloc((size_t)size + 1);
+  if (text != NULL && fread(text, 1, (size_t)size, file) != (size_t)size) {
+    free(text);
+    text = NULL;
+  }
+  if (text != NULL) {
+    text[size] = '\0';
+  }
+  fclose(file);
+  return text;
+}
+
+/* the number after `"key": ` within [object, end) */
+static bool read_number(char const* object, char const* end, char const* key,
+                        double* value) {
+  char const* found = strstr(object, key);
+  char* number_end = NULL;
+  if (found == NULL || found >= end) {
+    return false;
+  }
+  found += strlen(key);
+  *value = strtod(found, &number_end);
+  return number_end != found;
+}
+
+/*
+ * reads the benchmarks of a result file. the programs write one object per
+ * line, which is all this parser understands.
+ */
+static bool parse_results(char const* text, struct CompareFile* file) {
+  size_t capacity = 0;
+  char const* object = text;
+  file->entries = NULL;
+  file->count = 0;
+  while ((object = strstr(object, "{\"name\": \"")) != NULL) {
+    struct CompareEntry* entry = NULL;
+    char const* name = object + strlen("{\"name\": \"");
+    char const* name_end = strchr(name, '"');
+    char const* end = strchr(object, '\n');
+    char const* samples = NULL;
+    double size = 0.0;
+    if (end == NULL) {
+      end = object + strlen(object);
+    }
+    if (name_end == NULL || name_end >= end ||
+        (size_t)(name_end - name) >= COMPARE_MAX_NAME) {
+      return false;
+    }
+    if (file->count == capacity) {
+      struct CompareEntry* grown = NULL;
+      capacity = capacity == 0 ? 64 : capacity * 2;
+      grown = realloc(file->entries, capacity * sizeof(struct CompareEntry));
+      if (grown == NULL) {
+        return false;
+      }
+      file->entries = grown;
+    }
+    entry = &file->entries[file->count];
+    memcpy(entry->name, name, (size_t)(name_end - name));
+    entry->name[name_end - name] = '\0';
+    if (!read_number(object, end, "\"size\": ", &size) ||
+        !read_number(object, end, "\"ns_per_op\": ", &entry->ns_per_op)) {
+      return false;
+    }
+    entry->size = (size_t)size;
+    entry->samples_count = 0;
+    samples = strstr(object, "\"samples\": [");
+    if (samples != NULL && samples < end) {
+      char const* cursor = samples + strlen("\"samples\": [");
+      while (*cursor != ']' && cursor < end &&
+             entry->samples_count < COMPARE_MAX_SAMPLES) {
+        char* next = NULL;
+        entry->samples[entry->samples_count] = strtod(cursor, &next);
+        if (next == cursor) {
+          return false;
+        }
+        entry->samples_count += 1;
+        cursor = next;
+        while (*cursor == ',' || *cursor == ' ') {
+          ++cursor;
+        }
+      }
+    }
+    file->count += 1;
+    object = end;
+  }
+  return true;
+}
+
+static struct CompareEntry const* find_entry(struct CompareFile const* file,
+                                             struct CompareEntry const* key) {
+  for (size_t iter = 0; iter < file->count; ++iter) {
+    if (file->entries[iter].size == key->size &&
+        strcmp(file->entries[iter].name, key->name) == 0) {
+      return &file->entries[iter];
+    }
+  }
+  return NULL;
+}
+
+/*
+ * p-value of the current samples being larger than the baseline ones, one
+ * sided Mann-Whitney U with the normal approximation.
+ */
+static double slower_p_value(struct CompareEntry const* baseline,
+                             struct CompareEntry const* current) {
+  double const count1 = (double)current->samples_count;
+  double const count2 = (double)baseline->samples_count;
+  double u = 0.0;
+  double mean = 0.0;
+  double deviation = 0.0;
+  double z = 0.0;
+  if (current->samples_count == 0 || baseline->samples_count == 0) {
+    return 1.0;
+  }
+  for (size_t left = 0; left < current->samples_count; ++left) {
+    for (size_t right = 0; right < baseline->samples_count; ++right) {
+      if (current->samples[left] > baseline->samples[right]) {
+        u += 1.0;
+      } else if (!(current->samples[left] < baseline->samples[right])) {
+        u += 0.5;
+      }
+    }
+  }
+  mean = count1 * count2 / 2.0;
+  deviation = sqrt(count1 * count2 * (count1 + count2 + 1.0) / 12.0);
+  z = (u - mean - 0.5) / deviation;
+  return 0.5 * erfc(z / sqrt(2.0));
+}
+
+int main(int argc, char** argv) {
+  struct CompareFile baseline;
+  struct CompareFile current;
+  char* baseline_text = NULL;
+  char* current_text = NULL;
+  double threshold = 5.0;
+  double alpha = 0.01;
+  size_t regressions = 0;
+  size_t missing = 0;
+  if (argc < 3) {
+    fprintf(stderr,
+            "usage: %s <baseline.json> <current.json> [threshold %%] "
+            "[alpha]\n",
+            argv[0]);
+    return 2;
+  }
+  if (argc > 3) {
+    threshold = strtod(argv[3], NULL);
+  }
+  if (argc > 4) {
+    alpha = strtod(argv[4], NULL);
+  }
+  baseline_text = read_file(argv[1]);
+  current_text = read_file(argv[2]);
+  if (baseline_text == NULL || current_text == NULL) {
+    fprintf(stderr, "%s: cannot read %s\n", argv[0],
+            baseline_text == NULL ? argv[1] : argv[2]);
+    free(baseline_text);
+    free(current_text);
+    return 2;
+  }
+  if (!parse_results(baseline_text, &baseline) ||
+      !parse_results(current_text, &current)) {
+    fprintf(stderr, "%s: malformed results\n", argv[0]);
+    return 2;
+  }
+
+  printf("%s against %s, slower by over %.1f%% with p < %g regresses\n",
+         argv[2], argv[1], threshold, alpha);
+  printf("%-40s %10s %14s %14s %9s %10s\n", "name", "size", "baseline ns",
+         "current ns", "change", "p-value");
+  for (size_t iter = 0; iter < current.count; ++iter) {
+    struct CompareEntry const* now = &current.entries[iter];
+    struct CompareEntry const* before = find_entry(&baseline, now);
+    double change = 0.0;
+    double p_value = 1.0;
+    char const* verdict = "";
+    if (before == NULL) {
+      ++missing;
+      continue;
+    }
+    change = (now->ns_per_op - before->ns_per_op) / before->ns_per_op * 100.0;
+    p_value = slower_p_value(before, now);
+    if (change > threshold && p_value < alpha) {
+      verdict = " REGRESSION";
+      ++regressions;
+    }
+    printf("%-40s %10zu %14.1f %14.1f %+8.1f%% %10.4f%s\n", now->name,
+           now->size, before->ns_per_op, now->ns_per_op, change, p_value,
+           verdict);
+  }
+  if (missing > 0) {
+    printf("%zu results have no baseline\n", missing);
+  }
+  printf("%zu regressions\n", regressions);
+  free(baseline.entries);
+  free(current.entries);
+  free(baseline_text);
+  free(current_text);
+  return regressions > 0 ? 1 : 0;
+}
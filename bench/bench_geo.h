@@ -0,0 +1,354 @@
+/*
+ * benchmarks for one instantiation of geometry.h. include `bench.h`, the
+ * type's header, then define BENCH_TYPE before including this file.
+ */
+#ifndef BENCH_TYPE
+#error "BENCH_TYPE must be defined before including bench_geo.h"
+#endif
+
+#define BENCH_CONCAT_(lhs, rhs) lhs##_##rhs
+#define BENCH_CONCAT(lhs, rhs) BENCH_CONCAT_(lhs, rhs)
+#define BENCH_STRING_(name) #name
+#define BENCH_STRING(name) BENCH_STRING_(name)
+#define BENCH_FUNC(name) BENCH_CONCAT(name, BENCH_TYPE)
+#define BENCH_POINT BENCH_CONCAT(GeoPoint, BENCH_TYPE)
+#define BENCH_SEGMENT BENCH_CONCAT(GeoSegment, BENCH_TYPE)
+#define BENCH_GEOMETRY BENCH_CONCAT(GeoGeometry, BENCH_TYPE)
+#define BENCH_ENVELOPE BENCH_CONCAT(GeoEnvelope, BENCH_TYPE)
+#define BENCH_POINTS_SOA BENCH_CONCAT(GeoPointsSoA, BENCH_TYPE)
+
+/*
+ * every input lies in [0, BENCH_EXTENT]. small enough that the cross
+ * products in orientation() do not overflow an int.
+ */
+#define BENCH_EXTENT 16384.0
+/* query points a point in polygon benchmark cycles through */
+#define BENCH_QUERIES 256
+/* vertices of the polygon the batch benchmarks test against */
+#define BENCH_BATCH_POLYGON_SIZE 64
+
+#include "bench_shapes.h"
+
+/* results go here so no call can be optimized away */
+static volatile size_t bench_sink;
+
+/* a generated polygon and uniform query points over the extent */
+struct BenchPolygon {
+  struct BENCH_POINT* points;
+  struct BENCH_SEGMENT* segments;
+  struct BENCH_SEGMENT** segment_pointers;
+  struct BENCH_GEOMETRY geometry;
+  struct BENCH_POINT queries[BENCH_QUERIES];
+  size_t next;
+};
+
+static struct BenchPolygon* polygon_create(size_t shape, size_t size,
+                                           uint64_t seed) {
+  struct BenchPolygon* polygon = bench_alloc(sizeof(struct BenchPolygon));
+  polygon->points = bench_alloc(size * sizeof(struct BENCH_POINT));
+  polygon->segments = bench_alloc(size * sizeof(struct BENCH_SEGMENT));
+  polygon->segment_pointers =
+      bench_alloc(size * sizeof(struct BENCH_SEGMENT*));
+  bench_shapes[shape].generate(polygon->points, size, seed);
+  for (size_t iter = 0; iter < size; ++iter) {
+    polygon->segments[iter].start = &polygon->points[iter];
+    polygon->segments[iter].end = &polygon->points[(iter + 1) % size];
+    polygon->segment_pointers[iter] = &polygon->segments[iter];
+  }
+  polygon->geometry.segments = polygon->segment_pointers;
+  polygon->geometry.segments_count = size;
+  shape_uniform(polygon->queries, BENCH_QUERIES, seed + 1);
+  polygon->next = 0;
+  return polygon;
+}
+
+static void polygon_destroy(void* state) {
+  struct BenchPolygon* polygon = state;
+  free(polygon->segment_pointers);
+  free(polygon->segments);
+  free(polygon->points);
+  free(polygon);
+}
+
+/*
+ *----------------------------------
+ * geo_segments_intersect
+ *----------------------------------
+ */
+struct BenchSegments {
+  struct BENCH_POINT* points;
+  struct BENCH_SEGMENT* segments;
+  size_t count;
+  size_t next;
+};
+
+/* segments between consecutive points of the shape */
+static void* segments_intersect_setup(size_t shape, size_t size,
+                                      uint64_t seed, size_t* items) {
+  struct BenchSegments* segments = bench_alloc(sizeof(struct BenchSegments));
+  segments->points = bench_alloc(4 * size * sizeof(struct BENCH_POINT));
+  segments->segments = bench_alloc(2 * size * sizeof(struct BENCH_SEGMENT));
+  segments->count = size;
+  segments->next = 0;
+  bench_shapes[shape].generate(segments->points, 4 * size, seed);
+  for (size_t iter = 0; iter < 2 * size; ++iter) {
+    segments->segments[iter].start = &segments->points[2 * iter];
+    segments->segments[iter].end = &segments->points[2 * iter + 1];
+  }
+  *items = 1;
+  return segments;
+}
+
+/* one call tests the next of `size` pairs of segments */
+static void segments_intersect_run(void* state) {
+  struct BenchSegments* segments = state;
+  size_t intersect_count = 0;
+  size_t const pair = segments->next;
+  BENCH_FUNC(geo_segments_intersect)
+  (&segments->segments[2 * pair], &segments->segments[2 * pair + 1],
+   &intersect_count);
+  segments->next = pair + 1 == segments->count ? 0 : pair + 1;
+  bench_sink = intersect_count;
+}
+
+static void segments_intersect_teardown(void* state) {
+  struct BenchSegments* segments = state;
+  free(segments->segments);
+  free(segments->points);
+  free(segments);
+}
+
+/*
+ *----------------------------------
+ * geo_point_in_geometry
+ *----------------------------------
+ */
+static void* point_in_geometry_setup(size_t shape, size_t size,
+                                     uint64_t seed, size_t* items) {
+  *items = size;
+  return polygon_create(shape, size, seed);
+}
+
+static void point_in_geometry_run(void* state) {
+  struct BenchPolygon* polygon = state;
+  bool is_inside = false;
+  BENCH_FUNC(geo_point_in_geometry)
+  (&polygon->queries[polygon->next], &polygon->geometry, false, &is_inside);
+  polygon->next = (polygon->next + 1) % BENCH_QUERIES;
+  bench_sink = is_inside;
+}
+
+/*
+ *----------------------------------
+ * geo_geometry_is_simple
+ *----------------------------------
+ */
+static void geometry_is_simple_run(void* state) {
+  struct BenchPolygon* polygon = state;
+  bool is_simple = false;
+  BENCH_FUNC(geo_geometry_is_simple)(&polygon->geometry, &is_simple);
+  bench_sink = is_simple;
+}
+
+/*
+ *----------------------------------
+ * geo_convex_hull
+ *----------------------------------
+ */
+struct BenchHull {
+  struct BENCH_POINT* points;
+  struct BENCH_POINT** input;
+  struct BENCH_POINT** order;
+  struct BENCH_POINT** convex_hull;
+  struct BENCH_POINTS_SOA soa;
+  size_t* positions;
+  size_t count;
+};
+
+static void* convex_hull_setup(size_t shape, size_t size, uint64_t seed,
+                               size_t* items) {
+  struct BenchHull* hull = bench_alloc(sizeof(struct BenchHull));
+  hull->points = bench_alloc(size * sizeof(struct BENCH_POINT));
+  hull->input = bench_alloc(size * sizeof(struct BENCH_POINT*));
+  hull->order = bench_alloc(size * sizeof(struct BENCH_POINT*));
+  hull->convex_hull = bench_alloc(size * sizeof(struct BENCH_POINT*));
+  hull->soa.xs = bench_alloc(size * sizeof(BENCH_TYPE));
+  hull->soa.ys = bench_alloc(size * sizeof(BENCH_TYPE));
+  hull->soa.count = size;
+  /* the hull of every point, the whole output either hull function writes */
+  hull->positions = bench_alloc(size * sizeof(size_t));
+  hull->count = size;
+  bench_shapes[shape].generate(hull->points, size, seed);
+  for (size_t iter = 0; iter < size; ++iter) {
+    hull->input[iter] = &hull->points[iter];
+    hull->soa.xs[iter] = hull->points[iter].x;
+    hull->soa.ys[iter] = hull->points[iter].y;
+  }
+  *items = size;
+  return hull;
+}
+
+/*
+ * geo_convex_hull reorders its input, every call starts from a copy of the
+ * original order. the copy is part of the measured time.
+ */
+static void convex_hull_run(void* state) {
+  struct BenchHull* hull = state;
+  size_t convex_hull_size = 0;
+  memcpy((void*)hull->order, (void*)hull->input,
+         hull->count * sizeof(struct BENCH_POINT*));
+  BENCH_FUNC(geo_convex_hull)
+  (hull->order, hull->convex_hull, hull->count, &convex_hull_size);
+  bench_sink = convex_hull_size;
+}
+
+static void convex_hull_soa_run(void* state) {
+  struct BenchHull* hull = state;
+  size_t convex_hull_size = 0;
+  BENCH_FUNC(geo_convex_hull_soa)
+  (&hull->soa, NULL, NULL, hull->positions, &convex_hull_size);
+  bench_sink = convex_hull_size;
+}
+
+static void convex_hull_teardown(void* state) {
+  struct BenchHull* hull = state;
+  free(hull->positions);
+  free(hull->soa.ys);
+  free(hull->soa.xs);
+  free((void*)hull->convex_hull);
+  free((void*)hull->order);
+  free((void*)hull->input);
+  free(hull->points);
+  free(hull);
+}
+
+/*
+ *----------------------------------
+ * geo_points_in_geometry_soa
+ *----------------------------------
+ */
+struct BenchBatch {
+  struct BenchPolygon* polygon;
+  struct BENCH_POINT* points;
+  struct BENCH_POINTS_SOA soa;
+  struct BENCH_ENVELOPE envelope;
+  bool* is_inside;
+  uint64_t* keys;
+};
+
+/* the shape's points against a star polygon */
+static void* batch_setup(size_t shape, size_t size, uint64_t seed,
+                         size_t* items) {
+  struct BenchBatch* batch = bench_alloc(sizeof(struct BenchBatch));
+  batch->polygon =
+      polygon_create(BENCH_SHAPE_STAR, BENCH_BATCH_POLYGON_SIZE, seed);
+  batch->points = bench_alloc(size * sizeof(struct BENCH_POINT));
+  batch->soa.xs = bench_alloc(size * sizeof(BENCH_TYPE));
+  batch->soa.ys = bench_alloc(size * sizeof(BENCH_TYPE));
+  batch->soa.count = size;
+  batch->is_inside = bench_alloc(size * sizeof(bool));
+  batch->keys = bench_alloc(size * sizeof(uint64_t));
+  bench_shapes[shape].generate(batch->points, size, seed);
+  for (size_t iter = 0; iter < size; ++iter) {
+    batch->soa.xs[iter] = batch->points[iter].x;
+    batch->soa.ys[iter] = batch->points[iter].y;
+  }
+  batch->envelope.min.x = (BENCH_TYPE)0;
+  batch->envelope.min.y = (BENCH_TYPE)0;
+  batch->envelope.max.x = (BENCH_TYPE)BENCH_EXTENT;
+  batch->envelope.max.y = (BENCH_TYPE)BENCH_EXTENT;
+  *items = size;
+  return batch;
+}
+
+static void points_in_geometry_soa_run(void* state) {
+  struct BenchBatch* batch = state;
+  BENCH_FUNC(geo_points_in_geometry_soa)
+  (&batch->soa, &batch->polygon->geometry, false, NULL, batch->is_inside);
+  bench_sink = batch->is_inside[0];
+}
+
+/*
+ *----------------------------------
+ * geo_hilbert_key
+ *----------------------------------
+ */
+static void hilbert_key_run(void* state) {
+  struct BenchBatch* batch = state;
+  BENCH_FUNC(geo_hilbert_key)
+  (batch->points, batch->soa.count, &batch->envelope, batch->keys);
+  bench_sink = (size_t)batch->keys[0];
+}
+
+static void batch_teardown(void* state) {
+  struct BenchBatch* batch = state;
+  free(batch->keys);
+  free(batch->is_inside);
+  free(batch->soa.ys);
+  free(batch->soa.xs);
+  free(batch->points);
+  polygon_destroy(batch->polygon);
+  free(batch);
+}
+
+/*
+ * geo_geometry_is_simple is quadratic, larger polygons take minutes per
+ * call.
+ */
+static struct BenchCase const bench_cases[] = {
+    {"geo_segments_intersect/uniform", BENCH_SHAPE_UNIFORM, BENCH_MAX_SIZE,
+     true, segments_intersect_setup, segments_intersect_run,
+     segments_intersect_teardown},
+    {"geo_segments_intersect/clustered", BENCH_SHAPE_CLUSTERED, BENCH_MAX_SIZE,
+     true, segments_intersect_setup, segments_intersect_run,
+     segments_intersect_teardown},
+    {"geo_point_in_geometry/regular", BENCH_SHAPE_REGULAR, BENCH_MAX_SIZE, true,
+     point_in_geometry_setup, point_in_geometry_run, polygon_destroy},
+    {"geo_point_in_geometry/star", BENCH_SHAPE_STAR, BENCH_MAX_SIZE, true,
+     point_in_geometry_setup, point_in_geometry_run, polygon_destroy},
+    {"geo_point_in_geometry/spiral", BENCH_SHAPE_SPIRAL, BENCH_MAX_SIZE, true,
+     point_in_geometry_setup, point_in_geometry_run, polygon_destroy},
+    {"geo_point_in_geometry/comb", BENCH_SHAPE_COMB, BENCH_MAX_SIZE, true,
+     point_in_geometry_setup, point_in_geometry_run, polygon_destroy},
+    {"geo_point_in_geometry/sawtooth", BENCH_SHAPE_SAWTOOTH, BENCH_MAX_SIZE,
+     true, point_in_geometry_setup, point_in_geometry_run, polygon_destroy},
+    {"geo_point_in_geometry/coastline", BENCH_SHAPE_COASTLINE, BENCH_MAX_SIZE,
+     true, point_in_geometry_setup, point_in_geometry_run, polygon_destroy},
+    {"geo_geometry_is_simple/regular", BENCH_SHAPE_REGULAR, 10000, true,
+     point_in_geometry_setup, geometry_is_simple_run, polygon_destroy},
+    {"geo_geometry_is_simple/star", BENCH_SHAPE_STAR, 10000, true,
+     point_in_geometry_setup, geometry_is_simple_run, polygon_destroy},
+    {"geo_geometry_is_simple/comb", BENCH_SHAPE_COMB, 10000, true,
+     point_in_geometry_setup, geometry_is_simple_run, polygon_destroy},
+    {"geo_convex_hull/uniform", BENCH_SHAPE_UNIFORM, BENCH_MAX_SIZE, false,
+     convex_hull_setup, convex_hull_run, convex_hull_teardown},
+    {"geo_convex_hull/clustered", BENCH_SHAPE_CLUSTERED, BENCH_MAX_SIZE, false,
+     convex_hull_setup, convex_hull_run, convex_hull_teardown},
+    {"geo_convex_hull/circle", BENCH_SHAPE_CIRCLE, BENCH_MAX_SIZE, false,
+     convex_hull_setup, convex_hull_run, convex_hull_teardown},
+    {"geo_convex_hull_soa/uniform", BENCH_SHAPE_UNIFORM, BENCH_MAX_SIZE, false,
+     convex_hull_setup, convex_hull_soa_run, convex_hull_teardown},
+    {"geo_convex_hull_soa/clustered", BENCH_SHAPE_CLUSTERED, BENCH_MAX_SIZE,
+     false, convex_hull_setup, convex_hull_soa_run, convex_hull_teardown},
+    {"geo_convex_hull_soa/circle", BENCH_SHAPE_CIRCLE, BENCH_MAX_SIZE, false,
+     convex_hull_setup, convex_hull_soa_run, convex_hull_teardown},
+    {"geo_points_in_geometry_soa/uniform", BENCH_SHAPE_UNIFORM, BENCH_MAX_SIZE,
+     false, batch_setup, points_in_geometry_soa_run, batch_teardown},
+    {"geo_points_in_geometry_soa/clustered", BENCH_SHAPE_CLUSTERED,
+     BENCH_MAX_SIZE, false, batch_setup, points_in_geometry_soa_run,
+     batch_teardown},
+    {"geo_hilbert_key/uniform", BENCH_SHAPE_UNIFORM, BENCH_MAX_SIZE, false,
+     batch_setup, hilbert_key_run, batch_teardown},
+    {"geo_hilbert_key/clustered", BENCH_SHAPE_CLUSTERED, BENCH_MAX_SIZE, false,
+     batch_setup, hilbert_key_run, batch_teardown},
+};
+
+/* `generate` writes a shape instead of running the benchmarks */
+static int bench_main(int argc, char** argv) {
+  if (argc > 1 && strcmp(argv[1], "generate") == 0) {
+    return shape_generate_main(argc, argv);
+  }
+  return bench_run_all(BENCH_STRING(BENCH_TYPE), bench_cases,
+                       sizeof(bench_cases) / sizeof(bench_cases[0]), argc,
+                       argv);
+}
@@ -0,0 +1,6 @@
+#include "bench.h"
+#include "geo_long.h"
+#define BENCH_TYPE long
+#include "bench_geo.h"
+
+int main(int argc, char** argv) { return bench_main(argc, argv); }
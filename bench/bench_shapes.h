@@ -0,0 +1,328 @@
+/*
+ * deterministic synthetic inputs for the benchmarks. every generator fills
+ * `count` points from `seed`, the same seed always gives the same points.
+ * polygons come out as a ring without the closing point and are simple for
+ * any count they accept. included by bench_geo.h, uses its BENCH_* macros.
+ */
+
+#define BENCH_PI 3.14159265358979323846
+
+enum BenchShapeKind {
+  BENCH_SHAPE_REGULAR = 0,
+  BENCH_SHAPE_STAR = 1,
+  BENCH_SHAPE_SPIRAL = 2,
+  BENCH_SHAPE_COMB = 3,
+  BENCH_SHAPE_SAWTOOTH = 4,
+  BENCH_SHAPE_COASTLINE = 5,
+  BENCH_SHAPE_UNIFORM = 6,
+  BENCH_SHAPE_CLUSTERED = 7,
+  BENCH_SHAPE_CIRCLE = 8
+};
+
+/* smallest count every polygon generator accepts */
+#define BENCH_SHAPE_MIN_SIZE 6
+/* clusters of BENCH_SHAPE_CLUSTERED and their standard deviation */
+#define BENCH_SHAPE_CLUSTERS 16
+#define BENCH_SHAPE_CLUSTER_SIGMA (BENCH_EXTENT / 64.0)
+
+static void shape_point(struct BENCH_POINT* point, double x, double y) {
+  point->x = (BENCH_TYPE)x;
+  point->y = (BENCH_TYPE)y;
+}
+
+/* polar point around the middle of the extent */
+static void shape_polar(struct BENCH_POINT* point, double angle,
+                        double radius) {
+  double const middle = BENCH_EXTENT / 2.0;
+  shape_point(point, middle + radius * cos(angle),
+              middle + radius * sin(angle));
+}
+
+/* convex, every edge about the same length */
+static void shape_regular(struct BENCH_POINT* points, size_t count,
+                          uint64_t seed) {
+  double const step = 2.0 * BENCH_PI / (double)count;
+  (void)seed;
+  for (size_t iter = 0; iter < count; ++iter) {
+    shape_polar(&points[iter], step * (double)iter, BENCH_EXTENT / 2.0);
+  }
+}
+
+/* spikes with random inner and outer radii, half the vertices are reflex */
+static void shape_star(struct BENCH_POINT* points, size_t count,
+                       uint64_t seed) {
+  uint64_t state = bench_random_init(seed);
+  double const step = 2.0 * BENCH_PI / (double)count;
+  double const radius = BENCH_EXTENT / 2.0;
+  for (size_t iter = 0; iter < count; ++iter) {
+    double scale = (iter % 2 == 0) ? 0.8 + 0.2 * bench_uniform(&state)
+                                   : 0.2 + 0.3 * bench_uniform(&state);
+    shape_polar(&points[iter], step * (double)iter, radius * scale);
+  }
+}
+
+/*
+ * a band wound up to 16 times around the middle. a ray from a point crosses
+ * every turn, the most crossings a polygon of this size can give.
+ */
+static void shape_spiral(struct BENCH_POINT* points, size_t count,
+                         uint64_t seed) {
+  size_t const outer = count / 2;
+  size_t const inner = count - outer;
+  size_t turns = count / 64;
+  double const radius = BENCH_EXTENT / 2.0;
+  double spacing = 0.0;
+  double width = 0.0;
+  double sweep = 0.0;
+  (void)seed;
+  if (turns < 1) {
+    turns = 1;
+  }
+  if (turns > 16) {
+    turns = 16;
+  }
+  spacing = radius / (double)(turns + 1);
+  width = spacing / 2.0;
+  /* under 8 points a turn the chords cut across the band, small counts
+   * only wind part of a turn */
+  sweep = 2.0 * BENCH_PI * (double)turns;
+  if ((double)(outer - 1) / 8.0 < (double)turns) {
+    sweep = 2.0 * BENCH_PI * (double)(outer - 1) / 8.0;
+  }
+  for (size_t iter = 0; iter < outer; ++iter) {
+    double angle = sweep * (double)iter / (double)(outer - 1);
+    shape_polar(&points[iter], angle,
+                spacing + angle / sweep * (radius - spacing));
+  }
+  for (size_t iter = 0; iter < inner; ++iter) {
+    double angle = sweep * (double)(inner - 1 - iter) / (double)(inner - 1);
+    shape_polar(&points[outer + iter], angle,
+                spacing - width + angle / sweep * (radius - spacing));
+  }
+}
+
+/*
+ * teeth of random height on a base. counts that do not fit the teeth put
+ * the rest on the bottom edge, all colinear.
+ */
+static void shape_comb(struct BENCH_POINT* points, size_t count,
+                       uint64_t seed) {
+  uint64_t state = bench_random_init(seed);
+  size_t const teeth = (count - 2) / 4;
+  size_t const extra = count - 2 - 4 * teeth;
+  double const tooth = BENCH_EXTENT / (double)teeth;
+  double const base = BENCH_EXTENT / 8.0;
+  size_t next = 0;
+  for (size_t iter = 0; iter <= extra; ++iter) {
+    shape_point(&points[next++],
+                BENCH_EXTENT * (double)iter / (double)(extra + 1), 0.0);
+  }
+  shape_point(&points[next++], BENCH_EXTENT, 0.0);
+  for (size_t iter = teeth; iter > 0; --iter) {
+    double left = tooth * (double)(iter - 1);
+    double height = base + (BENCH_EXTENT - base) *
+                               (0.5 + 0.5 * bench_uniform(&state));
+    shape_point(&points[next++], left + tooth / 2.0, base);
+    shape_point(&points[next++], left + tooth / 2.0, height);
+    shape_point(&points[next++], left, height);
+    shape_point(&points[next++], left, base);
+  }
+}
+
+/* a box whose top edge zigzags by a tiny amount, nearly colinear edges */
+static void shape_sawtooth(struct BENCH_POINT* points, size_t count,
+                           uint64_t seed) {
+  double const height = BENCH_EXTENT / 2.0;
+  double const amplitude = BENCH_EXTENT / 8192.0;
+  (void)seed;
+  shape_point(&points[0], 0.0, 0.0);
+  shape_point(&points[1], BENCH_EXTENT, 0.0);
+  for (size_t iter = 2; iter < count; ++iter) {
+    double x =
+        BENCH_EXTENT * (double)(count - 1 - iter) / (double)(count - 3);
+    double y = height + (iter % 2 == 0 ? 0.0 : amplitude);
+    shape_point(&points[iter], x, y);
+  }
+}
+
+/*
+ * radius from periodic midpoint displacement, the detail of a coastline at
+ * every scale while staying star shaped and simple.
+ */
+static void shape_coastline(struct BENCH_POINT* points, size_t count,
+                            uint64_t seed) {
+  uint64_t state = bench_random_init(seed);
+  double const step = 2.0 * BENCH_PI / (double)count;
+  double* noise = bench_alloc(count * sizeof(double));
+  size_t span = 1;
+  double roughness = 0.5;
+  double low = 0.0;
+  double high = 0.0;
+  while (span < count) {
+    span *= 2;
+  }
+  for (size_t iter = 0; iter < count; ++iter) {
+    noise[iter] = 0.0;
+  }
+  /* halve the span each round, new points are the displaced mean of the
+   * points span apart around the ring */
+  for (span /= 2; span > 0; span /= 2) {
+    for (size_t iter = span; iter < count; iter += 2 * span) {
+      double left = noise[iter - span];
+      double right = noise[(iter + span) % count];
+      noise[iter] = (left + right) / 2.0 +
+                    roughness * (bench_uniform(&state) - 0.5);
+    }
+    roughness *= 0.6;
+  }
+  low = noise[0];
+  high = noise[0];
+  for (size_t iter = 1; iter < count; ++iter) {
+    low = noise[iter] < low ? noise[iter] : low;
+    high = noise[iter] > high ? noise[iter] : high;
+  }
+  for (size_t iter = 0; iter < count; ++iter) {
+    double scale = high > low ? (noise[iter] - low) / (high - low) : 1.0;
+    shape_polar(&points[iter], step * (double)iter,
+                BENCH_EXTENT / 2.0 * (0.4 + 0.6 * scale));
+  }
+  free(noise);
+}
+
+/* uniformly random over the extent */
+static void shape_uniform(struct BENCH_POINT* points, size_t count,
+                          uint64_t seed) {
+  uint64_t state = bench_random_init(seed);
+  for (size_t iter = 0; iter < count; ++iter) {
+    double x = bench_uniform(&state) * BENCH_EXTENT;
+    shape_point(&points[iter], x, bench_uniform(&state) * BENCH_EXTENT);
+  }
+}
+
+static double shape_clamp(double value) {
+  if (value < 0.0) {
+    return 0.0;
+  }
+  return value < BENCH_EXTENT - 1.0 ? value : BENCH_EXTENT - 1.0;
+}
+
+/* gaussian clusters around random centers, like cities on a map */
+static void shape_clustered(struct BENCH_POINT* points, size_t count,
+                            uint64_t seed) {
+  uint64_t state = bench_random_init(seed);
+  double centers[BENCH_SHAPE_CLUSTERS][2];
+  for (size_t iter = 0; iter < BENCH_SHAPE_CLUSTERS; ++iter) {
+    centers[iter][0] = bench_uniform(&state) * BENCH_EXTENT;
+    centers[iter][1] = bench_uniform(&state) * BENCH_EXTENT;
+  }
+  for (size_t iter = 0; iter < count; ++iter) {
+    size_t cluster = (size_t)(bench_random(&state) % BENCH_SHAPE_CLUSTERS);
+    /* box muller, 1 - uniform keeps the log away from 0 */
+    double length = sqrt(-2.0 * log(1.0 - bench_uniform(&state)));
+    double angle = 2.0 * BENCH_PI * bench_uniform(&state);
+    shape_point(&points[iter],
+                shape_clamp(centers[cluster][0] +
+                            BENCH_SHAPE_CLUSTER_SIGMA * length * cos(angle)),
+                shape_clamp(centers[cluster][1] +
+                            BENCH_SHAPE_CLUSTER_SIGMA * length * sin(angle)));
+  }
+}
+
+/* every point on the hull, in random order: the worst case for a hull */
+static void shape_circle(struct BENCH_POINT* points, size_t count,
+                         uint64_t seed) {
+  uint64_t state = bench_random_init(seed);
+  for (size_t iter = 0; iter < count; ++iter) {
+    shape_polar(&points[iter], 2.0 * BENCH_PI * bench_uniform(&state),
+                BENCH_EXTENT / 2.0 - 1.0);
+  }
+}
+
+struct BenchShape {
+  char const* name;
+  bool is_polygon;
+  void (*generate)(struct BENCH_POINT* points, size_t count, uint64_t seed);
+};
+
+/* indexed by enum BenchShapeKind */
+static struct BenchShape const bench_shapes[] = {
+    {"regular", true, shape_regular},
+    {"star", true, shape_star},
+    {"spiral", true, shape_spiral},
+    {"comb", true, shape_comb},
+    {"sawtooth", true, shape_sawtooth},
+    {"coastline", true, shape_coastline},
+    {"uniform", false, shape_uniform},
+    {"clustered", false, shape_clustered},
+    {"circle", false, shape_circle},
+};
+
+#define BENCH_SHAPES_COUNT (sizeof(bench_shapes) / sizeof(bench_shapes[0]))
+
+static struct BenchShape const* shape_find(char const* name) {
+  for (size_t iter = 0; iter < BENCH_SHAPES_COUNT; ++iter) {
+    if (strcmp(bench_shapes[iter].name, name) == 0) {
+      return &bench_shapes[iter];
+    }
+  }
+  return NULL;
+}
+
+/* a polygon as WKT, closed by repeating the first point */
+static void shape_write_wkt(FILE* out, struct BENCH_POINT const* points,
+                            size_t count) {
+  fprintf(out, "POLYGON ((");
+  for (size_t iter = 0; iter <= count; ++iter) {
+    struct BENCH_POINT const* point = &points[iter % count];
+    fprintf(out, "%s%.17g %.17g", iter == 0 ? "" : ", ", (double)point->x,
+            (double)point->y);
+  }
+  fprintf(out, "))\n");
+}
+
+/* points as `x,y` lines, readable by geo_csv_read_points_<type> */
+static void shape_write_csv(FILE* out, struct BENCH_POINT const* points,
+                            size_t count) {
+  for (size_t iter = 0; iter < count; ++iter) {
+    fprintf(out, "%.17g,%.17g\n", (double)points[iter].x,
+            (double)points[iter].y);
+  }
+}
+
+/*
+ * `generate <shape> <count> [seed]` writes one shape to stdout, polygons as
+ * WKT and point clouds as CSV.
+ */
+static int shape_generate_main(int argc, char** argv) {
+  struct BenchShape const* shape = NULL;
+  struct BENCH_POINT* points = NULL;
+  size_t count = 0;
+  uint64_t seed = 1;
+  if (argc < 4 || (shape = shape_find(argv[2])) == NULL) {
+    fprintf(stderr, "usage: %s generate <shape> <count> [seed]\nshapes:",
+            argv[0]);
+    for (size_t iter = 0; iter < BENCH_SHAPES_COUNT; ++iter) {
+      fprintf(stderr, " %s", bench_shapes[iter].name);
+    }
+    fprintf(stderr, "\n");
+    return 1;
+  }
+  count = (size_t)strtoull(argv[3], NULL, 10);
+  if (argc > 4) {
+    seed = (uint64_t)strtoull(argv[4], NULL, 10);
+  }
+  if (count < BENCH_SHAPE_MIN_SIZE) {
+    fprintf(stderr, "%s: count must be at least %d\n", argv[0],
+            BENCH_SHAPE_MIN_SIZE);
+    return 1;
+  }
+  points = bench_alloc(count * sizeof(struct BENCH_POINT));
+  shape->generate(points, count, seed);
+  if (shape->is_polygon) {
+    shape_write_wkt(stdout, points, count);
+  } else {
+    shape_write_csv(stdout, points, count);
+  }
+  free(points);
+  return 0;
+}
@@ -0,0 +1,1238 @@
+#ifndef GEO_COMMON_H
+#define GEO_COMMON_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*****************************************************************************
+ * GEO_COMMON DEFINITIONS
+ *
+ * everything that does not depend on GEO_TMPL_TYPE. `geometry.h` includes
+ * this header so it is shared by every type instantiation.
+ *****************************************************************************/
+
+/*
+ * the default allocator. define all three before including the headers to
+ * replace malloc, realloc and free everywhere.
+ */
+#ifndef GEO_MALLOC
+#include <stdlib.h>
+#define GEO_MALLOC(size) malloc(size)
+#define GEO_REALLOC(memory, size) realloc(memory, size)
+#define GEO_FREE(memory) free(memory)
+#endif
+
+enum GeoResult {
+  GEO_SUCCESS = 0,
+  GEO_ERR_NULL_POINTER = 1,
+  GEO_ERR_TOO_SMALL = 2,
+  GEO_ERR_OVERFLOW = 3,
+  GEO_ERR_OUT_OF_RANGE = 4,
+  GEO_ERR_FULL = 5,
+  GEO_ERR_IO = 6,
+  GEO_ERR_INVALID_FORMAT = 7,
+  GEO_ERR_NO_MEMORY = 8,
+  GEO_ERR_UNSUPPORTED = 9
+};
+
+enum GeoOrientation { RIGHT = -1, COLINEAR = 0, LEFT = 1 };
+
+/*
+ * instruction set levels the batch kernels are built for, the x86-64
+ * microarchitecture levels 1 to 4.
+ */
+enum GeoSimdLevel {
+  GEO_SIMD_GENERIC = 0,
+  GEO_SIMD_SSE4_2 = 1,
+  GEO_SIMD_AVX2 = 2,
+  GEO_SIMD_AVX512 = 3
+};
+
+/*
+ * the batch kernels get a version per level, and one is picked at load time,
+ * with gcc or clang on x86. define GEO_NO_SIMD_DISPATCH to build the generic
+ * version only.
+ */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && \
+    !defined(GEO_NO_SIMD_DISPATCH)
+#define GEO_SIMD_DISPATCH
+#define GEO_SIMD_TARGET(isa) __attribute__((target(isa)))
+#define GEO_SIMD_INLINE __attribute__((always_inline)) inline
+#else
+#define GEO_SIMD_INLINE inline
+#endif
+
+/*
+ * read only view of a whole file. `data` is page aligned when it comes from
+ * geo_file_map.
+ */
+struct GeoFileMap {
+  void const* data;
+  size_t size;
+};
+
+/* one match of a spatial join, both are positions in the join's inputs */
+struct GeoJoinPair {
+  size_t point;
+  size_t geometry;
+};
+
+/*
+ * header of a serialized spatial index (see geo_index_build_<type>). every
+ * section is addressed by its byte offset from the start of the header so the
+ * file can be used straight from a read only mapping at any address. numbers
+ * are stored in the byte order of the host that built the file.
+ *
+ * version 2 stores every ring closed, its first point repeated at the end, so
+ * rings can be used as ring views, and adds the compressed flag.
+ */
+#ifndef GEO_INDEX_VERSION
+#define GEO_INDEX_VERSION 2
+#endif
+/* the points section is delta + varint encoded, see geo_index_compress_<type> */
+#ifndef GEO_INDEX_FLAG_COMPRESSED
+#define GEO_INDEX_FLAG_COMPRESSED 1U
+#endif
+#ifndef GEO_INDEX_BYTE_ORDER
+#define GEO_INDEX_BYTE_ORDER 0x01020304U
+#endif
+#ifndef GEO_INDEX_ALIGNMENT
+#define GEO_INDEX_ALIGNMENT 16
+#endif
+
+struct GeoIndexHeader {
+  char magic[8];  // "GEOINDEX"
+  uint32_t version;
+  uint32_t byte_order;
+  uint32_t coordinate_size;  // sizeof(GEO_TMPL_TYPE)
+  uint32_t coordinate_kind;  // 0 integer, 1 floating point
+  uint32_t node_size;        // max children per node
+  uint32_t flags;
+  uint64_t nodes_count;
+  uint64_t leaf_nodes_start;  // nodes from here on point at entries
+  uint64_t entries_count;
+  uint64_t points_count;
+  uint64_t nodes_offset;
+  uint64_t entries_offset;
+  uint64_t points_offset;
+  uint64_t size;
+};
+
+/* shape kinds produced by the text readers, the values match WKB */
+enum GeoShapeType {
+  GEO_SHAPE_POINT = 1,
+  GEO_SHAPE_LINE_STRING = 2,
+  GEO_SHAPE_POLYGON = 3,
+  GEO_SHAPE_MULTI_POLYGON = 6
+};
+
+/*
+ * bump allocator over a caller owned buffer. allocations are never freed one
+ * by one, geo_arena_reset drops all of them at once.
+ */
+struct GeoArena {
+  unsigned char* data;
+  size_t capacity;
+  size_t used;
+};
+
+/*
+ * an ESRI Shapefile opened by geo_shp_open_double, pointers into the caller's
+ * mappings of the .shp file and its .shx record index.
+ */
+struct GeoShpFile {
+  unsigned char const* shp;
+  size_t shp_size;
+  unsigned char const* shx;
+  size_t shx_size;
+  uint32_t shape_type;
+  size_t records_count;
+};
+
+/*
+ * a FlatGeobuf file opened by geo_fgb_open_double, `data` is the caller's
+ * mapping. the packed R-tree has `nodes_count` nodes of 40 bytes from
+ * `index_offset` on, features follow from `features_offset`.
+ */
+struct GeoFgbFile {
+  unsigned char const* data;
+  size_t size;
+  uint8_t geometry_type;  // enum GeoShapeType, 0 when mixed
+  uint64_t features_count;
+  uint16_t index_node_size;  // 0 when the file has no index
+  size_t nodes_count;
+  size_t index_offset;
+  size_t features_offset;
+};
+
+/*
+ * memory for the functions that allocate temporary buffers. every call gets
+ * `context` back, `release` also gets the size that was allocated. memory
+ * has to be aligned like malloc's. functions taking a NULL allocator use
+ * GEO_MALLOC and GEO_FREE.
+ */
+struct GeoAllocator {
+  void* (*allocate)(void* context, size_t size);
+  void (*release)(void* context, void* memory, size_t size);
+  void* context;
+};
+
+/*
+ * where the parallel functions run their work. `submit` hands `job` to
+ * another thread, which calls it once with `argument`, and returns false
+ * when it can't. the calling thread always works too and never waits for a
+ * job that has not started, so a busy or refusing executor only means less
+ * help. `concurrency` caps the threads working on one call, the caller
+ * included, 0 and 1 keep it on the caller. functions taking a NULL executor
+ * run on the calling thread only.
+ */
+struct GeoExecutor {
+  bool (*submit)(void* context, void (*job)(void* argument), void* argument);
+  void* context;
+  size_t concurrency;
+};
+
+#ifndef GEO_MAX_THREADS
+#define GEO_MAX_THREADS 64
+#endif
+
+#ifndef GEO_POOL_QUEUE_SIZE
+#define GEO_POOL_QUEUE_SIZE 256
+#endif
+
+#ifndef GEO_EXECUTOR_BATCHES
+#define GEO_EXECUTOR_BATCHES 64
+#endif
+
+/*
+ * the built in executor, `threads_count` threads started by geo_pool_init
+ * taking jobs from one queue, at most GEO_MAX_THREADS of them. submitting to
+ * a full queue fails. not available with GEO_NO_THREADS.
+ */
+struct GeoPool {
+  void* state;
+};
+
+enum GeoResult geo_file_map(char const* path, struct GeoFileMap* map);
+enum GeoResult geo_file_unmap(struct GeoFileMap* map);
+enum GeoResult geo_file_write(char const* path, void const* data, size_t size);
+
+enum GeoResult geo_arena_init(struct GeoArena* arena, void* buffer,
+                              size_t capacity);
+enum GeoResult geo_arena_alloc(struct GeoArena* arena, size_t size,
+                               size_t alignment, void** memory);
+enum GeoResult geo_arena_reset(struct GeoArena* arena);
+
+enum GeoResult geo_pool_init(struct GeoPool* pool, size_t threads_count);
+enum GeoResult geo_pool_destroy(struct GeoPool* pool);
+enum GeoResult geo_pool_executor(struct GeoPool* pool,
+                                 struct GeoExecutor* executor);
+enum GeoResult geo_executor_run(struct GeoExecutor const* executor,
+                                void (*task)(void* context, size_t index),
+                                void* context, size_t count);
+
+enum GeoResult geo_parse_double(char const* text, size_t length,
+                                double* value);
+enum GeoResult geo_parse_int64(char const* text, size_t length,
+                               int64_t* value);
+
+enum GeoResult geo_simd_level(enum GeoSimdLevel* level);
+
+/*
+ * hot path counters, only compiled in when GEO_STATS is defined for every
+ * source file of the library. each thread counts its own calls, work the
+ * parallel functions hand to executor threads is counted on those threads.
+ * the equal_* counters are the exits of the floating point comparison and
+ * add up to its calls.
+ */
+
+#ifdef GEO_STATS
+#ifndef GEO_THREAD_LOCAL
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#define GEO_THREAD_LOCAL _Thread_local
+#elif defined(_MSC_VER)
+#define GEO_THREAD_LOCAL __declspec(thread)
+#else
+#define GEO_THREAD_LOCAL __thread
+#endif
+#endif
+
+struct GeoStats {
+  uint64_t orientation_calls;
+  uint64_t orientation_colinear;
+  uint64_t equal_nan;
+  uint64_t equal_exact;
+  uint64_t equal_infinite;
+  uint64_t equal_absolute;
+  uint64_t equal_relative;
+  uint64_t equal_sign;
+  uint64_t equal_ulps;  // fell through to the ULP distance
+  uint64_t segments_intersect_calls;
+  uint64_t point_in_polygon_calls;
+  uint64_t point_in_polygon_edges;
+  uint64_t is_simple_calls;
+  uint64_t is_simple_pairs;
+  uint64_t convex_hull_calls;
+  uint64_t convex_hull_comparisons;
+};
+
+extern GEO_THREAD_LOCAL struct GeoStats geo_stats;
+
+#define GEO_STATS_ADD(counter, count) (geo_stats.counter += (uint64_t)(count))
+
+enum GeoResult geo_stats_snapshot(struct GeoStats* stats);
+enum GeoResult geo_stats_reset(void);
+#else
+#define GEO_STATS_ADD(counter, count) ((void)0)
+#endif
+
+/*
+ * per call tracing, only compiled in when GEO_TRACE is defined for every
+ * source file of the library. the traced functions call `trace` once they
+ * return with the function, the size of their input and the cycles they took.
+ * calls the library makes to itself are not traced.
+ */
+#ifdef GEO_TRACE
+enum GeoTraceFunction {
+  GEO_TRACE_SEGMENTS_INTERSECT,
+  GEO_TRACE_GEOMETRY_IS_SIMPLE,
+  GEO_TRACE_POINT_IN_GEOMETRY,
+  GEO_TRACE_GEOMETRY_IN_GEOMETRY,
+  GEO_TRACE_CONVEX_HULL,
+  GEO_TRACE_CONVEX_HULL_SOA,
+  GEO_TRACE_POINTS_IN_GEOMETRY_SOA,
+  GEO_TRACE_INDEX_BUILD,
+  GEO_TRACE_INDEX_QUERY_POINT,
+  GEO_TRACE_SPATIAL_JOIN,
+  GEO_TRACE_SPATIAL_JOIN_COUNT,
+  GEO_TRACE_RING_VIEW_IS_SIMPLE,
+  GEO_TRACE_POINT_IN_RING_VIEW,
+  GEO_TRACE_POINT_IN_POLYGON_VIEW,
+  GEO_TRACE_FUNCTIONS_COUNT
+};
+
+struct GeoTracer {
+  void (*trace)(void* context, enum GeoTraceFunction function, size_t size,
+                uint64_t cycles);
+  void* context;
+};
+
+enum GeoResult geo_trace_set(struct GeoTracer const* tracer);
+char const* geo_trace_function_name(enum GeoTraceFunction function);
+uint64_t geo_trace_begin(void);
+void geo_trace_end(enum GeoTraceFunction function, size_t size,
+                   uint64_t start);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // GEO_COMMON_H
+
+/*****************************************************************************
+ * GEO_COMMON IMPLEMENTATION
+ *
+ * define GEO_COMMON_IMPL in exactly 1 source file before including this
+ * header. `src/geo_common.c` does this.
+ *****************************************************************************/
+
+#if defined(GEO_COMMON_IMPL) && !defined(GEO_COMMON_IMPL_INCLUDED)
+#define GEO_COMMON_IMPL_INCLUDED
+
+#include <fcntl.h>
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#ifndef GEO_NO_THREADS
+#include <pthread.h>
+#endif
+
+enum GeoResult geo_file_map(char const* path, struct GeoFileMap* map) {
+  struct stat info;
+  void* data = NULL;
+  int descriptor = -1;
+#ifndef GEO_UNSAFE
+  if (path == NULL || map == NULL) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+  descriptor = open(path, O_RDONLY);
+  if (descriptor < 0) {
+    return GEO_ERR_IO;
+  }
+  if (fstat(descriptor, &info) != 0 || info.st_size <= 0) {
+    close(descriptor);
+    return GEO_ERR_IO;
+  }
+  data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, descriptor, 0);
+  /* the mapping keeps its own reference to the file */
+  close(descriptor);
+  if (data == MAP_FAILED) {
+    return GEO_ERR_IO;
+  }
+  map->data = data;
+  map->size = (size_t)info.st_size;
+  return GEO_SUCCESS;
+}
+
+enum GeoResult geo_file_unmap(struct GeoFileMap* map) {
+#ifndef GEO_UNSAFE
+  if (map == NULL || map->data == NULL) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+  if (munmap((void*)(uintptr_t)map->data, map->size) != 0) {
+    return GEO_ERR_IO;
+  }
+  map->data = NULL;
+  map->size = 0;
+  return GEO_SUCCESS;
+}
+
+enum GeoResult geo_file_write(char const* path, void const* data,
+                              size_t size) {
+  FILE* file = NULL;
+  size_t written = 0;
+#ifndef GEO_UNSAFE
+  if (path == NULL || (data == NULL && size > 0)) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+  file = fopen(path, "wb");
+  if (file == NULL) {
+    return GEO_ERR_IO;
+  }
+  written = fwrite(data, 1, size, file);
+  if (fclose(file) != 0 || written != size) {
+    return GEO_ERR_IO;
+  }
+  return GEO_SUCCESS;
+}
+
+enum GeoResult geo_arena_init(struct GeoArena* arena, void* buffer,
+                              size_t capacity) {
+#ifndef GEO_UNSAFE
+  if (arena == NULL || (buffer == NULL && capacity > 0)) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+  arena->data = (unsigned char*)buffer;
+  arena->capacity = capacity;
+  arena->used = 0;
+  return GEO_SUCCESS;
+}
+
+/* `alignment` must be a power of 2 */
+enum GeoResult geo_arena_alloc(struct GeoArena* arena, size_t size,
+                               size_t alignment, void** memory) {
+  size_t padding = 0;
+#ifndef GEO_UNSAFE
+  if (arena == NULL || memory == NULL) {
+    return GEO_ERR_NULL_POINTER;
+  }
+  if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+    return GEO_ERR_OUT_OF_RANGE;
+  }
+#endif
+  padding = (alignment - ((uintptr_t)(arena->data + arena->used) &
+                          (alignment - 1))) &
+            (alignment - 1);
+  if (padding > arena->capacity - arena->used ||
+      size > arena->capacity - arena->used - padding) {
+    return GEO_ERR_FULL;
+  }
+  *memory = arena->data + arena->used + padding;
+  arena->used += padding + size;
+  return GEO_SUCCESS;
+}
+
+enum GeoResult geo_arena_reset(struct GeoArena* arena) {
+#ifndef GEO_UNSAFE
+  if (arena == NULL) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+  arena->used = 0;
+  return GEO_SUCCESS;
+}
+
+/*
+ * decimal number parsing.
+ *
+ * the digits are gathered into a 64 bit integer and a power of ten. when the
+ * integer fits the 53 bit mantissa and the power is at most 22 both are exact
+ * doubles, so one multiplication or division gives the correctly rounded
+ * result (Clinger's fast path). that covers the coordinates found in practice,
+ * anything longer takes the exact big integer path below, which unlike strtod
+ * does not depend on the locale.
+ */
+static double const geo_parse_powers[23] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+/*
+ * the slow path keeps GEO_PARSE_DIGITS significant digits and appends a 1
+ * when it dropped any nonzero ones. the halfway points between doubles have
+ * at most 767 significant digits, so that never changes the rounding. the
+ * value is then digits * 10^exponent, and the numerator and denominator of
+ * that fraction fit GEO_PARSE_WORDS 32 bit words once scaled.
+ */
+#define GEO_PARSE_DIGITS 800
+#define GEO_PARSE_WORDS 160
+
+struct GeoParseBig {
+  uint32_t words[GEO_PARSE_WORDS];  // least significant first
+  size_t count;
+};
+
+static void parse_big_multiply(struct GeoParseBig* big, uint32_t factor,
+                               uint32_t addend) {
+  uint64_t carry = addend;
+  for (size_t iter = 0; iter < big->count; ++iter) {
+    carry += (uint64_t)big->words[iter] * factor;
+    big->words[iter] = (uint32_t)carry;
+    carry >>= 32;
+  }
+  if (carry != 0) {
+    big->words[big->count++] = (uint32_t)carry;
+  }
+}
+
+static void parse_big_power(struct GeoParseBig* big, size_t power) {
+  for (; power >= 9; power -= 9) {
+    parse_big_multiply(big, 1000000000U, 0);
+  }
+  parse_big_multiply(big, (uint32_t)geo_parse_powers[power], 0);
+}
+
+static size_t parse_big_bits(struct GeoParseBig const* big) {
+  size_t bits = 0;
+  uint32_t top = 0;
+  if (big->count == 0) {
+    return 0;
+  }
+  top = big->words[big->count - 1];
+  for (; top != 0; top >>= 1) {
+    ++bits;
+  }
+  return ((big->count - 1) * 32) + bits;
+}
+
+static void parse_big_shift_left(struct GeoParseBig* big, size_t bits) {
+  size_t const words = bits / 32;
+  unsigned const shift = (unsigned)(bits % 32);
+  if (big->count == 0) {
+    return;
+  }
+  big->words[big->count + words] = 0;
+  for (size_t iter = big->count; iter-- > 0;) {
+    uint64_t const moved = (uint64_t)big->words[iter] << shift;
+    big->words[iter + words + 1] |= (uint32_t)(moved >> 32);
+    big->words[iter + words] = (uint32_t)moved;
+  }
+  memset(big->words, 0, words * sizeof(uint32_t));
+  big->count += words + 1;
+  while (big->count > 0 && big->words[big->count - 1] == 0) {
+    --big->count;
+  }
+}
+
+static void parse_big_shift_right_1(struct GeoParseBig* big) {
+  for (size_t iter = 0; iter < big->count; ++iter) {
+    big->words[iter] >>= 1;
+    if (iter + 1 < big->count) {
+      big->words[iter] |= big->words[iter + 1] << 31;
+    }
+  }
+  while (big->count > 0 && big->words[big->count - 1] == 0) {
+    --big->count;
+  }
+}
+
+static int parse_big_compare(struct GeoParseBig const* lhs,
+                             struct GeoParseBig const* rhs) {
+  if (lhs->count != rhs->count) {
+    return lhs->count < rhs->count ? -1 : 1;
+  }
+  for (size_t iter = lhs->count; iter-- > 0;) {
+    if (lhs->words[iter] != rhs->words[iter]) {
+      return lhs->words[iter] < rhs->words[iter] ? -1 : 1;
+    }
+  }
+  return 0;
+}
+
+/* `lhs` -= `rhs`, which is not larger */
+static void parse_big_subtract(struct GeoParseBig* lhs,
+                               struct GeoParseBig const* rhs) {
+  int64_t borrow = 0;
+  for (size_t iter = 0; iter < lhs->count; ++iter) {
+    int64_t difference = (int64_t)lhs->words[iter] - borrow -
+                         (iter < rhs->count ? (int64_t)rhs->words[iter] : 0);
+    borrow = difference < 0;
+    lhs->words[iter] = (uint32_t)(difference + (borrow << 32));
+  }
+  while (lhs->count > 0 && lhs->words[lhs->count - 1] == 0) {
+    --lhs->count;
+  }
+}
+
+/*
+ * the correctly rounded value of the digits of `text`, which has been checked
+ * to be a number with at least one nonzero digit. the fraction is scaled by
+ * 2^shift so its quotient has exactly 64 bits, which are rounded half to even
+ * at bit 53, or higher for subnormal results.
+ */
+static enum GeoResult parse_double_slow(char const* text, size_t length,
+                                        double* value) {
+  struct GeoParseBig numerator;
+  struct GeoParseBig denominator;
+  struct GeoParseBig scaled;
+  char digits[GEO_PARSE_DIGITS + 1];
+  size_t count = 0;
+  int64_t exponent = 0;
+  int64_t written_exponent = 0;
+  int64_t shift = 0;
+  int64_t binary_exponent = 0;
+  int64_t kept = 0;
+  uint64_t quotient = 0;
+  uint64_t mantissa = 0;
+  bool dropped = false;
+  bool fraction = false;
+  bool negative = false;
+  size_t iter = 0;
+  if (text[iter] == '-' || text[iter] == '+') {
+    negative = text[iter] == '-';
+    ++iter;
+  }
+  for (; iter < length && text[iter] != 'e' && text[iter] != 'E'; ++iter) {
+    if (text[iter] == '.') {
+      fraction = true;
+    } else if (count == 0 && text[iter] == '0') {
+      exponent -= fraction;
+    } else if (count < GEO_PARSE_DIGITS) {
+      digits[count++] = text[iter];
+      exponent -= fraction;
+    } else {
+      dropped = dropped || text[iter] != '0';
+      exponent += !fraction;
+    }
+  }
+  if (dropped) {
+    digits[count++] = '1';
+    --exponent;
+  }
+  if (iter < length) {
+    bool negative_exponent = false;
+    ++iter;
+    if (text[iter] == '-' || text[iter] == '+') {
+      negative_exponent = text[iter] == '-';
+      ++iter;
+    }
+    for (; iter < length; ++iter) {
+      if (written_exponent < 100000) {
+        written_exponent = (written_exponent * 10) + (text[iter] - '0');
+      }
+    }
+    exponent += negative_exponent ? -written_exponent : written_exponent;
+  }
+  /* at least 1e309, or below 1e-324 which is under half the least double */
+  if ((int64_t)count + exponent > 309) {
+    return GEO_ERR_OUT_OF_RANGE;
+  }
+  if ((int64_t)count + exponent < -324) {
+    *value = negative ? -0.0 : 0.0;
+    return GEO_SUCCESS;
+  }
+
+  numerator.count = 0;
+  denominator.count = 1;
+  denominator.words[0] = 1;
+  for (size_t digit = 0; digit < count; ++digit) {
+    parse_big_multiply(&numerator, 10, (uint32_t)(digits[digit] - '0'));
+  }
+  if (exponent >= 0) {
+    parse_big_power(&numerator, (size_t)exponent);
+  } else {
+    parse_big_power(&denominator, (size_t)-exponent);
+  }
+  shift = 63 + (int64_t)parse_big_bits(&denominator) -
+          (int64_t)parse_big_bits(&numerator);
+  if (shift >= 0) {
+    parse_big_shift_left(&numerator, (size_t)shift);
+  } else {
+    parse_big_shift_left(&denominator, (size_t)-shift);
+  }
+  scaled = denominator;
+  parse_big_shift_left(&scaled, 63);
+  if (parse_big_compare(&numerator, &scaled) < 0) {
+    parse_big_shift_left(&numerator, 1);
+    ++shift;
+  }
+  for (int bit = 63; bit >= 0; --bit) {
+    if (parse_big_compare(&numerator, &scaled) >= 0) {
+      parse_big_subtract(&numerator, &scaled);
+      quotient |= 1ULL << bit;
+    }
+    parse_big_shift_right_1(&scaled);
+  }
+
+  /* the value is quotient * 2^-shift with the top bit at 2^(63 - shift) */
+  binary_exponent = 63 - shift;
+  kept = binary_exponent >= -1022 ? 53 : 53 - (-1022 - binary_exponent);
+  if (kept < 0) {
+    *value = negative ? -0.0 : 0.0;
+    return GEO_SUCCESS;
+  }
+  if (kept == 0) {
+    mantissa = quotient > (1ULL << 63) ||
+               (quotient == (1ULL << 63) && numerator.count > 0);
+  } else {
+    uint64_t const rest = quotient & ((1ULL << (64 - kept)) - 1);
+    uint64_t const half = 1ULL << (63 - kept);
+    mantissa = quotient >> (64 - kept);
+    if (rest > half ||
+        (rest == half && (numerator.count > 0 || (mantissa & 1) != 0))) {
+      ++mantissa;
+    }
+  }
+  *value = ldexp((double)mantissa, (int)(binary_exponent - kept + 1));
+  if (*value > DBL_MAX) {
+    return GEO_ERR_OUT_OF_RANGE;
+  }
+  *value = negative ? -*value : *value;
+  return GEO_SUCCESS;
+}
+
+enum GeoResult geo_parse_double(char const* text, size_t length,
+                                double* value) {
+  uint64_t mantissa = 0;
+  int64_t exponent = 0;
+  int64_t written_exponent = 0;
+  size_t digits = 0;
+  size_t iter = 0;
+  bool negative = false;
+  bool exact = true;
+  bool negative_exponent = false;
+#ifndef GEO_UNSAFE
+  if (text == NULL || value == NULL) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+  if (iter < length && (text[iter] == '-' || text[iter] == '+')) {
+    negative = text[iter] == '-';
+    ++iter;
+  }
+  for (; iter < length && text[iter] >= '0' && text[iter] <= '9'; ++iter) {
+    if (mantissa < 1000000000000000000ULL) {
+      mantissa = (mantissa * 10) + (uint64_t)(text[iter] - '0');
+    } else {
+      exact = exact && text[iter] == '0';
+      ++exponent;
+    }
+    ++digits;
+  }
+  if (iter < length && text[iter] == '.') {
+    for (++iter; iter < length && text[iter] >= '0' && text[iter] <= '9';
+         ++iter) {
+      if (mantissa < 1000000000000000000ULL) {
+        mantissa = (mantissa * 10) + (uint64_t)(text[iter] - '0');
+        --exponent;
+      } else {
+        exact = exact && text[iter] == '0';
+      }
+      ++digits;
+    }
+  }
+  if (digits == 0) {
+    return GEO_ERR_INVALID_FORMAT;
+  }
+  if (iter < length && (text[iter] == 'e' || text[iter] == 'E')) {
+    ++iter;
+    if (iter < length && (text[iter] == '-' || text[iter] == '+')) {
+      negative_exponent = text[iter] == '-';
+      ++iter;
+    }
+    if (iter == length) {
+      return GEO_ERR_INVALID_FORMAT;
+    }
+    for (; iter < length && text[iter] >= '0' && text[iter] <= '9'; ++iter) {
+      if (written_exponent < 100000) {
+        written_exponent = (written_exponent * 10) + (text[iter] - '0');
+      }
+    }
+    exponent += negative_exponent ? -written_exponent : written_exponent;
+  }
+  if (iter != length) {
+    return GEO_ERR_INVALID_FORMAT;
+  }
+
+  if (mantissa == 0 && exact) {
+    *value = negative ? -0.0 : 0.0;
+    return GEO_SUCCESS;
+  }
+  if (exact && mantissa <= (1ULL << 53) && exponent >= -22 && exponent <= 22) {
+    *value = (double)mantissa;
+    *value = exponent < 0 ? *value / geo_parse_powers[-exponent]
+                          : *value * geo_parse_powers[exponent];
+    *value = negative ? -*value : *value;
+    return GEO_SUCCESS;
+  }
+  return parse_double_slow(text, length, value);
+}
+
+enum GeoResult geo_parse_int64(char const* text, size_t length,
+                               int64_t* value) {
+  uint64_t magnitude = 0;
+  uint64_t limit = (uint64_t)INT64_MAX;
+  size_t iter = 0;
+  bool negative = false;
+#ifndef GEO_UNSAFE
+  if (text == NULL || value == NULL) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+  if (iter < length && (text[iter] == '-' || text[iter] == '+')) {
+    negative = text[iter] == '-';
+    limit += negative;
+    ++iter;
+  }
+  if (iter == length) {
+    return GEO_ERR_INVALID_FORMAT;
+  }
+  for (; iter < length; ++iter) {
+    if (text[iter] < '0' || text[iter] > '9') {
+      return GEO_ERR_INVALID_FORMAT;
+    }
+    if (magnitude > (limit - (uint64_t)(text[iter] - '0')) / 10) {
+      return GEO_ERR_OUT_OF_RANGE;
+    }
+    magnitude = (magnitude * 10) + (uint64_t)(text[iter] - '0');
+  }
+  /* two's complement, -2^63 has no positive counterpart */
+  *value = negative ? (int64_t)(0 - magnitude) : (int64_t)magnitude;
+  return GEO_SUCCESS;
+}
+
+/*
+ * executors. a call of geo_executor_run is a batch whose tasks are claimed
+ * one at a time from `next`, by the caller and by every job that started
+ * before the caller ran out of tasks, so the threads that show up share the
+ * work whatever the task sizes. a job may start after the call returned, it
+ * then finds the batch closed and only drops its reference. so the batches
+ * are slots of a static table, taken per call and given back by the last
+ * reference, and no call allocates. `executor_mutex` guards `running` and
+ * `closed` of every batch.
+ */
+#ifndef GEO_NO_THREADS
+struct GeoExecutorBatch {
+  void (*task)(void* context, size_t index);
+  void* context;
+  size_t count;
+  size_t next;
+  size_t references;
+  size_t running;  // jobs working on the batch
+  bool closed;
+  bool used;  // taken by a call or by jobs still holding references
+};
+
+static struct GeoExecutorBatch executor_batches[GEO_EXECUTOR_BATCHES];
+static pthread_mutex_t executor_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t executor_idle = PTHREAD_COND_INITIALIZER;
+
+static struct GeoExecutorBatch* executor_acquire(void) {
+  for (size_t iter = 0; iter < GEO_EXECUTOR_BATCHES; ++iter) {
+    struct GeoExecutorBatch* batch = &executor_batches[iter];
+    if (!__atomic_load_n(&batch->used, __ATOMIC_RELAXED) &&
+        !__atomic_exchange_n(&batch->used, true, __ATOMIC_ACQUIRE)) {
+      return batch;
+    }
+  }
+  return NULL;
+}
+
+static void executor_work(struct GeoExecutorBatch* batch) {
+  for (;;) {
+    size_t index = __atomic_fetch_add(&batch->next, 1, __ATOMIC_RELAXED);
+    if (index >= batch->count) {
+      return;
+    }
+    batch->task(batch->context, index);
+  }
+}
+
+static void executor_release(struct GeoExecutorBatch* batch) {
+  if (__atomic_sub_fetch(&batch->references, 1, __ATOMIC_ACQ_REL) != 0) {
+    return;
+  }
+  __atomic_store_n(&batch->used, false, __ATOMIC_RELEASE);
+}
+
+static void executor_job(void* argument) {
+  struct GeoExecutorBatch* batch = (struct GeoExecutorBatch*)argument;
+  pthread_mutex_lock(&executor_mutex);
+  if (batch->closed) {
+    pthread_mutex_unlock(&executor_mutex);
+    executor_release(batch);
+    return;
+  }
+  ++batch->running;
+  pthread_mutex_unlock(&executor_mutex);
+  executor_work(batch);
+  pthread_mutex_lock(&executor_mutex);
+  if (--batch->running == 0) {
+    pthread_cond_broadcast(&executor_idle);
+  }
+  pthread_mutex_unlock(&executor_mutex);
+  executor_release(batch);
+}
+#endif
+
+/*
+ * runs `task` for every index below `count` and returns once all of them
+ * returned. without an executor, threads or a free batch the calling thread
+ * runs them in order.
+ */
+enum GeoResult geo_executor_run(struct GeoExecutor const* executor,
+                                void (*task)(void* context, size_t index),
+                                void* context, size_t count) {
+#ifndef GEO_NO_THREADS
+  struct GeoExecutorBatch* batch = NULL;
+  size_t helpers = 0;
+#endif
+#ifndef GEO_UNSAFE
+  if (task == NULL || (executor != NULL && executor->submit == NULL)) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+#ifndef GEO_NO_THREADS
+  if (executor != NULL && executor->concurrency > 1 && count > 1) {
+    helpers = executor->concurrency - 1 < count - 1
+                  ? executor->concurrency - 1
+                  : count - 1;
+    batch = executor_acquire();
+  }
+  if (batch != NULL) {
+    batch->task = task;
+    batch->context = context;
+    batch->count = count;
+    batch->next = 0;
+    batch->references = helpers + 1;
+    batch->running = 0;
+    batch->closed = false;
+    for (size_t iter = 0; iter < helpers; ++iter) {
+      if (!executor->submit(executor->context, executor_job, batch)) {
+        executor_release(batch);
+      }
+    }
+    executor_work(batch);
+    pthread_mutex_lock(&executor_mutex);
+    batch->closed = true;
+    while (batch->running > 0) {
+      pthread_cond_wait(&executor_idle, &executor_mutex);
+    }
+    pthread_mutex_unlock(&executor_mutex);
+    executor_release(batch);
+    return GEO_SUCCESS;
+  }
+#endif
+  for (size_t iter = 0; iter < count; ++iter) {
+    task(context, iter);
+  }
+  return GEO_SUCCESS;
+}
+
+#ifndef GEO_NO_THREADS
+struct GeoPoolJob {
+  void (*job)(void* argument);
+  void* argument;
+};
+
+struct GeoPoolState {
+  pthread_mutex_t mutex;
+  pthread_cond_t wake;
+  pthread_t threads[GEO_MAX_THREADS];
+  size_t threads_count;
+  struct GeoPoolJob queue[GEO_POOL_QUEUE_SIZE];
+  size_t head;  // next job to take
+  size_t size;
+  bool stopping;
+};
+
+/* runs jobs until the pool stops and its queue is empty */
+static void* pool_thread(void* argument) {
+  struct GeoPoolState* state = (struct GeoPoolState*)argument;
+  for (;;) {
+    struct GeoPoolJob job;
+    pthread_mutex_lock(&state->mutex);
+    while (state->size == 0 && !state->stopping) {
+      pthread_cond_wait(&state->wake, &state->mutex);
+    }
+    if (state->size == 0) {
+      pthread_mutex_unlock(&state->mutex);
+      return NULL;
+    }
+    job = state->queue[state->head];
+    state->head = (state->head + 1) % GEO_POOL_QUEUE_SIZE;
+    --state->size;
+    pthread_mutex_unlock(&state->mutex);
+    job.job(job.argument);
+  }
+}
+
+static bool pool_submit(void* context, void (*job)(void* argument),
+                        void* argument) {
+  struct GeoPoolState* state = (struct GeoPoolState*)context;
+  size_t tail = 0;
+  pthread_mutex_lock(&state->mutex);
+  if (state->size == GEO_POOL_QUEUE_SIZE || state->stopping) {
+    pthread_mutex_unlock(&state->mutex);
+    return false;
+  }
+  tail = (state->head + state->size) % GEO_POOL_QUEUE_SIZE;
+  state->queue[tail].job = job;
+  state->queue[tail].argument = argument;
+  ++state->size;
+  pthread_cond_signal(&state->wake);
+  pthread_mutex_unlock(&state->mutex);
+  return true;
+}
+#endif
+
+enum GeoResult geo_pool_init(struct GeoPool* pool, size_t threads_count) {
+#ifndef GEO_NO_THREADS
+  struct GeoPoolState* state = NULL;
+#endif
+#ifndef GEO_UNSAFE
+  if (pool == NULL) {
+    return GEO_ERR_NULL_POINTER;
+  }
+  if (threads_count == 0) {
+    return GEO_ERR_TOO_SMALL;
+  }
+#endif
+  pool->state = NULL;
+#ifndef GEO_NO_THREADS
+  if (threads_count > GEO_MAX_THREADS) {
+    threads_count = GEO_MAX_THREADS;
+  }
+  state = (struct GeoPoolState*)GEO_MALLOC(sizeof(*state));
+  if (state == NULL) {
+    return GEO_ERR_NO_MEMORY;
+  }
+  if (pthread_mutex_init(&state->mutex, NULL) != 0) {
+    GEO_FREE(state);
+    return GEO_ERR_NO_MEMORY;
+  }
+  if (pthread_cond_init(&state->wake, NULL) != 0) {
+    pthread_mutex_destroy(&state->mutex);
+    GEO_FREE(state);
+    return GEO_ERR_NO_MEMORY;
+  }
+  state->threads_count = 0;
+  state->head = 0;
+  state->size = 0;
+  state->stopping = false;
+  pool->state = state;
+  for (size_t iter = 0; iter < threads_count; ++iter) {
+    if (pthread_create(&state->threads[iter], NULL, pool_thread, state) != 0) {
+      geo_pool_destroy(pool);
+      return GEO_ERR_NO_MEMORY;
+    }
+    ++state->threads_count;
+  }
+  return GEO_SUCCESS;
+#else
+  (void)threads_count;
+  return GEO_ERR_UNSUPPORTED;
+#endif
+}
+
+/* runs the jobs still queued, then stops and joins the threads */
+enum GeoResult geo_pool_destroy(struct GeoPool* pool) {
+#ifndef GEO_NO_THREADS
+  struct GeoPoolState* state = NULL;
+#endif
+#ifndef GEO_UNSAFE
+  if (pool == NULL || pool->state == NULL) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+#ifndef GEO_NO_THREADS
+  state = (struct GeoPoolState*)pool->state;
+  pthread_mutex_lock(&state->mutex);
+  state->stopping = true;
+  pthread_cond_broadcast(&state->wake);
+  pthread_mutex_unlock(&state->mutex);
+  for (size_t iter = 0; iter < state->threads_count; ++iter) {
+    pthread_join(state->threads[iter], NULL);
+  }
+  pthread_cond_destroy(&state->wake);
+  pthread_mutex_destroy(&state->mutex);
+  GEO_FREE(state);
+#endif
+  pool->state = NULL;
+  return GEO_SUCCESS;
+}
+
+/*
+ * an executor over the pool, using every pool thread and the caller. lower
+ * its `concurrency` to cap a call.
+ */
+enum GeoResult geo_pool_executor(struct GeoPool* pool,
+                                 struct GeoExecutor* executor) {
+#ifndef GEO_UNSAFE
+  if (pool == NULL || pool->state == NULL || executor == NULL) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+#ifndef GEO_NO_THREADS
+  executor->submit = pool_submit;
+  executor->context = pool->state;
+  executor->concurrency =
+      ((struct GeoPoolState*)pool->state)->threads_count + 1;
+  return GEO_SUCCESS;
+#else
+  return GEO_ERR_UNSUPPORTED;
+#endif
+}
+
+/* the highest level the cpu and the build both support */
+enum GeoResult geo_simd_level(enum GeoSimdLevel* level) {
+#ifndef GEO_UNSAFE
+  if (level == NULL) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+  *level = GEO_SIMD_GENERIC;
+#ifdef GEO_SIMD_DISPATCH
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+      __builtin_cpu_supports("avx512dq") &&
+      __builtin_cpu_supports("avx512vl")) {
+    *level = GEO_SIMD_AVX512;
+  } else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    *level = GEO_SIMD_AVX2;
+  } else if (__builtin_cpu_supports("sse4.2") &&
+             __builtin_cpu_supports("popcnt")) {
+    *level = GEO_SIMD_SSE4_2;
+  }
+#endif
+  return GEO_SUCCESS;
+}
+
+#ifdef GEO_STATS
+GEO_THREAD_LOCAL struct GeoStats geo_stats;
+
+enum GeoResult geo_stats_snapshot(struct GeoStats* stats) {
+#ifndef GEO_UNSAFE
+  if (stats == NULL) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+  *stats = geo_stats;
+  return GEO_SUCCESS;
+}
+
+enum GeoResult geo_stats_reset(void) {
+  memset(&geo_stats, 0, sizeof(geo_stats));
+  return GEO_SUCCESS;
+}
+#endif
+
+#ifdef GEO_TRACE
+/*
+ * read by every traced call, so the fields are accessed atomically. `trace`
+ * is stored after `context` and loaded before it, a call that sees a tracer
+ * also sees its context. swapping one tracer for another while traced calls
+ * run may still pair the old function with the new context, so set it before
+ * other threads call the library.
+ */
+static struct GeoTracer geo_tracer;
+
+enum GeoResult geo_trace_set(struct GeoTracer const* tracer) {
+  if (tracer == NULL) {
+    __atomic_store_n(&geo_tracer.trace, NULL, __ATOMIC_RELEASE);
+    __atomic_store_n(&geo_tracer.context, NULL, __ATOMIC_RELAXED);
+    return GEO_SUCCESS;
+  }
+#ifndef GEO_UNSAFE
+  if (tracer->trace == NULL) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+  __atomic_store_n(&geo_tracer.context, tracer->context, __ATOMIC_RELAXED);
+  __atomic_store_n(&geo_tracer.trace, tracer->trace, __ATOMIC_RELEASE);
+  return GEO_SUCCESS;
+}
+
+char const* geo_trace_function_name(enum GeoTraceFunction function) {
+  static char const* const names[GEO_TRACE_FUNCTIONS_COUNT] = {
+      "geo_segments_intersect",     "geo_geometry_is_simple",
+      "geo_point_in_geometry",      "geo_geometry_in_geometry",
+      "geo_convex_hull",            "geo_convex_hull_soa",
+      "geo_points_in_geometry_soa", "geo_index_build",
+      "geo_index_query_point",      "geo_spatial_join",
+      "geo_spatial_join_count",     "geo_ring_view_is_simple",
+      "geo_point_in_ring_view",     "geo_point_in_polygon_view"};
+  if ((size_t)function >= GEO_TRACE_FUNCTIONS_COUNT) {
+    return NULL;
+  }
+  return names[function];
+}
+
+/* the time stamp counter, the virtual counter on arm64, clock() elsewhere */
+static uint64_t trace_cycles(void) {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  uint32_t low = 0;
+  uint32_t high = 0;
+  __asm__ __volatile__("lfence\n\trdtsc" : "=a"(low), "=d"(high)::"memory");
+  return ((uint64_t)high << 32) | low;
+#elif defined(__GNUC__) && defined(__aarch64__)
+  uint64_t counter = 0;
+  __asm__ __volatile__("isb\n\tmrs %0, cntvct_el0" : "=r"(counter)::"memory");
+  return counter;
+#else
+  clock_t const now = clock();
+  return (uint64_t)now;
+#endif
+}
+
+/* 0 without a tracer so untraced runs skip reading the counter */
+uint64_t geo_trace_begin(void) {
+  return __atomic_load_n(&geo_tracer.trace, __ATOMIC_RELAXED) == NULL
+             ? 0
+             : trace_cycles();
+}
+
+void geo_trace_end(enum GeoTraceFunction function, size_t size,
+                   uint64_t start) {
+  uint64_t end = 0;
+  void (*trace)(void* context, enum GeoTraceFunction function, size_t size,
+                uint64_t cycles) = NULL;
+  if (start == 0) {
+    return;
+  }
+  trace = __atomic_load_n(&geo_tracer.trace, __ATOMIC_ACQUIRE);
+  if (trace == NULL) {
+    return;
+  }
+  end = trace_cycles();
+  trace(__atomic_load_n(&geo_tracer.context, __ATOMIC_RELAXED), function, size,
+        end - start);
+}
+#endif
+
+#endif
@@ -12,6 +12,8 @@ extern "C" {
 #include <stdlib.h>
 #include <string.h>
 
+#include "geo_common.h"
+
 /*
  * macros to expand struct names and function names with a GEO_TMPL_TYPE suffix
  */
@@ -21,6 +23,19 @@ extern "C" {
 #define TMPL_POINT TMPL_CONCAT(GeoPoint, GEO_TMPL_TYPE)
 #define TMPL_SEGMENT TMPL_CONCAT(GeoSegment, GEO_TMPL_TYPE)
 #define TMPL_GEOMETRY TMPL_CONCAT(GeoGeometry, GEO_TMPL_TYPE)
+#define TMPL_ENVELOPE TMPL_CONCAT(GeoEnvelope, GEO_TMPL_TYPE)
+#define TMPL_RING_VIEW TMPL_CONCAT(GeoRingView, GEO_TMPL_TYPE)
+#define TMPL_POLYGON_VIEW TMPL_CONCAT(GeoPolygonView, GEO_TMPL_TYPE)
+#define TMPL_SHAPE TMPL_CONCAT(GeoShape, GEO_TMPL_TYPE)
+#define TMPL_SHAPE_BUILDER TMPL_CONCAT(GeoShapeBuilder, GEO_TMPL_TYPE)
+#define TMPL_WKT_PARSER TMPL_CONCAT(GeoWktParser, GEO_TMPL_TYPE)
+#define TMPL_JSON_PARSER TMPL_CONCAT(GeoJsonParser, GEO_TMPL_TYPE)
+#define TMPL_GRID TMPL_CONCAT(GeoGrid, GEO_TMPL_TYPE)
+#define TMPL_INDEX TMPL_CONCAT(GeoIndex, GEO_TMPL_TYPE)
+#define TMPL_INDEX_NODE TMPL_CONCAT(GeoIndexNode, GEO_TMPL_TYPE)
+#define TMPL_INDEX_ENTRY TMPL_CONCAT(GeoIndexEntry, GEO_TMPL_TYPE)
+#define TMPL_GRID_SLOT TMPL_CONCAT(GeoGridSlot, GEO_TMPL_TYPE)
+#define TMPL_POINTS_SOA TMPL_CONCAT(GeoPointsSoA, GEO_TMPL_TYPE)
 #define TMPL_FUNC(name) TMPL_CONCAT(name, GEO_TMPL_TYPE)
 
 /*
@@ -95,14 +110,194 @@ struct TMPL_GEOMETRY {
   size_t segments_count;
 };
 
-enum GeoResult {
-  GEO_SUCCESS = 0,
-  GEO_ERR_NULL_POINTER = 1,
-  GEO_ERR_TOO_SMALL = 2,
-  GEO_ERR_OVERFLOW = 3  // unused for now
+struct TMPL_ENVELOPE {
+  struct TMPL_POINT min;
+  struct TMPL_POINT max;
+};
+
+/*
+ * points as a structure of arrays, point i is (xs[i], ys[i]). the batch
+ * functions read both arrays front to back. buffers are owned by the caller.
+ */
+struct TMPL_POINTS_SOA {
+  GEO_TMPL_TYPE* xs;
+  GEO_TMPL_TYPE* ys;
+  size_t count;
+};
+
+/*
+ * read only view of a ring stored as interleaved x, y coordinates of
+ * GEO_TMPL_TYPE in host byte order. `coordinates` may point anywhere, even at
+ * an unaligned offset in a blob, as every point is read with memcpy. like a
+ * geometry, a ring is closed when its last point repeats the first, its edges
+ * join each point to the next one.
+ */
+struct TMPL_RING_VIEW {
+  void const* coordinates;
+  size_t points_count;
+};
+
+/* rings[0] is the outer ring, any others are holes */
+struct TMPL_POLYGON_VIEW {
+  struct TMPL_RING_VIEW const* rings;
+  size_t rings_count;
+};
+
+/*
+ * a geometry read from text. line strings and rings are `parts`, closed like
+ * the input is, with segments pointing at points in the reader's arena.
+ */
+struct TMPL_SHAPE {
+  enum GeoShapeType type;
+  struct TMPL_POINT point;  // GEO_SHAPE_POINT only
+  size_t points_count;      // 0 for EMPTY shapes
+  struct TMPL_GEOMETRY* parts;
+  size_t parts_count;
+  size_t* polygons;  // index of the outer ring of every polygon in `parts`
+  size_t polygons_count;
+};
+
+/*
+ * shape being read by one of the text readers, private to them. the points of
+ * every part are packed in the arena, the finished parts are linked from
+ * `last_part` back to the first one.
+ */
+struct TMPL_SHAPE_BUILDER {
+  struct GeoArena* arena;
+  struct TMPL_POINT point;  // coordinate being read
+  struct TMPL_POINT* part_points;
+  size_t part_points_count;
+  void* last_part;
+  size_t parts_count;
+  size_t polygons_count;
+  size_t segments_count;
+  size_t points_count;
+  bool polygon_start;
+};
+
+#ifndef GEO_WKT_TOKEN_SIZE
+#define GEO_WKT_TOKEN_SIZE 128
+#endif
+
+/*
+ * incremental WKT reader. chunks can be split anywhere, every complete shape
+ * is passed to `emit` as soon as its closing parenthesis is read. the shape
+ * only lives in the arena so `emit` may reset it once done with the shape.
+ */
+struct TMPL_WKT_PARSER {
+  void (*emit)(void* context, struct TMPL_SHAPE const* shape);
+  void* context;
+  enum GeoResult result;  // first error, every later call returns it
+  size_t offset;          // bytes read, where the error is when there is one
+  // private parsing state
+  struct TMPL_SHAPE_BUILDER builder;
+  enum GeoShapeType type;
+  unsigned state;
+  unsigned depth;
+  unsigned previous;
+  unsigned axis;
+  size_t token_length;
+  char token[GEO_WKT_TOKEN_SIZE];
+};
+
+#ifndef GEO_JSON_TOKEN_SIZE
+#define GEO_JSON_TOKEN_SIZE 128
+#endif
+#ifndef GEO_JSON_MAX_DEPTH
+#define GEO_JSON_MAX_DEPTH 64
+#endif
+
+/*
+ * incremental GeoJSON reader. only the geometry of a bare geometry, a Feature,
+ * a FeatureCollection or newline delimited features is looked at, everything
+ * else is skipped without being stored. like the WKT reader every geometry is
+ * passed to `emit` once its object is closed.
+ */
+struct TMPL_JSON_PARSER {
+  void (*emit)(void* context, struct TMPL_SHAPE const* shape);
+  void* context;
+  enum GeoResult result;  // first error, every later call returns it
+  size_t offset;          // bytes read, where the error is when there is one
+  // private parsing state
+  struct TMPL_SHAPE_BUILDER builder;
+  unsigned char kinds[GEO_JSON_MAX_DEPTH];
+  unsigned char roles[GEO_JSON_MAX_DEPTH];
+  unsigned char keys[GEO_JSON_MAX_DEPTH];
+  unsigned char types[GEO_JSON_MAX_DEPTH];
+  size_t depth;
+  unsigned expect;
+  unsigned coordinates_depth;
+  unsigned positions_depth;
+  unsigned axis;
+  bool in_string;
+  bool escape;
+  size_t token_length;
+  char token[GEO_JSON_TOKEN_SIZE];
+};
+
+/*
+ * spatial hash grid. points are bucketed by integer cell coordinates
+ * (floor(x / cell_size), floor(y / cell_size)) and the cells are hashed into
+ * an open addressed table of `slots`. `objects[id]` holds the slot index of
+ * object `id` (or GEO_GRID_NONE). insert, move, remove, and the queries are
+ * lock-free and can be called concurrently from any number of threads.
+ * queries are not snapshots: an object that is not modified while a query runs
+ * is reported exactly once, one moved during the query may be missed or
+ * reported at both positions. init is not thread safe. requires gcc/clang
+ * `__atomic` builtins.
+ */
+#ifndef GEO_GRID_NONE
+#define GEO_GRID_NONE SIZE_MAX
+#endif
+
+struct TMPL_GRID_SLOT {
+  uint64_t state;      // generation | tag | object id
+  uint32_t max_probe;  // furthest probe of any entry whose home is this slot
+  GEO_TMPL_TYPE x;
+  GEO_TMPL_TYPE y;
+};
+
+struct TMPL_GRID {
+  struct TMPL_GRID_SLOT* slots;
+  size_t slots_count;
+  size_t* objects;
+  size_t objects_count;
+  GEO_TMPL_TYPE cell_size;
+};
+
+/*
+ * packed hilbert r-tree over geometry envelopes plus the packed vertices of
+ * every geometry, laid out in one relocatable buffer (see GeoIndexHeader).
+ * geometries are stored in hilbert order of their envelope centers, `id` is
+ * the position of the geometry in the array it was built from.
+ */
+#ifndef GEO_INDEX_NODE_SIZE
+#define GEO_INDEX_NODE_SIZE 16
+#endif
+
+struct TMPL_INDEX_NODE {
+  struct TMPL_ENVELOPE envelope;
+  uint64_t first_child;  // index into nodes, or entries for leaf nodes
+  uint64_t children_count;
+};
+
+struct TMPL_INDEX_ENTRY {
+  struct TMPL_ENVELOPE envelope;
+  uint64_t first_point;
+  uint64_t points_count;
+  uint64_t id;
 };
 
-enum GeoOrientation { RIGHT = -1, COLINEAR = 0, LEFT = 1 };
+/* pointers into the buffer passed to geo_index_open, nothing is copied */
+struct TMPL_INDEX {
+  struct TMPL_INDEX_NODE const* nodes;
+  size_t nodes_count;
+  size_t leaf_nodes_start;
+  struct TMPL_INDEX_ENTRY const* entries;
+  size_t entries_count;
+  struct TMPL_POINT const* points;
+  size_t points_count;
+};
 
 // public forward declaration
 enum GeoResult TMPL_FUNC(geo_points_equal)(struct TMPL_POINT const* lhs,
@@ -116,6 +311,9 @@ enum GeoResult TMPL_FUNC(geo_geometry_is_closed)(
     struct TMPL_GEOMETRY const* geometry, bool* is_closed);
 enum GeoResult TMPL_FUNC(geo_geometry_is_simple)(
     struct TMPL_GEOMETRY const* geometry, bool* is_simple);
+enum GeoResult TMPL_FUNC(geo_geometry_is_simple_parallel)(
+    struct TMPL_GEOMETRY const* geometry, struct GeoExecutor const* executor,
+    bool* is_simple);
 enum GeoResult TMPL_FUNC(geo_point_in_geometry)(
     struct TMPL_POINT const* point, struct TMPL_GEOMETRY const* geometry,
     bool strict, bool* is_inside);
@@ -127,6 +325,175 @@ enum GeoResult TMPL_FUNC(geo_convex_hull)(struct TMPL_POINT** points,
                                           struct TMPL_POINT** convex_hull,
                                           size_t size,
                                           size_t* convex_hull_size);
+
+enum GeoResult TMPL_FUNC(geo_geometry_envelope)(
+    struct TMPL_GEOMETRY const* geometry, struct TMPL_ENVELOPE* envelope);
+enum GeoResult TMPL_FUNC(geo_geometry_build_size)(size_t points_count,
+                                                  size_t* size);
+enum GeoResult TMPL_FUNC(geo_geometry_build_from_points)(
+    struct GeoArena* arena, struct TMPL_POINT const* points,
+    size_t points_count, struct TMPL_GEOMETRY* geometry);
+
+enum GeoResult TMPL_FUNC(geo_convex_hull_soa)(
+    struct TMPL_POINTS_SOA const* points, struct GeoExecutor const* executor,
+    struct GeoAllocator const* allocator, size_t* convex_hull,
+    size_t* convex_hull_size);
+enum GeoResult TMPL_FUNC(geo_points_in_geometry_soa)(
+    struct TMPL_POINTS_SOA const* points, struct TMPL_GEOMETRY const* geometry,
+    bool strict, struct GeoExecutor const* executor, bool* is_inside);
+enum GeoResult TMPL_FUNC(geo_squared_distance_soa)(
+    struct TMPL_POINTS_SOA const* points, struct TMPL_POINT const* point,
+    GEO_TMPL_TYPE* distances);
+enum GeoResult TMPL_FUNC(geo_simd_select)(enum GeoSimdLevel level);
+
+enum GeoResult TMPL_FUNC(geo_morton_key)(struct TMPL_POINT const* points,
+                                         size_t size,
+                                         struct TMPL_ENVELOPE const* envelope,
+                                         uint64_t* keys);
+enum GeoResult TMPL_FUNC(geo_hilbert_key)(struct TMPL_POINT const* points,
+                                          size_t size,
+                                          struct TMPL_ENVELOPE const* envelope,
+                                          uint64_t* keys);
+enum GeoResult TMPL_FUNC(geo_sort_points_by_key)(
+    struct TMPL_POINT* points, uint64_t* keys, size_t size,
+    struct GeoExecutor const* executor);
+enum GeoResult TMPL_FUNC(geo_sort_geometries_by_key)(
+    struct TMPL_GEOMETRY** geometries, uint64_t* keys, size_t size,
+    struct GeoExecutor const* executor);
+
+enum GeoResult TMPL_FUNC(geo_index_build_size)(
+    struct TMPL_GEOMETRY* const* geometries, size_t count, size_t* size);
+enum GeoResult TMPL_FUNC(geo_index_build)(
+    struct TMPL_GEOMETRY* const* geometries, size_t count,
+    struct GeoExecutor const* executor, void* buffer, size_t buffer_size);
+enum GeoResult TMPL_FUNC(geo_index_open)(struct TMPL_INDEX* index,
+                                         void const* data, size_t size);
+enum GeoResult TMPL_FUNC(geo_index_query_envelope)(
+    struct TMPL_INDEX const* index, struct TMPL_ENVELOPE const* envelope,
+    size_t* ids, size_t ids_capacity, size_t* ids_count);
+enum GeoResult TMPL_FUNC(geo_index_query_point)(
+    struct TMPL_INDEX const* index, struct TMPL_POINT const* point,
+    bool strict, size_t* ids, size_t ids_capacity, size_t* ids_count);
+enum GeoResult TMPL_FUNC(geo_index_ring)(struct TMPL_INDEX const* index,
+                                         size_t position,
+                                         struct TMPL_RING_VIEW* view);
+enum GeoResult TMPL_FUNC(geo_index_compress)(void const* data, size_t size,
+                                             void* buffer, size_t buffer_size,
+                                             size_t* compressed_size);
+enum GeoResult TMPL_FUNC(geo_index_decompress)(void const* data, size_t size,
+                                               void* buffer,
+                                               size_t buffer_size,
+                                               size_t* decompressed_size);
+
+enum GeoResult TMPL_FUNC(geo_spatial_join)(
+    struct TMPL_POINT const* points, size_t points_count,
+    struct TMPL_GEOMETRY* const* geometries, size_t geometries_count,
+    bool strict, struct GeoExecutor const* executor,
+    struct GeoAllocator const* allocator, struct GeoJoinPair* pairs,
+    size_t pairs_capacity, size_t* pairs_count);
+enum GeoResult TMPL_FUNC(geo_spatial_join_count)(
+    struct TMPL_POINT const* points, size_t points_count,
+    struct TMPL_GEOMETRY* const* geometries, size_t geometries_count,
+    bool strict, struct GeoExecutor const* executor,
+    struct GeoAllocator const* allocator, size_t* counts);
+
+enum GeoResult TMPL_FUNC(geo_ring_view_envelope)(
+    struct TMPL_RING_VIEW const* view, struct TMPL_ENVELOPE* envelope);
+enum GeoResult TMPL_FUNC(geo_ring_view_is_closed)(
+    struct TMPL_RING_VIEW const* view, bool* is_closed);
+enum GeoResult TMPL_FUNC(geo_ring_view_is_simple)(
+    struct TMPL_RING_VIEW const* view, bool* is_simple);
+enum GeoResult TMPL_FUNC(geo_ring_view_is_simple_parallel)(
+    struct TMPL_RING_VIEW const* view, struct GeoExecutor const* executor,
+    bool* is_simple);
+enum GeoResult TMPL_FUNC(geo_point_in_ring_view)(
+    struct TMPL_POINT const* point, struct TMPL_RING_VIEW const* view,
+    bool strict, bool* is_inside);
+enum GeoResult TMPL_FUNC(geo_ring_view_in_ring_view)(
+    struct TMPL_RING_VIEW const* parent, struct TMPL_RING_VIEW const* child,
+    bool strict, bool* is_inside);
+enum GeoResult TMPL_FUNC(geo_point_in_polygon_view)(
+    struct TMPL_POINT const* point, struct TMPL_POLYGON_VIEW const* polygon,
+    bool strict, bool* is_inside);
+#if defined(GEO_FLOATING_POINT) && (GEO_TMPL_TYPE_SIZE == 64)
+enum GeoResult TMPL_FUNC(geo_wkb_read)(
+    void const* blob, size_t size, struct TMPL_POLYGON_VIEW* polygons,
+    size_t polygons_capacity, size_t* polygons_count,
+    struct TMPL_RING_VIEW* rings, size_t rings_capacity, size_t* rings_count);
+enum GeoResult TMPL_FUNC(geo_shp_open)(struct GeoShpFile* file,
+                                       void const* shp, size_t shp_size,
+                                       void const* shx, size_t shx_size);
+enum GeoResult TMPL_FUNC(geo_shp_record_envelope)(
+    struct GeoShpFile const* file, size_t record,
+    struct TMPL_ENVELOPE* envelope);
+enum GeoResult TMPL_FUNC(geo_shp_record_rings)(struct GeoShpFile const* file,
+                                               size_t record,
+                                               struct TMPL_RING_VIEW* rings,
+                                               size_t rings_capacity,
+                                               size_t* rings_count);
+enum GeoResult TMPL_FUNC(geo_point_in_shp_record)(
+    struct TMPL_POINT const* point, struct GeoShpFile const* file,
+    size_t record, bool strict, bool* is_inside);
+enum GeoResult TMPL_FUNC(geo_fgb_open)(struct GeoFgbFile* file,
+                                       void const* data, size_t size);
+enum GeoResult TMPL_FUNC(geo_fgb_query_envelope)(
+    struct GeoFgbFile const* file, struct TMPL_ENVELOPE const* envelope,
+    size_t* ids, size_t ids_capacity, size_t* ids_count);
+enum GeoResult TMPL_FUNC(geo_fgb_query_point)(struct GeoFgbFile const* file,
+                                              struct TMPL_POINT const* point,
+                                              bool strict, size_t* ids,
+                                              size_t ids_capacity,
+                                              size_t* ids_count);
+enum GeoResult TMPL_FUNC(geo_fgb_read)(
+    struct GeoFgbFile const* file, size_t feature,
+    struct TMPL_POLYGON_VIEW* polygons, size_t polygons_capacity,
+    size_t* polygons_count, struct TMPL_RING_VIEW* rings,
+    size_t rings_capacity, size_t* rings_count);
+#endif
+
+enum GeoResult TMPL_FUNC(geo_wkt_parser_init)(
+    struct TMPL_WKT_PARSER* parser, struct GeoArena* arena,
+    void (*emit)(void* context, struct TMPL_SHAPE const* shape),
+    void* context);
+enum GeoResult TMPL_FUNC(geo_wkt_parse)(struct TMPL_WKT_PARSER* parser,
+                                        char const* chunk, size_t size);
+enum GeoResult TMPL_FUNC(geo_wkt_parse_finish)(struct TMPL_WKT_PARSER* parser);
+enum GeoResult TMPL_FUNC(geo_wkt_parse_fd)(struct TMPL_WKT_PARSER* parser,
+                                           int descriptor);
+enum GeoResult TMPL_FUNC(geo_json_parser_init)(
+    struct TMPL_JSON_PARSER* parser, struct GeoArena* arena,
+    void (*emit)(void* context, struct TMPL_SHAPE const* shape),
+    void* context);
+enum GeoResult TMPL_FUNC(geo_json_parse)(struct TMPL_JSON_PARSER* parser,
+                                         char const* chunk, size_t size);
+enum GeoResult TMPL_FUNC(geo_json_parse_finish)(
+    struct TMPL_JSON_PARSER* parser);
+enum GeoResult TMPL_FUNC(geo_json_parse_fd)(struct TMPL_JSON_PARSER* parser,
+                                            int descriptor);
+enum GeoResult TMPL_FUNC(geo_csv_read_points)(
+    char const* text, size_t size, char separator, size_t x_column,
+    size_t y_column, bool has_header, struct GeoExecutor const* executor,
+    GEO_TMPL_TYPE* xs, GEO_TMPL_TYPE* ys, size_t capacity, size_t* count);
+
+enum GeoResult TMPL_FUNC(geo_grid_init)(struct TMPL_GRID* grid,
+                                        GEO_TMPL_TYPE cell_size,
+                                        struct TMPL_GRID_SLOT* slots,
+                                        size_t slots_count, size_t* objects,
+                                        size_t objects_count);
+enum GeoResult TMPL_FUNC(geo_grid_insert)(struct TMPL_GRID* grid, size_t id,
+                                          struct TMPL_POINT const* point,
+                                          bool* inserted);
+enum GeoResult TMPL_FUNC(geo_grid_move)(struct TMPL_GRID* grid, size_t id,
+                                        struct TMPL_POINT const* point,
+                                        bool* moved);
+enum GeoResult TMPL_FUNC(geo_grid_remove)(struct TMPL_GRID* grid, size_t id,
+                                          bool* removed);
+enum GeoResult TMPL_FUNC(geo_grid_query_radius)(
+    struct TMPL_GRID const* grid, struct TMPL_POINT const* center,
+    GEO_TMPL_TYPE radius, size_t* ids, size_t ids_capacity, size_t* ids_count);
+enum GeoResult TMPL_FUNC(geo_grid_query_geometry)(
+    struct TMPL_GRID const* grid, struct TMPL_GEOMETRY const* geometry,
+    bool strict, size_t* ids, size_t ids_capacity, size_t* ids_count);
 #ifdef __cplusplus
 }
 #endif
@@ -138,36 +505,134 @@ enum GeoResult TMPL_FUNC(geo_convex_hull)(struct TMPL_POINT** points,
 #ifdef GEO_TMPL_IMPL
 // private definitions
 
+/*
+ * with GEO_TRACE the traced functions are defined as static `_untraced`
+ * functions, which the library calls itself, and the public names become
+ * wrappers that report each call to the tracer.
+ */
+#ifdef GEO_TRACE
+#define UNTRACED_FUNC(name) TMPL_FUNC(TMPL_CONCAT(name, untraced))
+static enum GeoResult UNTRACED_FUNC(geo_segments_intersect)(
+    struct TMPL_SEGMENT const* segment1, struct TMPL_SEGMENT const* segment2,
+    size_t* intersect_count);
+static enum GeoResult UNTRACED_FUNC(geo_geometry_is_simple)(
+    struct TMPL_GEOMETRY const* geometry, bool* is_simple);
+static enum GeoResult UNTRACED_FUNC(geo_geometry_is_simple_parallel)(
+    struct TMPL_GEOMETRY const* geometry, struct GeoExecutor const* executor,
+    bool* is_simple);
+static enum GeoResult UNTRACED_FUNC(geo_point_in_geometry)(
+    struct TMPL_POINT const* point, struct TMPL_GEOMETRY const* geometry,
+    bool strict, bool* is_inside);
+static enum GeoResult UNTRACED_FUNC(geo_geometry_in_geometry)(
+    struct TMPL_GEOMETRY* parent, struct TMPL_GEOMETRY* child, bool strict,
+    bool* is_inside);
+static enum GeoResult UNTRACED_FUNC(geo_convex_hull)(
+    struct TMPL_POINT** points, struct TMPL_POINT** convex_hull, size_t size,
+    size_t* convex_hull_size);
+static enum GeoResult UNTRACED_FUNC(geo_convex_hull_soa)(
+    struct TMPL_POINTS_SOA const* points, struct GeoExecutor const* executor,
+    struct GeoAllocator const* allocator, size_t* convex_hull,
+    size_t* convex_hull_size);
+static enum GeoResult UNTRACED_FUNC(geo_points_in_geometry_soa)(
+    struct TMPL_POINTS_SOA const* points, struct TMPL_GEOMETRY const* geometry,
+    bool strict, struct GeoExecutor const* executor, bool* is_inside);
+static enum GeoResult UNTRACED_FUNC(geo_index_build)(
+    struct TMPL_GEOMETRY* const* geometries, size_t count,
+    struct GeoExecutor const* executor, void* buffer, size_t buffer_size);
+static enum GeoResult UNTRACED_FUNC(geo_index_query_point)(
+    struct TMPL_INDEX const* index, struct TMPL_POINT const* point, bool strict,
+    size_t* ids, size_t ids_capacity, size_t* ids_count);
+static enum GeoResult UNTRACED_FUNC(geo_spatial_join)(
+    struct TMPL_POINT const* points, size_t points_count,
+    struct TMPL_GEOMETRY* const* geometries, size_t geometries_count,
+    bool strict, struct GeoExecutor const* executor,
+    struct GeoAllocator const* allocator, struct GeoJoinPair* pairs,
+    size_t pairs_capacity, size_t* pairs_count);
+static enum GeoResult UNTRACED_FUNC(geo_spatial_join_count)(
+    struct TMPL_POINT const* points, size_t points_count,
+    struct TMPL_GEOMETRY* const* geometries, size_t geometries_count,
+    bool strict, struct GeoExecutor const* executor,
+    struct GeoAllocator const* allocator, size_t* counts);
+static enum GeoResult UNTRACED_FUNC(geo_ring_view_is_simple)(
+    struct TMPL_RING_VIEW const* view, bool* is_simple);
+static enum GeoResult UNTRACED_FUNC(geo_ring_view_is_simple_parallel)(
+    struct TMPL_RING_VIEW const* view, struct GeoExecutor const* executor,
+    bool* is_simple);
+static enum GeoResult UNTRACED_FUNC(geo_point_in_ring_view)(
+    struct TMPL_POINT const* point, struct TMPL_RING_VIEW const* view,
+    bool strict, bool* is_inside);
+static enum GeoResult UNTRACED_FUNC(geo_point_in_polygon_view)(
+    struct TMPL_POINT const* point, struct TMPL_POLYGON_VIEW const* polygon,
+    bool strict, bool* is_inside);
+#else
+#define UNTRACED_FUNC(name) TMPL_FUNC(name)
+#endif
+
+/*
+ * how many parts to split `count` items into so each has at least
+ * `part_size` of them and every thread `executor` allows gets one.
+ */
+static size_t parallel_parts(struct GeoExecutor const* const executor,
+                             size_t count, size_t part_size) {
+  size_t parts = 1;
+#ifndef GEO_NO_THREADS
+  if (executor != NULL && executor->concurrency > 1) {
+    parts = executor->concurrency < GEO_MAX_THREADS ? executor->concurrency
+                                                    : GEO_MAX_THREADS;
+  }
+#else
+  (void)executor;
+#endif
+  if (part_size > 0 && parts > count / part_size) {
+    parts = count / part_size;
+  }
+  return parts == 0 ? 1 : parts;
+}
+
+#ifndef GEO_UNSAFE
+static bool executor_valid(struct GeoExecutor const* const executor) {
+  return executor == NULL || executor->submit != NULL;
+}
+#endif
+
 // TODO use the result enum
 // TODO this is only valid for ieee754 compliant types. should assert this
 #ifdef GEO_FLOATING_POINT
 static bool equal(GEO_TMPL_TYPE lhs, GEO_TMPL_TYPE rhs) {
   if (isnan(lhs) || isnan(rhs)) {
+    GEO_STATS_ADD(equal_nan, 1);
     return false;
   }
 
   if (lhs == rhs) {
+    GEO_STATS_ADD(equal_exact, 1);
     return true;
   }
 
   if (isinf(lhs) || isinf(rhs)) {
+    GEO_STATS_ADD(equal_infinite, 1);
     return false;
   }
 
   GEO_TMPL_TYPE diff = fabs(lhs - rhs);
   if (diff <= GEO_ABS_EPSILON) {
+    GEO_STATS_ADD(equal_absolute, 1);
     return true;
   }
 
   GEO_TMPL_TYPE largest = fmax(fabs(lhs), fabs(rhs));
   if (diff <= largest * GEO_REL_EPSILON) {
+    GEO_STATS_ADD(equal_relative, 1);
     return true;
   }
 
   if (signbit(lhs) != signbit(rhs)) {
+    GEO_STATS_ADD(equal_sign, 1);
     return false;
   }
 
+  GEO_STATS_ADD(equal_ulps, 1);
+
   GEO_TMPL_TYPE_FIXED lhs_int = 0, rhs_int = 0, ulp_diff = 0;
   memcpy(&lhs_int, &lhs, sizeof(GEO_TMPL_TYPE));
   memcpy(&rhs_int, &rhs, sizeof(GEO_TMPL_TYPE));
@@ -196,25 +661,59 @@ static enum GeoOrientation orientation(struct TMPL_POINT const* const start,
   struct TMPL_POINT vec_ac = {.x = point->x - start->x,
                               .y = point->y - start->y};
   GEO_TMPL_TYPE cross = cross_product(&vec_ab, &vec_ac);
+  GEO_STATS_ADD(orientation_calls, 1);
 #ifdef GEO_FLOATING_POINT
   if (equal(cross, GEO_ZERO)) {
 #else
   if (cross == 0) {
 #endif
+    GEO_STATS_ADD(orientation_colinear, 1);
     return COLINEAR;
   }
   return cross < GEO_ZERO ? RIGHT : LEFT;
 }
 
-static bool in_disk(struct TMPL_SEGMENT const* const segment,
+static bool in_span(struct TMPL_POINT const* const start,
+                    struct TMPL_POINT const* const end,
                     struct TMPL_POINT const* const point) {
-  struct TMPL_POINT vec_ap = {.x = segment->start->x - point->x,
-                              .y = segment->start->y - point->y};
-  struct TMPL_POINT vec_bp = {.x = segment->end->x - point->x,
-                              .y = segment->end->y - point->y};
+  struct TMPL_POINT vec_ap = {.x = start->x - point->x,
+                              .y = start->y - point->y};
+  struct TMPL_POINT vec_bp = {.x = end->x - point->x, .y = end->y - point->y};
   return dot_product(&vec_ap, &vec_bp) <= GEO_ZERO;
 }
 
+static bool in_disk(struct TMPL_SEGMENT const* const segment,
+                    struct TMPL_POINT const* const point) {
+  return in_span(segment->start, segment->end, point);
+}
+
+/*
+ * one edge of the point in geometry ray cast. returns true when `point` lies on
+ * the edge, otherwise counts the edge in `intersections` if a ray from `point`
+ * crosses it.
+ */
+static bool ray_cast_edge(struct TMPL_POINT const* const start,
+                          struct TMPL_POINT const* const end,
+                          struct TMPL_POINT const* const point,
+                          size_t* intersections) {
+  enum GeoOrientation orientation_p = orientation(start, end, point);
+  GEO_STATS_ADD(point_in_polygon_edges, 1);
+  if (orientation_p == COLINEAR && in_span(start, end, point)) {
+    return true;
+  }
+  /*
+   * checks that a ray from `point` bisects the segment and that the
+   * orientation puts the `point` on the appropriate side of the
+   * `segment`.
+   *
+   * TODO should this be using `>` check and `equals` check instead of `>=`
+   * for FP numbers?
+   */
+  *intersections +=
+      (((end->y >= point->y) - (start->y >= point->y)) * orientation_p) > 0;
+  return false;
+}
+
 static GEO_TMPL_TYPE squared_distance(struct TMPL_POINT const* const point1,
                                       struct TMPL_POINT const* const point2) {
   GEO_TMPL_TYPE diff_x = point2->x - point1->x;
@@ -229,6 +728,7 @@ static int compare(const void* first, const void* second) {
   const struct TMPL_POINT* point = *(const struct TMPL_POINT* const*)second;
   enum GeoOrientation orientation_p =
       orientation(global_start_point, vec_end, point);
+  GEO_STATS_ADD(convex_hull_comparisons, 1);
 
   if (orientation_p == COLINEAR) {
     int distance = (squared_distance(global_start_point, point) >=
@@ -257,7 +757,7 @@ enum GeoResult TMPL_FUNC(geo_points_equal)(struct TMPL_POINT const* lhs,
   return GEO_SUCCESS;
 }
 
-enum GeoResult TMPL_FUNC(geo_segments_intersect)(
+enum GeoResult UNTRACED_FUNC(geo_segments_intersect)(
     struct TMPL_SEGMENT const* const segment1,
     struct TMPL_SEGMENT const* const segment2, size_t* intersect_count) {
   enum GeoOrientation orientation_a;
@@ -271,6 +771,7 @@ enum GeoResult TMPL_FUNC(geo_segments_intersect)(
     return GEO_ERR_NULL_POINTER;
   }
 #endif
+  GEO_STATS_ADD(segments_intersect_calls, 1);
   orientation_a = orientation(segment2->start, segment2->end, segment1->start);
   orientation_b = orientation(segment2->start, segment2->end, segment1->end);
   orientation_c = orientation(segment1->start, segment1->end, segment2->start);
@@ -331,12 +832,96 @@ enum GeoResult TMPL_FUNC(geo_geometry_is_closed)(
   return GEO_SUCCESS;
 }
 
-enum GeoResult TMPL_FUNC(geo_geometry_is_simple)(
+/*
+ * the segment pairs of the simple checks split across an executor. row `i`
+ * is segment `i` against every later segment, the tasks take every
+ * `tasks_count`th row so the long first rows are spread out. a task that
+ * finds a bad pair clears `is_simple` and the others stop at their next row.
+ */
+#ifndef GEO_SIMPLE_PARALLEL_SIZE
+#define GEO_SIMPLE_PARALLEL_SIZE 256
+#endif
+
+#define TMPL_SIMPLE_CHECK TMPL_CONCAT(GeoSimpleCheck, GEO_TMPL_TYPE)
+
+struct TMPL_SIMPLE_CHECK {
+  void const* source;
+  /* segment `index` of `source`, `storage` can back its two points */
+  struct TMPL_SEGMENT const* (*segment)(void const* source, size_t index,
+                                        struct TMPL_POINT* storage,
+                                        struct TMPL_SEGMENT* segment);
+  size_t segments_count;
+  size_t tasks_count;
+  bool is_simple;
+};
+
+static void simple_task(void* context, size_t index) {
+  struct TMPL_SIMPLE_CHECK* check = (struct TMPL_SIMPLE_CHECK*)context;
+  struct TMPL_POINT storage[4];
+  struct TMPL_SEGMENT first_storage;
+  struct TMPL_SEGMENT other_storage;
+  size_t const last = check->segments_count - 1;
+  for (size_t i = index; i < last; i += check->tasks_count) {
+    struct TMPL_SEGMENT const* first =
+        check->segment(check->source, i, &storage[0], &first_storage);
+    if (!__atomic_load_n(&check->is_simple, __ATOMIC_RELAXED)) {
+      return;
+    }
+    for (size_t j = i + 1; j <= last; ++j) {
+      size_t const expected = (j == i + 1 || (i == 0 && j == last)) ? 2 : 0;
+      size_t intersections = 0;
+      GEO_STATS_ADD(is_simple_pairs, 1);
+      UNTRACED_FUNC(geo_segments_intersect)(
+          first, check->segment(check->source, j, &storage[2], &other_storage),
+          &intersections);
+      if (intersections != expected) {
+        __atomic_store_n(&check->is_simple, false, __ATOMIC_RELAXED);
+        return;
+      }
+    }
+  }
+}
+
+static enum GeoResult simple_run(struct TMPL_SIMPLE_CHECK* check,
+                                 struct GeoExecutor const* executor,
+                                 size_t tasks_count, bool* is_simple) {
+  enum GeoResult result = GEO_SUCCESS;
+  check->tasks_count = tasks_count;
+  check->is_simple = true;
+  result = geo_executor_run(executor, simple_task, check, tasks_count);
+  if (result == GEO_SUCCESS) {
+    *is_simple = check->is_simple;
+  }
+  return result;
+}
+
+static struct TMPL_SEGMENT const* simple_geometry_segment(
+    void const* source, size_t index, struct TMPL_POINT* storage,
+    struct TMPL_SEGMENT* segment) {
+  (void)storage;
+  (void)segment;
+  return ((struct TMPL_GEOMETRY const*)source)->segments[index];
+}
+
+enum GeoResult UNTRACED_FUNC(geo_geometry_is_simple)(
     struct TMPL_GEOMETRY const* geometry, bool* is_simple) {
+  return UNTRACED_FUNC(geo_geometry_is_simple_parallel)(geometry, NULL,
+                                                        is_simple);
+}
+
+/*
+ * with an executor and at least GEO_SIMPLE_PARALLEL_SIZE segments the pairs
+ * are checked in parallel, after checking every segment up front.
+ */
+enum GeoResult UNTRACED_FUNC(geo_geometry_is_simple_parallel)(
+    struct TMPL_GEOMETRY const* geometry, struct GeoExecutor const* executor,
+    bool* is_simple) {
   enum GeoResult result = GEO_SUCCESS;
   size_t intersections = 0;
+  size_t parts = 0;
 #ifndef GEO_UNSAFE
-  if (geometry == NULL || geometry->segments == NULL) {
+  if (geometry == NULL || geometry->segments == NULL ||
+      !executor_valid(executor)) {
     return GEO_ERR_NULL_POINTER;
   }
 
@@ -344,8 +929,27 @@ enum GeoResult TMPL_FUNC(geo_geometry_is_simple)(
     return GEO_ERR_TOO_SMALL;
   }
 #endif
+  GEO_STATS_ADD(is_simple_calls, 1);
+  parts = parallel_parts(executor, geometry->segments_count, 1);
+  if (parts > 1 && geometry->segments_count >= GEO_SIMPLE_PARALLEL_SIZE) {
+    struct TMPL_SIMPLE_CHECK check;
+#ifndef GEO_UNSAFE
+    for (size_t iter = 0; iter < geometry->segments_count; ++iter) {
+      if (geometry->segments[iter] == NULL ||
+          geometry->segments[iter]->start == NULL ||
+          geometry->segments[iter]->end == NULL) {
+        return GEO_ERR_NULL_POINTER;
+      }
+    }
+#endif
+    check.source = geometry;
+    check.segment = simple_geometry_segment;
+    check.segments_count = geometry->segments_count;
+    return simple_run(&check, executor, parts, is_simple);
+  }
   // check that the first and second segments intersect
-  result = TMPL_FUNC(geo_segments_intersect)(
+  GEO_STATS_ADD(is_simple_pairs, 1);
+  result = UNTRACED_FUNC(geo_segments_intersect)(
       geometry->segments[0], geometry->segments[1], &intersections);
 
 #ifndef GEO_UNSAFE
@@ -359,7 +963,8 @@ enum GeoResult TMPL_FUNC(geo_geometry_is_simple)(
   }
 
   // check that the first and last segments intersect
-  result = TMPL_FUNC(geo_segments_intersect)(
+  GEO_STATS_ADD(is_simple_pairs, 1);
+  result = UNTRACED_FUNC(geo_segments_intersect)(
       geometry->segments[0], geometry->segments[geometry->segments_count - 1],
       &intersections);
 
@@ -375,7 +980,8 @@ enum GeoResult TMPL_FUNC(geo_geometry_is_simple)(
 
   // no other segments intersect with the first.
   for (size_t i = 2; i < geometry->segments_count - 1; ++i) {
-    result = TMPL_FUNC(geo_segments_intersect)(
+    GEO_STATS_ADD(is_simple_pairs, 1);
+    result = UNTRACED_FUNC(geo_segments_intersect)(
         geometry->segments[0], geometry->segments[i], &intersections);
 
 #ifndef GEO_UNSAFE
@@ -390,7 +996,8 @@ enum GeoResult TMPL_FUNC(geo_geometry_is_simple)(
   }
 
   for (size_t i = 1; i < geometry->segments_count - 1; ++i) {
-    result = TMPL_FUNC(geo_segments_intersect)(
+    GEO_STATS_ADD(is_simple_pairs, 1);
+    result = UNTRACED_FUNC(geo_segments_intersect)(
         geometry->segments[i], geometry->segments[i + 1], &intersections);
 
 #ifndef GEO_UNSAFE
@@ -403,7 +1010,8 @@ enum GeoResult TMPL_FUNC(geo_geometry_is_simple)(
       return GEO_SUCCESS;
     }
     for (size_t j = (i + 2); j < geometry->segments_count; ++j) {
-      result = TMPL_FUNC(geo_segments_intersect)(
+      GEO_STATS_ADD(is_simple_pairs, 1);
+      result = UNTRACED_FUNC(geo_segments_intersect)(
           geometry->segments[i], geometry->segments[j], &intersections);
 #ifndef GEO_UNSAFE
       if (result != GEO_SUCCESS) {
@@ -420,11 +1028,10 @@ enum GeoResult TMPL_FUNC(geo_geometry_is_simple)(
   return GEO_SUCCESS;
 }
 
-enum GeoResult TMPL_FUNC(geo_point_in_geometry)(
+enum GeoResult UNTRACED_FUNC(geo_point_in_geometry)(
     struct TMPL_POINT const* point, struct TMPL_GEOMETRY const* geometry,
     bool strict, bool* is_inside) {
   size_t intersections = 0;
-  enum GeoOrientation orientation_p;
 #ifndef GEO_UNSAFE
   if (geometry == NULL || geometry->segments == NULL || point == NULL) {
     return GEO_ERR_NULL_POINTER;
@@ -434,6 +1041,7 @@ enum GeoResult TMPL_FUNC(geo_point_in_geometry)(
     return GEO_ERR_TOO_SMALL;
   }
 #endif
+  GEO_STATS_ADD(point_in_polygon_calls, 1);
   for (size_t iter = 0; iter < geometry->segments_count; ++iter) {
 #ifndef GEO_UNSAFE
     if (geometry->segments[iter] == NULL ||
@@ -443,32 +1051,19 @@ enum GeoResult TMPL_FUNC(geo_point_in_geometry)(
     }
 #endif
 
-    orientation_p = orientation(geometry->segments[iter]->start,
-                                geometry->segments[iter]->end, point);
-    if (orientation_p == COLINEAR && in_disk(geometry->segments[iter], point)) {
+    if (ray_cast_edge(geometry->segments[iter]->start,
+                      geometry->segments[iter]->end, point, &intersections)) {
       *is_inside = !strict;
       return GEO_SUCCESS;
     }
-    /*
-     * checks that a ray from `point` bisects the segment and that the
-     * orientation puts the `point` on the appropriate side of the
-     * `segment`.
-     *
-     * TODO should this be using `>` check and `equals` check instead of `>=`
-     * for FP numbers?
-     */
-    intersections += (((geometry->segments[iter]->end->y >= point->y) -
-                       (geometry->segments[iter]->start->y >= point->y)) *
-                      orientation_p) > 0;
   }
   *is_inside = intersections & 1;
   return GEO_SUCCESS;
 }
 
-enum GeoResult TMPL_FUNC(geo_geometry_in_geometry)(struct TMPL_GEOMETRY* parent,
-                                                   struct TMPL_GEOMETRY* child,
-                                                   bool strict,
-                                                   bool* is_inside) {
+enum GeoResult UNTRACED_FUNC(geo_geometry_in_geometry)(
+    struct TMPL_GEOMETRY* parent, struct TMPL_GEOMETRY* child, bool strict,
+    bool* is_inside) {
   enum GeoResult result = GEO_SUCCESS;
 #ifndef GEO_UNSAFE
   if (parent == NULL || parent->segments == NULL || child == NULL ||
@@ -486,7 +1081,7 @@ enum GeoResult TMPL_FUNC(geo_geometry_in_geometry)(struct TMPL_GEOMETRY* parent,
       return GEO_ERR_NULL_POINTER;
     }
 #endif
-    result = TMPL_FUNC(geo_point_in_geometry)(child->segments[iter]->start,
+    result = UNTRACED_FUNC(geo_point_in_geometry)(child->segments[iter]->start,
                                               parent, strict, is_inside);
     if (result != GEO_SUCCESS) {
       return result;
@@ -495,7 +1090,7 @@ enum GeoResult TMPL_FUNC(geo_geometry_in_geometry)(struct TMPL_GEOMETRY* parent,
     if (!(*is_inside)) {
       return GEO_SUCCESS;
     }
-    result = TMPL_FUNC(geo_point_in_geometry)(child->segments[iter]->end,
+    result = UNTRACED_FUNC(geo_point_in_geometry)(child->segments[iter]->end,
                                               parent, strict, is_inside);
     if (result != GEO_SUCCESS) {
       return result;
@@ -508,10 +1103,9 @@ enum GeoResult TMPL_FUNC(geo_geometry_in_geometry)(struct TMPL_GEOMETRY* parent,
   return GEO_SUCCESS;
 }
 
-enum GeoResult TMPL_FUNC(geo_convex_hull)(struct TMPL_POINT** points,
-                                          struct TMPL_POINT** convex_hull,
-                                          size_t size,
-                                          size_t* convex_hull_size) {
+enum GeoResult UNTRACED_FUNC(geo_convex_hull)(
+    struct TMPL_POINT** points, struct TMPL_POINT** convex_hull, size_t size,
+    size_t* convex_hull_size) {
   /* used to find starting point */
   size_t min_idx = 0;
   GEO_TMPL_TYPE min_y = GEO_ZERO;
@@ -548,6 +1142,7 @@ enum GeoResult TMPL_FUNC(geo_convex_hull)(struct TMPL_POINT** points,
     }
   }
 
+  GEO_STATS_ADD(convex_hull_calls, 1);
   /* swap (if needed) so p0 is the actual starting point based on y and x
    * coords
    */
@@ -570,22 +1165,31 @@ enum GeoResult TMPL_FUNC(geo_convex_hull)(struct TMPL_POINT** points,
    */
   qsort((void*)&points[1], size - 1, sizeof(struct TMPL_POINT*), compare);
   /*
-   * 1. add p0, p1, and p2 onto a stack from the sorted list. The first 2 are
-   * guaranteed to be on the hull
-   * 2. iterate over points in sorted list in order starting at p2
+   * 1. add p0 onto a stack, it is guaranteed to be on the hull
+   * 2. iterate over points in sorted list in order starting at p1
    * 2a. calcuate orientation of pX compared to the vector formed by p(x-2)
    *    and p(x-1).
    * 2b if CCW, push onto stack. if CW, pop last p(x-1) off the
    *    stack and move back to 2a using p(x-2) and p(x-1) without popped
    * point.
+   * 2c. stop popping at p0, points colinear with it can pop everything
+   *    else. repeats of p0 are skipped, they sort anywhere among the points
+   *    colinear with it.
    *
    */
   convex_hull[0] = points[0];
-  convex_hull[1] = points[1];
-  convex_hull[2] = points[2];
-  *convex_hull_size = 3;
-  for (size_t iter = *convex_hull_size; iter < size; ++iter) {
-    while (orientation(convex_hull[(*convex_hull_size) - 2],
+  *convex_hull_size = 1;
+  for (size_t iter = 1; iter < size; ++iter) {
+#ifdef GEO_FLOATING_POINT
+    if (equal(points[iter]->x, points[0]->x) &&
+        equal(points[iter]->y, points[0]->y)) {
+#else
+    if (points[iter]->x == points[0]->x && points[iter]->y == points[0]->y) {
+#endif
+      continue;
+    }
+    while ((*convex_hull_size) > 1 &&
+           orientation(convex_hull[(*convex_hull_size) - 2],
                        convex_hull[(*convex_hull_size) - 1],
                        points[iter]) != LEFT) {
       (*convex_hull_size)--;
@@ -595,6 +1199,4855 @@ enum GeoResult TMPL_FUNC(geo_convex_hull)(struct TMPL_POINT** points,
   }
   return GEO_SUCCESS;
 }
+
+static void envelope_extend(struct TMPL_ENVELOPE* envelope,
+                            struct TMPL_POINT const* const point) {
+  if (point->x < envelope->min.x) {
+    envelope->min.x = point->x;
+  }
+  if (point->y < envelope->min.y) {
+    envelope->min.y = point->y;
+  }
+  if (point->x > envelope->max.x) {
+    envelope->max.x = point->x;
+  }
+  if (point->y > envelope->max.y) {
+    envelope->max.y = point->y;
+  }
+}
+
+enum GeoResult TMPL_FUNC(geo_geometry_envelope)(
+    struct TMPL_GEOMETRY const* geometry, struct TMPL_ENVELOPE* envelope) {
+#ifndef GEO_UNSAFE
+  if (geometry == NULL || geometry->segments == NULL || envelope == NULL) {
+    return GEO_ERR_NULL_POINTER;
+  }
+  if (geometry->segments_count < 3) {
+    return GEO_ERR_TOO_SMALL;
+  }
+#endif
+  for (size_t iter = 0; iter < geometry->segments_count; ++iter) {
+#ifndef GEO_UNSAFE
+    if (geometry->segments[iter] == NULL ||
+        geometry->segments[iter]->start == NULL ||
+        geometry->segments[iter]->end == NULL) {
+      return GEO_ERR_NULL_POINTER;
+    }
+#endif
+    if (iter == 0) {
+      envelope->min = *geometry->segments[0]->start;
+      envelope->max = envelope->min;
+    }
+    envelope_extend(envelope, geometry->segments[iter]->start);
+    envelope_extend(envelope, geometry->segments[iter]->end);
+  }
+  return GEO_SUCCESS;
+}
+
+/*
+ * geometry builder. the points, the segments and the segment pointers of a
+ * geometry are carved out of one arena allocation, in that order, so the
+ * segments and their pointers start on a pointer boundary.
+ */
+#define GEO_BUILD_ALIGNMENT \
+  (sizeof(GEO_TMPL_TYPE) > sizeof(void*) ? sizeof(GEO_TMPL_TYPE) : sizeof(void*))
+
+static size_t build_points_size(size_t points_count) {
+  size_t size = points_count * sizeof(struct TMPL_POINT);
+  return (size + (sizeof(void*) - 1)) & ~(sizeof(void*) - 1);
+}
+
+/* bytes of the single allocation, without its alignment padding */
+static size_t build_size(size_t points_count) {
+  return build_points_size(points_count) +
+         (points_count *
+          (sizeof(struct TMPL_SEGMENT) + sizeof(struct TMPL_SEGMENT*)));
+}
+
+enum GeoResult TMPL_FUNC(geo_geometry_build_size)(size_t points_count,
+                                                  size_t* size) {
+#ifndef GEO_UNSAFE
+  if (size == NULL) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+  if (points_count >
+      (SIZE_MAX - (2 * GEO_BUILD_ALIGNMENT)) /
+          (sizeof(struct TMPL_POINT) + sizeof(struct TMPL_SEGMENT) +
+           sizeof(struct TMPL_SEGMENT*))) {
+    return GEO_ERR_OVERFLOW;
+  }
+  /* the worst case padding of the arena is included */
+  *size = build_size(points_count) + GEO_BUILD_ALIGNMENT - 1;
+  return GEO_SUCCESS;
+}
+
+enum GeoResult TMPL_FUNC(geo_geometry_build_from_points)(
+    struct GeoArena* arena, struct TMPL_POINT const* points,
+    size_t points_count, struct TMPL_GEOMETRY* geometry) {
+  enum GeoResult result = GEO_SUCCESS;
+  struct TMPL_POINT* copies = NULL;
+  struct TMPL_SEGMENT* segments = NULL;
+  struct TMPL_SEGMENT** segment_pointers = NULL;
+  void* memory = NULL;
+  size_t size = 0;
+  bool is_closed = false;
+#ifndef GEO_UNSAFE
+  if (arena == NULL || points == NULL || geometry == NULL) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+  /* a closed input repeats its first point, the segments close the ring */
+  if (points_count > 1) {
+    TMPL_FUNC(geo_points_equal)(&points[0], &points[points_count - 1],
+                                &is_closed);
+    if (is_closed) {
+      --points_count;
+    }
+  }
+  if (points_count < 3) {
+    return GEO_ERR_TOO_SMALL;
+  }
+  result = TMPL_FUNC(geo_geometry_build_size)(points_count, &size);
+  if (result != GEO_SUCCESS) {
+    return result;
+  }
+  result = geo_arena_alloc(arena, build_size(points_count),
+                           GEO_BUILD_ALIGNMENT, &memory);
+  if (result != GEO_SUCCESS) {
+    return result;
+  }
+  copies = (struct TMPL_POINT*)memory;
+  segments = (struct TMPL_SEGMENT*)(void*)((unsigned char*)memory +
+                                           build_points_size(points_count));
+  segment_pointers = (struct TMPL_SEGMENT**)(void*)(segments + points_count);
+  memcpy(copies, points, points_count * sizeof(struct TMPL_POINT));
+  for (size_t iter = 0; iter < points_count; ++iter) {
+    segments[iter].start = &copies[iter];
+    segments[iter].end = &copies[iter + 1 < points_count ? iter + 1 : 0];
+    segment_pointers[iter] = &segments[iter];
+  }
+  geometry->segments = segment_pointers;
+  geometry->segments_count = points_count;
+  return GEO_SUCCESS;
+}
+
+/*
+ * temporary memory, from `allocator` or GEO_MALLOC when it is NULL.
+ */
+#ifndef GEO_UNSAFE
+static bool allocator_valid(struct GeoAllocator const* const allocator) {
+  return allocator == NULL ||
+         (allocator->allocate != NULL && allocator->release != NULL);
+}
+#endif
+
+static void* allocator_allocate(struct GeoAllocator const* const allocator,
+                                size_t size) {
+  if (allocator == NULL) {
+    return GEO_MALLOC(size);
+  }
+  return allocator->allocate(allocator->context, size);
+}
+
+static void allocator_release(struct GeoAllocator const* const allocator,
+                              void* memory, size_t size) {
+  if (memory == NULL) {
+    return;
+  }
+  if (allocator == NULL) {
+    GEO_FREE(memory);
+    return;
+  }
+  allocator->release(allocator->context, memory, size);
+}
+
+/*
+ * structure of arrays points.
+ */
+#ifndef GEO_SOA_BLOCK_SIZE
+#define GEO_SOA_BLOCK_SIZE 256
+#endif
+
+/* the fewest points a task of the parallel batch functions gets */
+#ifndef GEO_SOA_PARALLEL_SIZE
+#define GEO_SOA_PARALLEL_SIZE 4096
+#endif
+
+/* by x, then by y */
+static bool soa_less(struct TMPL_POINTS_SOA const* const points, size_t lhs,
+                     size_t rhs) {
+  GEO_STATS_ADD(convex_hull_comparisons, 1);
+  return points->xs[lhs] < points->xs[rhs] ||
+         (!(points->xs[rhs] < points->xs[lhs]) &&
+          points->ys[lhs] < points->ys[rhs]);
+}
+
+/* heap sort of point positions, in place and without recursion */
+static void soa_sift_down(struct TMPL_POINTS_SOA const* const points,
+                          size_t* order, size_t root, size_t count) {
+  size_t child = (2 * root) + 1;
+  while (child < count) {
+    size_t swap = 0;
+    if (child + 1 < count &&
+        soa_less(points, order[child], order[child + 1])) {
+      ++child;
+    }
+    if (!soa_less(points, order[root], order[child])) {
+      return;
+    }
+    swap = order[root];
+    order[root] = order[child];
+    order[child] = swap;
+    root = child;
+    child = (2 * root) + 1;
+  }
+}
+
+static void soa_sort(struct TMPL_POINTS_SOA const* const points,
+                     size_t* order, size_t count) {
+  for (size_t iter = count / 2; iter > 0; --iter) {
+    soa_sift_down(points, order, iter - 1, count);
+  }
+  for (size_t iter = count; iter > 1; --iter) {
+    size_t swap = order[0];
+    order[0] = order[iter - 1];
+    order[iter - 1] = swap;
+    soa_sift_down(points, order, 0, iter - 1);
+  }
+}
+
+static enum GeoOrientation soa_orientation(
+    struct TMPL_POINTS_SOA const* const points, size_t start, size_t end,
+    size_t point) {
+  struct TMPL_POINT first = {points->xs[start], points->ys[start]};
+  struct TMPL_POINT second = {points->xs[end], points->ys[end]};
+  struct TMPL_POINT third = {points->xs[point], points->ys[point]};
+  return orientation(&first, &second, &third);
+}
+
+/*
+ * andrew's monotone chain over the positions in `order`, sorted by x. the
+ * lower hull is built left to right then the upper hull right to left,
+ * popping every point that does not make a left turn. a point of the upper
+ * hull is pushed before the next point can pop it, so `convex_hull` needs
+ * `count + 1` positions even though the hull it returns fits in `count`.
+ */
+static size_t soa_chain(struct TMPL_POINTS_SOA const* const points,
+                        size_t const* order, size_t count,
+                        size_t* convex_hull) {
+  size_t size = 0;
+  size_t lower_size = 0;
+  for (size_t iter = 0; iter < count; ++iter) {
+    while (size >= 2 && soa_orientation(points, convex_hull[size - 2],
+                                        convex_hull[size - 1],
+                                        order[iter]) != LEFT) {
+      --size;
+    }
+    convex_hull[size++] = order[iter];
+  }
+  lower_size = size + 1;
+  for (size_t iter = count - 1; iter > 0; --iter) {
+    size_t point = order[iter - 1];
+    while (size >= lower_size &&
+           soa_orientation(points, convex_hull[size - 2],
+                           convex_hull[size - 1], point) != LEFT) {
+      --size;
+    }
+    if (iter > 1) {
+      convex_hull[size++] = point;
+    }
+  }
+  return size;
+}
+
+#define TMPL_HULL_BATCH TMPL_CONCAT(GeoHullBatch, GEO_TMPL_TYPE)
+
+struct TMPL_HULL_BATCH {
+  struct TMPL_POINTS_SOA const* points;
+  size_t* order;
+  size_t* chains;
+  size_t part_size;
+  size_t sizes[GEO_MAX_THREADS];
+};
+
+/* the hull of one part, in the part's own `count + 1` positions of chains */
+static void soa_hull_task(void* context, size_t index) {
+  struct TMPL_HULL_BATCH* batch = (struct TMPL_HULL_BATCH*)context;
+  size_t const begin = index * batch->part_size;
+  size_t const count = batch->points->count - begin < batch->part_size
+                           ? batch->points->count - begin
+                           : batch->part_size;
+  for (size_t iter = 0; iter < count; ++iter) {
+    batch->order[begin + iter] = begin + iter;
+  }
+  soa_sort(batch->points, batch->order + begin, count);
+  batch->sizes[index] = soa_chain(batch->points, batch->order + begin, count,
+                                  batch->chains + begin + index);
+}
+
+/*
+ * with an executor every part of the points gets its own hull in parallel.
+ * a point on the hull of all points is on the hull of its part, so the
+ * final hull is the hull of the part hulls.
+ */
+enum GeoResult UNTRACED_FUNC(geo_convex_hull_soa)(
+    struct TMPL_POINTS_SOA const* points, struct GeoExecutor const* executor,
+    struct GeoAllocator const* allocator, size_t* convex_hull,
+    size_t* convex_hull_size) {
+  struct TMPL_HULL_BATCH batch;
+  size_t parts = 0;
+  size_t count = 0;
+  size_t size = 0;
+  enum GeoResult result = GEO_SUCCESS;
+#ifndef GEO_UNSAFE
+  if (points == NULL || points->xs == NULL || points->ys == NULL ||
+      convex_hull == NULL || convex_hull_size == NULL ||
+      !executor_valid(executor) || !allocator_valid(allocator)) {
+    return GEO_ERR_NULL_POINTER;
+  }
+  if (points->count < 3) {
+    return GEO_ERR_TOO_SMALL;
+  }
+#endif
+  parts = parallel_parts(executor, points->count, GEO_SOA_PARALLEL_SIZE);
+  batch.part_size = (points->count + parts - 1) / parts;
+  parts = (points->count + batch.part_size - 1) / batch.part_size;
+  /* the order of every point, then a chain of `count + 1` for every part */
+  size = ((2 * points->count) + parts) * sizeof(size_t);
+  batch.order = (size_t*)allocator_allocate(allocator, size);
+  if (batch.order == NULL) {
+    return GEO_ERR_NO_MEMORY;
+  }
+  GEO_STATS_ADD(convex_hull_calls, 1);
+  batch.points = points;
+  batch.chains = batch.order + points->count;
+  result = geo_executor_run(executor, soa_hull_task, &batch, parts);
+  if (result != GEO_SUCCESS) {
+    allocator_release(allocator, batch.order, size);
+    return result;
+  }
+  if (parts > 1) {
+    for (size_t part = 0; part < parts; ++part) {
+      memcpy(batch.order + count,
+             batch.chains + (part * batch.part_size) + part,
+             batch.sizes[part] * sizeof(size_t));
+      count += batch.sizes[part];
+    }
+    soa_sort(points, batch.order, count);
+    batch.sizes[0] = soa_chain(points, batch.order, count, batch.chains);
+  }
+  memcpy(convex_hull, batch.chains, batch.sizes[0] * sizeof(size_t));
+  allocator_release(allocator, batch.order, size);
+  *convex_hull_size = batch.sizes[0];
+  return GEO_SUCCESS;
+}
+
+#undef TMPL_HULL_BATCH
+
+/*
+ * the ray cast of geo_point_in_geometry turned inside out: for a block of
+ * points at a time every edge is loaded once and run against all points of
+ * the block, which reads the coordinates with unit stride and keeps the
+ * loop over the points free of pointer chasing.
+ */
+/*
+ * the batch kernels. each body is inlined into one function per
+ * GeoSimdLevel so the compiler vectorizes it for that level, and
+ * `soa_kernels` points at the ones picked by geo_simd_select.
+ */
+#if defined(GEO_FLOATING_POINT) && !defined(GEO_STATS)
+/*
+ * ray_cast_edge without branches, which the early returns of equal() keep
+ * from vectorizing. for a zero rhs and the default epsilons equal() reduces
+ * to |cross| <= GEO_ABS_EPSILON: the relative test needs GEO_REL_EPSILON
+ * >= 1 and the ulps test only takes positive numbers below GEO_MAX_ULPS
+ * denormals. a NaN cross is not colinear and counts as LEFT, as in
+ * orientation(). stats builds keep the reference kernel for its counters.
+ */
+static GEO_SIMD_INLINE void soa_ray_cast_kernel(
+    struct TMPL_POINT const* const start, struct TMPL_POINT const* const end,
+    GEO_TMPL_TYPE const* xs, GEO_TMPL_TYPE const* ys, size_t count,
+    unsigned char* parity, unsigned char* on_edge) {
+  GEO_TMPL_TYPE const start_x = start->x;
+  GEO_TMPL_TYPE const start_y = start->y;
+  GEO_TMPL_TYPE const end_x = end->x;
+  GEO_TMPL_TYPE const end_y = end->y;
+  GEO_TMPL_TYPE const edge_x = end_x - start_x;
+  GEO_TMPL_TYPE const edge_y = end_y - start_y;
+  for (size_t iter = 0; iter < count; ++iter) {
+    GEO_TMPL_TYPE const cross = (edge_x * (ys[iter] - start_y)) -
+                                (edge_y * (xs[iter] - start_x));
+    GEO_TMPL_TYPE const dot =
+        ((start_x - xs[iter]) * (end_x - xs[iter])) +
+        ((start_y - ys[iter]) * (end_y - ys[iter]));
+    int const colinear = (cross <= (GEO_TMPL_TYPE)GEO_ABS_EPSILON) &
+                         (cross >= -(GEO_TMPL_TYPE)GEO_ABS_EPSILON);
+    int const orientation_p = (1 - (2 * (cross < GEO_ZERO))) * !colinear;
+    on_edge[iter] |= (unsigned char)(colinear & (dot <= GEO_ZERO));
+    parity[iter] ^= (unsigned char)((((end_y >= ys[iter]) -
+                                      (start_y >= ys[iter])) *
+                                     orientation_p) > 0);
+  }
+}
+#else
+static GEO_SIMD_INLINE void soa_ray_cast_kernel(
+    struct TMPL_POINT const* const start, struct TMPL_POINT const* const end,
+    GEO_TMPL_TYPE const* xs, GEO_TMPL_TYPE const* ys, size_t count,
+    unsigned char* parity, unsigned char* on_edge) {
+  for (size_t iter = 0; iter < count; ++iter) {
+    struct TMPL_POINT const point = {xs[iter], ys[iter]};
+    size_t intersections = 0;
+    on_edge[iter] |= ray_cast_edge(start, end, &point, &intersections);
+    parity[iter] ^= (unsigned char)intersections;
+  }
+}
+#endif
+
+static GEO_SIMD_INLINE void soa_distances_kernel(GEO_TMPL_TYPE const* xs,
+                                                 GEO_TMPL_TYPE const* ys,
+                                                 size_t count, GEO_TMPL_TYPE x,
+                                                 GEO_TMPL_TYPE y,
+                                                 GEO_TMPL_TYPE* distances) {
+  /* overflow is not checked, as documented, like squared_distance */
+  for (size_t iter = 0; iter < count; ++iter) {
+    GEO_TMPL_TYPE diff_x = xs[iter] - x;
+    GEO_TMPL_TYPE diff_y = ys[iter] - y;
+    distances[iter] = (diff_x * diff_x) + (diff_y * diff_y);
+  }
+}
+
+#define SOA_KERNELS(level, ...)                                              \
+  __VA_ARGS__ static void soa_ray_cast_##level(                              \
+      struct TMPL_POINT const* const start,                                  \
+      struct TMPL_POINT const* const end, GEO_TMPL_TYPE const* xs,           \
+      GEO_TMPL_TYPE const* ys, size_t count, unsigned char* parity,          \
+      unsigned char* on_edge) {                                              \
+    soa_ray_cast_kernel(start, end, xs, ys, count, parity, on_edge);         \
+  }                                                                          \
+  __VA_ARGS__ static void soa_distances_##level(                             \
+      GEO_TMPL_TYPE const* xs, GEO_TMPL_TYPE const* ys, size_t count,        \
+      GEO_TMPL_TYPE x, GEO_TMPL_TYPE y, GEO_TMPL_TYPE* distances) {          \
+    soa_distances_kernel(xs, ys, count, x, y, distances);                    \
+  }
+
+SOA_KERNELS(generic, )
+#ifdef GEO_SIMD_DISPATCH
+SOA_KERNELS(sse4_2, GEO_SIMD_TARGET("sse4.2,popcnt"))
+SOA_KERNELS(avx2, GEO_SIMD_TARGET("avx2,fma"))
+SOA_KERNELS(avx512, GEO_SIMD_TARGET("avx512f,avx512bw,avx512dq,avx512vl"))
+#endif
+#undef SOA_KERNELS
+
+#define TMPL_RAY_CAST_KERNEL TMPL_CONCAT(GeoRayCastKernel, GEO_TMPL_TYPE)
+#define TMPL_DISTANCES_KERNEL TMPL_CONCAT(GeoDistancesKernel, GEO_TMPL_TYPE)
+
+typedef void (*TMPL_RAY_CAST_KERNEL)(struct TMPL_POINT const* start,
+                                     struct TMPL_POINT const* end,
+                                     GEO_TMPL_TYPE const* xs,
+                                     GEO_TMPL_TYPE const* ys, size_t count,
+                                     unsigned char* parity,
+                                     unsigned char* on_edge);
+typedef void (*TMPL_DISTANCES_KERNEL)(GEO_TMPL_TYPE const* xs,
+                                      GEO_TMPL_TYPE const* ys, size_t count,
+                                      GEO_TMPL_TYPE x, GEO_TMPL_TYPE y,
+                                      GEO_TMPL_TYPE* distances);
+
+/*
+ * read and written with relaxed atomics, a batch call racing
+ * geo_simd_select runs the kernels of either level.
+ */
+static struct {
+  TMPL_RAY_CAST_KERNEL ray_cast;
+  TMPL_DISTANCES_KERNEL distances;
+} soa_kernels = {soa_ray_cast_generic, soa_distances_generic};
+
+enum GeoResult TMPL_FUNC(geo_simd_select)(enum GeoSimdLevel level) {
+  enum GeoSimdLevel supported = GEO_SIMD_GENERIC;
+  TMPL_RAY_CAST_KERNEL ray_cast = soa_ray_cast_generic;
+  TMPL_DISTANCES_KERNEL distances = soa_distances_generic;
+  geo_simd_level(&supported);
+  if (level > supported) {
+    return GEO_ERR_UNSUPPORTED;
+  }
+  switch (level) {
+#ifdef GEO_SIMD_DISPATCH
+    case GEO_SIMD_AVX512:
+      ray_cast = soa_ray_cast_avx512;
+      distances = soa_distances_avx512;
+      break;
+    case GEO_SIMD_AVX2:
+      ray_cast = soa_ray_cast_avx2;
+      distances = soa_distances_avx2;
+      break;
+    case GEO_SIMD_SSE4_2:
+      ray_cast = soa_ray_cast_sse4_2;
+      distances = soa_distances_sse4_2;
+      break;
+#endif
+    default:
+      break;
+  }
+  __atomic_store_n(&soa_kernels.ray_cast, ray_cast, __ATOMIC_RELAXED);
+  __atomic_store_n(&soa_kernels.distances, distances, __ATOMIC_RELAXED);
+  return GEO_SUCCESS;
+}
+
+#ifdef GEO_SIMD_DISPATCH
+/* picks the kernels once, before main */
+__attribute__((constructor)) static void soa_kernels_init(void) {
+  enum GeoSimdLevel level = GEO_SIMD_GENERIC;
+  geo_simd_level(&level);
+  TMPL_FUNC(geo_simd_select)(level);
+}
+#endif
+
+#define TMPL_SOA_BATCH TMPL_CONCAT(GeoSoaBatch, GEO_TMPL_TYPE)
+
+struct TMPL_SOA_BATCH {
+  struct TMPL_POINTS_SOA const* points;
+  struct TMPL_GEOMETRY const* geometry;
+  bool strict;
+  bool* is_inside;
+  size_t part_size;  // points per task, whole blocks
+};
+
+static void soa_in_geometry_task(void* context, size_t index) {
+  struct TMPL_SOA_BATCH const* batch = (struct TMPL_SOA_BATCH const*)context;
+  struct TMPL_GEOMETRY const* geometry = batch->geometry;
+  TMPL_RAY_CAST_KERNEL const ray_cast =
+      __atomic_load_n(&soa_kernels.ray_cast, __ATOMIC_RELAXED);
+  size_t const begin = index * batch->part_size;
+  size_t const end = batch->points->count - begin < batch->part_size
+                         ? batch->points->count
+                         : begin + batch->part_size;
+  unsigned char parity[GEO_SOA_BLOCK_SIZE];
+  unsigned char on_edge[GEO_SOA_BLOCK_SIZE];
+  for (size_t block = begin; block < end; block += GEO_SOA_BLOCK_SIZE) {
+    size_t block_size = end - block < GEO_SOA_BLOCK_SIZE ? end - block
+                                                         : GEO_SOA_BLOCK_SIZE;
+    GEO_TMPL_TYPE const* xs = batch->points->xs + block;
+    GEO_TMPL_TYPE const* ys = batch->points->ys + block;
+    memset(parity, 0, block_size);
+    memset(on_edge, 0, block_size);
+    for (size_t edge = 0; edge < geometry->segments_count; ++edge) {
+      struct TMPL_POINT const start = *geometry->segments[edge]->start;
+      struct TMPL_POINT const end_point = *geometry->segments[edge]->end;
+      ray_cast(&start, &end_point, xs, ys, block_size, parity, on_edge);
+    }
+    for (size_t iter = 0; iter < block_size; ++iter) {
+      batch->is_inside[block + iter] =
+          on_edge[iter] ? !batch->strict : parity[iter] & 1;
+    }
+  }
+}
+
+/* the points are split into parts of whole blocks, one task each */
+enum GeoResult UNTRACED_FUNC(geo_points_in_geometry_soa)(
+    struct TMPL_POINTS_SOA const* points, struct TMPL_GEOMETRY const* geometry,
+    bool strict, struct GeoExecutor const* executor, bool* is_inside) {
+  struct TMPL_SOA_BATCH batch;
+  size_t blocks_count = 0;
+  size_t parts = 0;
+#ifndef GEO_UNSAFE
+  if (points == NULL || geometry == NULL || geometry->segments == NULL ||
+      is_inside == NULL || !executor_valid(executor) ||
+      ((points->xs == NULL || points->ys == NULL) && points->count > 0)) {
+    return GEO_ERR_NULL_POINTER;
+  }
+  if (geometry->segments_count < 3) {
+    return GEO_ERR_TOO_SMALL;
+  }
+  for (size_t iter = 0; iter < geometry->segments_count; ++iter) {
+    if (geometry->segments[iter] == NULL ||
+        geometry->segments[iter]->start == NULL ||
+        geometry->segments[iter]->end == NULL) {
+      return GEO_ERR_NULL_POINTER;
+    }
+  }
+#endif
+  GEO_STATS_ADD(point_in_polygon_calls, points->count);
+  if (points->count == 0) {
+    return GEO_SUCCESS;
+  }
+  blocks_count = (points->count + GEO_SOA_BLOCK_SIZE - 1) / GEO_SOA_BLOCK_SIZE;
+  parts = parallel_parts(executor, points->count, GEO_SOA_PARALLEL_SIZE);
+  batch.points = points;
+  batch.geometry = geometry;
+  batch.strict = strict;
+  batch.is_inside = is_inside;
+  batch.part_size = ((blocks_count + parts - 1) / parts) * GEO_SOA_BLOCK_SIZE;
+  return geo_executor_run(executor, soa_in_geometry_task, &batch,
+                          (points->count + batch.part_size - 1) /
+                              batch.part_size);
+}
+
+#undef TMPL_SOA_BATCH
+
+enum GeoResult TMPL_FUNC(geo_squared_distance_soa)(
+    struct TMPL_POINTS_SOA const* points, struct TMPL_POINT const* point,
+    GEO_TMPL_TYPE* distances) {
+#ifndef GEO_UNSAFE
+  if (points == NULL || point == NULL ||
+      ((points->xs == NULL || points->ys == NULL || distances == NULL) &&
+       points->count > 0)) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+  __atomic_load_n(&soa_kernels.distances, __ATOMIC_RELAXED)(
+      points->xs, points->ys, points->count, point->x, point->y, distances);
+  return GEO_SUCCESS;
+}
+
+#undef TMPL_DISTANCES_KERNEL
+#undef TMPL_RAY_CAST_KERNEL
+
+/*
+ * spatial hash grid internals.
+ *
+ * slot state layout: [generation:30][tag:2][object id:32]. the generation is
+ * bumped every time a live slot is retired so a reader can detect that a slot
+ * was reused while it was copying the coordinates out (seqlock style).
+ */
+#ifndef GEO_GRID_TAG_EMPTY
+#define GEO_GRID_TAG_EMPTY 0U
+#define GEO_GRID_TAG_BUSY 1U
+#define GEO_GRID_TAG_LIVE 2U
+#define GEO_GRID_TAG_TOMB 3U
+#define GEO_GRID_STATE(gen, tag, id) \
+  (((uint64_t)(gen) << 34) | ((uint64_t)(tag) << 32) | (uint64_t)(id))
+#define GEO_GRID_STATE_GEN(state) ((state) >> 34)
+#define GEO_GRID_STATE_TAG(state) ((unsigned)(((state) >> 32) & 3U))
+#define GEO_GRID_STATE_ID(state) ((size_t)((state) & 0xFFFFFFFFU))
+#define GEO_GRID_MAX_CELL 4611686018427387904.0  // 2^62
+#endif
+
+static int64_t grid_cell(GEO_TMPL_TYPE value, GEO_TMPL_TYPE cell_size) {
+#ifdef GEO_FLOATING_POINT
+  double cell = floor((double)value / (double)cell_size);
+  /* clamp so the cast below is defined for huge or non finite values */
+  if (!(cell < GEO_GRID_MAX_CELL)) {
+    cell = GEO_GRID_MAX_CELL;
+  } else if (!(cell > -GEO_GRID_MAX_CELL)) {
+    cell = -GEO_GRID_MAX_CELL;
+  }
+  return (int64_t)cell;
+#else
+  GEO_TMPL_TYPE cell = value / cell_size;
+  /* c division truncates towards zero, cells are floored */
+  if ((value % cell_size) != 0 && value < 0) {
+    --cell;
+  }
+  return (int64_t)cell;
+#endif
+}
+
+static size_t grid_home(struct TMPL_GRID const* const grid, int64_t cell_x,
+                        int64_t cell_y) {
+  uint64_t hash = ((uint64_t)cell_x * 0x9E3779B97F4A7C15ULL) ^
+                  ((uint64_t)cell_y * 0xC2B2AE3D27D4EB4FULL);
+  hash ^= hash >> 29;
+  return (size_t)hash & (grid->slots_count - 1);
+}
+
+/*
+ * claims the first free (empty or tombstoned) slot probing from `home`,
+ * stores `point` in it, and publishes it as live for `id`. the slot is not
+ * reachable by queries until `objects[id]` points at it.
+ */
+static enum GeoResult grid_claim(struct TMPL_GRID* grid, size_t id,
+                                 struct TMPL_POINT const* const point,
+                                 size_t* index) {
+  size_t mask = grid->slots_count - 1;
+  size_t home = grid_home(grid, grid_cell(point->x, grid->cell_size),
+                          grid_cell(point->y, grid->cell_size));
+  for (size_t probe = 0; probe < grid->slots_count; ++probe) {
+    struct TMPL_GRID_SLOT* slot = &grid->slots[(home + probe) & mask];
+    uint64_t state = __atomic_load_n(&slot->state, __ATOMIC_ACQUIRE);
+    unsigned tag = GEO_GRID_STATE_TAG(state);
+    uint64_t busy = 0;
+    uint32_t max_probe = 0;
+    if (tag != GEO_GRID_TAG_EMPTY && tag != GEO_GRID_TAG_TOMB) {
+      continue;
+    }
+    busy =
+        GEO_GRID_STATE(GEO_GRID_STATE_GEN(state), GEO_GRID_TAG_BUSY, 0U);
+    if (!__atomic_compare_exchange_n(&slot->state, &state, busy, false,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+      continue;
+    }
+    /* pairs with the acquire fence in grid_read_slot */
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store(&slot->x, &point->x, __ATOMIC_RELAXED);
+    __atomic_store(&slot->y, &point->y, __ATOMIC_RELAXED);
+
+    max_probe = __atomic_load_n(&grid->slots[home].max_probe, __ATOMIC_RELAXED);
+    while (max_probe < (uint32_t)probe &&
+           !__atomic_compare_exchange_n(&grid->slots[home].max_probe,
+                                        &max_probe, (uint32_t)probe, false,
+                                        __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+    }
+    __atomic_store_n(
+        &slot->state,
+        GEO_GRID_STATE(GEO_GRID_STATE_GEN(state), GEO_GRID_TAG_LIVE, id),
+        __ATOMIC_RELEASE);
+    *index = (home + probe) & mask;
+    return GEO_SUCCESS;
+  }
+  return GEO_ERR_FULL;
+}
+
+/* only the thread that unlinked `index` from `objects` may retire it */
+static void grid_retire(struct TMPL_GRID* grid, size_t index) {
+  struct TMPL_GRID_SLOT* slot = &grid->slots[index];
+  uint64_t state = __atomic_load_n(&slot->state, __ATOMIC_ACQUIRE);
+  __atomic_store_n(
+      &slot->state,
+      GEO_GRID_STATE(GEO_GRID_STATE_GEN(state) + 1, GEO_GRID_TAG_TOMB, 0U),
+      __ATOMIC_RELEASE);
+}
+
+/*
+ * copies a consistent snapshot of a live slot. returns false when the slot is
+ * not live, was reused mid read, or is a stale entry of a moved object.
+ */
+static bool grid_read_slot(struct TMPL_GRID const* const grid, size_t index,
+                           size_t* id, struct TMPL_POINT* point) {
+  struct TMPL_GRID_SLOT* slot = &grid->slots[index];
+  uint64_t before = __atomic_load_n(&slot->state, __ATOMIC_ACQUIRE);
+  uint64_t after = 0;
+  if (GEO_GRID_STATE_TAG(before) != GEO_GRID_TAG_LIVE) {
+    return false;
+  }
+  __atomic_load(&slot->x, &point->x, __ATOMIC_RELAXED);
+  __atomic_load(&slot->y, &point->y, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  after = __atomic_load_n(&slot->state, __ATOMIC_RELAXED);
+  if (before != after) {
+    return false;
+  }
+  *id = GEO_GRID_STATE_ID(before);
+  return __atomic_load_n(&grid->objects[*id], __ATOMIC_ACQUIRE) == index;
+}
+
+static bool grid_accept(struct TMPL_POINT const* const point,
+                        struct TMPL_POINT const* const center,
+                        GEO_TMPL_TYPE radius_squared,
+                        struct TMPL_GEOMETRY const* const geometry,
+                        bool strict) {
+  bool is_inside = false;
+  if (geometry == NULL) {
+    return squared_distance(center, point) <= radius_squared;
+  }
+  return UNTRACED_FUNC(geo_point_in_geometry)(point, geometry, strict,
+                                          &is_inside) == GEO_SUCCESS &&
+         is_inside;
+}
+
+/*
+ * collects the ids of every live object inside the [min, max] envelope that
+ * passes grid_accept. falls back to a scan of the whole table when the
+ * envelope covers more cells than there are slots.
+ */
+static void grid_query(struct TMPL_GRID const* const grid,
+                       struct TMPL_POINT const* const min,
+                       struct TMPL_POINT const* const max,
+                       struct TMPL_POINT const* const center,
+                       GEO_TMPL_TYPE radius_squared,
+                       struct TMPL_GEOMETRY const* const geometry, bool strict,
+                       size_t* ids, size_t ids_capacity, size_t* ids_count) {
+  int64_t min_x = grid_cell(min->x, grid->cell_size);
+  int64_t min_y = grid_cell(min->y, grid->cell_size);
+  int64_t max_x = grid_cell(max->x, grid->cell_size);
+  int64_t max_y = grid_cell(max->y, grid->cell_size);
+  uint64_t span_x = (uint64_t)max_x - (uint64_t)min_x;
+  uint64_t span_y = (uint64_t)max_y - (uint64_t)min_y;
+  size_t mask = grid->slots_count - 1;
+  struct TMPL_POINT point;
+  size_t id = 0;
+
+  *ids_count = 0;
+  if (span_x >= grid->slots_count || span_y >= grid->slots_count ||
+      (span_x + 1) * (span_y + 1) > grid->slots_count) {
+    for (size_t index = 0; index < grid->slots_count; ++index) {
+      if (grid_read_slot(grid, index, &id, &point) &&
+          grid_accept(&point, center, radius_squared, geometry, strict)) {
+        if (*ids_count < ids_capacity) {
+          ids[*ids_count] = id;
+        }
+        ++(*ids_count);
+      }
+    }
+    return;
+  }
+
+  for (int64_t cell_x = min_x; cell_x <= max_x; ++cell_x) {
+    for (int64_t cell_y = min_y; cell_y <= max_y; ++cell_y) {
+      size_t home = grid_home(grid, cell_x, cell_y);
+      uint32_t max_probe =
+          __atomic_load_n(&grid->slots[home].max_probe, __ATOMIC_SEQ_CST);
+      for (size_t probe = 0; probe <= max_probe; ++probe) {
+        size_t index = (home + probe) & mask;
+        if (!grid_read_slot(grid, index, &id, &point)) {
+          continue;
+        }
+        /* probe chains are shared by every cell hashed nearby */
+        if (grid_cell(point.x, grid->cell_size) != cell_x ||
+            grid_cell(point.y, grid->cell_size) != cell_y) {
+          continue;
+        }
+        if (grid_accept(&point, center, radius_squared, geometry, strict)) {
+          if (*ids_count < ids_capacity) {
+            ids[*ids_count] = id;
+          }
+          ++(*ids_count);
+        }
+      }
+    }
+  }
+}
+
+enum GeoResult TMPL_FUNC(geo_grid_init)(struct TMPL_GRID* grid,
+                                        GEO_TMPL_TYPE cell_size,
+                                        struct TMPL_GRID_SLOT* slots,
+                                        size_t slots_count, size_t* objects,
+                                        size_t objects_count) {
+#ifndef GEO_UNSAFE
+  if (grid == NULL || slots == NULL || objects == NULL) {
+    return GEO_ERR_NULL_POINTER;
+  }
+  /* slots_count must be a power of 2 and at least one slot per object */
+  if (objects_count == 0 || slots_count < objects_count ||
+      (slots_count & (slots_count - 1)) != 0) {
+    return GEO_ERR_TOO_SMALL;
+  }
+  if (!(cell_size > GEO_ZERO) || objects_count > 0xFFFFFFFFU ||
+      slots_count > 0xFFFFFFFFU) {
+    return GEO_ERR_OUT_OF_RANGE;
+  }
+#endif
+  memset(slots, 0, slots_count * sizeof(struct TMPL_GRID_SLOT));
+  for (size_t iter = 0; iter < objects_count; ++iter) {
+    objects[iter] = GEO_GRID_NONE;
+  }
+  grid->slots = slots;
+  grid->slots_count = slots_count;
+  grid->objects = objects;
+  grid->objects_count = objects_count;
+  grid->cell_size = cell_size;
+  return GEO_SUCCESS;
+}
+
+enum GeoResult TMPL_FUNC(geo_grid_insert)(struct TMPL_GRID* grid, size_t id,
+                                          struct TMPL_POINT const* point,
+                                          bool* inserted) {
+  enum GeoResult result = GEO_SUCCESS;
+  size_t index = 0;
+  size_t expected = GEO_GRID_NONE;
+#ifndef GEO_UNSAFE
+  if (grid == NULL || grid->slots == NULL || point == NULL) {
+    return GEO_ERR_NULL_POINTER;
+  }
+  if (id >= grid->objects_count) {
+    return GEO_ERR_OUT_OF_RANGE;
+  }
+#endif
+  result = grid_claim(grid, id, point, &index);
+  if (result != GEO_SUCCESS) {
+    return result;
+  }
+  *inserted = __atomic_compare_exchange_n(&grid->objects[id], &expected, index,
+                                          false, __ATOMIC_SEQ_CST,
+                                          __ATOMIC_SEQ_CST);
+  if (!(*inserted)) {
+    /* already present, the claimed slot was never reachable */
+    grid_retire(grid, index);
+  }
+  return GEO_SUCCESS;
+}
+
+enum GeoResult TMPL_FUNC(geo_grid_move)(struct TMPL_GRID* grid, size_t id,
+                                        struct TMPL_POINT const* point,
+                                        bool* moved) {
+  enum GeoResult result = GEO_SUCCESS;
+  size_t index = 0;
+  size_t current = 0;
+#ifndef GEO_UNSAFE
+  if (grid == NULL || grid->slots == NULL || point == NULL) {
+    return GEO_ERR_NULL_POINTER;
+  }
+  if (id >= grid->objects_count) {
+    return GEO_ERR_OUT_OF_RANGE;
+  }
+#endif
+  result = grid_claim(grid, id, point, &index);
+  if (result != GEO_SUCCESS) {
+    return result;
+  }
+  /*
+   * the new slot becomes visible and the old one stale in the same atomic
+   * step, so a query never reports the object twice or not at all.
+   */
+  current = __atomic_load_n(&grid->objects[id], __ATOMIC_SEQ_CST);
+  do {
+    if (current == GEO_GRID_NONE) {
+      grid_retire(grid, index);
+      *moved = false;
+      return GEO_SUCCESS;
+    }
+  } while (!__atomic_compare_exchange_n(&grid->objects[id], &current, index,
+                                        false, __ATOMIC_SEQ_CST,
+                                        __ATOMIC_SEQ_CST));
+  grid_retire(grid, current);
+  *moved = true;
+  return GEO_SUCCESS;
+}
+
+enum GeoResult TMPL_FUNC(geo_grid_remove)(struct TMPL_GRID* grid, size_t id,
+                                          bool* removed) {
+  size_t current = 0;
+#ifndef GEO_UNSAFE
+  if (grid == NULL || grid->slots == NULL) {
+    return GEO_ERR_NULL_POINTER;
+  }
+  if (id >= grid->objects_count) {
+    return GEO_ERR_OUT_OF_RANGE;
+  }
+#endif
+  current =
+      __atomic_exchange_n(&grid->objects[id], GEO_GRID_NONE, __ATOMIC_SEQ_CST);
+  *removed = current != GEO_GRID_NONE;
+  if (*removed) {
+    grid_retire(grid, current);
+  }
+  return GEO_SUCCESS;
+}
+
+enum GeoResult TMPL_FUNC(geo_grid_query_radius)(
+    struct TMPL_GRID const* grid, struct TMPL_POINT const* center,
+    GEO_TMPL_TYPE radius, size_t* ids, size_t ids_capacity,
+    size_t* ids_count) {
+  struct TMPL_POINT min;
+  struct TMPL_POINT max;
+#ifndef GEO_UNSAFE
+  if (grid == NULL || grid->slots == NULL || center == NULL ||
+      (ids == NULL && ids_capacity > 0)) {
+    return GEO_ERR_NULL_POINTER;
+  }
+  if (radius < GEO_ZERO) {
+    return GEO_ERR_OUT_OF_RANGE;
+  }
+#endif
+  min.x = center->x - radius;
+  min.y = center->y - radius;
+  max.x = center->x + radius;
+  max.y = center->y + radius;
+  grid_query(grid, &min, &max, center, radius * radius, NULL, false, ids,
+             ids_capacity, ids_count);
+  return GEO_SUCCESS;
+}
+
+enum GeoResult TMPL_FUNC(geo_grid_query_geometry)(
+    struct TMPL_GRID const* grid, struct TMPL_GEOMETRY const* geometry,
+    bool strict, size_t* ids, size_t ids_capacity, size_t* ids_count) {
+  enum GeoResult result = GEO_SUCCESS;
+  struct TMPL_ENVELOPE envelope = {{GEO_ZERO, GEO_ZERO}, {GEO_ZERO, GEO_ZERO}};
+#ifndef GEO_UNSAFE
+  if (grid == NULL || grid->slots == NULL || geometry == NULL ||
+      geometry->segments == NULL || (ids == NULL && ids_capacity > 0)) {
+    return GEO_ERR_NULL_POINTER;
+  }
+  if (geometry->segments_count < 3) {
+    return GEO_ERR_TOO_SMALL;
+  }
+#endif
+  result = TMPL_FUNC(geo_geometry_envelope)(geometry, &envelope);
+  if (result != GEO_SUCCESS) {
+    return result;
+  }
+  grid_query(grid, &envelope.min, &envelope.max, NULL, GEO_ZERO, geometry,
+             strict, ids, ids_capacity, ids_count);
+  return GEO_SUCCESS;
+}
+
+/*
+ * space filling curve keys and key sorting internals.
+ *
+ * coordinates are quantized to 32 bits per axis over the envelope so every
+ * key is a 64 bit integer. the radix sort is an in place msd (american flag)
+ * sort, only the top level is split across threads.
+ */
+#ifndef GEO_SORT_INSERTION_SIZE
+#define GEO_SORT_INSERTION_SIZE 32
+#endif
+
+#ifndef GEO_SORT_PARALLEL_SIZE
+#define GEO_SORT_PARALLEL_SIZE 65536
+#endif
+
+static uint32_t quantize(GEO_TMPL_TYPE value, double min, double scale) {
+  double scaled = ((double)value - min) * scale;
+  /* written so nan ends up as 0 */
+  scaled = scaled > 0.0 ? scaled : 0.0;
+  scaled = scaled < 4294967295.0 ? scaled : 4294967295.0;
+  return (uint32_t)scaled;
+}
+
+static double quantize_scale(GEO_TMPL_TYPE min, GEO_TMPL_TYPE max) {
+  double width = (double)max - (double)min;
+  return width > 0.0 ? 4294967295.0 / width : 0.0;
+}
+
+static uint64_t spread_bits(uint32_t value) {
+  uint64_t bits = value;
+  bits = (bits | (bits << 16)) & 0x0000FFFF0000FFFFULL;
+  bits = (bits | (bits << 8)) & 0x00FF00FF00FF00FFULL;
+  bits = (bits | (bits << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+  bits = (bits | (bits << 2)) & 0x3333333333333333ULL;
+  bits = (bits | (bits << 1)) & 0x5555555555555555ULL;
+  return bits;
+}
+
+/*
+ * branch free hilbert index of a 2^32 x 2^32 grid. this is the prefix scan
+ * formulation from http://threadlocalmutex.com/?p=126 widened to 32 bits. it
+ * gives the same index as the classic `xy2d` loop.
+ */
+static uint64_t hilbert_index(uint32_t x, uint32_t y) {
+  uint32_t a = x ^ y;
+  uint32_t b = 0xFFFFFFFFU ^ a;
+  uint32_t c = 0xFFFFFFFFU ^ (x | y);
+  uint32_t d = x & (y ^ 0xFFFFFFFFU);
+  uint32_t state_a = a | (b >> 1);
+  uint32_t state_b = (a >> 1) ^ a;
+  uint32_t state_c = ((c >> 1) ^ (b & (d >> 1))) ^ c;
+  uint32_t state_d = ((a & (c >> 1)) ^ (d >> 1)) ^ d;
+  uint32_t index0 = 0;
+  uint32_t index1 = 0;
+
+  for (unsigned shift = 2; shift <= 8; shift <<= 1) {
+    a = state_a;
+    b = state_b;
+    c = state_c;
+    d = state_d;
+    state_a = (a & (a >> shift)) ^ (b & (b >> shift));
+    state_b = (a & (b >> shift)) ^ (b & ((a ^ b) >> shift));
+    state_c ^= (a & (c >> shift)) ^ (b & (d >> shift));
+    state_d ^= (b & (c >> shift)) ^ ((a ^ b) & (d >> shift));
+  }
+  a = state_a;
+  b = state_b;
+  c = state_c;
+  d = state_d;
+  state_c ^= (a & (c >> 16)) ^ (b & (d >> 16));
+  state_d ^= (b & (c >> 16)) ^ ((a ^ b) & (d >> 16));
+
+  a = state_c ^ (state_c >> 1);
+  b = state_d ^ (state_d >> 1);
+  index0 = x ^ y;
+  index1 = b | (0xFFFFFFFFU ^ (index0 | a));
+  return (spread_bits(index1) << 1) | spread_bits(index0);
+}
+
+static void sort_swap(uint64_t* keys, unsigned char* items, size_t item_size,
+                      size_t lhs, size_t rhs) {
+  unsigned char temp[sizeof(struct TMPL_POINT) + sizeof(void*)];
+  uint64_t key = keys[lhs];
+  keys[lhs] = keys[rhs];
+  keys[rhs] = key;
+  memcpy(temp, items + (lhs * item_size), item_size);
+  memcpy(items + (lhs * item_size), items + (rhs * item_size), item_size);
+  memcpy(items + (rhs * item_size), temp, item_size);
+}
+
+static void insertion_sort(uint64_t* keys, unsigned char* items,
+                           size_t item_size, size_t size) {
+  for (size_t iter = 1; iter < size; ++iter) {
+    for (size_t pos = iter; pos > 0 && keys[pos - 1] > keys[pos]; --pos) {
+      sort_swap(keys, items, item_size, pos - 1, pos);
+    }
+  }
+}
+
+/* counts how many keys fall into each byte value at `shift` */
+static void radix_histogram(uint64_t const* keys, size_t size, unsigned shift,
+                            size_t* counts) {
+  memset(counts, 0, 256 * sizeof(size_t));
+  for (size_t iter = 0; iter < size; ++iter) {
+    ++counts[(keys[iter] >> shift) & 0xFFU];
+  }
+}
+
+/*
+ * permutes the items into their byte buckets in place. `offsets` must have
+ * 257 entries and is filled with the start of each bucket.
+ */
+static void radix_permute(uint64_t* keys, unsigned char* items,
+                          size_t item_size, size_t const* counts,
+                          unsigned shift, size_t* offsets) {
+  size_t heads[256];
+  offsets[0] = 0;
+  for (size_t bucket = 0; bucket < 256; ++bucket) {
+    heads[bucket] = offsets[bucket];
+    offsets[bucket + 1] = offsets[bucket] + counts[bucket];
+  }
+  for (size_t bucket = 0; bucket < 256; ++bucket) {
+    while (heads[bucket] < offsets[bucket + 1]) {
+      size_t target = (keys[heads[bucket]] >> shift) & 0xFFU;
+      if (target == bucket) {
+        ++heads[bucket];
+      } else {
+        sort_swap(keys, items, item_size, heads[bucket], heads[target]);
+        ++heads[target];
+      }
+    }
+  }
+}
+
+static void radix_sort(uint64_t* keys, unsigned char* items, size_t item_size,
+                       size_t size, unsigned shift) {
+  size_t counts[256];
+  size_t offsets[257];
+  for (;;) {
+    if (size <= GEO_SORT_INSERTION_SIZE) {
+      insertion_sort(keys, items, item_size, size);
+      return;
+    }
+    radix_histogram(keys, size, shift, counts);
+    /* skip bytes every key shares, common for clustered data */
+    if (counts[(keys[0] >> shift) & 0xFFU] != size) {
+      break;
+    }
+    if (shift == 0) {
+      return;
+    }
+    shift -= 8;
+  }
+  radix_permute(keys, items, item_size, counts, shift, offsets);
+  if (shift == 0) {
+    return;
+  }
+  for (size_t bucket = 0; bucket < 256; ++bucket) {
+    if (counts[bucket] > 1) {
+      radix_sort(keys + offsets[bucket], items + (offsets[bucket] * item_size),
+                 item_size, counts[bucket], shift - 8);
+    }
+  }
+}
+
+struct GeoSortShared {
+  uint64_t* keys;
+  unsigned char* items;
+  size_t item_size;
+  size_t size;
+  unsigned shift;
+  size_t offsets[257];
+  size_t order[256];
+};
+
+struct GeoSortWorker {
+  struct GeoSortShared* shared;
+  size_t begin;
+  size_t end;
+  size_t counts[256];
+};
+
+static void radix_histogram_task(void* context, size_t index) {
+  struct GeoSortWorker* worker = &((struct GeoSortWorker*)context)[index];
+  radix_histogram(worker->shared->keys + worker->begin,
+                  worker->end - worker->begin, worker->shared->shift,
+                  worker->counts);
+}
+
+/* buckets are handed out largest first */
+static void radix_bucket_task(void* context, size_t index) {
+  struct GeoSortShared* shared = (struct GeoSortShared*)context;
+  size_t const bucket = shared->order[index];
+  size_t const begin = shared->offsets[bucket];
+  if (shared->offsets[bucket + 1] - begin > 1) {
+    radix_sort(shared->keys + begin,
+               shared->items + (begin * shared->item_size), shared->item_size,
+               shared->offsets[bucket + 1] - begin, shared->shift - 8);
+  }
+}
+
+static enum GeoResult parallel_radix_sort(
+    uint64_t* keys, unsigned char* items, size_t item_size, size_t size,
+    struct GeoExecutor const* const executor) {
+  enum GeoResult result = GEO_SUCCESS;
+  struct GeoSortShared shared;
+  struct GeoSortWorker workers[GEO_MAX_THREADS];
+  size_t counts[256];
+  size_t chunk = 0;
+  size_t const threads_count = parallel_parts(executor, size, 1);
+
+  if (threads_count < 2 || size < GEO_SORT_PARALLEL_SIZE) {
+    radix_sort(keys, items, item_size, size, 56);
+    return GEO_SUCCESS;
+  }
+  shared.keys = keys;
+  shared.items = items;
+  shared.item_size = item_size;
+  shared.size = size;
+  chunk = (size + threads_count - 1) / threads_count;
+  for (size_t iter = 0; iter < threads_count; ++iter) {
+    workers[iter].shared = &shared;
+    workers[iter].begin = iter * chunk < size ? iter * chunk : size;
+    workers[iter].end =
+        (iter + 1) * chunk < size ? (iter + 1) * chunk : size;
+  }
+
+  for (shared.shift = 56;; shared.shift -= 8) {
+    result = geo_executor_run(executor, radix_histogram_task, workers,
+                              threads_count);
+    if (result != GEO_SUCCESS) {
+      return result;
+    }
+    memset(counts, 0, sizeof(counts));
+    for (size_t iter = 0; iter < threads_count; ++iter) {
+      for (size_t bucket = 0; bucket < 256; ++bucket) {
+        counts[bucket] += workers[iter].counts[bucket];
+      }
+    }
+    if (counts[(keys[0] >> shared.shift) & 0xFFU] != size) {
+      break;
+    }
+    if (shared.shift == 0) {
+      return GEO_SUCCESS;
+    }
+  }
+
+  radix_permute(keys, items, item_size, counts, shared.shift, shared.offsets);
+  if (shared.shift == 0) {
+    return GEO_SUCCESS;
+  }
+  /* hand out the biggest buckets first so the threads finish together */
+  for (size_t iter = 0; iter < 256; ++iter) {
+    size_t pos = iter;
+    for (; pos > 0 && counts[shared.order[pos - 1]] < counts[iter]; --pos) {
+      shared.order[pos] = shared.order[pos - 1];
+    }
+    shared.order[pos] = iter;
+  }
+  return geo_executor_run(executor, radix_bucket_task, &shared, 256);
+}
+
+enum GeoResult TMPL_FUNC(geo_morton_key)(struct TMPL_POINT const* points,
+                                         size_t size,
+                                         struct TMPL_ENVELOPE const* envelope,
+                                         uint64_t* keys) {
+  double min_x = 0.0;
+  double min_y = 0.0;
+  double scale_x = 0.0;
+  double scale_y = 0.0;
+#ifndef GEO_UNSAFE
+  if (points == NULL || envelope == NULL || keys == NULL) {
+    return GEO_ERR_NULL_POINTER;
+  }
+  if (envelope->max.x < envelope->min.x || envelope->max.y < envelope->min.y) {
+    return GEO_ERR_OUT_OF_RANGE;
+  }
+#endif
+  min_x = (double)envelope->min.x;
+  min_y = (double)envelope->min.y;
+  scale_x = quantize_scale(envelope->min.x, envelope->max.x);
+  scale_y = quantize_scale(envelope->min.y, envelope->max.y);
+  for (size_t iter = 0; iter < size; ++iter) {
+    keys[iter] = spread_bits(quantize(points[iter].x, min_x, scale_x)) |
+                 (spread_bits(quantize(points[iter].y, min_y, scale_y)) << 1);
+  }
+  return GEO_SUCCESS;
+}
+
+enum GeoResult TMPL_FUNC(geo_hilbert_key)(struct TMPL_POINT const* points,
+                                          size_t size,
+                                          struct TMPL_ENVELOPE const* envelope,
+                                          uint64_t* keys) {
+  double min_x = 0.0;
+  double min_y = 0.0;
+  double scale_x = 0.0;
+  double scale_y = 0.0;
+#ifndef GEO_UNSAFE
+  if (points == NULL || envelope == NULL || keys == NULL) {
+    return GEO_ERR_NULL_POINTER;
+  }
+  if (envelope->max.x < envelope->min.x || envelope->max.y < envelope->min.y) {
+    return GEO_ERR_OUT_OF_RANGE;
+  }
+#endif
+  min_x = (double)envelope->min.x;
+  min_y = (double)envelope->min.y;
+  scale_x = quantize_scale(envelope->min.x, envelope->max.x);
+  scale_y = quantize_scale(envelope->min.y, envelope->max.y);
+  for (size_t iter = 0; iter < size; ++iter) {
+    keys[iter] = hilbert_index(quantize(points[iter].x, min_x, scale_x),
+                               quantize(points[iter].y, min_y, scale_y));
+  }
+  return GEO_SUCCESS;
+}
+
+enum GeoResult TMPL_FUNC(geo_sort_points_by_key)(
+    struct TMPL_POINT* points, uint64_t* keys, size_t size,
+    struct GeoExecutor const* executor) {
+#ifndef GEO_UNSAFE
+  if (points == NULL || keys == NULL || !executor_valid(executor)) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+  return parallel_radix_sort(keys, (unsigned char*)points,
+                             sizeof(struct TMPL_POINT), size, executor);
+}
+
+enum GeoResult TMPL_FUNC(geo_sort_geometries_by_key)(
+    struct TMPL_GEOMETRY** geometries, uint64_t* keys, size_t size,
+    struct GeoExecutor const* executor) {
+#ifndef GEO_UNSAFE
+  if (geometries == NULL || keys == NULL || !executor_valid(executor)) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+  return parallel_radix_sort(keys, (unsigned char*)geometries,
+                             sizeof(struct TMPL_GEOMETRY*), size, executor);
+}
+
+/*
+ * serialized spatial index internals.
+ *
+ * build lays the sections out as header | nodes | entries | points. the nodes
+ * are stored level by level with the root first. while building, the points
+ * section (at least 3 points per geometry) doubles as scratch space for the
+ * hilbert keys and the sort order so no memory is allocated.
+ */
+#ifdef GEO_FLOATING_POINT
+#define GEO_INDEX_COORDINATE_KIND 1U
+#else
+#define GEO_INDEX_COORDINATE_KIND 0U
+#endif
+
+#ifndef GEO_INDEX_MAX_DEPTH
+#define GEO_INDEX_MAX_DEPTH 64
+#endif
+
+struct GeoIndexLayout {
+  size_t levels_count;
+  size_t level_sizes[GEO_INDEX_MAX_DEPTH];  // leaf level first
+  size_t nodes_count;
+  size_t points_count;
+  size_t nodes_offset;
+  size_t entries_offset;
+  size_t points_offset;
+  size_t size;
+};
+
+static size_t index_align(size_t offset) {
+  return (offset + (GEO_INDEX_ALIGNMENT - 1)) &
+         ~(size_t)(GEO_INDEX_ALIGNMENT - 1);
+}
+
+static enum GeoResult index_layout(struct TMPL_GEOMETRY* const* geometries,
+                                   size_t count,
+                                   struct GeoIndexLayout* layout) {
+  size_t level_size = count;
+  layout->levels_count = 0;
+  layout->nodes_count = 0;
+  layout->points_count = 0;
+  for (size_t iter = 0; iter < count; ++iter) {
+#ifndef GEO_UNSAFE
+    if (geometries[iter] == NULL || geometries[iter]->segments == NULL) {
+      return GEO_ERR_NULL_POINTER;
+    }
+    if (geometries[iter]->segments_count < 3) {
+      return GEO_ERR_TOO_SMALL;
+    }
+    for (size_t segment = 0; segment < geometries[iter]->segments_count;
+         ++segment) {
+      if (geometries[iter]->segments[segment] == NULL ||
+          geometries[iter]->segments[segment]->start == NULL ||
+          geometries[iter]->segments[segment]->end == NULL) {
+        return GEO_ERR_NULL_POINTER;
+      }
+    }
+#endif
+    layout->points_count += geometries[iter]->segments_count + 1;
+  }
+  while (count > 0) {
+    level_size = (level_size + GEO_INDEX_NODE_SIZE - 1) / GEO_INDEX_NODE_SIZE;
+    layout->level_sizes[layout->levels_count++] = level_size;
+    layout->nodes_count += level_size;
+    if (level_size == 1) {
+      break;
+    }
+  }
+  layout->nodes_offset = index_align(sizeof(struct GeoIndexHeader));
+  layout->entries_offset = index_align(
+      layout->nodes_offset + layout->nodes_count * sizeof(struct TMPL_INDEX_NODE));
+  layout->points_offset = index_align(
+      layout->entries_offset + count * sizeof(struct TMPL_INDEX_ENTRY));
+  layout->size = index_align(layout->points_offset +
+                             layout->points_count * sizeof(struct TMPL_POINT));
+  return GEO_SUCCESS;
+}
+
+static void envelope_merge(struct TMPL_ENVELOPE* envelope,
+                           struct TMPL_ENVELOPE const* const other) {
+  envelope_extend(envelope, &other->min);
+  envelope_extend(envelope, &other->max);
+}
+
+static bool envelopes_intersect(struct TMPL_ENVELOPE const* const lhs,
+                                struct TMPL_ENVELOPE const* const rhs) {
+  return lhs->min.x <= rhs->max.x && rhs->min.x <= lhs->max.x &&
+         lhs->min.y <= rhs->max.y && rhs->min.y <= lhs->max.y;
+}
+
+/* ray cast over a ring of packed points whose last point repeats the first */
+static bool ring_contains(struct TMPL_POINT const* points, size_t count,
+                          struct TMPL_POINT const* const point, bool strict) {
+  size_t intersections = 0;
+  for (size_t iter = 1; iter < count; ++iter) {
+    if (ray_cast_edge(&points[iter - 1], &points[iter], point,
+                      &intersections)) {
+      return !strict;
+    }
+  }
+  return intersections & 1;
+}
+
+struct GeoIdsCollector {
+  size_t* ids;
+  size_t capacity;
+  size_t count;
+};
+
+static void collect_id(void* context, size_t id) {
+  struct GeoIdsCollector* collector = (struct GeoIdsCollector*)context;
+  if (collector->count < collector->capacity) {
+    collector->ids[collector->count] = id;
+  }
+  ++collector->count;
+}
+
+static bool index_section_fits(uint64_t offset, uint64_t count,
+                               size_t element_size, uint64_t size) {
+  return offset <= size && (offset % GEO_INDEX_ALIGNMENT) == 0 &&
+         count <= (size - offset) / element_size;
+}
+
+/*
+ * depth first search of the tree calling `visit` with the id of every match.
+ * `point` is NULL for envelope queries, otherwise each candidate is refined
+ * with a point in ring test. child ranges are checked as they are visited so
+ * a corrupt file can't read out of bounds.
+ */
+static enum GeoResult index_search(struct TMPL_INDEX const* index,
+                                   struct TMPL_ENVELOPE const* const envelope,
+                                   struct TMPL_POINT const* const point,
+                                   bool strict,
+                                   void (*visit)(void* context, size_t id),
+                                   void* context) {
+  size_t path[GEO_INDEX_MAX_DEPTH];
+  uint64_t next[GEO_INDEX_MAX_DEPTH];
+  size_t depth = 0;
+
+  if (index->nodes_count == 0 ||
+      !envelopes_intersect(&index->nodes[0].envelope, envelope)) {
+    return GEO_SUCCESS;
+  }
+  path[0] = 0;
+  next[0] = 0;
+  depth = 1;
+  while (depth > 0) {
+    struct TMPL_INDEX_NODE const* node = &index->nodes[path[depth - 1]];
+    uint64_t child = 0;
+    if (next[depth - 1] >= node->children_count) {
+      --depth;
+      continue;
+    }
+    child = node->first_child + next[depth - 1]++;
+    if (path[depth - 1] >= index->leaf_nodes_start) {
+      struct TMPL_INDEX_ENTRY const* entry = NULL;
+      if (child >= index->entries_count) {
+        return GEO_ERR_INVALID_FORMAT;
+      }
+      entry = &index->entries[child];
+      if (!envelopes_intersect(&entry->envelope, envelope)) {
+        continue;
+      }
+      if (point != NULL) {
+        if (entry->points_count < 4 ||
+            entry->first_point > index->points_count ||
+            entry->points_count > index->points_count - entry->first_point) {
+          return GEO_ERR_INVALID_FORMAT;
+        }
+        if (!ring_contains(&index->points[entry->first_point],
+                           (size_t)entry->points_count, point, strict)) {
+          continue;
+        }
+      }
+      visit(context, (size_t)entry->id);
+      continue;
+    }
+    /* children always come after their parent, which also rules out cycles */
+    if (child >= index->nodes_count || child <= path[depth - 1]) {
+      return GEO_ERR_INVALID_FORMAT;
+    }
+    if (!envelopes_intersect(&index->nodes[child].envelope, envelope)) {
+      continue;
+    }
+    if (depth == GEO_INDEX_MAX_DEPTH) {
+      return GEO_ERR_INVALID_FORMAT;
+    }
+    path[depth] = (size_t)child;
+    next[depth] = 0;
+    ++depth;
+  }
+  return GEO_SUCCESS;
+}
+
+enum GeoResult TMPL_FUNC(geo_index_build_size)(
+    struct TMPL_GEOMETRY* const* geometries, size_t count, size_t* size) {
+  enum GeoResult result = GEO_SUCCESS;
+  struct GeoIndexLayout layout;
+#ifndef GEO_UNSAFE
+  if ((geometries == NULL && count > 0) || size == NULL) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+  result = index_layout(geometries, count, &layout);
+  if (result != GEO_SUCCESS) {
+    return result;
+  }
+  *size = layout.size;
+  return GEO_SUCCESS;
+}
+
+/* the envelopes of step 1 of geo_index_build, one part of them per task */
+#define TMPL_INDEX_BUILD TMPL_CONCAT(GeoIndexBuild, GEO_TMPL_TYPE)
+
+struct TMPL_INDEX_BUILD {
+  struct TMPL_GEOMETRY* const* geometries;
+  struct TMPL_INDEX_ENTRY* entries;
+  size_t count;
+  size_t part_size;
+};
+
+static void index_envelope_task(void* context, size_t index) {
+  struct TMPL_INDEX_BUILD const* build = (struct TMPL_INDEX_BUILD*)context;
+  size_t const begin = index * build->part_size;
+  size_t const end = begin + build->part_size < build->count
+                         ? begin + build->part_size
+                         : build->count;
+  for (size_t iter = begin; iter < end; ++iter) {
+    TMPL_FUNC(geo_geometry_envelope)(build->geometries[iter],
+                                     &build->entries[iter].envelope);
+    build->entries[iter].id = iter;
+  }
+}
+
+enum GeoResult UNTRACED_FUNC(geo_index_build)(
+    struct TMPL_GEOMETRY* const* geometries, size_t count,
+    struct GeoExecutor const* executor, void* buffer, size_t buffer_size) {
+  enum GeoResult result = GEO_SUCCESS;
+  struct GeoIndexLayout layout;
+  unsigned char* bytes = (unsigned char*)buffer;
+  struct GeoIndexHeader* header = (struct GeoIndexHeader*)buffer;
+  struct TMPL_INDEX_NODE* nodes = NULL;
+  struct TMPL_INDEX_ENTRY* entries = NULL;
+  struct TMPL_POINT* points = NULL;
+  uint64_t* keys = NULL;
+  size_t* order = NULL;
+  struct TMPL_ENVELOPE total;
+  double scale_x = 0.0;
+  double scale_y = 0.0;
+  size_t level_start = 0;
+  size_t child_start = 0;
+  size_t point_offset = 0;
+  struct TMPL_INDEX_BUILD build;
+  size_t parts = 0;
+
+#ifndef GEO_UNSAFE
+  if ((geometries == NULL && count > 0) || buffer == NULL ||
+      !executor_valid(executor)) {
+    return GEO_ERR_NULL_POINTER;
+  }
+  if (((uintptr_t)buffer % GEO_INDEX_ALIGNMENT) != 0) {
+    return GEO_ERR_OUT_OF_RANGE;
+  }
+#endif
+  result = index_layout(geometries, count, &layout);
+  if (result != GEO_SUCCESS) {
+    return result;
+  }
+  if (buffer_size < layout.size) {
+    return GEO_ERR_TOO_SMALL;
+  }
+  /* zeroed so padding is deterministic and files diff cleanly */
+  memset(buffer, 0, layout.size);
+  nodes = (struct TMPL_INDEX_NODE*)(bytes + layout.nodes_offset);
+  entries = (struct TMPL_INDEX_ENTRY*)(bytes + layout.entries_offset);
+  points = (struct TMPL_POINT*)(bytes + layout.points_offset);
+  keys = (uint64_t*)(bytes + layout.points_offset);
+  order = (size_t*)(keys + count);
+
+  /* 1. envelopes in input order */
+  parts = parallel_parts(executor, count, GEO_SOA_PARALLEL_SIZE);
+  build.geometries = geometries;
+  build.entries = entries;
+  build.count = count;
+  build.part_size = (count + parts - 1) / parts;
+  result = geo_executor_run(executor, index_envelope_task, &build, parts);
+  if (result != GEO_SUCCESS) {
+    return result;
+  }
+  for (size_t iter = 0; iter < count; ++iter) {
+    if (iter == 0) {
+      total = entries[0].envelope;
+    }
+    envelope_merge(&total, &entries[iter].envelope);
+  }
+
+  /* 2. sort by hilbert key of the envelope centers */
+  if (count > 0) {
+    scale_x = quantize_scale(total.min.x, total.max.x);
+    scale_y = quantize_scale(total.min.y, total.max.y);
+  }
+  for (size_t iter = 0; iter < count; ++iter) {
+    struct TMPL_ENVELOPE const* envelope = &entries[iter].envelope;
+    GEO_TMPL_TYPE center_x =
+        envelope->min.x + ((envelope->max.x - envelope->min.x) / 2);
+    GEO_TMPL_TYPE center_y =
+        envelope->min.y + ((envelope->max.y - envelope->min.y) / 2);
+    keys[iter] =
+        hilbert_index(quantize(center_x, (double)total.min.x, scale_x),
+                      quantize(center_y, (double)total.min.y, scale_y));
+    order[iter] = iter;
+  }
+  result = parallel_radix_sort(keys, (unsigned char*)order, sizeof(size_t),
+                               count, executor);
+  if (result != GEO_SUCCESS) {
+    return result;
+  }
+
+  /* 3. apply the order to the entries one cycle at a time */
+  for (size_t iter = 0; iter < count; ++iter) {
+    struct TMPL_INDEX_ENTRY temp;
+    size_t current = iter;
+    if (order[iter] == iter) {
+      continue;
+    }
+    temp = entries[iter];
+    while (order[current] != iter) {
+      size_t source = order[current];
+      entries[current] = entries[source];
+      order[current] = current;
+      current = source;
+    }
+    entries[current] = temp;
+    order[current] = current;
+  }
+
+  /* 4. pack the vertices, this overwrites the keys and order */
+  for (size_t iter = 0; iter < count; ++iter) {
+    struct TMPL_GEOMETRY const* geometry = geometries[entries[iter].id];
+    entries[iter].first_point = point_offset;
+    entries[iter].points_count = geometry->segments_count + 1;
+    for (size_t segment = 0; segment < geometry->segments_count; ++segment) {
+      points[point_offset++] = *geometry->segments[segment]->start;
+    }
+    points[point_offset++] =
+        *geometry->segments[geometry->segments_count - 1]->end;
+  }
+
+  /* 5. nodes, bottom level up. the root ends up at index 0 */
+  level_start = layout.nodes_count;
+  for (size_t level = 0; level < layout.levels_count; ++level) {
+    size_t children_count = level == 0 ? count : layout.level_sizes[level - 1];
+    child_start = level_start;
+    level_start -= layout.level_sizes[level];
+    for (size_t iter = 0; iter < layout.level_sizes[level]; ++iter) {
+      struct TMPL_INDEX_NODE* node = &nodes[level_start + iter];
+      size_t first = iter * GEO_INDEX_NODE_SIZE;
+      size_t last = first + GEO_INDEX_NODE_SIZE < children_count
+                        ? first + GEO_INDEX_NODE_SIZE
+                        : children_count;
+      node->first_child = level == 0 ? first : child_start + first;
+      node->children_count = last - first;
+      for (size_t child = first; child < last; ++child) {
+        struct TMPL_ENVELOPE const* envelope =
+            level == 0 ? &entries[child].envelope
+                       : &nodes[child_start + child].envelope;
+        if (child == first) {
+          node->envelope = *envelope;
+        }
+        envelope_merge(&node->envelope, envelope);
+      }
+    }
+    if (level == 0) {
+      header->leaf_nodes_start = level_start;
+    }
+  }
+
+  memcpy(header->magic, "GEOINDEX", sizeof(header->magic));
+  header->version = GEO_INDEX_VERSION;
+  header->byte_order = GEO_INDEX_BYTE_ORDER;
+  header->coordinate_size = sizeof(GEO_TMPL_TYPE);
+  header->coordinate_kind = GEO_INDEX_COORDINATE_KIND;
+  header->node_size = GEO_INDEX_NODE_SIZE;
+  header->nodes_count = layout.nodes_count;
+  header->entries_count = count;
+  header->points_count = layout.points_count;
+  header->nodes_offset = layout.nodes_offset;
+  header->entries_offset = layout.entries_offset;
+  header->points_offset = layout.points_offset;
+  header->size = layout.size;
+  return GEO_SUCCESS;
+}
+
+/* everything but the points section, whose size depends on the flags */
+static enum GeoResult index_check_header(void const* data, size_t size) {
+  struct GeoIndexHeader const* header = (struct GeoIndexHeader const*)data;
+  if (size < sizeof(struct GeoIndexHeader) ||
+      memcmp(header->magic, "GEOINDEX", sizeof(header->magic)) != 0 ||
+      header->version != GEO_INDEX_VERSION ||
+      header->byte_order != GEO_INDEX_BYTE_ORDER ||
+      header->coordinate_size != sizeof(GEO_TMPL_TYPE) ||
+      header->coordinate_kind != GEO_INDEX_COORDINATE_KIND ||
+      (header->flags & ~GEO_INDEX_FLAG_COMPRESSED) != 0 ||
+      header->size > size ||
+      !index_section_fits(header->nodes_offset, header->nodes_count,
+                          sizeof(struct TMPL_INDEX_NODE), header->size) ||
+      !index_section_fits(header->entries_offset, header->entries_count,
+                          sizeof(struct TMPL_INDEX_ENTRY), header->size) ||
+      header->points_offset > header->size ||
+      (header->points_offset % GEO_INDEX_ALIGNMENT) != 0 ||
+      header->leaf_nodes_start > header->nodes_count ||
+      (header->nodes_count == 0) != (header->entries_count == 0)) {
+    return GEO_ERR_INVALID_FORMAT;
+  }
+  return GEO_SUCCESS;
+}
+
+enum GeoResult TMPL_FUNC(geo_index_open)(struct TMPL_INDEX* index,
+                                         void const* data, size_t size) {
+  enum GeoResult result = GEO_SUCCESS;
+  struct GeoIndexHeader const* header = (struct GeoIndexHeader const*)data;
+  unsigned char const* bytes = (unsigned char const*)data;
+#ifndef GEO_UNSAFE
+  if (index == NULL || data == NULL) {
+    return GEO_ERR_NULL_POINTER;
+  }
+  if (((uintptr_t)data % GEO_INDEX_ALIGNMENT) != 0) {
+    return GEO_ERR_OUT_OF_RANGE;
+  }
+#endif
+  result = index_check_header(data, size);
+  if (result != GEO_SUCCESS) {
+    return result;
+  }
+  if (header->flags & GEO_INDEX_FLAG_COMPRESSED) {
+    return GEO_ERR_UNSUPPORTED;
+  }
+  if (!index_section_fits(header->points_offset, header->points_count,
+                          sizeof(struct TMPL_POINT), header->size)) {
+    return GEO_ERR_INVALID_FORMAT;
+  }
+  index->nodes =
+      (struct TMPL_INDEX_NODE const*)(bytes + header->nodes_offset);
+  index->nodes_count = (size_t)header->nodes_count;
+  index->leaf_nodes_start = (size_t)header->leaf_nodes_start;
+  index->entries =
+      (struct TMPL_INDEX_ENTRY const*)(bytes + header->entries_offset);
+  index->entries_count = (size_t)header->entries_count;
+  index->points = (struct TMPL_POINT const*)(bytes + header->points_offset);
+  index->points_count = (size_t)header->points_count;
+  return GEO_SUCCESS;
+}
+
+enum GeoResult TMPL_FUNC(geo_index_query_envelope)(
+    struct TMPL_INDEX const* index, struct TMPL_ENVELOPE const* envelope,
+    size_t* ids, size_t ids_capacity, size_t* ids_count) {
+  enum GeoResult result = GEO_SUCCESS;
+  struct GeoIdsCollector collector;
+#ifndef GEO_UNSAFE
+  if (index == NULL || envelope == NULL || ids_count == NULL ||
+      (ids == NULL && ids_capacity > 0)) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+  collector.ids = ids;
+  collector.capacity = ids_capacity;
+  collector.count = 0;
+  result = index_search(index, envelope, NULL, false, collect_id, &collector);
+  *ids_count = collector.count;
+  return result;
+}
+
+enum GeoResult UNTRACED_FUNC(geo_index_query_point)(
+    struct TMPL_INDEX const* index, struct TMPL_POINT const* point,
+    bool strict, size_t* ids, size_t ids_capacity, size_t* ids_count) {
+  enum GeoResult result = GEO_SUCCESS;
+  struct TMPL_ENVELOPE envelope;
+  struct GeoIdsCollector collector;
+#ifndef GEO_UNSAFE
+  if (index == NULL || point == NULL || ids_count == NULL ||
+      (ids == NULL && ids_capacity > 0)) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+  envelope.min = *point;
+  envelope.max = *point;
+  collector.ids = ids;
+  collector.capacity = ids_capacity;
+  collector.count = 0;
+  result = index_search(index, &envelope, point, strict, collect_id, &collector);
+  *ids_count = collector.count;
+  return result;
+}
+
+enum GeoResult TMPL_FUNC(geo_index_ring)(struct TMPL_INDEX const* index,
+                                         size_t position,
+                                         struct TMPL_RING_VIEW* view) {
+  struct TMPL_INDEX_ENTRY const* entry = NULL;
+#ifndef GEO_UNSAFE
+  if (index == NULL || view == NULL) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+  if (position >= index->entries_count) {
+    return GEO_ERR_OUT_OF_RANGE;
+  }
+  entry = &index->entries[position];
+  if (entry->points_count < 4 || entry->first_point > index->points_count ||
+      entry->points_count > index->points_count - entry->first_point) {
+    return GEO_ERR_INVALID_FORMAT;
+  }
+  view->coordinates = &index->points[entry->first_point];
+  view->points_count = (size_t)entry->points_count;
+  return GEO_SUCCESS;
+}
+
+/*
+ * compressed points section. every coordinate is mapped to an integer key
+ * whose order matches the coordinate order (for floating point the sign and
+ * magnitude bits are folded so neighbouring values get neighbouring keys),
+ * then each axis is stored as the zigzag encoded difference to the previous
+ * point, 7 bits per byte. this is lossless for every type.
+ */
+static uint64_t index_coordinate_key(GEO_TMPL_TYPE value) {
+#if defined(GEO_FLOATING_POINT) && (GEO_TMPL_TYPE_SIZE == 64)
+  uint64_t bits = 0;
+  memcpy(&bits, &value, sizeof(bits));
+  return (bits >> 63) ? ~bits : bits | (1ULL << 63);
+#elif defined(GEO_FLOATING_POINT)
+  uint32_t bits = 0;
+  memcpy(&bits, &value, sizeof(bits));
+  return (bits >> 31) ? ~bits : bits | 0x80000000U;
+#else
+  return (uint64_t)(int64_t)value;
+#endif
+}
+
+static GEO_TMPL_TYPE index_coordinate_value(uint64_t key) {
+  GEO_TMPL_TYPE value;
+#if defined(GEO_FLOATING_POINT) && (GEO_TMPL_TYPE_SIZE == 64)
+  uint64_t bits = (key >> 63) ? key & ~(1ULL << 63) : ~key;
+  memcpy(&value, &bits, sizeof(bits));
+#elif defined(GEO_FLOATING_POINT)
+  uint32_t bits = (uint32_t)key;
+  bits = (bits >> 31) ? bits & 0x7FFFFFFFU : ~bits;
+  memcpy(&value, &bits, sizeof(bits));
+#else
+  value = (GEO_TMPL_TYPE)(int64_t)key;
+#endif
+  return value;
+}
+
+/* writes what fits in `capacity`, returns the offset after the whole varint */
+static size_t index_put_delta(unsigned char* out, size_t offset,
+                              size_t capacity, uint64_t key,
+                              uint64_t* previous) {
+  uint64_t delta = key - *previous;
+  uint64_t value = (delta << 1) ^ (0 - (delta >> 63));
+  *previous = key;
+  do {
+    unsigned char byte = (unsigned char)(value & 0x7FU);
+    value >>= 7;
+    if (value != 0) {
+      byte |= 0x80U;
+    }
+    if (offset < capacity) {
+      out[offset] = byte;
+    }
+    ++offset;
+  } while (value != 0);
+  return offset;
+}
+
+static bool index_get_delta(unsigned char const* in, size_t size,
+                            size_t* offset, uint64_t* previous) {
+  uint64_t value = 0;
+  for (unsigned shift = 0; shift < 64 && *offset < size; shift += 7) {
+    unsigned char byte = in[(*offset)++];
+    value |= (uint64_t)(byte & 0x7FU) << shift;
+    if ((byte & 0x80U) == 0) {
+      *previous += (value >> 1) ^ (0 - (value & 1));
+      return true;
+    }
+  }
+  return false;
+}
+
+/* compression keeps everything before the points section as it is */
+static bool index_points_last(struct GeoIndexHeader const* header) {
+  return header->nodes_offset + (header->nodes_count *
+                                 sizeof(struct TMPL_INDEX_NODE)) <=
+             header->points_offset &&
+         header->entries_offset + (header->entries_count *
+                                   sizeof(struct TMPL_INDEX_ENTRY)) <=
+             header->points_offset;
+}
+
+enum GeoResult TMPL_FUNC(geo_index_compress)(void const* data, size_t size,
+                                             void* buffer, size_t buffer_size,
+                                             size_t* compressed_size) {
+  enum GeoResult result = GEO_SUCCESS;
+  struct TMPL_INDEX index;
+  struct GeoIndexHeader const* header = (struct GeoIndexHeader const*)data;
+  struct GeoIndexHeader* out_header = (struct GeoIndexHeader*)buffer;
+  unsigned char* out = (unsigned char*)buffer;
+  uint64_t previous_x = 0;
+  uint64_t previous_y = 0;
+  size_t offset = 0;
+  size_t total = 0;
+#ifndef GEO_UNSAFE
+  if (data == NULL || compressed_size == NULL ||
+      (buffer == NULL && buffer_size > 0)) {
+    return GEO_ERR_NULL_POINTER;
+  }
+  if (((uintptr_t)buffer % GEO_INDEX_ALIGNMENT) != 0) {
+    return GEO_ERR_OUT_OF_RANGE;
+  }
+#endif
+  result = TMPL_FUNC(geo_index_open)(&index, data, size);
+  if (result != GEO_SUCCESS) {
+    return result;
+  }
+  if (!index_points_last(header)) {
+    return GEO_ERR_INVALID_FORMAT;
+  }
+  offset = (size_t)header->points_offset;
+  if (buffer_size >= offset) {
+    memcpy(buffer, data, offset);
+  }
+  for (size_t iter = 0; iter < index.points_count; ++iter) {
+    offset = index_put_delta(out, offset, buffer_size,
+                             index_coordinate_key(index.points[iter].x),
+                             &previous_x);
+    offset = index_put_delta(out, offset, buffer_size,
+                             index_coordinate_key(index.points[iter].y),
+                             &previous_y);
+  }
+  total = index_align(offset);
+  *compressed_size = total;
+  if (total > buffer_size) {
+    return GEO_ERR_TOO_SMALL;
+  }
+  memset(out + offset, 0, total - offset);
+  out_header->flags |= GEO_INDEX_FLAG_COMPRESSED;
+  out_header->size = total;
+  return GEO_SUCCESS;
+}
+
+enum GeoResult TMPL_FUNC(geo_index_decompress)(void const* data, size_t size,
+                                               void* buffer,
+                                               size_t buffer_size,
+                                               size_t* decompressed_size) {
+  enum GeoResult result = GEO_SUCCESS;
+  struct GeoIndexHeader const* header = (struct GeoIndexHeader const*)data;
+  struct GeoIndexHeader* out_header = (struct GeoIndexHeader*)buffer;
+  unsigned char const* in = (unsigned char const*)data;
+  struct TMPL_POINT* points = NULL;
+  uint64_t key_x = 0;
+  uint64_t key_y = 0;
+  size_t offset = 0;
+  size_t total = 0;
+#ifndef GEO_UNSAFE
+  if (data == NULL || decompressed_size == NULL ||
+      (buffer == NULL && buffer_size > 0)) {
+    return GEO_ERR_NULL_POINTER;
+  }
+  if (((uintptr_t)data % GEO_INDEX_ALIGNMENT) != 0 ||
+      ((uintptr_t)buffer % GEO_INDEX_ALIGNMENT) != 0) {
+    return GEO_ERR_OUT_OF_RANGE;
+  }
+#endif
+  result = index_check_header(data, size);
+  if (result != GEO_SUCCESS) {
+    return result;
+  }
+  if ((header->flags & GEO_INDEX_FLAG_COMPRESSED) == 0 ||
+      !index_points_last(header) ||
+      header->points_count > (SIZE_MAX - header->points_offset -
+                              GEO_INDEX_ALIGNMENT) /
+                                 sizeof(struct TMPL_POINT)) {
+    return GEO_ERR_INVALID_FORMAT;
+  }
+  offset = (size_t)header->points_offset;
+  total = index_align(offset + ((size_t)header->points_count *
+                                sizeof(struct TMPL_POINT)));
+  *decompressed_size = total;
+  if (total > buffer_size) {
+    return GEO_ERR_TOO_SMALL;
+  }
+  memset(buffer, 0, total);
+  memcpy(buffer, data, offset);
+  points = (struct TMPL_POINT*)(void*)((unsigned char*)buffer + offset);
+  for (size_t iter = 0; iter < header->points_count; ++iter) {
+    if (!index_get_delta(in, (size_t)header->size, &offset, &key_x) ||
+        !index_get_delta(in, (size_t)header->size, &offset, &key_y)) {
+      return GEO_ERR_INVALID_FORMAT;
+    }
+    points[iter].x = index_coordinate_value(key_x);
+    points[iter].y = index_coordinate_value(key_y);
+  }
+  out_header->flags &= ~GEO_INDEX_FLAG_COMPRESSED;
+  out_header->size = total;
+  return GEO_SUCCESS;
+}
+
+/*
+ * spatial join internals.
+ *
+ * with few geometries every point is checked against every envelope and
+ * refined with geo_point_in_geometry. otherwise the geometries are packed
+ * into a temporary index (the same one geo_index_build writes) whose packed
+ * rings make the refinement a walk over contiguous memory. the points are
+ * split into one contiguous range per thread.
+ */
+#define TMPL_JOIN TMPL_CONCAT(GeoJoin, GEO_TMPL_TYPE)
+#define TMPL_JOIN_WORKER TMPL_CONCAT(GeoJoinWorker, GEO_TMPL_TYPE)
+
+#ifndef GEO_JOIN_SCAN_SIZE
+#define GEO_JOIN_SCAN_SIZE 16
+#endif
+
+#ifndef GEO_JOIN_BUFFER_SIZE
+#define GEO_JOIN_BUFFER_SIZE 32
+#endif
+
+struct TMPL_JOIN {
+  struct TMPL_POINT const* points;
+  struct TMPL_GEOMETRY* const* geometries;
+  size_t geometries_count;
+  bool strict;
+  bool use_index;
+  struct TMPL_ENVELOPE envelopes[GEO_JOIN_SCAN_SIZE];
+  struct TMPL_INDEX index;
+  struct GeoJoinPair* pairs;
+  size_t pairs_capacity;
+  size_t pairs_count;
+  enum GeoResult result;
+};
+
+struct TMPL_JOIN_WORKER {
+  struct TMPL_JOIN* join;
+  size_t begin;
+  size_t end;
+  size_t point;
+  size_t* counts;  // NULL when collecting pairs
+  size_t buffered_count;
+  struct GeoJoinPair buffered[GEO_JOIN_BUFFER_SIZE];
+};
+
+/* reserves room for the buffered pairs with one atomic add */
+static void join_flush(struct TMPL_JOIN_WORKER* worker) {
+  struct TMPL_JOIN* join = worker->join;
+  size_t start = __atomic_fetch_add(&join->pairs_count, worker->buffered_count,
+                                    __ATOMIC_RELAXED);
+  for (size_t iter = 0; iter < worker->buffered_count; ++iter) {
+    if (start + iter < join->pairs_capacity) {
+      join->pairs[start + iter] = worker->buffered[iter];
+    }
+  }
+  worker->buffered_count = 0;
+}
+
+static void join_visit(void* context, size_t id) {
+  struct TMPL_JOIN_WORKER* worker = (struct TMPL_JOIN_WORKER*)context;
+  if (worker->counts != NULL) {
+    ++worker->counts[id];
+    return;
+  }
+  worker->buffered[worker->buffered_count].point = worker->point;
+  worker->buffered[worker->buffered_count].geometry = id;
+  if (++worker->buffered_count == GEO_JOIN_BUFFER_SIZE) {
+    join_flush(worker);
+  }
+}
+
+static void join_task(void* context, size_t index) {
+  struct TMPL_JOIN_WORKER* worker = &((struct TMPL_JOIN_WORKER*)context)[index];
+  struct TMPL_JOIN* join = worker->join;
+  struct TMPL_ENVELOPE envelope;
+  enum GeoResult result = GEO_SUCCESS;
+  bool is_inside = false;
+
+  for (worker->point = worker->begin; worker->point < worker->end;
+       ++worker->point) {
+    struct TMPL_POINT const* point = &join->points[worker->point];
+    envelope.min = *point;
+    envelope.max = *point;
+    if (join->use_index) {
+      result = index_search(&join->index, &envelope, point, join->strict,
+                            join_visit, worker);
+    } else {
+      for (size_t iter = 0; iter < join->geometries_count; ++iter) {
+        if (!envelopes_intersect(&join->envelopes[iter], &envelope)) {
+          continue;
+        }
+        result = UNTRACED_FUNC(geo_point_in_geometry)(
+            point, join->geometries[iter], join->strict, &is_inside);
+        if (result != GEO_SUCCESS) {
+          break;
+        }
+        if (is_inside) {
+          join_visit(worker, iter);
+        }
+      }
+    }
+    if (result != GEO_SUCCESS) {
+      join->result = result;
+      break;
+    }
+  }
+  if (worker->counts == NULL) {
+    join_flush(worker);
+  }
+}
+
+/*
+ * validates the inputs, prepares the scan envelopes or the index, and runs
+ * the workers. `counts` is NULL when collecting pairs.
+ */
+static enum GeoResult join_run(struct TMPL_JOIN* join, size_t points_count,
+                               struct GeoExecutor const* executor,
+                               struct GeoAllocator const* allocator,
+                               size_t* counts) {
+  struct TMPL_JOIN_WORKER* workers = NULL;
+  size_t* worker_counts = NULL;
+  size_t worker_counts_size = 0;
+  void* buffer = NULL;
+  size_t buffer_size = 0;
+  size_t chunk = 0;
+  enum GeoResult result = GEO_SUCCESS;
+  size_t const threads_count = parallel_parts(executor, points_count, 1);
+
+  join->use_index = join->geometries_count > GEO_JOIN_SCAN_SIZE;
+  join->result = GEO_SUCCESS;
+  join->pairs_count = 0;
+  if (join->use_index) {
+    result = TMPL_FUNC(geo_index_build_size)(join->geometries,
+                                             join->geometries_count,
+                                             &buffer_size);
+    if (result != GEO_SUCCESS) {
+      return result;
+    }
+    buffer = allocator_allocate(allocator, buffer_size);
+    if (buffer == NULL) {
+      return GEO_ERR_NO_MEMORY;
+    }
+    result = UNTRACED_FUNC(geo_index_build)(join->geometries,
+                                            join->geometries_count, executor,
+                                            buffer, buffer_size);
+    if (result == GEO_SUCCESS) {
+      result = TMPL_FUNC(geo_index_open)(&join->index, buffer, buffer_size);
+    }
+  } else {
+    for (size_t iter = 0; iter < join->geometries_count; ++iter) {
+#ifndef GEO_UNSAFE
+      if (join->geometries[iter] == NULL) {
+        return GEO_ERR_NULL_POINTER;
+      }
+#endif
+      result = TMPL_FUNC(geo_geometry_envelope)(join->geometries[iter],
+                                                &join->envelopes[iter]);
+      if (result != GEO_SUCCESS) {
+        return result;
+      }
+    }
+  }
+
+  workers = (struct TMPL_JOIN_WORKER*)allocator_allocate(
+      allocator, threads_count * sizeof(struct TMPL_JOIN_WORKER));
+  /* each extra thread counts into its own array, summed at the end */
+  if (counts != NULL && threads_count > 1) {
+    worker_counts_size =
+        (threads_count - 1) * join->geometries_count * sizeof(size_t);
+    worker_counts = (size_t*)allocator_allocate(allocator, worker_counts_size);
+    if (worker_counts != NULL) {
+      memset(worker_counts, 0, worker_counts_size);
+    }
+  }
+  if (result == GEO_SUCCESS &&
+      (workers == NULL ||
+       (counts != NULL && threads_count > 1 && worker_counts == NULL))) {
+    result = GEO_ERR_NO_MEMORY;
+  }
+  if (result == GEO_SUCCESS) {
+    chunk = (points_count + threads_count - 1) / threads_count;
+    for (size_t iter = 0; iter < threads_count; ++iter) {
+      workers[iter].join = join;
+      workers[iter].begin = iter * chunk < points_count ? iter * chunk
+                                                        : points_count;
+      workers[iter].end = (iter + 1) * chunk < points_count
+                              ? (iter + 1) * chunk
+                              : points_count;
+      workers[iter].buffered_count = 0;
+      workers[iter].counts =
+          counts == NULL ? NULL
+          : iter == 0    ? counts
+                         : worker_counts + ((iter - 1) * join->geometries_count);
+    }
+    if (counts != NULL && join->geometries_count > 0) {
+      memset(counts, 0, join->geometries_count * sizeof(size_t));
+    }
+    result = geo_executor_run(executor, join_task, workers, threads_count);
+    if (result == GEO_SUCCESS) {
+      result = join->result;
+    }
+  }
+  if (result == GEO_SUCCESS && worker_counts != NULL) {
+    for (size_t iter = 0; iter < (threads_count - 1) * join->geometries_count;
+         ++iter) {
+      counts[iter % join->geometries_count] += worker_counts[iter];
+    }
+  }
+  allocator_release(allocator, worker_counts, worker_counts_size);
+  allocator_release(allocator, workers,
+                    threads_count * sizeof(struct TMPL_JOIN_WORKER));
+  allocator_release(allocator, buffer, buffer_size);
+  return result;
+}
+
+enum GeoResult UNTRACED_FUNC(geo_spatial_join)(
+    struct TMPL_POINT const* points, size_t points_count,
+    struct TMPL_GEOMETRY* const* geometries, size_t geometries_count,
+    bool strict, struct GeoExecutor const* executor,
+    struct GeoAllocator const* allocator, struct GeoJoinPair* pairs,
+    size_t pairs_capacity, size_t* pairs_count) {
+  struct TMPL_JOIN join;
+  enum GeoResult result = GEO_SUCCESS;
+#ifndef GEO_UNSAFE
+  if ((points == NULL && points_count > 0) ||
+      (geometries == NULL && geometries_count > 0) || pairs_count == NULL ||
+      (pairs == NULL && pairs_capacity > 0) || !executor_valid(executor) ||
+      !allocator_valid(allocator)) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+  join.points = points;
+  join.geometries = geometries;
+  join.geometries_count = geometries_count;
+  join.strict = strict;
+  join.pairs = pairs;
+  join.pairs_capacity = pairs_capacity;
+  result = join_run(&join, points_count, executor, allocator, NULL);
+  if (result != GEO_SUCCESS) {
+    return result;
+  }
+  *pairs_count = join.pairs_count;
+  return GEO_SUCCESS;
+}
+
+enum GeoResult UNTRACED_FUNC(geo_spatial_join_count)(
+    struct TMPL_POINT const* points, size_t points_count,
+    struct TMPL_GEOMETRY* const* geometries, size_t geometries_count,
+    bool strict, struct GeoExecutor const* executor,
+    struct GeoAllocator const* allocator, size_t* counts) {
+  struct TMPL_JOIN join;
+#ifndef GEO_UNSAFE
+  if ((points == NULL && points_count > 0) ||
+      (geometries == NULL && geometries_count > 0) ||
+      (counts == NULL && geometries_count > 0) ||
+      !executor_valid(executor) || !allocator_valid(allocator)) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+  join.points = points;
+  join.geometries = geometries;
+  join.geometries_count = geometries_count;
+  join.strict = strict;
+  join.pairs = NULL;
+  join.pairs_capacity = 0;
+  return join_run(&join, points_count, executor, allocator, counts);
+}
+
+#undef TMPL_JOIN
+#undef TMPL_JOIN_WORKER
+/*
+ * ring views. points are copied out of the coordinates with memcpy so views
+ * over unaligned blobs are safe.
+ */
+static void view_point(struct TMPL_RING_VIEW const* const view, size_t index,
+                       struct TMPL_POINT* point) {
+  unsigned char const* coordinates =
+      (unsigned char const*)view->coordinates +
+      (index * 2 * sizeof(GEO_TMPL_TYPE));
+  memcpy(&point->x, coordinates, sizeof(GEO_TMPL_TYPE));
+  memcpy(&point->y, coordinates + sizeof(GEO_TMPL_TYPE), sizeof(GEO_TMPL_TYPE));
+}
+
+/* segment between the points `index` and `index + 1`, backed by `storage` */
+static void view_segment(struct TMPL_RING_VIEW const* const view, size_t index,
+                         struct TMPL_POINT* storage,
+                         struct TMPL_SEGMENT* segment) {
+  view_point(view, index, &storage[0]);
+  view_point(view, index + 1, &storage[1]);
+  segment->start = &storage[0];
+  segment->end = &storage[1];
+}
+
+static bool view_contains(struct TMPL_RING_VIEW const* const view,
+                          struct TMPL_POINT const* const point, bool strict) {
+  size_t intersections = 0;
+  struct TMPL_POINT start;
+  struct TMPL_POINT end;
+  GEO_STATS_ADD(point_in_polygon_calls, 1);
+  view_point(view, 0, &start);
+  for (size_t iter = 1; iter < view->points_count; ++iter) {
+    view_point(view, iter, &end);
+    if (ray_cast_edge(&start, &end, point, &intersections)) {
+      return !strict;
+    }
+    start = end;
+  }
+  return intersections & 1;
+}
+
+enum GeoResult TMPL_FUNC(geo_ring_view_envelope)(
+    struct TMPL_RING_VIEW const* view, struct TMPL_ENVELOPE* envelope) {
+  struct TMPL_POINT point;
+#ifndef GEO_UNSAFE
+  if (view == NULL || view->coordinates == NULL || envelope == NULL) {
+    return GEO_ERR_NULL_POINTER;
+  }
+  if (view->points_count < 4) {
+    return GEO_ERR_TOO_SMALL;
+  }
+#endif
+  view_point(view, 0, &envelope->min);
+  envelope->max = envelope->min;
+  for (size_t iter = 1; iter < view->points_count; ++iter) {
+    view_point(view, iter, &point);
+    envelope_extend(envelope, &point);
+  }
+  return GEO_SUCCESS;
+}
+
+enum GeoResult TMPL_FUNC(geo_ring_view_is_closed)(
+    struct TMPL_RING_VIEW const* view, bool* is_closed) {
+  struct TMPL_POINT first;
+  struct TMPL_POINT last;
+#ifndef GEO_UNSAFE
+  if (view == NULL || view->coordinates == NULL || is_closed == NULL) {
+    return GEO_ERR_NULL_POINTER;
+  }
+  if (view->points_count < 4) {
+    return GEO_ERR_TOO_SMALL;
+  }
+#endif
+  view_point(view, 0, &first);
+  view_point(view, view->points_count - 1, &last);
+  return TMPL_FUNC(geo_points_equal)(&first, &last, is_closed);
+}
+
+static struct TMPL_SEGMENT const* simple_view_segment(
+    void const* source, size_t index, struct TMPL_POINT* storage,
+    struct TMPL_SEGMENT* segment) {
+  view_segment((struct TMPL_RING_VIEW const*)source, index, storage, segment);
+  return segment;
+}
+
+enum GeoResult UNTRACED_FUNC(geo_ring_view_is_simple)(
+    struct TMPL_RING_VIEW const* view, bool* is_simple) {
+  return UNTRACED_FUNC(geo_ring_view_is_simple_parallel)(view, NULL,
+                                                         is_simple);
+}
+
+/* same checks as geo_geometry_is_simple with the segments read from the view */
+enum GeoResult UNTRACED_FUNC(geo_ring_view_is_simple_parallel)(
+    struct TMPL_RING_VIEW const* view, struct GeoExecutor const* executor,
+    bool* is_simple) {
+  struct TMPL_POINT storage[4];
+  struct TMPL_SEGMENT first;
+  struct TMPL_SEGMENT other;
+  size_t intersections = 0;
+  size_t segments_count = 0;
+  size_t parts = 0;
+#ifndef GEO_UNSAFE
+  if (view == NULL || view->coordinates == NULL || is_simple == NULL ||
+      !executor_valid(executor)) {
+    return GEO_ERR_NULL_POINTER;
+  }
+  if (view->points_count < 4) {
+    return GEO_ERR_TOO_SMALL;
+  }
+#endif
+  segments_count = view->points_count - 1;
+  *is_simple = false;
+  GEO_STATS_ADD(is_simple_calls, 1);
+  parts = parallel_parts(executor, segments_count, 1);
+  if (parts > 1 && segments_count >= GEO_SIMPLE_PARALLEL_SIZE) {
+    struct TMPL_SIMPLE_CHECK check;
+    check.source = view;
+    check.segment = simple_view_segment;
+    check.segments_count = segments_count;
+    return simple_run(&check, executor, parts, is_simple);
+  }
+
+  // the first segment touches its neighbours and nothing else.
+  view_segment(view, 0, &storage[0], &first);
+  for (size_t i = 1; i < segments_count; ++i) {
+    view_segment(view, i, &storage[2], &other);
+    GEO_STATS_ADD(is_simple_pairs, 1);
+    UNTRACED_FUNC(geo_segments_intersect)(&first, &other, &intersections);
+    if (intersections != ((i == 1 || i == segments_count - 1) ? 2U : 0U)) {
+      return GEO_SUCCESS;
+    }
+  }
+
+  for (size_t i = 1; i < segments_count - 1; ++i) {
+    view_segment(view, i, &storage[0], &first);
+    view_segment(view, i + 1, &storage[2], &other);
+    GEO_STATS_ADD(is_simple_pairs, 1);
+    UNTRACED_FUNC(geo_segments_intersect)(&first, &other, &intersections);
+    if (intersections != 2) {
+      return GEO_SUCCESS;
+    }
+    for (size_t j = (i + 2); j < segments_count; ++j) {
+      view_segment(view, j, &storage[2], &other);
+      GEO_STATS_ADD(is_simple_pairs, 1);
+      UNTRACED_FUNC(geo_segments_intersect)(&first, &other, &intersections);
+      if (intersections != 0) {
+        return GEO_SUCCESS;
+      }
+    }
+  }
+  *is_simple = true;
+  return GEO_SUCCESS;
+}
+
+enum GeoResult UNTRACED_FUNC(geo_point_in_ring_view)(
+    struct TMPL_POINT const* point, struct TMPL_RING_VIEW const* view,
+    bool strict, bool* is_inside) {
+#ifndef GEO_UNSAFE
+  if (point == NULL || view == NULL || view->coordinates == NULL ||
+      is_inside == NULL) {
+    return GEO_ERR_NULL_POINTER;
+  }
+  if (view->points_count < 4) {
+    return GEO_ERR_TOO_SMALL;
+  }
+#endif
+  *is_inside = view_contains(view, point, strict);
+  return GEO_SUCCESS;
+}
+
+enum GeoResult TMPL_FUNC(geo_ring_view_in_ring_view)(
+    struct TMPL_RING_VIEW const* parent, struct TMPL_RING_VIEW const* child,
+    bool strict, bool* is_inside) {
+  struct TMPL_POINT point;
+#ifndef GEO_UNSAFE
+  if (parent == NULL || parent->coordinates == NULL || child == NULL ||
+      child->coordinates == NULL || is_inside == NULL) {
+    return GEO_ERR_NULL_POINTER;
+  }
+  if (parent->points_count < 4 || child->points_count < 4) {
+    return GEO_ERR_TOO_SMALL;
+  }
+#endif
+  for (size_t iter = 0; iter < child->points_count; ++iter) {
+    view_point(child, iter, &point);
+    *is_inside = view_contains(parent, &point, strict);
+    if (!(*is_inside)) {
+      return GEO_SUCCESS;
+    }
+  }
+  return GEO_SUCCESS;
+}
+
+/*
+ * inside the outer ring and outside every hole. the boundary of a hole is the
+ * boundary of the polygon so it follows `strict` the same way the outer ring
+ * does.
+ */
+enum GeoResult UNTRACED_FUNC(geo_point_in_polygon_view)(
+    struct TMPL_POINT const* point, struct TMPL_POLYGON_VIEW const* polygon,
+    bool strict, bool* is_inside) {
+#ifndef GEO_UNSAFE
+  if (point == NULL || polygon == NULL || polygon->rings == NULL ||
+      is_inside == NULL) {
+    return GEO_ERR_NULL_POINTER;
+  }
+  if (polygon->rings_count == 0) {
+    return GEO_ERR_TOO_SMALL;
+  }
+  for (size_t iter = 0; iter < polygon->rings_count; ++iter) {
+    if (polygon->rings[iter].coordinates == NULL) {
+      return GEO_ERR_NULL_POINTER;
+    }
+    if (polygon->rings[iter].points_count < 4) {
+      return GEO_ERR_TOO_SMALL;
+    }
+  }
+#endif
+  *is_inside = view_contains(&polygon->rings[0], point, strict);
+  for (size_t iter = 1; *is_inside && iter < polygon->rings_count; ++iter) {
+    /* strictly inside a hole is outside, on its boundary follows `strict` */
+    if (view_contains(&polygon->rings[iter], point, true)) {
+      *is_inside = false;
+    } else if (view_contains(&polygon->rings[iter], point, false)) {
+      *is_inside = !strict;
+    }
+  }
+  return GEO_SUCCESS;
+}
+
+#if defined(GEO_FLOATING_POINT) && (GEO_TMPL_TYPE_SIZE == 64)
+/*
+ * zero copy WKB reader. only 2D Polygon and MultiPolygon geometries are read,
+ * in the ISO/OGC encoding or as EWKB with an embedded SRID (which is skipped).
+ * coordinates are referenced in place, so the blob has to use the host byte
+ * order, a blob in the other order returns GEO_ERR_UNSUPPORTED.
+ */
+#ifndef GEO_WKB_EWKB_Z
+#define GEO_WKB_EWKB_Z 0x80000000U
+#define GEO_WKB_EWKB_M 0x40000000U
+#define GEO_WKB_EWKB_SRID 0x20000000U
+#endif
+
+struct GeoWkbReader {
+  unsigned char const* data;
+  size_t size;
+  size_t offset;
+  unsigned char host_order;
+  struct TMPL_POLYGON_VIEW* polygons;
+  size_t polygons_capacity;
+  size_t polygons_count;
+  struct TMPL_RING_VIEW* rings;
+  size_t rings_capacity;
+  size_t rings_count;
+};
+
+static enum GeoResult wkb_read_u32(struct GeoWkbReader* reader,
+                                   uint32_t* value) {
+  if (reader->size - reader->offset < sizeof(uint32_t)) {
+    return GEO_ERR_INVALID_FORMAT;
+  }
+  memcpy(value, reader->data + reader->offset, sizeof(uint32_t));
+  reader->offset += sizeof(uint32_t);
+  return GEO_SUCCESS;
+}
+
+static enum GeoResult wkb_read_header(struct GeoWkbReader* reader,
+                                      uint32_t* type) {
+  enum GeoResult result = GEO_SUCCESS;
+  uint32_t srid = 0;
+  if (reader->offset == reader->size) {
+    return GEO_ERR_INVALID_FORMAT;
+  }
+  if (reader->data[reader->offset] > 1) {
+    return GEO_ERR_INVALID_FORMAT;
+  }
+  if (reader->data[reader->offset] != reader->host_order) {
+    return GEO_ERR_UNSUPPORTED;
+  }
+  ++reader->offset;
+  result = wkb_read_u32(reader, type);
+  if (result != GEO_SUCCESS) {
+    return result;
+  }
+  if (*type & (GEO_WKB_EWKB_Z | GEO_WKB_EWKB_M)) {
+    return GEO_ERR_UNSUPPORTED;
+  }
+  if (*type & GEO_WKB_EWKB_SRID) {
+    *type &= ~GEO_WKB_EWKB_SRID;
+    result = wkb_read_u32(reader, &srid);
+    if (result != GEO_SUCCESS) {
+      return result;
+    }
+  }
+  /* ISO Z, M and ZM types are 1000 + type, 2000 + type and 3000 + type */
+  if (*type >= 1000U && *type < 4000U) {
+    return GEO_ERR_UNSUPPORTED;
+  }
+  return GEO_SUCCESS;
+}
+
+/* polygon body: number of rings, then every ring as a count and its points */
+static enum GeoResult wkb_read_polygon(struct GeoWkbReader* reader) {
+  enum GeoResult result = GEO_SUCCESS;
+  uint32_t rings_count = 0;
+  uint32_t points_count = 0;
+  size_t first_ring = reader->rings_count;
+  size_t point_size = 2 * sizeof(GEO_TMPL_TYPE);
+
+  result = wkb_read_u32(reader, &rings_count);
+  if (result != GEO_SUCCESS) {
+    return result;
+  }
+  for (uint32_t iter = 0; iter < rings_count; ++iter) {
+    result = wkb_read_u32(reader, &points_count);
+    if (result != GEO_SUCCESS) {
+      return result;
+    }
+    if (points_count > (reader->size - reader->offset) / point_size) {
+      return GEO_ERR_INVALID_FORMAT;
+    }
+    if (reader->rings_count < reader->rings_capacity) {
+      reader->rings[reader->rings_count].coordinates =
+          reader->data + reader->offset;
+      reader->rings[reader->rings_count].points_count = points_count;
+    }
+    ++reader->rings_count;
+    reader->offset += points_count * point_size;
+  }
+  if (reader->polygons_count < reader->polygons_capacity) {
+    reader->polygons[reader->polygons_count].rings =
+        first_ring < reader->rings_capacity ? &reader->rings[first_ring]
+                                            : NULL;
+    reader->polygons[reader->polygons_count].rings_count = rings_count;
+  }
+  ++reader->polygons_count;
+  return GEO_SUCCESS;
+}
+
+enum GeoResult TMPL_FUNC(geo_wkb_read)(
+    void const* blob, size_t size, struct TMPL_POLYGON_VIEW* polygons,
+    size_t polygons_capacity, size_t* polygons_count,
+    struct TMPL_RING_VIEW* rings, size_t rings_capacity, size_t* rings_count) {
+  enum GeoResult result = GEO_SUCCESS;
+  struct GeoWkbReader reader;
+  uint32_t type = 0;
+  uint32_t parts_count = 0;
+  uint32_t one = 1;
+#ifndef GEO_UNSAFE
+  if (blob == NULL || polygons_count == NULL || rings_count == NULL ||
+      (polygons == NULL && polygons_capacity > 0) ||
+      (rings == NULL && rings_capacity > 0)) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+  reader.data = (unsigned char const*)blob;
+  reader.size = size;
+  reader.offset = 0;
+  /* WKB byte order flag, 0 is big endian and 1 little endian */
+  memcpy(&reader.host_order, &one, 1);
+  reader.polygons = polygons;
+  reader.polygons_capacity = polygons_capacity;
+  reader.polygons_count = 0;
+  reader.rings = rings;
+  reader.rings_capacity = rings_capacity;
+  reader.rings_count = 0;
+
+  result = wkb_read_header(&reader, &type);
+  if (result == GEO_SUCCESS && type == GEO_SHAPE_POLYGON) {
+    result = wkb_read_polygon(&reader);
+  } else if (result == GEO_SUCCESS && type == GEO_SHAPE_MULTI_POLYGON) {
+    result = wkb_read_u32(&reader, &parts_count);
+    for (uint32_t iter = 0; result == GEO_SUCCESS && iter < parts_count;
+         ++iter) {
+      result = wkb_read_header(&reader, &type);
+      if (result == GEO_SUCCESS && type != GEO_SHAPE_POLYGON) {
+        result = GEO_ERR_INVALID_FORMAT;
+      }
+      if (result == GEO_SUCCESS) {
+        result = wkb_read_polygon(&reader);
+      }
+    }
+  } else if (result == GEO_SUCCESS) {
+    result = GEO_ERR_UNSUPPORTED;
+  }
+  if (result == GEO_SUCCESS && reader.offset != reader.size) {
+    result = GEO_ERR_INVALID_FORMAT;
+  }
+  if (result != GEO_SUCCESS) {
+    return result;
+  }
+
+  *polygons_count = reader.polygons_count;
+  *rings_count = reader.rings_count;
+  if (reader.polygons_count > polygons_capacity ||
+      reader.rings_count > rings_capacity) {
+    return GEO_ERR_TOO_SMALL;
+  }
+  return GEO_SUCCESS;
+}
+
+/*
+ * ESRI Shapefile polygons. the .shx file is a fixed size record per shape
+ * giving its offset in the .shp file, so record N is found in O(1). every
+ * polygon record starts with its bounding box, then the number of parts and
+ * points, the index of the first point of every part and the points as
+ * little endian doubles. parts are referenced in place, so like WKB the
+ * reader needs a little endian host. a polygon is every part taken together
+ * with the even-odd rule: outer rings are clockwise, holes counterclockwise
+ * and a point is inside when it is inside an odd number of parts.
+ */
+#ifndef GEO_SHP_FILE_CODE
+#define GEO_SHP_FILE_CODE 9994
+#define GEO_SHP_VERSION 1000
+#define GEO_SHP_HEADER_SIZE 100
+#define GEO_SHP_NULL 0
+#define GEO_SHP_POLYGON 5
+#define GEO_SHP_POLYGON_Z 15
+#define GEO_SHP_POLYGON_M 25
+#endif
+
+/* the file code, lengths and offsets are big endian */
+static uint32_t shp_read_be32(unsigned char const* data) {
+  return ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) |
+         ((uint32_t)data[2] << 8) | (uint32_t)data[3];
+}
+
+static uint32_t shp_read_le32(unsigned char const* data) {
+  return ((uint32_t)data[3] << 24) | ((uint32_t)data[2] << 16) |
+         ((uint32_t)data[1] << 8) | (uint32_t)data[0];
+}
+
+static bool shp_is_polygon(uint32_t type) {
+  return type == GEO_SHP_POLYGON || type == GEO_SHP_POLYGON_Z ||
+         type == GEO_SHP_POLYGON_M;
+}
+
+static enum GeoResult shp_check_header(unsigned char const* data,
+                                       size_t size) {
+  if (size < GEO_SHP_HEADER_SIZE ||
+      shp_read_be32(data) != GEO_SHP_FILE_CODE ||
+      shp_read_le32(data + 28) != GEO_SHP_VERSION ||
+      (size_t)shp_read_be32(data + 24) * 2 != size) {
+    return GEO_ERR_INVALID_FORMAT;
+  }
+  return GEO_SUCCESS;
+}
+
+/*
+ * content of a record, after its 8 byte header. null shapes return
+ * GEO_SUCCESS with a NULL `content`.
+ */
+static enum GeoResult shp_record(struct GeoShpFile const* file, size_t record,
+                                 unsigned char const** content,
+                                 size_t* content_size) {
+  unsigned char const* entry = NULL;
+  size_t offset = 0;
+  uint32_t type = 0;
+  if (record >= file->records_count) {
+    return GEO_ERR_OUT_OF_RANGE;
+  }
+  entry = file->shx + GEO_SHP_HEADER_SIZE + (record * 8);
+  offset = (size_t)shp_read_be32(entry) * 2;
+  *content_size = (size_t)shp_read_be32(entry + 4) * 2;
+  if (offset < GEO_SHP_HEADER_SIZE || offset > file->shp_size - 8 ||
+      *content_size < sizeof(uint32_t) ||
+      *content_size > file->shp_size - 8 - offset) {
+    return GEO_ERR_INVALID_FORMAT;
+  }
+  *content = file->shp + offset + 8;
+  type = shp_read_le32(*content);
+  if (type == GEO_SHP_NULL) {
+    *content = NULL;
+  } else if (type != file->shape_type) {
+    return GEO_ERR_INVALID_FORMAT;
+  }
+  return GEO_SUCCESS;
+}
+
+/*
+ * box, parts and points of a polygon record. a part ends where the next one
+ * starts and every part has to be a closed ring.
+ */
+static enum GeoResult shp_polygon(unsigned char const* content,
+                                  size_t content_size, uint32_t* parts_count,
+                                  uint32_t* points_count,
+                                  unsigned char const** points) {
+  uint32_t start = 0;
+  uint32_t end = 0;
+  if (content_size < 44) {
+    return GEO_ERR_INVALID_FORMAT;
+  }
+  *parts_count = shp_read_le32(content + 36);
+  *points_count = shp_read_le32(content + 40);
+  if (*parts_count == 0 ||
+      *parts_count > (content_size - 44) / sizeof(uint32_t) ||
+      *points_count > (content_size - 44 - (*parts_count * sizeof(uint32_t))) /
+                          (2 * sizeof(GEO_TMPL_TYPE))) {
+    return GEO_ERR_INVALID_FORMAT;
+  }
+  if (shp_read_le32(content + 44) != 0) {
+    return GEO_ERR_INVALID_FORMAT;
+  }
+  for (uint32_t iter = 0; iter < *parts_count; ++iter) {
+    start = shp_read_le32(content + 44 + (iter * sizeof(uint32_t)));
+    end = iter + 1 < *parts_count
+              ? shp_read_le32(content + 44 + ((iter + 1) * sizeof(uint32_t)))
+              : *points_count;
+    if (end < start || end - start < 4 || end > *points_count) {
+      return GEO_ERR_INVALID_FORMAT;
+    }
+  }
+  *points = content + 44 + (*parts_count * sizeof(uint32_t));
+  return GEO_SUCCESS;
+}
+
+static void shp_part(unsigned char const* content, uint32_t parts_count,
+                     uint32_t points_count, unsigned char const* points,
+                     uint32_t part, struct TMPL_RING_VIEW* view) {
+  uint32_t start = shp_read_le32(content + 44 + (part * sizeof(uint32_t)));
+  uint32_t end =
+      part + 1 < parts_count
+          ? shp_read_le32(content + 44 + ((part + 1) * sizeof(uint32_t)))
+          : points_count;
+  view->coordinates = points + (start * 2 * sizeof(GEO_TMPL_TYPE));
+  view->points_count = end - start;
+}
+
+enum GeoResult TMPL_FUNC(geo_shp_open)(struct GeoShpFile* file,
+                                       void const* shp, size_t shp_size,
+                                       void const* shx, size_t shx_size) {
+  enum GeoResult result = GEO_SUCCESS;
+  uint32_t one = 1;
+  unsigned char host_order = 0;
+#ifndef GEO_UNSAFE
+  if (file == NULL || shp == NULL || shx == NULL) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+  result = shp_check_header((unsigned char const*)shp, shp_size);
+  if (result == GEO_SUCCESS) {
+    result = shp_check_header((unsigned char const*)shx, shx_size);
+  }
+  if (result == GEO_SUCCESS && (shx_size - GEO_SHP_HEADER_SIZE) % 8 != 0) {
+    result = GEO_ERR_INVALID_FORMAT;
+  }
+  if (result != GEO_SUCCESS) {
+    return result;
+  }
+  memcpy(&host_order, &one, 1);
+  if (host_order != 1 ||
+      !shp_is_polygon(shp_read_le32((unsigned char const*)shp + 32))) {
+    return GEO_ERR_UNSUPPORTED;
+  }
+  file->shp = (unsigned char const*)shp;
+  file->shp_size = shp_size;
+  file->shx = (unsigned char const*)shx;
+  file->shx_size = shx_size;
+  file->shape_type = shp_read_le32(file->shp + 32);
+  file->records_count = (shx_size - GEO_SHP_HEADER_SIZE) / 8;
+  return GEO_SUCCESS;
+}
+
+enum GeoResult TMPL_FUNC(geo_shp_record_envelope)(
+    struct GeoShpFile const* file, size_t record,
+    struct TMPL_ENVELOPE* envelope) {
+  enum GeoResult result = GEO_SUCCESS;
+  unsigned char const* content = NULL;
+  size_t content_size = 0;
+#ifndef GEO_UNSAFE
+  if (file == NULL || envelope == NULL) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+  result = shp_record(file, record, &content, &content_size);
+  if (result != GEO_SUCCESS) {
+    return result;
+  }
+  if (content == NULL) {
+    return GEO_ERR_TOO_SMALL;
+  }
+  if (content_size < 36) {
+    return GEO_ERR_INVALID_FORMAT;
+  }
+  memcpy(&envelope->min.x, content + 4, sizeof(GEO_TMPL_TYPE));
+  memcpy(&envelope->min.y, content + 12, sizeof(GEO_TMPL_TYPE));
+  memcpy(&envelope->max.x, content + 20, sizeof(GEO_TMPL_TYPE));
+  memcpy(&envelope->max.y, content + 28, sizeof(GEO_TMPL_TYPE));
+  return GEO_SUCCESS;
+}
+
+enum GeoResult TMPL_FUNC(geo_shp_record_rings)(struct GeoShpFile const* file,
+                                               size_t record,
+                                               struct TMPL_RING_VIEW* rings,
+                                               size_t rings_capacity,
+                                               size_t* rings_count) {
+  enum GeoResult result = GEO_SUCCESS;
+  unsigned char const* content = NULL;
+  unsigned char const* points = NULL;
+  size_t content_size = 0;
+  uint32_t parts_count = 0;
+  uint32_t points_count = 0;
+#ifndef GEO_UNSAFE
+  if (file == NULL || rings_count == NULL ||
+      (rings == NULL && rings_capacity > 0)) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+  result = shp_record(file, record, &content, &content_size);
+  if (result != GEO_SUCCESS) {
+    return result;
+  }
+  if (content == NULL) {
+    *rings_count = 0;
+    return GEO_SUCCESS;
+  }
+  result =
+      shp_polygon(content, content_size, &parts_count, &points_count, &points);
+  if (result != GEO_SUCCESS) {
+    return result;
+  }
+  *rings_count = parts_count;
+  if (parts_count > rings_capacity) {
+    return GEO_ERR_TOO_SMALL;
+  }
+  for (uint32_t iter = 0; iter < parts_count; ++iter) {
+    shp_part(content, parts_count, points_count, points, iter, &rings[iter]);
+  }
+  return GEO_SUCCESS;
+}
+
+enum GeoResult TMPL_FUNC(geo_point_in_shp_record)(
+    struct TMPL_POINT const* point, struct GeoShpFile const* file,
+    size_t record, bool strict, bool* is_inside) {
+  enum GeoResult result = GEO_SUCCESS;
+  struct TMPL_ENVELOPE envelope;
+  struct TMPL_RING_VIEW view;
+  struct TMPL_POINT start;
+  struct TMPL_POINT end;
+  unsigned char const* content = NULL;
+  unsigned char const* points = NULL;
+  size_t content_size = 0;
+  size_t intersections = 0;
+  uint32_t parts_count = 0;
+  uint32_t points_count = 0;
+#ifndef GEO_UNSAFE
+  if (point == NULL || file == NULL || is_inside == NULL) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+  result = shp_record(file, record, &content, &content_size);
+  if (result != GEO_SUCCESS) {
+    return result;
+  }
+  *is_inside = false;
+  if (content == NULL) {
+    return GEO_SUCCESS;
+  }
+  result =
+      shp_polygon(content, content_size, &parts_count, &points_count, &points);
+  if (result != GEO_SUCCESS) {
+    return result;
+  }
+  /* the record's box rejects most points without reading its points */
+  memcpy(&envelope, content + 4, sizeof(envelope));
+  if (point->x < envelope.min.x || point->x > envelope.max.x ||
+      point->y < envelope.min.y || point->y > envelope.max.y) {
+    return GEO_SUCCESS;
+  }
+  /* even-odd over the edges of every part, see above */
+  for (uint32_t part = 0; part < parts_count; ++part) {
+    shp_part(content, parts_count, points_count, points, part, &view);
+    view_point(&view, 0, &start);
+    for (size_t iter = 1; iter < view.points_count; ++iter) {
+      view_point(&view, iter, &end);
+      if (ray_cast_edge(&start, &end, point, &intersections)) {
+        *is_inside = !strict;
+        return GEO_SUCCESS;
+      }
+      start = end;
+    }
+  }
+  *is_inside = intersections & 1;
+  return GEO_SUCCESS;
+}
+
+/*
+ * FlatGeobuf. after the magic bytes comes the size prefixed header, then the
+ * packed hilbert R-tree and the size prefixed features, all of them
+ * flatbuffers. the tree is stored level by level with the root first, every
+ * node is a box and an offset: the position of its first child for inner
+ * nodes, the byte offset of the feature (from the start of the features) for
+ * leaves. the leaves are in feature order, so leaf i locates feature i.
+ * coordinates are little endian doubles read in place, like WKB this needs a
+ * little endian host. flatbuffer reads are bounds checked against the buffer
+ * they belong to so a corrupt file can't read out of bounds.
+ */
+#ifndef GEO_FGB_MAGIC_SIZE
+#define GEO_FGB_MAGIC_SIZE 8
+#define GEO_FGB_NODE_SIZE 40
+#endif
+
+struct GeoFgbTable {
+  unsigned char const* data;
+  size_t size;
+  size_t position;
+  size_t vtable_size;
+  size_t vtable;
+};
+
+static bool fgb_u32(unsigned char const* data, size_t size, size_t position,
+                    uint32_t* value) {
+  if (size < sizeof(uint32_t) || position > size - sizeof(uint32_t)) {
+    return false;
+  }
+  memcpy(value, data + position, sizeof(uint32_t));
+  return true;
+}
+
+static bool fgb_table(unsigned char const* data, size_t size, size_t position,
+                      struct GeoFgbTable* table) {
+  int32_t vtable_offset = 0;
+  uint16_t vtable_size = 0;
+  if (!fgb_u32(data, size, position, (uint32_t*)(void*)&vtable_offset)) {
+    return false;
+  }
+  /* the vtable is at table - offset and may come before or after the table */
+  if ((vtable_offset > 0 && (size_t)vtable_offset > position) ||
+      (vtable_offset < 0 &&
+       (size_t)(-(int64_t)vtable_offset) > size - position)) {
+    return false;
+  }
+  table->data = data;
+  table->size = size;
+  table->position = position;
+  table->vtable = (size_t)((int64_t)position - vtable_offset);
+  if (table->vtable > size - sizeof(uint16_t)) {
+    return false;
+  }
+  memcpy(&vtable_size, data + table->vtable, sizeof(vtable_size));
+  table->vtable_size = vtable_size;
+  return table->vtable_size >= 4 && table->vtable_size <= size - table->vtable;
+}
+
+/* position of a field in the buffer, 0 when the field is absent */
+static size_t fgb_field(struct GeoFgbTable const* table, size_t field) {
+  uint16_t offset = 0;
+  if (4 + (field * 2) + 2 > table->vtable_size) {
+    return 0;
+  }
+  memcpy(&offset, table->data + table->vtable + 4 + (field * 2),
+         sizeof(offset));
+  return offset == 0 ? 0 : table->position + offset;
+}
+
+/* scalars keep `value` as their default when absent */
+static bool fgb_scalar(struct GeoFgbTable const* table, size_t field,
+                       void* value, size_t value_size) {
+  size_t position = fgb_field(table, field);
+  if (position == 0) {
+    return true;
+  }
+  if (position > table->size || value_size > table->size - position) {
+    return false;
+  }
+  memcpy(value, table->data + position, value_size);
+  return true;
+}
+
+/* target of an offset field, 0 when absent */
+static bool fgb_reference(unsigned char const* data, size_t size,
+                          size_t position, size_t* target) {
+  uint32_t offset = 0;
+  if (!fgb_u32(data, size, position, &offset) || offset > size - position) {
+    return false;
+  }
+  *target = position + offset;
+  return true;
+}
+
+static bool fgb_vector(struct GeoFgbTable const* table, size_t field,
+                       size_t element_size, size_t* elements,
+                       size_t* length) {
+  size_t position = fgb_field(table, field);
+  uint32_t count = 0;
+  *elements = 0;
+  *length = 0;
+  if (position == 0) {
+    return true;
+  }
+  if (!fgb_reference(table->data, table->size, position, &position) ||
+      !fgb_u32(table->data, table->size, position, &count)) {
+    return false;
+  }
+  *elements = position + sizeof(uint32_t);
+  *length = count;
+  return count <= (table->size - *elements) / element_size;
+}
+
+/* root table of a size prefixed flatbuffer at `position` */
+static bool fgb_root(unsigned char const* data, size_t size, size_t position,
+                     struct GeoFgbTable* table) {
+  uint32_t buffer_size = 0;
+  size_t root = 0;
+  if (!fgb_u32(data, size, position, &buffer_size) ||
+      buffer_size > size - position - sizeof(uint32_t)) {
+    return false;
+  }
+  data += position + sizeof(uint32_t);
+  return fgb_reference(data, buffer_size, 0, &root) &&
+         fgb_table(data, buffer_size, root, table);
+}
+
+/* level sizes from the leaves up, like the packed R-tree of the writer */
+static bool fgb_levels(uint64_t features_count, uint16_t node_size,
+                       size_t* level_sizes, size_t* levels_count,
+                       uint64_t* nodes_count) {
+  uint64_t level_size = features_count;
+  uint64_t total = features_count;
+  *levels_count = 0;
+  if (features_count > SIZE_MAX / GEO_FGB_NODE_SIZE) {
+    return false;
+  }
+  level_sizes[(*levels_count)++] = (size_t)level_size;
+  do {
+    level_size = (level_size + node_size - 1) / node_size;
+    if (*levels_count == GEO_INDEX_MAX_DEPTH) {
+      return false;
+    }
+    level_sizes[(*levels_count)++] = (size_t)level_size;
+    total += level_size;
+  } while (level_size != 1);
+  *nodes_count = total;
+  return true;
+}
+
+static void fgb_node(struct GeoFgbFile const* file, size_t position,
+                     struct TMPL_ENVELOPE* envelope, uint64_t* offset) {
+  unsigned char const* node =
+      file->data + file->index_offset + (position * GEO_FGB_NODE_SIZE);
+  memcpy(&envelope->min.x, node, sizeof(GEO_TMPL_TYPE));
+  memcpy(&envelope->min.y, node + 8, sizeof(GEO_TMPL_TYPE));
+  memcpy(&envelope->max.x, node + 16, sizeof(GEO_TMPL_TYPE));
+  memcpy(&envelope->max.y, node + 24, sizeof(GEO_TMPL_TYPE));
+  memcpy(offset, node + 32, sizeof(uint64_t));
+}
+
+struct GeoFgbReader {
+  struct TMPL_POLYGON_VIEW* polygons;
+  size_t polygons_capacity;
+  size_t polygons_count;
+  struct TMPL_RING_VIEW* rings;
+  size_t rings_capacity;
+  size_t rings_count;
+  /* set for point queries, the rings are tested instead of collected */
+  struct TMPL_POINT const* point;
+  bool strict;
+  bool is_inside;
+};
+
+/* rings of a polygon are slices of `xy`, `ends` has the end of every ring */
+static enum GeoResult fgb_read_polygon(struct GeoFgbTable const* geometry,
+                                       struct GeoFgbReader* reader) {
+  struct TMPL_RING_VIEW view;
+  size_t ends = 0;
+  size_t rings_count = 0;
+  size_t xy = 0;
+  size_t points_count = 0;
+  size_t first_ring = reader->rings_count;
+  uint32_t start = 0;
+  uint32_t end = 0;
+  bool is_inside = false;
+  if (!fgb_vector(geometry, 0, sizeof(uint32_t), &ends, &rings_count) ||
+      !fgb_vector(geometry, 1, sizeof(GEO_TMPL_TYPE), &xy, &points_count)) {
+    return GEO_ERR_INVALID_FORMAT;
+  }
+  points_count /= 2;
+  /* without `ends` the polygon is a single ring */
+  if (ends == 0) {
+    rings_count = 1;
+  }
+  for (size_t iter = 0; iter < rings_count; ++iter) {
+    end = (uint32_t)points_count;
+    if (ends != 0) {
+      memcpy(&end, geometry->data + ends + (iter * sizeof(uint32_t)),
+             sizeof(end));
+    }
+    if (end < start || end - start < 4 || end > points_count) {
+      return GEO_ERR_INVALID_FORMAT;
+    }
+    view.coordinates =
+        geometry->data + xy + (start * 2 * sizeof(GEO_TMPL_TYPE));
+    view.points_count = end - start;
+    start = end;
+    if (reader->point != NULL) {
+      /* same rule as geo_point_in_polygon_view */
+      if (iter == 0) {
+        is_inside = view_contains(&view, reader->point, reader->strict);
+      } else if (is_inside && view_contains(&view, reader->point, true)) {
+        is_inside = false;
+      } else if (is_inside && view_contains(&view, reader->point, false)) {
+        is_inside = !reader->strict;
+      }
+      continue;
+    }
+    if (reader->rings_count < reader->rings_capacity) {
+      reader->rings[reader->rings_count] = view;
+    }
+    ++reader->rings_count;
+  }
+  reader->is_inside = reader->is_inside || is_inside;
+  if (reader->point == NULL) {
+    if (reader->polygons_count < reader->polygons_capacity) {
+      reader->polygons[reader->polygons_count].rings =
+          first_ring < reader->rings_capacity ? &reader->rings[first_ring]
+                                              : NULL;
+      reader->polygons[reader->polygons_count].rings_count = rings_count;
+    }
+    ++reader->polygons_count;
+  }
+  return GEO_SUCCESS;
+}
+
+/* a geometry without a type has the type of the header */
+static enum GeoResult fgb_read_geometry(struct GeoFgbFile const* file,
+                                        struct GeoFgbTable const* geometry,
+                                        struct GeoFgbReader* reader) {
+  enum GeoResult result = GEO_SUCCESS;
+  struct GeoFgbTable part;
+  size_t parts = 0;
+  size_t parts_count = 0;
+  size_t position = 0;
+  uint8_t type = 0;
+  if (!fgb_scalar(geometry, 6, &type, sizeof(type))) {
+    return GEO_ERR_INVALID_FORMAT;
+  }
+  if (type == 0) {
+    type = file->geometry_type;
+  }
+  if (type == GEO_SHAPE_POLYGON) {
+    return fgb_read_polygon(geometry, reader);
+  }
+  if (type != GEO_SHAPE_MULTI_POLYGON) {
+    return GEO_ERR_UNSUPPORTED;
+  }
+  if (!fgb_vector(geometry, 7, sizeof(uint32_t), &parts, &parts_count)) {
+    return GEO_ERR_INVALID_FORMAT;
+  }
+  for (size_t iter = 0; result == GEO_SUCCESS && iter < parts_count; ++iter) {
+    position = parts + (iter * sizeof(uint32_t));
+    type = 0;
+    if (!fgb_reference(geometry->data, geometry->size, position, &position) ||
+        !fgb_table(geometry->data, geometry->size, position, &part) ||
+        !fgb_scalar(&part, 6, &type, sizeof(type)) ||
+        (type != 0 && type != GEO_SHAPE_POLYGON)) {
+      return GEO_ERR_INVALID_FORMAT;
+    }
+    result = fgb_read_polygon(&part, reader);
+  }
+  return result;
+}
+
+/* `offset` is the leaf's offset, from the start of the features */
+static enum GeoResult fgb_read_feature(struct GeoFgbFile const* file,
+                                       uint64_t offset,
+                                       struct GeoFgbReader* reader) {
+  struct GeoFgbTable feature;
+  struct GeoFgbTable geometry;
+  size_t position = 0;
+  if (offset > file->size - file->features_offset ||
+      !fgb_root(file->data, file->size,
+                file->features_offset + (size_t)offset, &feature)) {
+    return GEO_ERR_INVALID_FORMAT;
+  }
+  /* a feature without geometry has no rings */
+  position = fgb_field(&feature, 0);
+  if (position == 0) {
+    return GEO_SUCCESS;
+  }
+  if (!fgb_reference(feature.data, feature.size, position, &position) ||
+      !fgb_table(feature.data, feature.size, position, &geometry)) {
+    return GEO_ERR_INVALID_FORMAT;
+  }
+  return fgb_read_geometry(file, &geometry, reader);
+}
+
+/*
+ * depth first search of the packed tree calling `visit` with the position
+ * and offset of every leaf whose box intersects `envelope`. the children of
+ * a node are the `index_node_size` nodes from its offset on, cut at the end
+ * of their level.
+ */
+static enum GeoResult fgb_search(
+    struct GeoFgbFile const* file, struct TMPL_ENVELOPE const* const envelope,
+    enum GeoResult (*visit)(void* context, struct GeoFgbFile const* file,
+                            size_t feature, uint64_t offset),
+    void* context) {
+  enum GeoResult result = GEO_SUCCESS;
+  struct TMPL_ENVELOPE box;
+  size_t level_sizes[GEO_INDEX_MAX_DEPTH];
+  size_t level_starts[GEO_INDEX_MAX_DEPTH];
+  size_t next[GEO_INDEX_MAX_DEPTH];
+  size_t end[GEO_INDEX_MAX_DEPTH];
+  size_t level[GEO_INDEX_MAX_DEPTH];
+  size_t levels_count = 0;
+  size_t start = file->nodes_count;
+  size_t depth = 0;
+  uint64_t nodes_count = 0;
+  uint64_t offset = 0;
+
+  if (file->features_count == 0) {
+    return GEO_SUCCESS;
+  }
+  if (file->index_node_size == 0) {
+    return GEO_ERR_UNSUPPORTED;
+  }
+  fgb_levels(file->features_count, file->index_node_size, level_sizes,
+             &levels_count, &nodes_count);
+  /* levels are stored root first */
+  for (size_t iter = 0; iter < levels_count; ++iter) {
+    start -= level_sizes[iter];
+    level_starts[iter] = start;
+  }
+  next[0] = 0;
+  end[0] = 1;
+  level[0] = levels_count - 1;
+  depth = 1;
+  while (depth > 0) {
+    size_t position = 0;
+    size_t child_level = 0;
+    if (next[depth - 1] >= end[depth - 1]) {
+      --depth;
+      continue;
+    }
+    position = next[depth - 1]++;
+    fgb_node(file, position, &box, &offset);
+    if (!envelopes_intersect(&box, envelope)) {
+      continue;
+    }
+    if (level[depth - 1] == 0) {
+      result = visit(context, file, position - level_starts[0], offset);
+      if (result != GEO_SUCCESS) {
+        return result;
+      }
+      continue;
+    }
+    child_level = level[depth - 1] - 1;
+    if (offset < level_starts[child_level] ||
+        offset >= level_starts[child_level] + level_sizes[child_level]) {
+      return GEO_ERR_INVALID_FORMAT;
+    }
+    next[depth] = (size_t)offset;
+    end[depth] = level_starts[child_level] + level_sizes[child_level];
+    if (end[depth] - next[depth] > file->index_node_size) {
+      end[depth] = next[depth] + file->index_node_size;
+    }
+    level[depth] = child_level;
+    ++depth;
+  }
+  return GEO_SUCCESS;
+}
+
+static enum GeoResult fgb_collect(void* context, struct GeoFgbFile const* file,
+                                  size_t feature, uint64_t offset) {
+  (void)file;
+  (void)offset;
+  collect_id(context, feature);
+  return GEO_SUCCESS;
+}
+
+struct GeoFgbPointQuery {
+  struct GeoFgbReader reader;
+  struct GeoIdsCollector collector;
+};
+
+static enum GeoResult fgb_collect_containing(void* context,
+                                             struct GeoFgbFile const* file,
+                                             size_t feature, uint64_t offset) {
+  struct GeoFgbPointQuery* query = (struct GeoFgbPointQuery*)context;
+  enum GeoResult result = GEO_SUCCESS;
+  query->reader.is_inside = false;
+  result = fgb_read_feature(file, offset, &query->reader);
+  if (result == GEO_SUCCESS && query->reader.is_inside) {
+    collect_id(&query->collector, feature);
+  }
+  /* features of other types never contain the point */
+  return result == GEO_ERR_UNSUPPORTED ? GEO_SUCCESS : result;
+}
+
+enum GeoResult TMPL_FUNC(geo_fgb_open)(struct GeoFgbFile* file,
+                                       void const* data, size_t size) {
+  static unsigned char const magic[7] = {'f', 'g', 'b', 3, 'f', 'g', 'b'};
+  struct GeoFgbTable header;
+  size_t level_sizes[GEO_INDEX_MAX_DEPTH];
+  size_t levels_count = 0;
+  uint64_t nodes_count = 0;
+  uint32_t header_size = 0;
+  uint32_t one = 1;
+  unsigned char host_order = 0;
+#ifndef GEO_UNSAFE
+  if (file == NULL || data == NULL) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+  if (size < GEO_FGB_MAGIC_SIZE + sizeof(uint32_t) ||
+      memcmp(data, magic, sizeof(magic)) != 0) {
+    return GEO_ERR_INVALID_FORMAT;
+  }
+  memcpy(&host_order, &one, 1);
+  if (host_order != 1) {
+    return GEO_ERR_UNSUPPORTED;
+  }
+  file->data = (unsigned char const*)data;
+  file->size = size;
+  file->geometry_type = 0;
+  file->features_count = 0;
+  file->index_node_size = 16;
+  file->nodes_count = 0;
+  if (!fgb_root(file->data, size, GEO_FGB_MAGIC_SIZE, &header) ||
+      !fgb_scalar(&header, 2, &file->geometry_type, sizeof(uint8_t)) ||
+      !fgb_scalar(&header, 8, &file->features_count, sizeof(uint64_t)) ||
+      !fgb_scalar(&header, 9, &file->index_node_size, sizeof(uint16_t))) {
+    return GEO_ERR_INVALID_FORMAT;
+  }
+  fgb_u32(file->data, size, GEO_FGB_MAGIC_SIZE, &header_size);
+  file->index_offset = GEO_FGB_MAGIC_SIZE + sizeof(uint32_t) + header_size;
+  if (file->features_count == 0) {
+    file->index_node_size = 0;
+  }
+  if (file->index_node_size > 0) {
+    if (file->index_node_size < 2 ||
+        !fgb_levels(file->features_count, file->index_node_size, level_sizes,
+                    &levels_count, &nodes_count) ||
+        nodes_count > (size - file->index_offset) / GEO_FGB_NODE_SIZE) {
+      return GEO_ERR_INVALID_FORMAT;
+    }
+    file->nodes_count = (size_t)nodes_count;
+  }
+  file->features_offset =
+      file->index_offset + (file->nodes_count * GEO_FGB_NODE_SIZE);
+  return GEO_SUCCESS;
+}
+
+enum GeoResult TMPL_FUNC(geo_fgb_query_envelope)(
+    struct GeoFgbFile const* file, struct TMPL_ENVELOPE const* envelope,
+    size_t* ids, size_t ids_capacity, size_t* ids_count) {
+  enum GeoResult result = GEO_SUCCESS;
+  struct GeoIdsCollector collector;
+#ifndef GEO_UNSAFE
+  if (file == NULL || envelope == NULL || ids_count == NULL ||
+      (ids == NULL && ids_capacity > 0)) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+  collector.ids = ids;
+  collector.capacity = ids_capacity;
+  collector.count = 0;
+  result = fgb_search(file, envelope, fgb_collect, &collector);
+  *ids_count = collector.count;
+  return result;
+}
+
+enum GeoResult TMPL_FUNC(geo_fgb_query_point)(struct GeoFgbFile const* file,
+                                              struct TMPL_POINT const* point,
+                                              bool strict, size_t* ids,
+                                              size_t ids_capacity,
+                                              size_t* ids_count) {
+  enum GeoResult result = GEO_SUCCESS;
+  struct TMPL_ENVELOPE envelope;
+  struct GeoFgbPointQuery query;
+#ifndef GEO_UNSAFE
+  if (file == NULL || point == NULL || ids_count == NULL ||
+      (ids == NULL && ids_capacity > 0)) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+  envelope.min = *point;
+  envelope.max = *point;
+  memset(&query.reader, 0, sizeof(query.reader));
+  query.reader.point = point;
+  query.reader.strict = strict;
+  query.collector.ids = ids;
+  query.collector.capacity = ids_capacity;
+  query.collector.count = 0;
+  result = fgb_search(file, &envelope, fgb_collect_containing, &query);
+  *ids_count = query.collector.count;
+  return result;
+}
+
+enum GeoResult TMPL_FUNC(geo_fgb_read)(
+    struct GeoFgbFile const* file, size_t feature,
+    struct TMPL_POLYGON_VIEW* polygons, size_t polygons_capacity,
+    size_t* polygons_count, struct TMPL_RING_VIEW* rings,
+    size_t rings_capacity, size_t* rings_count) {
+  enum GeoResult result = GEO_SUCCESS;
+  struct GeoFgbReader reader;
+  struct TMPL_ENVELOPE box;
+  uint64_t offset = 0;
+#ifndef GEO_UNSAFE
+  if (file == NULL || polygons_count == NULL || rings_count == NULL ||
+      (polygons == NULL && polygons_capacity > 0) ||
+      (rings == NULL && rings_capacity > 0)) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+  if (feature >= file->features_count) {
+    return GEO_ERR_OUT_OF_RANGE;
+  }
+  if (file->index_node_size == 0) {
+    return GEO_ERR_UNSUPPORTED;
+  }
+  /* the leaves are the last level, in feature order */
+  fgb_node(file, file->nodes_count - (size_t)file->features_count + feature,
+           &box, &offset);
+  memset(&reader, 0, sizeof(reader));
+  reader.polygons = polygons;
+  reader.polygons_capacity = polygons_capacity;
+  reader.rings = rings;
+  reader.rings_capacity = rings_capacity;
+  result = fgb_read_feature(file, offset, &reader);
+  if (result != GEO_SUCCESS) {
+    return result;
+  }
+  *polygons_count = reader.polygons_count;
+  *rings_count = reader.rings_count;
+  if (reader.polygons_count > polygons_capacity ||
+      reader.rings_count > rings_capacity) {
+    return GEO_ERR_TOO_SMALL;
+  }
+  return GEO_SUCCESS;
+}
+#endif
+
+/*
+ * text readers.
+ *
+ * both readers are character level state machines. only words, numbers and
+ * strings can be split by a chunk boundary, what is needed of them is kept in
+ * `token` until the rest arrives. the points of a line string or ring are bump
+ * allocated one after the other so they end up contiguous in the arena, each
+ * finished part is then linked to the previous one and the segments are built
+ * once the whole shape is read.
+ */
+#include <errno.h>
+#include <unistd.h>
+
+#ifndef GEO_READ_SIZE
+#define GEO_READ_SIZE 65536
+#endif
+
+#define TMPL_SHAPE_PART TMPL_CONCAT(GeoShapePart, GEO_TMPL_TYPE)
+
+struct TMPL_SHAPE_PART {
+  struct TMPL_POINT* points;
+  size_t points_count;
+  bool polygon_start;
+  struct TMPL_SHAPE_PART* previous;
+};
+
+static void shape_reset(struct TMPL_SHAPE_BUILDER* builder) {
+  builder->part_points = NULL;
+  builder->part_points_count = 0;
+  builder->last_part = NULL;
+  builder->parts_count = 0;
+  builder->polygons_count = 0;
+  builder->segments_count = 0;
+  builder->points_count = 0;
+  builder->polygon_start = false;
+}
+
+/* nothing else is allocated while a part is read so its points are packed */
+static enum GeoResult shape_add_point(struct TMPL_SHAPE_BUILDER* builder) {
+  void* memory = NULL;
+  enum GeoResult result =
+      geo_arena_alloc(builder->arena, sizeof(struct TMPL_POINT),
+                      sizeof(GEO_TMPL_TYPE), &memory);
+  if (result != GEO_SUCCESS) {
+    return result;
+  }
+  *(struct TMPL_POINT*)memory = builder->point;
+  if (builder->part_points == NULL) {
+    builder->part_points = (struct TMPL_POINT*)memory;
+  }
+  ++builder->part_points_count;
+  ++builder->points_count;
+  return GEO_SUCCESS;
+}
+
+static enum GeoResult shape_end_part(struct TMPL_SHAPE_BUILDER* builder,
+                                     size_t minimum) {
+  struct TMPL_SHAPE_PART* part = NULL;
+  void* memory = NULL;
+  enum GeoResult result = GEO_SUCCESS;
+  if (builder->part_points_count < minimum) {
+    return GEO_ERR_INVALID_FORMAT;
+  }
+  result = geo_arena_alloc(builder->arena, sizeof(struct TMPL_SHAPE_PART),
+                           sizeof(void*), &memory);
+  if (result != GEO_SUCCESS) {
+    return result;
+  }
+  part = (struct TMPL_SHAPE_PART*)memory;
+  part->points = builder->part_points;
+  part->points_count = builder->part_points_count;
+  part->polygon_start = builder->polygon_start;
+  part->previous = (struct TMPL_SHAPE_PART*)builder->last_part;
+  builder->last_part = part;
+  builder->segments_count += part->points_count - 1;
+  builder->polygons_count += builder->polygon_start;
+  ++builder->parts_count;
+  builder->polygon_start = false;
+  builder->part_points = NULL;
+  builder->part_points_count = 0;
+  return GEO_SUCCESS;
+}
+
+/* lays out the parts as geometries and resets the builder for the next shape */
+static enum GeoResult shape_finish(struct TMPL_SHAPE_BUILDER* builder,
+                                   enum GeoShapeType type,
+                                   struct TMPL_SHAPE* shape) {
+  enum GeoResult result = GEO_SUCCESS;
+  struct TMPL_SHAPE_PART* part = (struct TMPL_SHAPE_PART*)builder->last_part;
+  struct TMPL_SEGMENT* segments = NULL;
+  struct TMPL_SEGMENT** segment_pointers = NULL;
+  void* memory = NULL;
+  size_t part_index = builder->parts_count;
+  size_t segment_index = builder->segments_count;
+  size_t polygon_index = builder->polygons_count;
+
+  memset(shape, 0, sizeof(*shape));
+  shape->type = type;
+  shape->point = builder->point;
+  shape->points_count = builder->points_count;
+  shape->parts_count = builder->parts_count;
+  shape->polygons_count = builder->polygons_count;
+  if (builder->parts_count > 0) {
+    result = geo_arena_alloc(
+        builder->arena, builder->parts_count * sizeof(struct TMPL_GEOMETRY),
+        sizeof(void*), &memory);
+    shape->parts = (struct TMPL_GEOMETRY*)memory;
+    if (result == GEO_SUCCESS) {
+      result = geo_arena_alloc(
+          builder->arena, builder->segments_count * sizeof(struct TMPL_SEGMENT),
+          sizeof(void*), &memory);
+      segments = (struct TMPL_SEGMENT*)memory;
+    }
+    if (result == GEO_SUCCESS) {
+      result = geo_arena_alloc(
+          builder->arena,
+          builder->segments_count * sizeof(struct TMPL_SEGMENT*),
+          sizeof(void*), &memory);
+      segment_pointers = (struct TMPL_SEGMENT**)memory;
+    }
+    if (result == GEO_SUCCESS) {
+      result = geo_arena_alloc(builder->arena,
+                               builder->polygons_count * sizeof(size_t),
+                               sizeof(size_t), &memory);
+      shape->polygons = (size_t*)memory;
+    }
+    if (result != GEO_SUCCESS) {
+      return result;
+    }
+  }
+
+  /* the parts are linked last to first */
+  for (; part != NULL; part = part->previous) {
+    size_t count = part->points_count - 1;
+    --part_index;
+    segment_index -= count;
+    for (size_t iter = 0; iter < count; ++iter) {
+      segments[segment_index + iter].start = &part->points[iter];
+      segments[segment_index + iter].end = &part->points[iter + 1];
+      segment_pointers[segment_index + iter] = &segments[segment_index + iter];
+    }
+    shape->parts[part_index].segments = &segment_pointers[segment_index];
+    shape->parts[part_index].segments_count = count;
+    if (part->polygon_start) {
+      shape->polygons[--polygon_index] = part_index;
+    }
+  }
+  shape_reset(builder);
+  return GEO_SUCCESS;
+}
+
+static enum GeoResult parse_coordinate(char const* text, size_t length,
+                                       GEO_TMPL_TYPE* coordinate) {
+  enum GeoResult result = GEO_SUCCESS;
+#ifdef GEO_FLOATING_POINT
+  double value = 0;
+  result = geo_parse_double(text, length, &value);
+  *coordinate = (GEO_TMPL_TYPE)value;
+#else
+  int64_t value = 0;
+  result = geo_parse_int64(text, length, &value);
+  *coordinate = (GEO_TMPL_TYPE)value;
+  if (result == GEO_SUCCESS && (int64_t)*coordinate != value) {
+    result = GEO_ERR_OUT_OF_RANGE;
+  }
+#endif
+  return result;
+}
+
+static ssize_t read_retry(int descriptor, char* buffer, size_t size) {
+  ssize_t bytes = 0;
+  do {
+    bytes = read(descriptor, buffer, size);
+  } while (bytes < 0 && errno == EINTR);
+  return bytes;
+}
+
+static bool text_space(char c) {
+  return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+}
+
+static bool text_letter(char c) {
+  return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+}
+
+/*
+ * streaming WKT reader.
+ */
+#ifndef GEO_WKT_STATE_TYPE
+#define GEO_WKT_STATE_TYPE 0U    // expecting a geometry type
+#define GEO_WKT_STATE_BODY 1U    // expecting `(` or EMPTY after the type
+#define GEO_WKT_STATE_INSIDE 2U  // inside the parentheses
+#define GEO_WKT_OPEN 0U
+#define GEO_WKT_CLOSE 1U
+#define GEO_WKT_COMMA 2U
+#define GEO_WKT_NUMBER 3U
+#endif
+
+static bool wkt_number_char(char c) {
+  return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' ||
+         c == 'e' || c == 'E';
+}
+
+static bool wkt_word_is(char const* text, size_t length, char const* word) {
+  size_t iter = 0;
+  for (; iter < length && word[iter] != '\0'; ++iter) {
+    /* ascii upper case */
+    if ((text[iter] & ~0x20) != word[iter]) {
+      return false;
+    }
+  }
+  return iter == length && word[iter] == '\0';
+}
+
+/* number of nested parentheses around the coordinates of the current type */
+static unsigned wkt_coordinates_depth(enum GeoShapeType type) {
+  return type == GEO_SHAPE_MULTI_POLYGON ? 3U
+         : type == GEO_SHAPE_POLYGON     ? 2U
+                                         : 1U;
+}
+
+static enum GeoResult wkt_emit(struct TMPL_WKT_PARSER* parser) {
+  struct TMPL_SHAPE shape;
+  enum GeoResult result = shape_finish(&parser->builder, parser->type, &shape);
+  if (result != GEO_SUCCESS) {
+    return result;
+  }
+  parser->state = GEO_WKT_STATE_TYPE;
+  parser->depth = 0;
+  parser->emit(parser->context, &shape);
+  return GEO_SUCCESS;
+}
+
+static enum GeoResult wkt_punctuation(struct TMPL_WKT_PARSER* parser,
+                                      char c) {
+  unsigned coordinates_depth = wkt_coordinates_depth(parser->type);
+  bool in_coordinates = parser->depth == coordinates_depth;
+  bool point_done = parser->previous == GEO_WKT_NUMBER && parser->axis == 2;
+  enum GeoResult result = GEO_SUCCESS;
+
+  if (c == '(') {
+    if (!(parser->state == GEO_WKT_STATE_BODY ||
+          (parser->state == GEO_WKT_STATE_INSIDE &&
+           parser->depth < coordinates_depth &&
+           (parser->previous == GEO_WKT_OPEN ||
+            parser->previous == GEO_WKT_COMMA)))) {
+      return GEO_ERR_INVALID_FORMAT;
+    }
+    parser->state = GEO_WKT_STATE_INSIDE;
+    ++parser->depth;
+    parser->axis = 0;
+    parser->previous = GEO_WKT_OPEN;
+    /* the first ring after a polygon's parenthesis is its outer ring */
+    if (parser->depth == coordinates_depth - 1) {
+      parser->builder.polygon_start = true;
+    }
+    return GEO_SUCCESS;
+  }
+
+  if (parser->state != GEO_WKT_STATE_INSIDE) {
+    return GEO_ERR_INVALID_FORMAT;
+  }
+  if (in_coordinates ? !point_done : parser->previous != GEO_WKT_CLOSE) {
+    return GEO_ERR_INVALID_FORMAT;
+  }
+  if (c == ',') {
+    if (in_coordinates && parser->type == GEO_SHAPE_POINT) {
+      return GEO_ERR_INVALID_FORMAT;
+    }
+    parser->axis = 0;
+    parser->previous = GEO_WKT_COMMA;
+    return GEO_SUCCESS;
+  }
+
+  if (in_coordinates && parser->type != GEO_SHAPE_POINT) {
+    result = shape_end_part(&parser->builder,
+                            parser->type == GEO_SHAPE_LINE_STRING ? 2 : 4);
+    if (result != GEO_SUCCESS) {
+      return result;
+    }
+  }
+  parser->previous = GEO_WKT_CLOSE;
+  if (--parser->depth > 0) {
+    return GEO_SUCCESS;
+  }
+  return wkt_emit(parser);
+}
+
+static enum GeoResult wkt_word(struct TMPL_WKT_PARSER* parser,
+                               char const* text, size_t length) {
+  if (parser->state == GEO_WKT_STATE_TYPE) {
+    if (wkt_word_is(text, length, "POINT")) {
+      parser->type = GEO_SHAPE_POINT;
+    } else if (wkt_word_is(text, length, "LINESTRING")) {
+      parser->type = GEO_SHAPE_LINE_STRING;
+    } else if (wkt_word_is(text, length, "POLYGON")) {
+      parser->type = GEO_SHAPE_POLYGON;
+    } else if (wkt_word_is(text, length, "MULTIPOLYGON")) {
+      parser->type = GEO_SHAPE_MULTI_POLYGON;
+    } else if (wkt_word_is(text, length, "MULTIPOINT") ||
+               wkt_word_is(text, length, "MULTILINESTRING") ||
+               wkt_word_is(text, length, "GEOMETRYCOLLECTION")) {
+      return GEO_ERR_UNSUPPORTED;
+    } else {
+      return GEO_ERR_INVALID_FORMAT;
+    }
+    parser->state = GEO_WKT_STATE_BODY;
+    return GEO_SUCCESS;
+  }
+  if (parser->state == GEO_WKT_STATE_BODY) {
+    if (wkt_word_is(text, length, "EMPTY")) {
+      return wkt_emit(parser);
+    }
+    if (wkt_word_is(text, length, "Z") || wkt_word_is(text, length, "M") ||
+        wkt_word_is(text, length, "ZM")) {
+      return GEO_ERR_UNSUPPORTED;
+    }
+  }
+  return GEO_ERR_INVALID_FORMAT;
+}
+
+static enum GeoResult wkt_number(struct TMPL_WKT_PARSER* parser,
+                                 char const* text, size_t length) {
+  enum GeoResult result = GEO_SUCCESS;
+  if (parser->state != GEO_WKT_STATE_INSIDE ||
+      parser->depth != wkt_coordinates_depth(parser->type) ||
+      parser->previous == GEO_WKT_CLOSE) {
+    return GEO_ERR_INVALID_FORMAT;
+  }
+  if (parser->axis == 2) {
+    return GEO_ERR_UNSUPPORTED;
+  }
+  result = parse_coordinate(text, length,
+                            parser->axis == 0 ? &parser->builder.point.x
+                                              : &parser->builder.point.y);
+  if (result != GEO_SUCCESS) {
+    return result;
+  }
+  parser->previous = GEO_WKT_NUMBER;
+  if (++parser->axis < 2) {
+    return GEO_SUCCESS;
+  }
+  if (parser->type == GEO_SHAPE_POINT) {
+    parser->builder.points_count = 1;
+    return GEO_SUCCESS;
+  }
+  return shape_add_point(&parser->builder);
+}
+
+static enum GeoResult wkt_token(struct TMPL_WKT_PARSER* parser,
+                                char const* text, size_t length) {
+  return text_letter(text[0]) ? wkt_word(parser, text, length)
+                              : wkt_number(parser, text, length);
+}
+
+enum GeoResult TMPL_FUNC(geo_wkt_parser_init)(
+    struct TMPL_WKT_PARSER* parser, struct GeoArena* arena,
+    void (*emit)(void* context, struct TMPL_SHAPE const* shape),
+    void* context) {
+#ifndef GEO_UNSAFE
+  if (parser == NULL || arena == NULL || emit == NULL) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+  memset(parser, 0, sizeof(*parser));
+  parser->builder.arena = arena;
+  parser->emit = emit;
+  parser->context = context;
+  parser->result = GEO_SUCCESS;
+  parser->state = GEO_WKT_STATE_TYPE;
+  shape_reset(&parser->builder);
+  return GEO_SUCCESS;
+}
+
+enum GeoResult TMPL_FUNC(geo_wkt_parse)(struct TMPL_WKT_PARSER* parser,
+                                        char const* chunk, size_t size) {
+  enum GeoResult result = GEO_SUCCESS;
+  size_t iter = 0;
+  size_t start = 0;
+  bool number = false;
+#ifndef GEO_UNSAFE
+  if (parser == NULL || (chunk == NULL && size > 0)) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+  if (parser->result != GEO_SUCCESS) {
+    return parser->result;
+  }
+
+  if (parser->token_length > 0) {
+    number = !text_letter(parser->token[0]);
+    for (; iter < size && (number ? wkt_number_char(chunk[iter])
+                                  : text_letter(chunk[iter]));
+         ++iter) {
+      if (parser->token_length == GEO_WKT_TOKEN_SIZE) {
+        parser->result = GEO_ERR_INVALID_FORMAT;
+        return parser->result;
+      }
+      parser->token[parser->token_length++] = chunk[iter];
+    }
+    if (iter == size) {
+      parser->offset += size;
+      return GEO_SUCCESS;
+    }
+    result = wkt_token(parser, parser->token, parser->token_length);
+    parser->token_length = 0;
+  }
+
+  while (result == GEO_SUCCESS && iter < size) {
+    char c = chunk[iter];
+    start = iter;
+    if (text_space(c)) {
+      ++iter;
+    } else if (c == '(' || c == ')' || c == ',') {
+      result = wkt_punctuation(parser, c);
+      ++iter;
+    } else if (text_letter(c) || wkt_number_char(c)) {
+      number = !text_letter(c);
+      for (++iter; iter < size && (number ? wkt_number_char(chunk[iter])
+                                          : text_letter(chunk[iter]));
+           ++iter) {
+      }
+      if (iter < size) {
+        result = wkt_token(parser, chunk + start, iter - start);
+      } else if (iter - start <= GEO_WKT_TOKEN_SIZE) {
+        memcpy(parser->token, chunk + start, iter - start);
+        parser->token_length = iter - start;
+      } else {
+        result = GEO_ERR_INVALID_FORMAT;
+      }
+    } else {
+      result = GEO_ERR_INVALID_FORMAT;
+    }
+  }
+  if (result != GEO_SUCCESS) {
+    parser->result = result;
+    parser->offset += start;
+    return result;
+  }
+  parser->offset += size;
+  return GEO_SUCCESS;
+}
+
+/* call once the input has ended, a shape left open is an error */
+enum GeoResult TMPL_FUNC(geo_wkt_parse_finish)(struct TMPL_WKT_PARSER* parser) {
+  enum GeoResult result = GEO_SUCCESS;
+#ifndef GEO_UNSAFE
+  if (parser == NULL) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+  if (parser->result != GEO_SUCCESS) {
+    return parser->result;
+  }
+  if (parser->token_length > 0) {
+    result = wkt_token(parser, parser->token, parser->token_length);
+    parser->token_length = 0;
+  }
+  if (result == GEO_SUCCESS && parser->state != GEO_WKT_STATE_TYPE) {
+    result = GEO_ERR_INVALID_FORMAT;
+  }
+  parser->result = result;
+  return result;
+}
+
+/* reads `descriptor` to its end, then finishes the parse */
+enum GeoResult TMPL_FUNC(geo_wkt_parse_fd)(struct TMPL_WKT_PARSER* parser,
+                                           int descriptor) {
+  char buffer[GEO_READ_SIZE];
+  enum GeoResult result = GEO_SUCCESS;
+  ssize_t bytes = 0;
+#ifndef GEO_UNSAFE
+  if (parser == NULL) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+  while ((bytes = read_retry(descriptor, buffer, sizeof(buffer))) > 0) {
+    result = TMPL_FUNC(geo_wkt_parse)(parser, buffer, (size_t)bytes);
+    if (result != GEO_SUCCESS) {
+      return result;
+    }
+  }
+  if (bytes < 0) {
+    parser->result = GEO_ERR_IO;
+    return parser->result;
+  }
+  return TMPL_FUNC(geo_wkt_parse_finish)(parser);
+}
+
+/*
+ * streaming GeoJSON reader.
+ *
+ * every open object or array gets a role from its parent and the key it is the
+ * value of, only the coordinates of objects in a geometry position are read.
+ * the keys of a geometry can come in any order, so the nesting of the
+ * coordinates is learned from the depth of the first number and checked
+ * against the type once the geometry object closes.
+ */
+#ifndef GEO_JSON_ROLE_OTHER
+#define GEO_JSON_ROLE_OTHER 0U
+#define GEO_JSON_ROLE_ROOT 1U      // top level object, geometry or feature
+#define GEO_JSON_ROLE_FEATURES 2U  // "features" array of the top level
+#define GEO_JSON_ROLE_FEATURE 3U
+#define GEO_JSON_ROLE_GEOMETRY 4U        // "geometry" object of a feature
+#define GEO_JSON_ROLE_COORDINATES 5U     // any array inside "coordinates"
+#define GEO_JSON_KEY_OTHER 0U
+#define GEO_JSON_KEY_TYPE 1U
+#define GEO_JSON_KEY_COORDINATES 2U
+#define GEO_JSON_KEY_GEOMETRY 3U
+#define GEO_JSON_KEY_FEATURES 4U
+#define GEO_JSON_TYPE_NONE 0U  // otherwise a GeoShapeType or OTHER
+#define GEO_JSON_TYPE_OTHER 255U
+#define GEO_JSON_EXPECT_VALUE 0U
+#define GEO_JSON_EXPECT_VALUE_OR_CLOSE 1U
+#define GEO_JSON_EXPECT_KEY 2U
+#define GEO_JSON_EXPECT_KEY_OR_CLOSE 3U
+#define GEO_JSON_EXPECT_COLON 4U
+#define GEO_JSON_EXPECT_SEPARATOR 5U
+#endif
+
+static bool json_token_char(char c) {
+  return (c >= '0' && c <= '9') || text_letter(c) || c == '-' || c == '+' ||
+         c == '.';
+}
+
+static bool json_token_is(char const* text, size_t length, char const* word) {
+  return length == strlen(word) && memcmp(text, word, length) == 0;
+}
+
+static bool json_expects_value(struct TMPL_JSON_PARSER const* parser) {
+  return parser->expect == GEO_JSON_EXPECT_VALUE ||
+         parser->expect == GEO_JSON_EXPECT_VALUE_OR_CLOSE;
+}
+
+/* after a value, a new top level value can follow */
+static void json_value_done(struct TMPL_JSON_PARSER* parser) {
+  parser->expect = parser->depth == 0 ? GEO_JSON_EXPECT_VALUE
+                                      : GEO_JSON_EXPECT_SEPARATOR;
+}
+
+static unsigned json_shape_positions_depth(unsigned type) {
+  return type == GEO_SHAPE_MULTI_POLYGON ? 4U
+         : type == GEO_SHAPE_POLYGON     ? 3U
+         : type == GEO_SHAPE_LINE_STRING ? 2U
+                                         : 1U;
+}
+
+static unsigned json_child_role(struct TMPL_JSON_PARSER const* parser,
+                                char kind) {
+  unsigned role = 0;
+  unsigned key = 0;
+  if (parser->depth == 0) {
+    return kind == '{' ? GEO_JSON_ROLE_ROOT : GEO_JSON_ROLE_OTHER;
+  }
+  role = parser->roles[parser->depth - 1];
+  key = parser->keys[parser->depth - 1];
+  if (role == GEO_JSON_ROLE_COORDINATES) {
+    return GEO_JSON_ROLE_COORDINATES;
+  }
+  if (role == GEO_JSON_ROLE_FEATURES) {
+    return kind == '{' ? GEO_JSON_ROLE_FEATURE : GEO_JSON_ROLE_OTHER;
+  }
+  if (kind == '{' && key == GEO_JSON_KEY_GEOMETRY &&
+      (role == GEO_JSON_ROLE_ROOT || role == GEO_JSON_ROLE_FEATURE)) {
+    return GEO_JSON_ROLE_GEOMETRY;
+  }
+  if (kind == '[' && key == GEO_JSON_KEY_FEATURES &&
+      role == GEO_JSON_ROLE_ROOT) {
+    return GEO_JSON_ROLE_FEATURES;
+  }
+  if (kind == '[' && key == GEO_JSON_KEY_COORDINATES &&
+      (role == GEO_JSON_ROLE_ROOT || role == GEO_JSON_ROLE_GEOMETRY)) {
+    return GEO_JSON_ROLE_COORDINATES;
+  }
+  return GEO_JSON_ROLE_OTHER;
+}
+
+static enum GeoResult json_open(struct TMPL_JSON_PARSER* parser, char kind) {
+  unsigned role = json_child_role(parser, kind);
+  if (!json_expects_value(parser)) {
+    return GEO_ERR_INVALID_FORMAT;
+  }
+  if (parser->depth == GEO_JSON_MAX_DEPTH) {
+    return GEO_ERR_UNSUPPORTED;
+  }
+  if (role == GEO_JSON_ROLE_COORDINATES) {
+    if (kind != '[') {
+      return GEO_ERR_INVALID_FORMAT;
+    }
+    ++parser->coordinates_depth;
+    parser->axis = 0;
+    if (parser->positions_depth > 0 &&
+        parser->coordinates_depth > parser->positions_depth) {
+      return GEO_ERR_INVALID_FORMAT;
+    }
+    /* the first ring of every polygon is its outer ring */
+    if (parser->positions_depth >= 3 &&
+        parser->coordinates_depth == parser->positions_depth - 2) {
+      parser->builder.polygon_start = true;
+    }
+  }
+  if (role == GEO_JSON_ROLE_ROOT || role == GEO_JSON_ROLE_GEOMETRY) {
+    shape_reset(&parser->builder);
+    parser->coordinates_depth = 0;
+    parser->positions_depth = 0;
+  }
+  parser->kinds[parser->depth] = (unsigned char)kind;
+  parser->roles[parser->depth] = (unsigned char)role;
+  parser->keys[parser->depth] = GEO_JSON_KEY_OTHER;
+  parser->types[parser->depth] = GEO_JSON_TYPE_NONE;
+  ++parser->depth;
+  parser->expect = kind == '{' ? GEO_JSON_EXPECT_KEY_OR_CLOSE
+                               : GEO_JSON_EXPECT_VALUE_OR_CLOSE;
+  return GEO_SUCCESS;
+}
+
+static enum GeoResult json_close_coordinates(struct TMPL_JSON_PARSER* parser) {
+  enum GeoResult result = GEO_SUCCESS;
+  if (parser->positions_depth > 0 &&
+      parser->coordinates_depth == parser->positions_depth) {
+    /* a position, anything after x and y (elevation) is ignored */
+    if (parser->axis < 2) {
+      return GEO_ERR_INVALID_FORMAT;
+    }
+    parser->axis = 0;
+    if (parser->positions_depth == 1) {
+      parser->builder.points_count = 1;
+    } else {
+      result = shape_add_point(&parser->builder);
+    }
+  } else if (parser->positions_depth >= 2 &&
+             parser->coordinates_depth == parser->positions_depth - 1) {
+    result = shape_end_part(&parser->builder,
+                            parser->positions_depth == 2 ? 2 : 4);
+  }
+  --parser->coordinates_depth;
+  return result;
+}
+
+static enum GeoResult json_close_geometry(struct TMPL_JSON_PARSER* parser,
+                                          unsigned role, unsigned type) {
+  struct TMPL_SHAPE shape;
+  enum GeoResult result = GEO_SUCCESS;
+  if (type == GEO_JSON_TYPE_NONE || type == GEO_JSON_TYPE_OTHER) {
+    /* a feature or collection at the top level is not a geometry */
+    return role == GEO_JSON_ROLE_GEOMETRY ? GEO_ERR_INVALID_FORMAT
+                                          : GEO_SUCCESS;
+  }
+  if (parser->positions_depth > 0 &&
+      parser->positions_depth != json_shape_positions_depth(type)) {
+    return GEO_ERR_INVALID_FORMAT;
+  }
+  result = shape_finish(&parser->builder, (enum GeoShapeType)type, &shape);
+  if (result != GEO_SUCCESS) {
+    return result;
+  }
+  parser->positions_depth = 0;
+  parser->emit(parser->context, &shape);
+  return GEO_SUCCESS;
+}
+
+static enum GeoResult json_close(struct TMPL_JSON_PARSER* parser, char kind) {
+  enum GeoResult result = GEO_SUCCESS;
+  unsigned role = 0;
+  if (parser->depth == 0 ||
+      parser->kinds[parser->depth - 1] != (kind == '}' ? '{' : '[')) {
+    return GEO_ERR_INVALID_FORMAT;
+  }
+  if (parser->expect != GEO_JSON_EXPECT_SEPARATOR &&
+      parser->expect != (kind == '}' ? GEO_JSON_EXPECT_KEY_OR_CLOSE
+                                     : GEO_JSON_EXPECT_VALUE_OR_CLOSE)) {
+    return GEO_ERR_INVALID_FORMAT;
+  }
+  --parser->depth;
+  role = parser->roles[parser->depth];
+  if (role == GEO_JSON_ROLE_COORDINATES) {
+    result = json_close_coordinates(parser);
+  } else if (role == GEO_JSON_ROLE_ROOT || role == GEO_JSON_ROLE_GEOMETRY) {
+    result = json_close_geometry(parser, role, parser->types[parser->depth]);
+  }
+  json_value_done(parser);
+  return result;
+}
+
+static unsigned json_key(char const* text, size_t length) {
+  return json_token_is(text, length, "type")          ? GEO_JSON_KEY_TYPE
+         : json_token_is(text, length, "coordinates") ? GEO_JSON_KEY_COORDINATES
+         : json_token_is(text, length, "geometry")    ? GEO_JSON_KEY_GEOMETRY
+         : json_token_is(text, length, "features")    ? GEO_JSON_KEY_FEATURES
+                                                      : GEO_JSON_KEY_OTHER;
+}
+
+/* `length` can be over the token size, the string is then none of the names */
+static enum GeoResult json_string(struct TMPL_JSON_PARSER* parser,
+                                  char const* text, size_t length) {
+  unsigned top = (unsigned)parser->depth - 1;
+  if (parser->expect == GEO_JSON_EXPECT_KEY ||
+      parser->expect == GEO_JSON_EXPECT_KEY_OR_CLOSE) {
+    parser->keys[top] = (unsigned char)json_key(text, length);
+    parser->expect = GEO_JSON_EXPECT_COLON;
+    return GEO_SUCCESS;
+  }
+  if (!json_expects_value(parser)) {
+    return GEO_ERR_INVALID_FORMAT;
+  }
+  json_value_done(parser);
+  if (parser->depth == 0 ||
+      parser->roles[top] == GEO_JSON_ROLE_COORDINATES) {
+    return parser->depth == 0 ? GEO_SUCCESS : GEO_ERR_INVALID_FORMAT;
+  }
+  if (parser->keys[top] != GEO_JSON_KEY_TYPE ||
+      (parser->roles[top] != GEO_JSON_ROLE_ROOT &&
+       parser->roles[top] != GEO_JSON_ROLE_GEOMETRY)) {
+    return GEO_SUCCESS;
+  }
+  if (json_token_is(text, length, "Point")) {
+    parser->types[top] = GEO_SHAPE_POINT;
+  } else if (json_token_is(text, length, "LineString")) {
+    parser->types[top] = GEO_SHAPE_LINE_STRING;
+  } else if (json_token_is(text, length, "Polygon")) {
+    parser->types[top] = GEO_SHAPE_POLYGON;
+  } else if (json_token_is(text, length, "MultiPolygon")) {
+    parser->types[top] = GEO_SHAPE_MULTI_POLYGON;
+  } else if (json_token_is(text, length, "MultiPoint") ||
+             json_token_is(text, length, "MultiLineString") ||
+             json_token_is(text, length, "GeometryCollection")) {
+    return GEO_ERR_UNSUPPORTED;
+  } else {
+    parser->types[top] = GEO_JSON_TYPE_OTHER;
+  }
+  return GEO_SUCCESS;
+}
+
+static enum GeoResult json_token(struct TMPL_JSON_PARSER* parser,
+                                 char const* text, size_t length) {
+  enum GeoResult result = GEO_SUCCESS;
+  bool coordinate = parser->depth > 0 && parser->roles[parser->depth - 1] ==
+                                             GEO_JSON_ROLE_COORDINATES;
+  if (!json_expects_value(parser)) {
+    return GEO_ERR_INVALID_FORMAT;
+  }
+  json_value_done(parser);
+  if (text_letter(text[0])) {
+    return !coordinate && (json_token_is(text, length, "true") ||
+                           json_token_is(text, length, "false") ||
+                           json_token_is(text, length, "null"))
+               ? GEO_SUCCESS
+               : GEO_ERR_INVALID_FORMAT;
+  }
+  /* numbers outside of coordinates are skipped without being converted */
+  if (!coordinate) {
+    return GEO_SUCCESS;
+  }
+  if (length > GEO_JSON_TOKEN_SIZE) {
+    return GEO_ERR_INVALID_FORMAT;
+  }
+  if (parser->positions_depth == 0) {
+    parser->positions_depth = parser->coordinates_depth;
+    parser->builder.polygon_start = parser->positions_depth >= 3;
+  }
+  if (parser->coordinates_depth != parser->positions_depth) {
+    return GEO_ERR_INVALID_FORMAT;
+  }
+  if (parser->axis < 2) {
+    result = parse_coordinate(text, length,
+                              parser->axis == 0 ? &parser->builder.point.x
+                                                : &parser->builder.point.y);
+  }
+  ++parser->axis;
+  return result;
+}
+
+/* the string scan goes on from `*iter`, returns true once its quote is read */
+static bool json_scan_string(struct TMPL_JSON_PARSER* parser,
+                             char const* chunk, size_t size, size_t* iter) {
+  for (; *iter < size; ++(*iter)) {
+    char c = chunk[*iter];
+    if (parser->escape) {
+      parser->escape = false;
+    } else if (c == '\\') {
+      parser->escape = true;
+    } else if (c == '"') {
+      ++(*iter);
+      parser->in_string = false;
+      return true;
+    }
+    if (parser->token_length < GEO_JSON_TOKEN_SIZE) {
+      parser->token[parser->token_length] = c;
+    }
+    ++parser->token_length;
+  }
+  return false;
+}
+
+static enum GeoResult json_feed(struct TMPL_JSON_PARSER* parser,
+                                char const* chunk, size_t size,
+                                size_t* start) {
+  enum GeoResult result = GEO_SUCCESS;
+  size_t iter = 0;
+  size_t length = 0;
+
+  if (parser->in_string) {
+    if (!json_scan_string(parser, chunk, size, &iter)) {
+      return GEO_SUCCESS;
+    }
+    result = json_string(parser, parser->token, parser->token_length);
+    parser->token_length = 0;
+  } else if (parser->token_length > 0) {
+    for (; iter < size && json_token_char(chunk[iter]); ++iter) {
+      if (parser->token_length < GEO_JSON_TOKEN_SIZE) {
+        parser->token[parser->token_length] = chunk[iter];
+      }
+      ++parser->token_length;
+    }
+    if (iter == size) {
+      return GEO_SUCCESS;
+    }
+    result = json_token(parser, parser->token, parser->token_length);
+    parser->token_length = 0;
+  }
+
+  while (result == GEO_SUCCESS && iter < size) {
+    char c = chunk[iter];
+    *start = iter;
+    if (text_space(c)) {
+      ++iter;
+    } else if (c == '{' || c == '[') {
+      result = json_open(parser, c);
+      ++iter;
+    } else if (c == '}' || c == ']') {
+      result = json_close(parser, c);
+      ++iter;
+    } else if (c == ',') {
+      if (parser->expect != GEO_JSON_EXPECT_SEPARATOR) {
+        result = GEO_ERR_INVALID_FORMAT;
+      } else {
+        parser->expect = parser->kinds[parser->depth - 1] == '{'
+                             ? GEO_JSON_EXPECT_KEY
+                             : GEO_JSON_EXPECT_VALUE;
+      }
+      ++iter;
+    } else if (c == ':') {
+      if (parser->expect != GEO_JSON_EXPECT_COLON) {
+        result = GEO_ERR_INVALID_FORMAT;
+      }
+      parser->expect = GEO_JSON_EXPECT_VALUE;
+      ++iter;
+    } else if (c == '"') {
+      ++iter;
+      parser->in_string = true;
+      parser->token_length = 0;
+      if (json_scan_string(parser, chunk, size, &iter)) {
+        result = json_string(parser, parser->token, parser->token_length);
+        parser->token_length = 0;
+      }
+    } else if (json_token_char(c)) {
+      for (++iter; iter < size && json_token_char(chunk[iter]); ++iter) {
+      }
+      length = iter - *start;
+      if (iter < size) {
+        result = json_token(parser, chunk + *start, length);
+      } else {
+        memcpy(parser->token, chunk + *start,
+               length < GEO_JSON_TOKEN_SIZE ? length : GEO_JSON_TOKEN_SIZE);
+        parser->token_length = length;
+      }
+    } else {
+      result = GEO_ERR_INVALID_FORMAT;
+    }
+  }
+  return result;
+}
+
+enum GeoResult TMPL_FUNC(geo_json_parser_init)(
+    struct TMPL_JSON_PARSER* parser, struct GeoArena* arena,
+    void (*emit)(void* context, struct TMPL_SHAPE const* shape),
+    void* context) {
+#ifndef GEO_UNSAFE
+  if (parser == NULL || arena == NULL || emit == NULL) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+  memset(parser, 0, sizeof(*parser));
+  parser->builder.arena = arena;
+  parser->emit = emit;
+  parser->context = context;
+  parser->result = GEO_SUCCESS;
+  parser->expect = GEO_JSON_EXPECT_VALUE;
+  shape_reset(&parser->builder);
+  return GEO_SUCCESS;
+}
+
+enum GeoResult TMPL_FUNC(geo_json_parse)(struct TMPL_JSON_PARSER* parser,
+                                         char const* chunk, size_t size) {
+  enum GeoResult result = GEO_SUCCESS;
+  size_t start = 0;
+#ifndef GEO_UNSAFE
+  if (parser == NULL || (chunk == NULL && size > 0)) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+  if (parser->result != GEO_SUCCESS) {
+    return parser->result;
+  }
+  result = json_feed(parser, chunk, size, &start);
+  if (result != GEO_SUCCESS) {
+    parser->result = result;
+    parser->offset += start;
+    return result;
+  }
+  parser->offset += size;
+  return GEO_SUCCESS;
+}
+
+/* call once the input has ended, a value left open is an error */
+enum GeoResult TMPL_FUNC(geo_json_parse_finish)(
+    struct TMPL_JSON_PARSER* parser) {
+  enum GeoResult result = GEO_SUCCESS;
+#ifndef GEO_UNSAFE
+  if (parser == NULL) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+  if (parser->result != GEO_SUCCESS) {
+    return parser->result;
+  }
+  if (parser->in_string) {
+    result = GEO_ERR_INVALID_FORMAT;
+  } else if (parser->token_length > 0) {
+    result = json_token(parser, parser->token, parser->token_length);
+    parser->token_length = 0;
+  }
+  if (result == GEO_SUCCESS &&
+      (parser->depth > 0 || parser->expect != GEO_JSON_EXPECT_VALUE)) {
+    result = GEO_ERR_INVALID_FORMAT;
+  }
+  parser->result = result;
+  return result;
+}
+
+/* reads `descriptor` to its end, then finishes the parse */
+enum GeoResult TMPL_FUNC(geo_json_parse_fd)(struct TMPL_JSON_PARSER* parser,
+                                            int descriptor) {
+  char buffer[GEO_READ_SIZE];
+  enum GeoResult result = GEO_SUCCESS;
+  ssize_t bytes = 0;
+#ifndef GEO_UNSAFE
+  if (parser == NULL) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+  while ((bytes = read_retry(descriptor, buffer, sizeof(buffer))) > 0) {
+    result = TMPL_FUNC(geo_json_parse)(parser, buffer, (size_t)bytes);
+    if (result != GEO_SUCCESS) {
+      return result;
+    }
+  }
+  if (bytes < 0) {
+    parser->result = GEO_ERR_IO;
+    return parser->result;
+  }
+  return TMPL_FUNC(geo_json_parse_finish)(parser);
+}
+
+#undef TMPL_SHAPE_PART
+
+/*
+ * delimited text points. the text is cut into one range per thread, every
+ * range but the first starts after a newline. the threads first count the
+ * lines of their range so each knows where its points go, then parse them
+ * straight into `xs` and `ys`.
+ */
+#ifndef GEO_CSV_THREAD_SIZE
+#define GEO_CSV_THREAD_SIZE 65536
+#endif
+
+#define TMPL_CSV_WORKER TMPL_CONCAT(GeoCsvWorker, GEO_TMPL_TYPE)
+
+struct TMPL_CSV_WORKER {
+  char const* begin;
+  char const* end;
+  char separator;
+  size_t x_column;
+  size_t y_column;
+  GEO_TMPL_TYPE* xs;
+  GEO_TMPL_TYPE* ys;
+  size_t first;  // position of the range's first point
+  size_t count;
+  bool parse;
+  enum GeoResult result;
+};
+
+static char const* csv_line_end(char const* line, char const* end) {
+  char const* newline = (char const*)memchr(line, '\n', (size_t)(end - line));
+  return newline == NULL ? end : newline;
+}
+
+static bool csv_line_blank(char const* line, char const* end) {
+  while (line < end && text_space(*line)) {
+    ++line;
+  }
+  return line == end;
+}
+
+/* the field without surrounding spaces and quotes */
+static enum GeoResult csv_parse_field(char const* field, char const* end,
+                                      GEO_TMPL_TYPE* coordinate) {
+  while (field < end && text_space(*field)) {
+    ++field;
+  }
+  while (end > field && text_space(end[-1])) {
+    --end;
+  }
+  if (end - field >= 2 && *field == '"' && end[-1] == '"') {
+    ++field;
+    --end;
+  }
+  return parse_coordinate(field, (size_t)(end - field), coordinate);
+}
+
+static enum GeoResult csv_parse_line(struct TMPL_CSV_WORKER* worker,
+                                     char const* line, char const* end,
+                                     size_t position) {
+  enum GeoResult result = GEO_SUCCESS;
+  size_t column = 0;
+  size_t found = 0;
+  char const* field = line;
+  while (found < 2) {
+    char const* field_end = (char const*)memchr(field, worker->separator,
+                                                (size_t)(end - field));
+    if (field_end == NULL) {
+      field_end = end;
+    }
+    if (column == worker->x_column) {
+      result = csv_parse_field(field, field_end, &worker->xs[position]);
+      ++found;
+    }
+    if (result == GEO_SUCCESS && column == worker->y_column) {
+      result = csv_parse_field(field, field_end, &worker->ys[position]);
+      ++found;
+    }
+    if (result != GEO_SUCCESS) {
+      return result;
+    }
+    if (found < 2 && field_end == end) {
+      return GEO_ERR_INVALID_FORMAT;
+    }
+    field = field_end + 1;
+    ++column;
+  }
+  return GEO_SUCCESS;
+}
+
+static void csv_task(void* context, size_t index) {
+  struct TMPL_CSV_WORKER* worker = &((struct TMPL_CSV_WORKER*)context)[index];
+  char const* line = worker->begin;
+  size_t count = 0;
+  while (line < worker->end) {
+    char const* end = csv_line_end(line, worker->end);
+    if (!csv_line_blank(line, end)) {
+      if (worker->parse) {
+        worker->result =
+            csv_parse_line(worker, line, end, worker->first + count);
+        if (worker->result != GEO_SUCCESS) {
+          return;
+        }
+      }
+      ++count;
+    }
+    line = end + 1;
+  }
+  worker->count = count;
+}
+
+enum GeoResult TMPL_FUNC(geo_csv_read_points)(
+    char const* text, size_t size, char separator, size_t x_column,
+    size_t y_column, bool has_header, struct GeoExecutor const* executor,
+    GEO_TMPL_TYPE* xs, GEO_TMPL_TYPE* ys, size_t capacity, size_t* count) {
+  struct TMPL_CSV_WORKER workers[GEO_MAX_THREADS];
+  char const* begin = text;
+  char const* end = text + size;
+  size_t total = 0;
+  size_t threads_count = 0;
+  enum GeoResult result = GEO_SUCCESS;
+#ifndef GEO_UNSAFE
+  if (text == NULL || count == NULL || !executor_valid(executor) ||
+      ((xs == NULL || ys == NULL) && capacity > 0)) {
+    return GEO_ERR_NULL_POINTER;
+  }
+#endif
+  if (has_header) {
+    begin = csv_line_end(begin, end);
+    begin = begin < end ? begin + 1 : end;
+  }
+  threads_count =
+      parallel_parts(executor, (size_t)(end - begin), GEO_CSV_THREAD_SIZE);
+  for (size_t iter = 0; iter < threads_count; ++iter) {
+    char const* range = begin + ((size_t)(end - begin) / threads_count) * iter;
+    if (iter > 0) {
+      range = range > workers[iter - 1].begin ? range : workers[iter - 1].begin;
+      range = csv_line_end(range - 1, end);
+      range = range < end ? range + 1 : end;
+      workers[iter - 1].end = range;
+    }
+    workers[iter].begin = range;
+    workers[iter].end = end;
+    workers[iter].separator = separator;
+    workers[iter].x_column = x_column;
+    workers[iter].y_column = y_column;
+    workers[iter].xs = xs;
+    workers[iter].ys = ys;
+    workers[iter].parse = false;
+    workers[iter].result = GEO_SUCCESS;
+  }
+  result = geo_executor_run(executor, csv_task, workers, threads_count);
+  if (result != GEO_SUCCESS) {
+    return result;
+  }
+  for (size_t iter = 0; iter < threads_count; ++iter) {
+    workers[iter].first = total;
+    workers[iter].parse = true;
+    total += workers[iter].count;
+  }
+  *count = total;
+  if (total > capacity) {
+    return GEO_ERR_TOO_SMALL;
+  }
+  result = geo_executor_run(executor, csv_task, workers, threads_count);
+  if (result != GEO_SUCCESS) {
+    return result;
+  }
+  for (size_t iter = 0; iter < threads_count; ++iter) {
+    if (workers[iter].result != GEO_SUCCESS) {
+      return workers[iter].result;
+    }
+  }
+  return GEO_SUCCESS;
+}
+
+#undef TMPL_CSV_WORKER
+
+#ifdef GEO_TRACE
+/*
+ * the public traced functions. the size is what the cost of a call grows
+ * with: segments, points or geometries of the input, 2 for a segment pair.
+ */
+enum GeoResult TMPL_FUNC(geo_segments_intersect)(
+    struct TMPL_SEGMENT const* segment1, struct TMPL_SEGMENT const* segment2,
+    size_t* intersect_count) {
+  uint64_t const start = geo_trace_begin();
+  enum GeoResult const result = UNTRACED_FUNC(geo_segments_intersect)(
+      segment1, segment2, intersect_count);
+  geo_trace_end(GEO_TRACE_SEGMENTS_INTERSECT, 2, start);
+  return result;
+}
+
+enum GeoResult TMPL_FUNC(geo_geometry_is_simple)(
+    struct TMPL_GEOMETRY const* geometry, bool* is_simple) {
+  uint64_t const start = geo_trace_begin();
+  enum GeoResult const result = UNTRACED_FUNC(geo_geometry_is_simple)(
+      geometry, is_simple);
+  geo_trace_end(GEO_TRACE_GEOMETRY_IS_SIMPLE,
+                geometry == NULL ? 0 : geometry->segments_count, start);
+  return result;
+}
+
+enum GeoResult TMPL_FUNC(geo_geometry_is_simple_parallel)(
+    struct TMPL_GEOMETRY const* geometry, struct GeoExecutor const* executor,
+    bool* is_simple) {
+  uint64_t const start = geo_trace_begin();
+  enum GeoResult const result = UNTRACED_FUNC(geo_geometry_is_simple_parallel)(
+      geometry, executor, is_simple);
+  geo_trace_end(GEO_TRACE_GEOMETRY_IS_SIMPLE,
+                geometry == NULL ? 0 : geometry->segments_count, start);
+  return result;
+}
+
+enum GeoResult TMPL_FUNC(geo_point_in_geometry)(
+    struct TMPL_POINT const* point, struct TMPL_GEOMETRY const* geometry,
+    bool strict, bool* is_inside) {
+  uint64_t const start = geo_trace_begin();
+  enum GeoResult const result = UNTRACED_FUNC(geo_point_in_geometry)(
+      point, geometry, strict, is_inside);
+  geo_trace_end(GEO_TRACE_POINT_IN_GEOMETRY,
+                geometry == NULL ? 0 : geometry->segments_count, start);
+  return result;
+}
+
+enum GeoResult TMPL_FUNC(geo_geometry_in_geometry)(
+    struct TMPL_GEOMETRY* parent, struct TMPL_GEOMETRY* child, bool strict,
+    bool* is_inside) {
+  uint64_t const start = geo_trace_begin();
+  enum GeoResult const result = UNTRACED_FUNC(geo_geometry_in_geometry)(
+      parent, child, strict, is_inside);
+  geo_trace_end(GEO_TRACE_GEOMETRY_IN_GEOMETRY,
+                child == NULL ? 0 : child->segments_count, start);
+  return result;
+}
+
+enum GeoResult TMPL_FUNC(geo_convex_hull)(
+    struct TMPL_POINT** points, struct TMPL_POINT** convex_hull, size_t size,
+    size_t* convex_hull_size) {
+  uint64_t const start = geo_trace_begin();
+  enum GeoResult const result = UNTRACED_FUNC(geo_convex_hull)(
+      points, convex_hull, size, convex_hull_size);
+  geo_trace_end(GEO_TRACE_CONVEX_HULL, size, start);
+  return result;
+}
+
+enum GeoResult TMPL_FUNC(geo_convex_hull_soa)(
+    struct TMPL_POINTS_SOA const* points, struct GeoExecutor const* executor,
+    struct GeoAllocator const* allocator, size_t* convex_hull,
+    size_t* convex_hull_size) {
+  uint64_t const start = geo_trace_begin();
+  enum GeoResult const result = UNTRACED_FUNC(geo_convex_hull_soa)(
+      points, executor, allocator, convex_hull, convex_hull_size);
+  geo_trace_end(GEO_TRACE_CONVEX_HULL_SOA,
+                points == NULL ? 0 : points->count, start);
+  return result;
+}
+
+enum GeoResult TMPL_FUNC(geo_points_in_geometry_soa)(
+    struct TMPL_POINTS_SOA const* points, struct TMPL_GEOMETRY const* geometry,
+    bool strict, struct GeoExecutor const* executor, bool* is_inside) {
+  uint64_t const start = geo_trace_begin();
+  enum GeoResult const result = UNTRACED_FUNC(geo_points_in_geometry_soa)(
+      points, geometry, strict, executor, is_inside);
+  geo_trace_end(GEO_TRACE_POINTS_IN_GEOMETRY_SOA,
+                points == NULL ? 0 : points->count, start);
+  return result;
+}
+
+enum GeoResult TMPL_FUNC(geo_index_build)(
+    struct TMPL_GEOMETRY* const* geometries, size_t count,
+    struct GeoExecutor const* executor, void* buffer, size_t buffer_size) {
+  uint64_t const start = geo_trace_begin();
+  enum GeoResult const result = UNTRACED_FUNC(geo_index_build)(
+      geometries, count, executor, buffer, buffer_size);
+  geo_trace_end(GEO_TRACE_INDEX_BUILD, count, start);
+  return result;
+}
+
+enum GeoResult TMPL_FUNC(geo_index_query_point)(
+    struct TMPL_INDEX const* index, struct TMPL_POINT const* point, bool strict,
+    size_t* ids, size_t ids_capacity, size_t* ids_count) {
+  uint64_t const start = geo_trace_begin();
+  enum GeoResult const result = UNTRACED_FUNC(geo_index_query_point)(
+      index, point, strict, ids, ids_capacity, ids_count);
+  geo_trace_end(GEO_TRACE_INDEX_QUERY_POINT,
+                index == NULL ? 0 : index->entries_count, start);
+  return result;
+}
+
+enum GeoResult TMPL_FUNC(geo_spatial_join)(
+    struct TMPL_POINT const* points, size_t points_count,
+    struct TMPL_GEOMETRY* const* geometries, size_t geometries_count,
+    bool strict, struct GeoExecutor const* executor,
+    struct GeoAllocator const* allocator, struct GeoJoinPair* pairs,
+    size_t pairs_capacity, size_t* pairs_count) {
+  uint64_t const start = geo_trace_begin();
+  enum GeoResult const result = UNTRACED_FUNC(geo_spatial_join)(
+      points, points_count, geometries, geometries_count, strict, executor,
+      allocator, pairs, pairs_capacity, pairs_count);
+  geo_trace_end(GEO_TRACE_SPATIAL_JOIN, points_count, start);
+  return result;
+}
+
+enum GeoResult TMPL_FUNC(geo_spatial_join_count)(
+    struct TMPL_POINT const* points, size_t points_count,
+    struct TMPL_GEOMETRY* const* geometries, size_t geometries_count,
+    bool strict, struct GeoExecutor const* executor,
+    struct GeoAllocator const* allocator, size_t* counts) {
+  uint64_t const start = geo_trace_begin();
+  enum GeoResult const result = UNTRACED_FUNC(geo_spatial_join_count)(
+      points, points_count, geometries, geometries_count, strict, executor,
+      allocator, counts);
+  geo_trace_end(GEO_TRACE_SPATIAL_JOIN_COUNT, points_count, start);
+  return result;
+}
+
+enum GeoResult TMPL_FUNC(geo_ring_view_is_simple)(
+    struct TMPL_RING_VIEW const* view, bool* is_simple) {
+  uint64_t const start = geo_trace_begin();
+  enum GeoResult const result = UNTRACED_FUNC(geo_ring_view_is_simple)(
+      view, is_simple);
+  geo_trace_end(GEO_TRACE_RING_VIEW_IS_SIMPLE,
+                view == NULL ? 0 : view->points_count, start);
+  return result;
+}
+
+enum GeoResult TMPL_FUNC(geo_ring_view_is_simple_parallel)(
+    struct TMPL_RING_VIEW const* view, struct GeoExecutor const* executor,
+    bool* is_simple) {
+  uint64_t const start = geo_trace_begin();
+  enum GeoResult const result =
+      UNTRACED_FUNC(geo_ring_view_is_simple_parallel)(view, executor,
+                                                      is_simple);
+  geo_trace_end(GEO_TRACE_RING_VIEW_IS_SIMPLE,
+                view == NULL ? 0 : view->points_count, start);
+  return result;
+}
+
+enum GeoResult TMPL_FUNC(geo_point_in_ring_view)(
+    struct TMPL_POINT const* point, struct TMPL_RING_VIEW const* view,
+    bool strict, bool* is_inside) {
+  uint64_t const start = geo_trace_begin();
+  enum GeoResult const result = UNTRACED_FUNC(geo_point_in_ring_view)(
+      point, view, strict, is_inside);
+  geo_trace_end(GEO_TRACE_POINT_IN_RING_VIEW,
+                view == NULL ? 0 : view->points_count, start);
+  return result;
+}
+
+enum GeoResult TMPL_FUNC(geo_point_in_polygon_view)(
+    struct TMPL_POINT const* point, struct TMPL_POLYGON_VIEW const* polygon,
+    bool strict, bool* is_inside) {
+  uint64_t const start = geo_trace_begin();
+  size_t size = 0;
+  enum GeoResult const result = UNTRACED_FUNC(geo_point_in_polygon_view)(
+      point, polygon, strict, is_inside);
+  if (polygon != NULL && polygon->rings != NULL) {
+    for (size_t iter = 0; iter < polygon->rings_count; ++iter) {
+      size += polygon->rings[iter].points_count;
+    }
+  }
+  geo_trace_end(GEO_TRACE_POINT_IN_POLYGON_VIEW, size, start);
+  return result;
+}
+
+#endif
+
+#undef UNTRACED_FUNC
 #endif
 
 #undef TMPL_CONCAT
@@ -602,11 +6055,26 @@ enum GeoResult TMPL_FUNC(geo_convex_hull)(struct TMPL_POINT** points,
 #undef TMPL_POINT
 #undef TMPL_SEGMENT
 #undef TMPL_GEOMETRY
+#undef TMPL_ENVELOPE
+#undef TMPL_RING_VIEW
+#undef TMPL_POLYGON_VIEW
+#undef TMPL_SHAPE
+#undef TMPL_SHAPE_BUILDER
+#undef TMPL_WKT_PARSER
+#undef TMPL_JSON_PARSER
+#undef TMPL_GRID
+#undef TMPL_INDEX
+#undef TMPL_INDEX_NODE
+#undef TMPL_INDEX_ENTRY
+#undef TMPL_GRID_SLOT
+#undef TMPL_POINTS_SOA
 #undef TMPL_FUNC
 #undef GEO_TMPL_TYPE_FIXED
 #undef GEO_ABS_EPSILON
 #undef GEO_REL_EPSILON
 #undef GEO_MAX_ULPS
 #undef GEO_ZERO
+#undef GEO_INDEX_COORDINATE_KIND
+#undef GEO_BUILD_ALIGNMENT
 
 #endif
@@ -0,0 +1,368 @@
+#ifndef GEO_GEOMETRY_HPP
+#define GEO_GEOMETRY_HPP
+
+/*****************************************************************************
+ * GEO C++20 FRONT END
+ *
+ * the predicates of `geometry.h` as templates, header only and without the
+ * GEO_TMPL_TYPE instantiation. every function is constexpr so calls fold into
+ * the caller, or into a constant when the shapes are, and the answers are the
+ * same as the C functions of the same type give, floating point tolerances
+ * included.
+ *****************************************************************************/
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <type_traits>
+
+namespace geo {
+
+/*
+ * floating point comparison settings, the defaults of GEO_ABS_EPSILON,
+ * GEO_REL_EPSILON and GEO_MAX_ULPS. specialize it to use other floating
+ * point types, `Bits` is the signed integer of the same size.
+ */
+template <class T>
+struct Tolerance;
+
+template <>
+struct Tolerance<double> {
+  static constexpr double absolute = 1e-12;
+  static constexpr double relative = 1e-9;
+  static constexpr std::int64_t ulps = 4;
+  using Bits = std::int64_t;
+};
+
+template <>
+struct Tolerance<float> {
+  static constexpr double absolute = 1e-9;
+  static constexpr double relative = 1e-6;
+  static constexpr std::int32_t ulps = 4;
+  using Bits = std::int32_t;
+};
+
+/*
+ * number types compared with `==` instead of a tolerance, the integers and
+ * anything `std::numeric_limits` calls exact. specialize it for a rational
+ * type that does not specialize `std::numeric_limits`.
+ */
+template <class T>
+struct Exact : std::bool_constant<std::numeric_limits<T>::is_exact> {};
+
+template <class T>
+concept ExactCoordinate =
+    Exact<T>::value && !std::same_as<T, bool> &&
+    requires(T const lhs, T const rhs) {
+      T{0};
+      { lhs + rhs } -> std::convertible_to<T>;
+      { lhs - rhs } -> std::convertible_to<T>;
+      { lhs * rhs } -> std::convertible_to<T>;
+      { lhs == rhs } -> std::convertible_to<bool>;
+      { lhs < rhs } -> std::convertible_to<bool>;
+      { lhs <= rhs } -> std::convertible_to<bool>;
+      { lhs >= rhs } -> std::convertible_to<bool>;
+    };
+
+template <class T>
+concept Coordinate =
+    ExactCoordinate<T> ||
+    (std::floating_point<T> && requires {
+      Tolerance<T>::absolute;
+      Tolerance<T>::relative;
+      Tolerance<T>::ulps;
+      typename Tolerance<T>::Bits;
+    });
+
+enum class Orientation : int { right = -1, colinear = 0, left = 1 };
+
+template <Coordinate T>
+struct Point {
+  T x;
+  T y;
+};
+
+template <Coordinate T>
+struct Segment {
+  Point<T> start;
+  Point<T> end;
+};
+
+template <Coordinate T>
+struct Envelope {
+  Point<T> min;
+  Point<T> max;
+};
+
+/* a closed ring, the last point repeats the first like GeoRingView_<type> */
+template <Coordinate T>
+struct Ring {
+  std::span<Point<T> const> points;
+};
+
+/* the outer ring first, then the holes, like GeoPolygonView_<type> */
+template <Coordinate T>
+struct Polygon {
+  std::span<Ring<T> const> rings;
+};
+
+/*
+ * exact for `ExactCoordinate` types, the tolerances of `Tolerance<T>` for
+ * floating point. <cmath> is not constexpr before C++23, so NaN, infinity,
+ * magnitude and sign are tested by hand.
+ */
+template <Coordinate T>
+[[nodiscard]] constexpr bool equal(T lhs, T rhs) {
+  if constexpr (ExactCoordinate<T>) {
+    return lhs == rhs;
+  } else {
+    using Bits = typename Tolerance<T>::Bits;
+    constexpr T infinity = std::numeric_limits<T>::infinity();
+    if (lhs != lhs || rhs != rhs) {
+      return false;
+    }
+    if (!(lhs < rhs) && !(rhs < lhs)) {
+      return true;
+    }
+    if (lhs == infinity || lhs == -infinity || rhs == infinity ||
+        rhs == -infinity) {
+      return false;
+    }
+    T const diff = lhs < rhs ? rhs - lhs : lhs - rhs;
+    if (diff <= Tolerance<T>::absolute) {
+      return true;
+    }
+    T const lhs_abs = lhs < T{0} ? -lhs : lhs;
+    T const rhs_abs = rhs < T{0} ? -rhs : rhs;
+    T const largest = lhs_abs < rhs_abs ? rhs_abs : lhs_abs;
+    if (diff <= largest * Tolerance<T>::relative) {
+      return true;
+    }
+    Bits const lhs_bits = std::bit_cast<Bits>(lhs);
+    Bits const rhs_bits = std::bit_cast<Bits>(rhs);
+    if ((lhs_bits < 0) != (rhs_bits < 0)) {
+      return false;
+    }
+    Bits const ulp_diff =
+        lhs_bits > rhs_bits ? lhs_bits - rhs_bits : rhs_bits - lhs_bits;
+    return ulp_diff <= Tolerance<T>::ulps;
+  }
+}
+
+template <Coordinate T>
+[[nodiscard]] constexpr bool points_equal(Point<T> const& lhs,
+                                       Point<T> const& rhs) {
+  return equal(lhs.x, rhs.x) && equal(lhs.y, rhs.y);
+}
+
+/* which side of the line from `start` through `end` `point` is on */
+template <Coordinate T>
+[[nodiscard]] constexpr Orientation orientation(Point<T> const& start,
+                                             Point<T> const& end,
+                                             Point<T> const& point) {
+  T const cross = static_cast<T>(((end.x - start.x) * (point.y - start.y)) -
+                                 ((end.y - start.y) * (point.x - start.x)));
+  if (equal(cross, T{0})) {
+    return Orientation::colinear;
+  }
+  return cross < T{0} ? Orientation::right : Orientation::left;
+}
+
+/* whether `point` projects onto the segment, for colinear points */
+template <Coordinate T>
+[[nodiscard]] constexpr bool in_disk(Segment<T> const& segment,
+                                  Point<T> const& point) {
+  T const dot = static_cast<T>(((segment.start.x - point.x) *
+                                (segment.end.x - point.x)) +
+                               ((segment.start.y - point.y) *
+                                (segment.end.y - point.y)));
+  return dot <= T{0};
+}
+
+/*
+ * 1 when the segments cross, otherwise the number of end points lying on the
+ * other segment, like geo_segments_intersect_<type>.
+ */
+template <Coordinate T>
+[[nodiscard]] constexpr std::size_t segments_intersect(Segment<T> const& first,
+                                                    Segment<T> const& second) {
+  Orientation const orientation_a =
+      orientation(second.start, second.end, first.start);
+  Orientation const orientation_b =
+      orientation(second.start, second.end, first.end);
+  Orientation const orientation_c =
+      orientation(first.start, first.end, second.start);
+  Orientation const orientation_d =
+      orientation(first.start, first.end, second.end);
+  if (static_cast<int>(orientation_a) * static_cast<int>(orientation_b) < 0 &&
+      static_cast<int>(orientation_c) * static_cast<int>(orientation_d) < 0) {
+    return 1;
+  }
+  std::size_t count = 0;
+  Orientation constexpr colinear = Orientation::colinear;
+  count += orientation_a == colinear && in_disk(second, first.start);
+  count += orientation_b == colinear && in_disk(second, first.end);
+  count += orientation_c == colinear && in_disk(first, second.start);
+  count += orientation_d == colinear && in_disk(first, second.end);
+  return count;
+}
+
+/* rings need 4 points, smaller ones are neither closed nor simple */
+template <Coordinate T>
+[[nodiscard]] constexpr bool ring_is_closed(Ring<T> const& ring) {
+  return ring.points.size() >= 4 &&
+         points_equal(ring.points.front(), ring.points.back());
+}
+
+/* the checks of geo_ring_view_is_simple_<type> */
+template <Coordinate T>
+[[nodiscard]] constexpr bool ring_is_simple(Ring<T> const& ring) {
+  std::span<Point<T> const> const points = ring.points;
+  if (points.size() < 4) {
+    return false;
+  }
+  std::size_t const segments_count = points.size() - 1;
+  Segment<T> first{points[0], points[1]};
+  // the first segment touches its neighbours and nothing else.
+  for (std::size_t i = 1; i < segments_count; ++i) {
+    Segment<T> const other{points[i], points[i + 1]};
+    std::size_t const expected = (i == 1 || i == segments_count - 1) ? 2 : 0;
+    if (segments_intersect(first, other) != expected) {
+      return false;
+    }
+  }
+  for (std::size_t i = 1; i < segments_count - 1; ++i) {
+    first = Segment<T>{points[i], points[i + 1]};
+    if (segments_intersect(first, Segment<T>{points[i + 1], points[i + 2]}) !=
+        2) {
+      return false;
+    }
+    for (std::size_t j = i + 2; j < segments_count; ++j) {
+      if (segments_intersect(first, Segment<T>{points[j], points[j + 1]}) !=
+          0) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/*
+ * even-odd ray cast. points on an edge are inside unless `strict`, rings
+ * under 4 points contain nothing.
+ */
+template <Coordinate T>
+[[nodiscard]] constexpr bool point_in_ring(Point<T> const& point,
+                                        Ring<T> const& ring,
+                                        bool strict = false) {
+  std::span<Point<T> const> const points = ring.points;
+  if (points.size() < 4) {
+    return false;
+  }
+  std::size_t intersections = 0;
+  for (std::size_t iter = 1; iter < points.size(); ++iter) {
+    Point<T> const& start = points[iter - 1];
+    Point<T> const& end = points[iter];
+    Orientation const side = orientation(start, end, point);
+    if (side == Orientation::colinear &&
+        in_disk(Segment<T>{start, end}, point)) {
+      return !strict;
+    }
+    intersections += (((end.y >= point.y) - (start.y >= point.y)) *
+                      static_cast<int>(side)) > 0;
+  }
+  return (intersections & 1) != 0;
+}
+
+/*
+ * inside the outer ring and outside every hole, the boundary of a hole
+ * follows `strict` like the outer one. polygons without rings contain
+ * nothing.
+ */
+template <Coordinate T>
+[[nodiscard]] constexpr bool point_in_polygon(Point<T> const& point,
+                                              Polygon<T> const& polygon,
+                                              bool strict = false) {
+  if (polygon.rings.empty()) {
+    return false;
+  }
+  bool is_inside = point_in_ring(point, polygon.rings[0], strict);
+  for (std::size_t iter = 1; is_inside && iter < polygon.rings.size();
+       ++iter) {
+    if (point_in_ring(point, polygon.rings[iter], true)) {
+      is_inside = false;
+    } else if (point_in_ring(point, polygon.rings[iter], false)) {
+      is_inside = !strict;
+    }
+  }
+  return is_inside;
+}
+
+/* rings under 4 points give a zero envelope */
+template <Coordinate T>
+[[nodiscard]] constexpr Envelope<T> envelope(Ring<T> const& ring) {
+  if (ring.points.size() < 4) {
+    return Envelope<T>{};
+  }
+  Envelope<T> result{ring.points.front(), ring.points.front()};
+  for (Point<T> const& point : ring.points) {
+    result.min.x = std::min(result.min.x, point.x);
+    result.min.y = std::min(result.min.y, point.y);
+    result.max.x = std::max(result.max.x, point.x);
+    result.max.y = std::max(result.max.y, point.y);
+  }
+  return result;
+}
+
+/*
+ * andrew's monotone chain, like geo_convex_hull_soa_<type>. sorts `points`
+ * by x then y and writes the hull counterclockwise from the lowest of the
+ * leftmost points to `hull`, returning its size. `hull` needs room for every
+ * point, under 3 points or a smaller `hull` returns 0.
+ */
+template <Coordinate T>
+constexpr std::size_t convex_hull(std::span<Point<T>> points,
+                               std::span<Point<T>> hull) {
+  if (points.size() < 3 || hull.size() < points.size()) {
+    return 0;
+  }
+  std::sort(points.begin(), points.end(),
+            [](Point<T> const& lhs, Point<T> const& rhs) {
+              return lhs.x < rhs.x || (!(rhs.x < lhs.x) && lhs.y < rhs.y);
+            });
+  std::size_t size = 0;
+  for (Point<T> const& point : points) {
+    while (size >= 2 && orientation(hull[size - 2], hull[size - 1], point) !=
+                            Orientation::left) {
+      --size;
+    }
+    hull[size++] = point;
+  }
+  /*
+   * the upper hull keeps its last point in `top` rather than in `hull`: the
+   * next point may still pop it and the chain can be one past every point.
+   */
+  std::size_t const lower_size = size;
+  Point<T> top = hull[--size];
+  for (std::size_t iter = points.size() - 1; iter > 0; --iter) {
+    Point<T> const& point = points[iter - 1];
+    while (size >= lower_size &&
+           orientation(hull[size - 1], top, point) != Orientation::left) {
+      top = hull[--size];
+    }
+    if (iter > 1) {
+      hull[size++] = top;
+      top = point;
+    }
+  }
+  hull[size++] = top;
+  return size;
+}
+
+}  // namespace geo
+
+#endif
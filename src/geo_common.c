@@ -0,0 +1,3 @@
+#define GEO_COMMON_IMPL
+#include "geo_common.h"
+#undef GEO_COMMON_IMPL
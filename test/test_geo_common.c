@@ -0,0 +1,370 @@
+#include "geo_common.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*----------------------------------
+ * public/extern function tests
+ *----------------------------------
+ */
+
+/*----------------------------------
+ * geo_file_map tests
+ *----------------------------------
+ */
+void geo_file_map_returns_geo_err_null_pointer_when_path_is_null(void) {
+  struct GeoFileMap map;
+  enum GeoResult result = geo_file_map(NULL, &map);
+  assert(result == GEO_ERR_NULL_POINTER);
+}
+
+void geo_file_map_returns_geo_err_io_when_file_does_not_exist(void) {
+  struct GeoFileMap map;
+  enum GeoResult result = geo_file_map("./bin/does_not_exist.bin", &map);
+  assert(result == GEO_ERR_IO);
+}
+
+void geo_file_map_returns_geo_success_and_maps_file_written_by_geo_file_write(void) {
+  char const data[] = "packed geometry";
+  struct GeoFileMap map;
+  enum GeoResult result = geo_file_write("./bin/test_geo_file_map.bin", data, sizeof(data));
+  assert(result == GEO_SUCCESS);
+  result = geo_file_map("./bin/test_geo_file_map.bin", &map);
+  assert(result == GEO_SUCCESS);
+  assert(map.size == sizeof(data));
+  assert(memcmp(map.data, data, sizeof(data)) == 0);
+  result = geo_file_unmap(&map);
+  assert(result == GEO_SUCCESS);
+  assert(map.data == NULL);
+  remove("./bin/test_geo_file_map.bin");
+}
+
+/*----------------------------------
+ * geo_file_write tests
+ *----------------------------------
+ */
+void geo_file_write_returns_geo_err_null_pointer_when_data_is_null(void) {
+  enum GeoResult result = geo_file_write("./bin/test_geo_file_write.bin", NULL, 1);
+  assert(result == GEO_ERR_NULL_POINTER);
+}
+
+void geo_file_write_returns_geo_err_io_when_directory_does_not_exist(void) {
+  char const data[] = "x";
+  enum GeoResult result = geo_file_write("./bin/missing/test.bin", data, 1);
+  assert(result == GEO_ERR_IO);
+}
+
+/*----------------------------------
+ * geo_arena tests
+ *----------------------------------
+ */
+void geo_arena_alloc_returns_geo_success_and_aligned_memory_until_full(void) {
+  unsigned char buffer[64];
+  struct GeoArena arena;
+  void *first = NULL;
+  void *second = NULL;
+  assert(geo_arena_init(&arena, buffer, sizeof(buffer)) == GEO_SUCCESS);
+  assert(geo_arena_alloc(&arena, 3, 1, &first) == GEO_SUCCESS);
+  assert(geo_arena_alloc(&arena, 8, 8, &second) == GEO_SUCCESS);
+  assert(((size_t)second & 7) == 0);
+  assert((unsigned char *)second >= (unsigned char *)first + 3);
+  assert(geo_arena_alloc(&arena, 64, 1, &second) == GEO_ERR_FULL);
+  assert(geo_arena_reset(&arena) == GEO_SUCCESS);
+  assert(geo_arena_alloc(&arena, 64, 1, &second) == GEO_SUCCESS);
+  assert(second == buffer);
+}
+
+void geo_arena_alloc_returns_geo_err_out_of_range_when_alignment_is_not_a_power_of_2(void) {
+  unsigned char buffer[16];
+  struct GeoArena arena;
+  void *memory = NULL;
+  geo_arena_init(&arena, buffer, sizeof(buffer));
+  assert(geo_arena_alloc(&arena, 1, 3, &memory) == GEO_ERR_OUT_OF_RANGE);
+}
+
+/*----------------------------------
+ * geo_parse_double tests
+ *----------------------------------
+ */
+static double parse_double(char const *text) {
+  double value = 0;
+  assert(geo_parse_double(text, strlen(text), &value) == GEO_SUCCESS);
+  return value;
+}
+
+void geo_parse_double_returns_geo_success_and_same_value_as_strtod(void) {
+  char const *texts[] = {"0",     "-0.5",  "+12.25", "1e3",     "1.5E-3",         ".5",
+                         "7.",    "123456789012345678901234", "-179.99999999999997",
+                         "0.1",   "2.2250738585072014e-308",  "4.9e-324", "1e22", "1e23",
+                         "9007199254740993", "3.14159265358979323846"};
+  for (size_t iter = 0; iter < sizeof(texts) / sizeof(texts[0]); ++iter) {
+    double expected = strtod(texts[iter], NULL);
+    double value = parse_double(texts[iter]);
+    assert(memcmp(&value, &expected, sizeof(value)) == 0);
+  }
+}
+
+void geo_parse_double_returns_geo_success_and_same_value_as_strtod_for_hard_cases(void) {
+  char const *texts[] = {"2.2250738585072011e-308", "2.4703282292062327e-324", "2.4703282292062328e-324",
+                         "1.7976931348623158e308",  "-1e-400",                 "4.4501477170144023e-308",
+                         "9007199254740992.5",      "9007199254740993.0000000000000000000000000001",
+                         "0.000000000000000000000000000000000000000000001e-280", "1e-323"};
+  for (size_t iter = 0; iter < sizeof(texts) / sizeof(texts[0]); ++iter) {
+    double expected = strtod(texts[iter], NULL);
+    double value = parse_double(texts[iter]);
+    assert(memcmp(&value, &expected, sizeof(value)) == 0);
+  }
+}
+
+void geo_parse_double_returns_geo_success_and_same_value_as_strtod_for_long_numbers(void) {
+  char text[1200];
+  uint64_t seed = 7;
+  for (size_t iter = 0; iter < 2000; ++iter) {
+    size_t const digits = 17 + (iter % 8) + ((iter % 50) == 0 ? 1000 : 0) + ((iter % 7) == 0 ? 120 : 0);
+    size_t length = 0;
+    double expected = 0;
+    double value = 0;
+    for (size_t digit = 0; digit < digits; ++digit) {
+      seed = (seed * 6364136223846793005ULL) + 1442695040888963407ULL;
+      text[length++] = (char)('0' + ((seed >> 33) % 10));
+      if (digit == 0) {
+        text[length++] = '.';
+      }
+    }
+    seed = (seed * 6364136223846793005ULL) + 1442695040888963407ULL;
+    length += (size_t)sprintf(text + length, "e%d", (int)((seed >> 33) % 640) - 330);
+    expected = strtod(text, NULL);
+    if (expected > 1.7976931348623157e308) {
+      assert(geo_parse_double(text, length, &value) == GEO_ERR_OUT_OF_RANGE);
+      continue;
+    }
+    assert(geo_parse_double(text, length, &value) == GEO_SUCCESS);
+    assert(memcmp(&value, &expected, sizeof(value)) == 0);
+  }
+}
+
+void geo_parse_double_returns_geo_err_invalid_format_when_text_is_not_a_number(void) {
+  char const *texts[] = {"", "-", ".", "1e", "1e+", "1.2.3", "1x", "nan", "inf", "--1"};
+  double value = 0;
+  for (size_t iter = 0; iter < sizeof(texts) / sizeof(texts[0]); ++iter) {
+    assert(geo_parse_double(texts[iter], strlen(texts[iter]), &value) == GEO_ERR_INVALID_FORMAT);
+  }
+}
+
+void geo_parse_double_returns_geo_err_out_of_range_when_number_overflows(void) {
+  double value = 0;
+  assert(geo_parse_double("1e400", 5, &value) == GEO_ERR_OUT_OF_RANGE);
+  assert(geo_parse_double("1.7976931348623159e308", 22, &value) == GEO_ERR_OUT_OF_RANGE);
+}
+
+/*----------------------------------
+ * geo_parse_int64 tests
+ *----------------------------------
+ */
+void geo_parse_int64_returns_geo_success_for_the_int64_range(void) {
+  int64_t value = 0;
+  assert(geo_parse_int64("-42", 3, &value) == GEO_SUCCESS && value == -42);
+  assert(geo_parse_int64("9223372036854775807", 19, &value) == GEO_SUCCESS && value == INT64_MAX);
+  assert(geo_parse_int64("-9223372036854775808", 20, &value) == GEO_SUCCESS && value == INT64_MIN);
+  assert(geo_parse_int64("9223372036854775808", 19, &value) == GEO_ERR_OUT_OF_RANGE);
+  assert(geo_parse_int64("1.5", 3, &value) == GEO_ERR_INVALID_FORMAT);
+  assert(geo_parse_int64("+", 1, &value) == GEO_ERR_INVALID_FORMAT);
+}
+
+/*----------------------------------
+ * geo_simd_level tests
+ *----------------------------------
+ */
+void geo_simd_level_returns_geo_err_null_pointer_when_level_is_null(void) {
+  assert(geo_simd_level(NULL) == GEO_ERR_NULL_POINTER);
+}
+
+void geo_simd_level_returns_geo_success_and_a_known_level(void) {
+  enum GeoSimdLevel level = GEO_SIMD_AVX512;
+  assert(geo_simd_level(&level) == GEO_SUCCESS);
+  assert(level >= GEO_SIMD_GENERIC && level <= GEO_SIMD_AVX512);
+#ifdef GEO_NO_SIMD_DISPATCH
+  assert(level == GEO_SIMD_GENERIC);
+#endif
+}
+
+/*----------------------------------
+ * geo_executor tests
+ *----------------------------------
+ */
+struct ExecutorCounts {
+  size_t runs[1000];
+  struct GeoExecutor const *executor;
+};
+
+static void count_run(void *context, size_t index) {
+  struct ExecutorCounts *counts = context;
+  __atomic_fetch_add(&counts->runs[index], 1, __ATOMIC_RELAXED);
+}
+
+/* every task starts a batch of its own on the same executor */
+static void nested_run(void *context, size_t index) {
+  struct ExecutorCounts *counts = context;
+  struct ExecutorCounts *inner = malloc(sizeof(struct ExecutorCounts));
+  memset(inner, 0, sizeof(struct ExecutorCounts));
+  assert(geo_executor_run(counts->executor, count_run, inner, 10) == GEO_SUCCESS);
+  for (size_t iter = 0; iter < 10; ++iter) {
+    assert(inner->runs[iter] == 1);
+  }
+  free(inner);
+  __atomic_fetch_add(&counts->runs[index], 1, __ATOMIC_RELAXED);
+}
+
+static bool refusing_submit(void *context, void (*job)(void *argument), void *argument) {
+  (void)context;
+  (void)job;
+  (void)argument;
+  return false;
+}
+
+/* keeps the jobs to start them after the batches returned */
+struct DeferredJobs {
+  void (*jobs[GEO_EXECUTOR_BATCHES * 2])(void *argument);
+  void *arguments[GEO_EXECUTOR_BATCHES * 2];
+  size_t count;
+};
+
+static bool deferring_submit(void *context, void (*job)(void *argument), void *argument) {
+  struct DeferredJobs *deferred = context;
+  deferred->jobs[deferred->count] = job;
+  deferred->arguments[deferred->count] = argument;
+  ++deferred->count;
+  return true;
+}
+
+void geo_pool_init_returns_geo_err_null_pointer_when_pool_is_null(void) {
+  assert(geo_pool_init(NULL, 1) == GEO_ERR_NULL_POINTER);
+}
+
+void geo_pool_init_returns_geo_err_too_small_when_threads_count_is_0(void) {
+  struct GeoPool pool;
+  assert(geo_pool_init(&pool, 0) == GEO_ERR_TOO_SMALL);
+}
+
+void geo_pool_executor_returns_geo_success_and_the_threads_and_the_caller_as_concurrency(void) {
+  struct GeoPool pool;
+  struct GeoExecutor executor = {NULL, NULL, 0};
+  assert(geo_pool_init(&pool, 3) == GEO_SUCCESS);
+  assert(geo_pool_executor(&pool, &executor) == GEO_SUCCESS);
+  assert(executor.submit != NULL);
+  assert(executor.concurrency == 4);
+  assert(geo_pool_destroy(&pool) == GEO_SUCCESS);
+  assert(pool.state == NULL);
+  assert(geo_pool_executor(&pool, &executor) == GEO_ERR_NULL_POINTER);
+}
+
+void geo_executor_run_returns_geo_err_null_pointer_when_task_is_null(void) {
+  assert(geo_executor_run(NULL, NULL, NULL, 1) == GEO_ERR_NULL_POINTER);
+}
+
+void geo_executor_run_returns_geo_success_and_runs_every_index_once(void) {
+  struct GeoPool pool;
+  struct GeoExecutor executor;
+  struct GeoExecutor refusing = {refusing_submit, NULL, 8};
+  struct GeoExecutor const *executors[3];
+  struct ExecutorCounts *counts = malloc(sizeof(struct ExecutorCounts));
+  assert(geo_pool_init(&pool, 7) == GEO_SUCCESS);
+  assert(geo_pool_executor(&pool, &executor) == GEO_SUCCESS);
+  executors[0] = NULL;
+  executors[1] = &executor;
+  executors[2] = &refusing;
+  for (size_t iter = 0; iter < 3; ++iter) {
+    memset(counts, 0, sizeof(struct ExecutorCounts));
+    assert(geo_executor_run(executors[iter], count_run, counts, 1000) == GEO_SUCCESS);
+    for (size_t index = 0; index < 1000; ++index) {
+      assert(counts->runs[index] == 1);
+    }
+  }
+  assert(geo_executor_run(&executor, count_run, counts, 0) == GEO_SUCCESS);
+  assert(geo_pool_destroy(&pool) == GEO_SUCCESS);
+  free(counts);
+}
+
+void geo_executor_run_returns_geo_success_when_tasks_run_batches_on_the_same_executor(void) {
+  struct GeoPool pool;
+  struct GeoExecutor executor;
+  struct ExecutorCounts *counts = malloc(sizeof(struct ExecutorCounts));
+  assert(geo_pool_init(&pool, 3) == GEO_SUCCESS);
+  assert(geo_pool_executor(&pool, &executor) == GEO_SUCCESS);
+  memset(counts, 0, sizeof(struct ExecutorCounts));
+  counts->executor = &executor;
+  assert(geo_executor_run(&executor, nested_run, counts, 100) == GEO_SUCCESS);
+  for (size_t index = 0; index < 100; ++index) {
+    assert(counts->runs[index] == 1);
+  }
+  assert(geo_pool_destroy(&pool) == GEO_SUCCESS);
+  free(counts);
+}
+
+void geo_executor_run_returns_geo_success_and_runs_in_order_when_every_batch_is_taken(void) {
+  struct DeferredJobs *deferred = malloc(sizeof(struct DeferredJobs));
+  struct GeoExecutor executor = {deferring_submit, NULL, 2};
+  struct ExecutorCounts *counts = malloc(sizeof(struct ExecutorCounts));
+  deferred->count = 0;
+  executor.context = deferred;
+  /* every call leaves a job holding its batch, the last ones find none free */
+  for (size_t iter = 0; iter < GEO_EXECUTOR_BATCHES + 4; ++iter) {
+    memset(counts, 0, sizeof(struct ExecutorCounts));
+    assert(geo_executor_run(&executor, count_run, counts, 100) == GEO_SUCCESS);
+    for (size_t index = 0; index < 100; ++index) {
+      assert(counts->runs[index] == 1);
+    }
+  }
+  assert(deferred->count == GEO_EXECUTOR_BATCHES);
+  /* the late jobs find their batches closed and give them back */
+  for (size_t iter = 0; iter < deferred->count; ++iter) {
+    deferred->jobs[iter](deferred->arguments[iter]);
+  }
+  deferred->count = 0;
+  assert(geo_executor_run(&executor, count_run, counts, 100) == GEO_SUCCESS);
+  assert(deferred->count == 1);
+  deferred->jobs[0](deferred->arguments[0]);
+  free(counts);
+  free(deferred);
+}
+
+int main(void) {
+  /* geo_file_map tests */
+  geo_file_map_returns_geo_err_null_pointer_when_path_is_null();
+  geo_file_map_returns_geo_err_io_when_file_does_not_exist();
+  geo_file_map_returns_geo_success_and_maps_file_written_by_geo_file_write();
+
+  /* geo_file_write tests */
+  geo_file_write_returns_geo_err_null_pointer_when_data_is_null();
+  geo_file_write_returns_geo_err_io_when_directory_does_not_exist();
+
+  /* geo_arena tests */
+  geo_arena_alloc_returns_geo_success_and_aligned_memory_until_full();
+  geo_arena_alloc_returns_geo_err_out_of_range_when_alignment_is_not_a_power_of_2();
+
+  /* geo_parse_double tests */
+  geo_parse_double_returns_geo_success_and_same_value_as_strtod();
+  geo_parse_double_returns_geo_success_and_same_value_as_strtod_for_hard_cases();
+  geo_parse_double_returns_geo_success_and_same_value_as_strtod_for_long_numbers();
+  geo_parse_double_returns_geo_err_invalid_format_when_text_is_not_a_number();
+  geo_parse_double_returns_geo_err_out_of_range_when_number_overflows();
+
+  /* geo_parse_int64 tests */
+  geo_parse_int64_returns_geo_success_for_the_int64_range();
+
+  /* geo_simd_level tests */
+  geo_simd_level_returns_geo_err_null_pointer_when_level_is_null();
+  geo_simd_level_returns_geo_success_and_a_known_level();
+
+  /* geo_executor tests */
+  geo_pool_init_returns_geo_err_null_pointer_when_pool_is_null();
+  geo_pool_init_returns_geo_err_too_small_when_threads_count_is_0();
+  geo_pool_executor_returns_geo_success_and_the_threads_and_the_caller_as_concurrency();
+  geo_executor_run_returns_geo_err_null_pointer_when_task_is_null();
+  geo_executor_run_returns_geo_success_and_runs_every_index_once();
+  geo_executor_run_returns_geo_success_when_tasks_run_batches_on_the_same_executor();
+  geo_executor_run_returns_geo_success_and_runs_in_order_when_every_batch_is_taken();
+  printf("All common tests pass.\n");
+  return 0;
+}
@@ -0,0 +1,435 @@
+#include "geometry.hpp"
+
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include "geo_double.h"
+#include "geo_float.h"
+#include "geo_int.h"
+
+/* a 5 pointed star, not convex, closed like a ring view */
+template <class T>
+static std::vector<geo::Point<T>> star_ring() {
+  return {{10, 0}, {12, 7}, {20, 8}, {14, 12}, {16, 20}, {10, 15},
+          {4, 20}, {6, 12}, {0, 8},  {8, 7},   {10, 0}};
+}
+
+/* a square with a square hole, closed rings of an embedded service area */
+static constexpr std::array<geo::Point<int>, 5> service_shell = {
+    {{0, 0}, {12, 0}, {12, 12}, {0, 12}, {0, 0}}};
+static constexpr std::array<geo::Point<int>, 5> service_hole = {
+    {{4, 4}, {8, 4}, {8, 8}, {4, 8}, {4, 4}}};
+static constexpr std::array<geo::Ring<int>, 2> service_rings = {
+    {geo::Ring<int>{service_shell}, geo::Ring<int>{service_hole}}};
+static constexpr geo::Polygon<int> service_area{service_rings};
+
+/* an exact fraction, the denominator is always positive */
+struct Rational {
+  long long numerator;
+  long long denominator;
+
+  constexpr Rational(long long value = 0) : Rational(value, 1) {}
+  constexpr Rational(long long num, long long den)
+      : numerator(den < 0 ? -num : num), denominator(den < 0 ? -den : den) {
+    long long const divisor = std::gcd(numerator, denominator);
+    if (divisor > 1) {
+      numerator /= divisor;
+      denominator /= divisor;
+    }
+  }
+
+  friend constexpr Rational operator+(Rational lhs, Rational rhs) {
+    return {(lhs.numerator * rhs.denominator) +
+                (rhs.numerator * lhs.denominator),
+            lhs.denominator * rhs.denominator};
+  }
+  friend constexpr Rational operator-(Rational lhs, Rational rhs) {
+    return {(lhs.numerator * rhs.denominator) -
+                (rhs.numerator * lhs.denominator),
+            lhs.denominator * rhs.denominator};
+  }
+  friend constexpr Rational operator*(Rational lhs, Rational rhs) {
+    return {lhs.numerator * rhs.numerator, lhs.denominator * rhs.denominator};
+  }
+  friend constexpr bool operator==(Rational lhs, Rational rhs) {
+    return lhs.numerator * rhs.denominator == rhs.numerator * lhs.denominator;
+  }
+  friend constexpr bool operator<(Rational lhs, Rational rhs) {
+    return lhs.numerator * rhs.denominator < rhs.numerator * lhs.denominator;
+  }
+  friend constexpr bool operator<=(Rational lhs, Rational rhs) {
+    return !(rhs < lhs);
+  }
+  friend constexpr bool operator>=(Rational lhs, Rational rhs) {
+    return !(lhs < rhs);
+  }
+};
+
+template <>
+struct geo::Exact<Rational> : std::true_type {};
+
+/*----------------------------------
+ * equal tests
+ *----------------------------------
+ */
+void geo_equal_double_matches_geo_points_equal_double() {
+  double const values[] = {0.0,
+                           -0.0,
+                           1.0,
+                           1.0 + 1e-13,
+                           1.0 + 1e-8,
+                           1e12,
+                           1e12 + 1e3,
+                           std::nextafter(1e300, 2e300),
+                           1e300,
+                           -1e-300,
+                           std::numeric_limits<double>::infinity(),
+                           std::numeric_limits<double>::quiet_NaN()};
+  for (double lhs : values) {
+    for (double rhs : values) {
+      GeoPoint_double c_lhs = {lhs, 0.0};
+      GeoPoint_double c_rhs = {rhs, 0.0};
+      bool expected = false;
+      assert(geo_points_equal_double(&c_lhs, &c_rhs, &expected) == GEO_SUCCESS);
+      assert(geo::points_equal(geo::Point<double>{lhs, 0.0},
+                               geo::Point<double>{rhs, 0.0}) == expected);
+    }
+  }
+}
+
+void geo_equal_float_matches_geo_points_equal_float() {
+  float const values[] = {0.0F, 1.0F, 1.0F + 1e-7F, 1.0F + 1e-5F, 3e38F,
+                          std::nextafter(3e38F, 3.4e38F), -2.5F};
+  for (float lhs : values) {
+    for (float rhs : values) {
+      GeoPoint_float c_lhs = {0.0F, lhs};
+      GeoPoint_float c_rhs = {0.0F, rhs};
+      bool expected = false;
+      assert(geo_points_equal_float(&c_lhs, &c_rhs, &expected) == GEO_SUCCESS);
+      assert(geo::points_equal(geo::Point<float>{0.0F, lhs},
+                               geo::Point<float>{0.0F, rhs}) == expected);
+    }
+  }
+}
+
+/*----------------------------------
+ * segments_intersect tests
+ *----------------------------------
+ */
+void geo_segments_intersect_int_matches_geo_segments_intersect_int() {
+  /* every pair of segments between points of a 3 x 3 lattice */
+  std::vector<geo::Point<int>> lattice;
+  for (int y = 0; y < 3; ++y) {
+    for (int x = 0; x < 3; ++x) {
+      lattice.push_back({x, y});
+    }
+  }
+  for (auto const& a : lattice) {
+    for (auto const& b : lattice) {
+      for (auto const& c : lattice) {
+        for (auto const& d : lattice) {
+          GeoPoint_int c_points[4] = {{a.x, a.y}, {b.x, b.y}, {c.x, c.y},
+                                      {d.x, d.y}};
+          GeoSegment_int first = {&c_points[0], &c_points[1]};
+          GeoSegment_int second = {&c_points[2], &c_points[3]};
+          size_t expected = 0;
+          assert(geo_segments_intersect_int(&first, &second, &expected) ==
+                 GEO_SUCCESS);
+          assert(geo::segments_intersect(geo::Segment<int>{a, b},
+                                         geo::Segment<int>{c, d}) == expected);
+        }
+      }
+    }
+  }
+}
+
+/*----------------------------------
+ * point_in_ring tests
+ *----------------------------------
+ */
+void geo_point_in_ring_double_matches_geo_point_in_ring_view_double() {
+  std::vector<geo::Point<double>> const points = star_ring<double>();
+  geo::Ring<double> const ring{points};
+  GeoRingView_double const view = {points.data(), points.size()};
+  for (double y = -1.0; y <= 21.0; y += 0.5) {
+    for (double x = -1.0; x <= 21.0; x += 0.5) {
+      for (int strict = 0; strict < 2; ++strict) {
+        GeoPoint_double const c_point = {x, y};
+        bool expected = false;
+        assert(geo_point_in_ring_view_double(&c_point, &view, strict != 0,
+                                             &expected) == GEO_SUCCESS);
+        assert(geo::point_in_ring(geo::Point<double>{x, y}, ring,
+                                  strict != 0) == expected);
+      }
+    }
+  }
+}
+
+void geo_point_in_ring_int_matches_geo_point_in_ring_view_int() {
+  std::vector<geo::Point<int>> const points = star_ring<int>();
+  geo::Ring<int> const ring{points};
+  GeoRingView_int const view = {points.data(), points.size()};
+  for (int y = -1; y <= 21; ++y) {
+    for (int x = -1; x <= 21; ++x) {
+      for (int strict = 0; strict < 2; ++strict) {
+        GeoPoint_int const c_point = {x, y};
+        bool expected = false;
+        assert(geo_point_in_ring_view_int(&c_point, &view, strict != 0,
+                                          &expected) == GEO_SUCCESS);
+        assert(geo::point_in_ring(geo::Point<int>{x, y}, ring, strict != 0) ==
+               expected);
+      }
+    }
+  }
+}
+
+void geo_point_in_ring_int_returns_false_when_ring_has_under_4_points() {
+  std::array<geo::Point<int>, 3> const points = {{{0, 0}, {4, 0}, {0, 0}}};
+  assert(!geo::point_in_ring(geo::Point<int>{0, 0}, geo::Ring<int>{points}));
+}
+
+/*----------------------------------
+ * ring_is_closed and ring_is_simple tests
+ *----------------------------------
+ */
+void geo_ring_is_simple_int_matches_geo_ring_view_is_simple_int() {
+  std::vector<std::vector<geo::Point<int>>> const rings = {
+      star_ring<int>(),
+      {{0, 0}, {4, 0}, {4, 4}, {0, 4}, {0, 0}},
+      {{0, 0}, {4, 4}, {4, 0}, {0, 4}, {0, 0}},
+      {{0, 0}, {4, 0}, {2, 0}, {2, 4}, {0, 0}},
+      {{0, 0}, {4, 0}, {4, 4}, {2, 0}, {0, 4}, {0, 0}}};
+  for (auto const& points : rings) {
+    GeoRingView_int const view = {points.data(), points.size()};
+    bool expected = false;
+    assert(geo_ring_view_is_simple_int(&view, &expected) == GEO_SUCCESS);
+    assert(geo::ring_is_simple(geo::Ring<int>{points}) == expected);
+    assert(geo::ring_is_closed(geo::Ring<int>{points}));
+  }
+}
+
+void geo_ring_is_closed_double_returns_false_when_last_point_differs() {
+  std::array<geo::Point<double>, 4> const points = {
+      {{0.0, 0.0}, {1.0, 0.0}, {1.0, 1.0}, {0.0, 1e-6}}};
+  assert(!geo::ring_is_closed(geo::Ring<double>{points}));
+}
+
+/*----------------------------------
+ * envelope tests
+ *----------------------------------
+ */
+void geo_envelope_int_matches_geo_ring_view_envelope_int() {
+  std::vector<geo::Point<int>> const points = star_ring<int>();
+  GeoRingView_int const view = {points.data(), points.size()};
+  GeoEnvelope_int expected;
+  assert(geo_ring_view_envelope_int(&view, &expected) == GEO_SUCCESS);
+  geo::Envelope<int> const envelope = geo::envelope(geo::Ring<int>{points});
+  assert(envelope.min.x == expected.min.x && envelope.min.y == expected.min.y);
+  assert(envelope.max.x == expected.max.x && envelope.max.y == expected.max.y);
+}
+
+/*----------------------------------
+ * point_in_polygon tests
+ *----------------------------------
+ */
+void geo_point_in_polygon_int_matches_geo_point_in_polygon_view_int() {
+  GeoRingView_int const views[2] = {
+      {service_shell.data(), service_shell.size()},
+      {service_hole.data(), service_hole.size()}};
+  GeoPolygonView_int const polygon = {views, 2};
+  for (int y = -1; y <= 13; ++y) {
+    for (int x = -1; x <= 13; ++x) {
+      for (int strict = 0; strict < 2; ++strict) {
+        GeoPoint_int const c_point = {x, y};
+        bool expected = false;
+        assert(geo_point_in_polygon_view_int(&c_point, &polygon, strict != 0,
+                                             &expected) == GEO_SUCCESS);
+        assert(geo::point_in_polygon(geo::Point<int>{x, y}, service_area,
+                                     strict != 0) == expected);
+      }
+    }
+  }
+}
+
+/*----------------------------------
+ * constexpr tests
+ *----------------------------------
+ */
+void geo_predicates_int_validate_a_table_at_compile_time() {
+  static_assert(geo::ring_is_closed(service_area.rings[0]));
+  static_assert(geo::ring_is_simple(service_area.rings[0]));
+  static_assert(geo::ring_is_simple(service_area.rings[1]));
+  static_assert(geo::point_in_polygon(geo::Point<int>{2, 2}, service_area));
+  static_assert(!geo::point_in_polygon(geo::Point<int>{6, 6}, service_area));
+  static_assert(geo::point_in_polygon(geo::Point<int>{4, 6}, service_area));
+  static_assert(
+      !geo::point_in_polygon(geo::Point<int>{4, 6}, service_area, true));
+  static_assert(geo::segments_intersect(
+                    geo::Segment<int>{{0, 0}, {4, 4}},
+                    geo::Segment<int>{{0, 4}, {4, 0}}) == 1);
+  static_assert(geo::in_disk(geo::Segment<int>{{0, 0}, {4, 0}},
+                             geo::Point<int>{2, 0}));
+
+  static constexpr std::array<geo::Point<int>, 5> bowtie = {
+      {{0, 0}, {4, 4}, {4, 0}, {0, 4}, {0, 0}}};
+  static_assert(!geo::ring_is_simple(geo::Ring<int>{bowtie}));
+
+  constexpr geo::Envelope<int> envelope = geo::envelope(service_area.rings[0]);
+  static_assert(envelope.min.x == 0 && envelope.min.y == 0);
+  static_assert(envelope.max.x == 12 && envelope.max.y == 12);
+  assert(envelope.max.x == 12);
+}
+
+void geo_convex_hull_int_runs_at_compile_time() {
+  constexpr std::size_t size = [] {
+    std::array<geo::Point<int>, 6> points = {
+        {{0, 0}, {4, 0}, {2, 1}, {4, 4}, {2, 3}, {0, 4}}};
+    std::array<geo::Point<int>, 6> hull{};
+    return geo::convex_hull(std::span<geo::Point<int>>{points},
+                            std::span<geo::Point<int>>{hull});
+  }();
+  static_assert(size == 4);
+  assert(size == 4);
+}
+
+void geo_convex_hull_int_stays_inside_hull_at_compile_time() {
+  /* the upper chain holds (1, 0) until (0, 1) pops it */
+  constexpr std::size_t size = [] {
+    std::array<geo::Point<int>, 3> points = {{{0, 1}, {1, 0}, {2, 1}}};
+    std::array<geo::Point<int>, 3> hull{};
+    return geo::convex_hull(std::span<geo::Point<int>>{points},
+                            std::span<geo::Point<int>>{hull});
+  }();
+  static_assert(size == 3);
+  assert(size == 3);
+}
+
+void geo_predicates_rational_are_exact_at_compile_time() {
+  using Point = geo::Point<Rational>;
+  constexpr Rational third{1, 3};
+  constexpr Rational half{1, 2};
+  constexpr Rational millionth{1, 1000000};
+  /* colinear only without rounding, 1/3 has no binary representation */
+  static_assert(geo::orientation(Point{0, 0}, Point{1, 1},
+                                 Point{third, third}) ==
+                geo::Orientation::colinear);
+  static_assert(geo::orientation(Point{0, 0}, Point{1, 1},
+                                 Point{third, third + millionth}) ==
+                geo::Orientation::left);
+
+  static constexpr std::array<Point, 4> triangle = {
+      {{0, 0}, {1, 0}, {0, 1}, {0, 0}}};
+  constexpr geo::Ring<Rational> ring{triangle};
+  static_assert(geo::ring_is_closed(ring));
+  static_assert(geo::ring_is_simple(ring));
+  static_assert(geo::point_in_ring(Point{third, third}, ring));
+  static_assert(geo::point_in_ring(Point{half, half}, ring));
+  static_assert(!geo::point_in_ring(Point{half, half}, ring, true));
+  static_assert(!geo::point_in_ring(Point{half, half + millionth}, ring));
+  assert(geo::point_in_ring(Point{third, third}, ring, true));
+}
+
+void geo_equal_double_runs_at_compile_time() {
+  static_assert(geo::equal(0.1 + 0.2, 0.3));
+  static_assert(!geo::equal(1.0, 1.0 + 1e-6));
+  static_assert(!geo::equal(std::numeric_limits<double>::quiet_NaN(),
+                            std::numeric_limits<double>::quiet_NaN()));
+  static_assert(!geo::equal(std::numeric_limits<double>::infinity(), 1e308));
+  static_assert(geo::equal(1e300, 1e300 + 1e288));
+  static_assert(geo::equal(-0.0, 0.0));
+  assert(geo::equal(0.1 + 0.2, 0.3));
+}
+
+/*----------------------------------
+ * convex_hull tests
+ *----------------------------------
+ */
+void geo_convex_hull_double_matches_geo_convex_hull_soa_double() {
+  std::vector<geo::Point<double>> points = star_ring<double>();
+  points.pop_back();
+  points.push_back({10.0, 10.0});
+  points.push_back({20.0, 8.0});
+  std::vector<double> xs;
+  std::vector<double> ys;
+  for (auto const& point : points) {
+    xs.push_back(point.x);
+    ys.push_back(point.y);
+  }
+  GeoPointsSoA_double const soa = {xs.data(), ys.data(), xs.size()};
+  std::vector<size_t> expected(points.size());
+  size_t expected_size = 0;
+  assert(geo_convex_hull_soa_double(&soa, NULL, NULL, expected.data(),
+                                    &expected_size) == GEO_SUCCESS);
+  std::vector<geo::Point<double>> hull(points.size());
+  std::size_t const size =
+      geo::convex_hull(std::span<geo::Point<double>>{points},
+                       std::span<geo::Point<double>>{hull});
+  assert(size == expected_size);
+  for (std::size_t iter = 0; iter < size; ++iter) {
+    assert(geo::points_equal(hull[iter],
+                             geo::Point<double>{xs[expected[iter]],
+                                                ys[expected[iter]]}));
+  }
+}
+
+void geo_convex_hull_double_fills_a_hull_the_size_of_points() {
+  std::vector<geo::Point<double>> points = {{0.0, 1.0}, {1.0, 0.0}, {2.0, 1.0}};
+  std::vector<geo::Point<double>> hull(points.size());
+  std::size_t const size =
+      geo::convex_hull(std::span<geo::Point<double>>{points},
+                       std::span<geo::Point<double>>{hull});
+  assert(size == 3);
+  assert(geo::points_equal(hull[0], geo::Point<double>{0.0, 1.0}));
+  assert(geo::points_equal(hull[1], geo::Point<double>{1.0, 0.0}));
+  assert(geo::points_equal(hull[2], geo::Point<double>{2.0, 1.0}));
+}
+
+void geo_convex_hull_int_returns_0_when_hull_is_too_small() {
+  std::array<geo::Point<int>, 4> points = {{{0, 0}, {4, 0}, {4, 4}, {0, 4}}};
+  std::array<geo::Point<int>, 3> hull{};
+  assert(geo::convex_hull(std::span<geo::Point<int>>{points},
+                          std::span<geo::Point<int>>{hull}) == 0);
+}
+
+int main() {
+  /* equal tests */
+  geo_equal_double_matches_geo_points_equal_double();
+  geo_equal_float_matches_geo_points_equal_float();
+
+  /* segments_intersect tests */
+  geo_segments_intersect_int_matches_geo_segments_intersect_int();
+
+  /* point_in_ring tests */
+  geo_point_in_ring_double_matches_geo_point_in_ring_view_double();
+  geo_point_in_ring_int_matches_geo_point_in_ring_view_int();
+  geo_point_in_ring_int_returns_false_when_ring_has_under_4_points();
+
+  /* ring_is_closed and ring_is_simple tests */
+  geo_ring_is_simple_int_matches_geo_ring_view_is_simple_int();
+  geo_ring_is_closed_double_returns_false_when_last_point_differs();
+
+  /* envelope tests */
+  geo_envelope_int_matches_geo_ring_view_envelope_int();
+
+  /* point_in_polygon tests */
+  geo_point_in_polygon_int_matches_geo_point_in_polygon_view_int();
+
+  /* convex_hull tests */
+  geo_convex_hull_double_matches_geo_convex_hull_soa_double();
+  geo_convex_hull_double_fills_a_hull_the_size_of_points();
+  geo_convex_hull_int_returns_0_when_hull_is_too_small();
+
+  /* constexpr tests */
+  geo_predicates_int_validate_a_table_at_compile_time();
+  geo_convex_hull_int_runs_at_compile_time();
+  geo_convex_hull_int_stays_inside_hull_at_compile_time();
+  geo_predicates_rational_are_exact_at_compile_time();
+  geo_equal_double_runs_at_compile_time();
+  printf("All C++ tests pass.\n");
+  return 0;
+}
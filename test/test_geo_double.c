@@ -1,6 +1,9 @@
 #include "geo_double.h"
 #include <assert.h>
+#include <fcntl.h>
 #include <stdio.h>
+#include <string.h>
+#include <unistd.h>
 
 /*----------------------------------
  * private/static function tests
@@ -2232,6 +2235,2597 @@ void geo_convex_hull_double_with_30_points_returns_geo_success_and_sets_hull_siz
   assert(hull_size == 12);
 }
 
+void geo_convex_hull_double_returns_geo_success_and_sets_hull_size_to_4_when_start_point_is_repeated(void) {
+  size_t count = 7;
+  size_t hull_size = 0;
+  struct GeoPoint_double *hull[7];
+  struct GeoPoint_double *points[7];
+  struct GeoPoint_double cloud[7] = {{0, 0}, {2, 0}, {4, 0}, {4, 4}, {0, 4}, {0, 0}, {2, 2}};
+  for (size_t iter = 0; iter < count; ++iter) {
+    points[iter] = &cloud[iter];
+  }
+
+  enum GeoResult result = geo_convex_hull_double(points, hull, count, &hull_size);
+  assert(result == GEO_SUCCESS);
+  assert(hull_size == 4);
+  assert(hull[0]->x == 0 && hull[0]->y == 0);
+  assert(hull[1] == &cloud[2]);
+  assert(hull[2] == &cloud[3]);
+  assert(hull[3] == &cloud[4]);
+}
+
+void geo_convex_hull_double_returns_geo_success_and_leaves_out_the_start_point_repeated_before_a_left_turn(void) {
+  size_t count = 6;
+  size_t hull_size = 0;
+  struct GeoPoint_double *hull[6];
+  struct GeoPoint_double *points[6];
+  struct GeoPoint_double cloud[6] = {{0, 0}, {3, 3}, {1, 1}, {2, 2}, {0, 0}, {4, 0}};
+  for (size_t iter = 0; iter < count; ++iter) {
+    points[iter] = &cloud[iter];
+  }
+
+  enum GeoResult result = geo_convex_hull_double(points, hull, count, &hull_size);
+  assert(result == GEO_SUCCESS);
+  assert(hull_size == 3);
+  assert(hull[0]->x == 0 && hull[0]->y == 0);
+  assert(hull[1] == &cloud[5]);
+  assert(hull[2] == &cloud[1]);
+}
+
+/*----------------------------------
+ * geo_grid_double tests
+ *----------------------------------
+ */
+void geo_grid_init_double_returns_geo_err_null_pointer_when_grid_is_null(void) {
+  struct GeoGridSlot_double slots[8];
+  size_t objects[4];
+  enum GeoResult result = geo_grid_init_double(NULL, 1, slots, 8, objects, 4);
+  assert(result == GEO_ERR_NULL_POINTER);
+}
+
+void geo_grid_init_double_returns_geo_err_too_small_when_slots_count_is_not_a_power_of_2(void) {
+  struct GeoGrid_double grid;
+  struct GeoGridSlot_double slots[6];
+  size_t objects[4];
+  enum GeoResult result = geo_grid_init_double(&grid, 1, slots, 6, objects, 4);
+  assert(result == GEO_ERR_TOO_SMALL);
+}
+
+void geo_grid_init_double_returns_geo_err_out_of_range_when_cell_size_is_not_positive(void) {
+  struct GeoGrid_double grid;
+  struct GeoGridSlot_double slots[8];
+  size_t objects[4];
+  enum GeoResult result = geo_grid_init_double(&grid, 0, slots, 8, objects, 4);
+  assert(result == GEO_ERR_OUT_OF_RANGE);
+}
+
+void geo_grid_insert_double_returns_geo_err_out_of_range_when_id_is_not_less_than_objects_count(void) {
+  struct GeoGrid_double grid;
+  struct GeoGridSlot_double slots[8];
+  size_t objects[4];
+  struct GeoPoint_double point = {1, 1};
+  bool inserted = false;
+  enum GeoResult result = geo_grid_init_double(&grid, 2, slots, 8, objects, 4);
+  assert(result == GEO_SUCCESS);
+  result = geo_grid_insert_double(&grid, 4, &point, &inserted);
+  assert(result == GEO_ERR_OUT_OF_RANGE);
+}
+
+void geo_grid_insert_double_returns_geo_success_and_inserted_set_to_false_when_id_is_already_present(void) {
+  struct GeoGrid_double grid;
+  struct GeoGridSlot_double slots[8];
+  size_t objects[4];
+  struct GeoPoint_double point1 = {1, 1};
+  struct GeoPoint_double point2 = {5, 5};
+  size_t ids[4];
+  size_t ids_count = 0;
+  bool inserted = false;
+  enum GeoResult result = geo_grid_init_double(&grid, 2, slots, 8, objects, 4);
+  assert(result == GEO_SUCCESS);
+  result = geo_grid_insert_double(&grid, 1, &point1, &inserted);
+  assert(result == GEO_SUCCESS);
+  assert(inserted);
+  result = geo_grid_insert_double(&grid, 1, &point2, &inserted);
+  assert(result == GEO_SUCCESS);
+  assert(!inserted);
+  result = geo_grid_query_radius_double(&grid, &point2, 1, ids, 4, &ids_count);
+  assert(result == GEO_SUCCESS);
+  assert(ids_count == 0);
+}
+
+void geo_grid_query_radius_double_returns_geo_success_and_only_ids_within_radius(void) {
+  /*
+   * p0 and p1 are within 3 of the center (0, 0), p2 is not.
+   */
+  struct GeoGrid_double grid;
+  struct GeoGridSlot_double slots[16];
+  size_t objects[8];
+  struct GeoPoint_double center = {0, 0};
+  struct GeoPoint_double point0 = {1, 1};
+  struct GeoPoint_double point1 = {-2, 2};
+  struct GeoPoint_double point2 = {3, 3};
+  size_t ids[8];
+  size_t ids_count = 0;
+  bool inserted = false;
+  enum GeoResult result = geo_grid_init_double(&grid, 2, slots, 16, objects, 8);
+  assert(result == GEO_SUCCESS);
+  assert(geo_grid_insert_double(&grid, 0, &point0, &inserted) == GEO_SUCCESS);
+  assert(geo_grid_insert_double(&grid, 1, &point1, &inserted) == GEO_SUCCESS);
+  assert(geo_grid_insert_double(&grid, 2, &point2, &inserted) == GEO_SUCCESS);
+  result = geo_grid_query_radius_double(&grid, &center, 3, ids, 8, &ids_count);
+  assert(result == GEO_SUCCESS);
+  assert(ids_count == 2);
+  assert((ids[0] == 0 && ids[1] == 1) || (ids[0] == 1 && ids[1] == 0));
+}
+
+void geo_grid_query_radius_double_returns_geo_success_and_ids_count_larger_than_capacity_when_ids_is_too_small(void) {
+  struct GeoGrid_double grid;
+  struct GeoGridSlot_double slots[16];
+  size_t objects[8];
+  struct GeoPoint_double point = {1, 1};
+  size_t ids[1];
+  size_t ids_count = 0;
+  bool inserted = false;
+  enum GeoResult result = geo_grid_init_double(&grid, 2, slots, 16, objects, 8);
+  assert(result == GEO_SUCCESS);
+  assert(geo_grid_insert_double(&grid, 0, &point, &inserted) == GEO_SUCCESS);
+  assert(geo_grid_insert_double(&grid, 1, &point, &inserted) == GEO_SUCCESS);
+  result = geo_grid_query_radius_double(&grid, &point, 0, ids, 1, &ids_count);
+  assert(result == GEO_SUCCESS);
+  assert(ids_count == 2);
+}
+
+void geo_grid_move_double_returns_geo_success_and_object_is_only_found_at_new_position(void) {
+  struct GeoGrid_double grid;
+  struct GeoGridSlot_double slots[16];
+  size_t objects[8];
+  struct GeoPoint_double from = {1, 1};
+  struct GeoPoint_double to = {-40, 25};
+  size_t ids[8];
+  size_t ids_count = 0;
+  bool inserted = false;
+  bool moved = false;
+  enum GeoResult result = geo_grid_init_double(&grid, 2, slots, 16, objects, 8);
+  assert(result == GEO_SUCCESS);
+  assert(geo_grid_insert_double(&grid, 3, &from, &inserted) == GEO_SUCCESS);
+  result = geo_grid_move_double(&grid, 3, &to, &moved);
+  assert(result == GEO_SUCCESS);
+  assert(moved);
+  assert(geo_grid_query_radius_double(&grid, &from, 1, ids, 8, &ids_count) == GEO_SUCCESS);
+  assert(ids_count == 0);
+  assert(geo_grid_query_radius_double(&grid, &to, 1, ids, 8, &ids_count) == GEO_SUCCESS);
+  assert(ids_count == 1);
+  assert(ids[0] == 3);
+}
+
+void geo_grid_move_double_returns_geo_success_and_moved_set_to_false_when_id_is_not_present(void) {
+  struct GeoGrid_double grid;
+  struct GeoGridSlot_double slots[8];
+  size_t objects[4];
+  struct GeoPoint_double point = {1, 1};
+  size_t ids[4];
+  size_t ids_count = 0;
+  bool moved = true;
+  enum GeoResult result = geo_grid_init_double(&grid, 2, slots, 8, objects, 4);
+  assert(result == GEO_SUCCESS);
+  result = geo_grid_move_double(&grid, 0, &point, &moved);
+  assert(result == GEO_SUCCESS);
+  assert(!moved);
+  assert(geo_grid_query_radius_double(&grid, &point, 1, ids, 4, &ids_count) == GEO_SUCCESS);
+  assert(ids_count == 0);
+}
+
+void geo_grid_move_double_returns_geo_err_full_when_no_slot_is_free(void) {
+  struct GeoGrid_double grid;
+  struct GeoGridSlot_double slots[2];
+  size_t objects[2];
+  struct GeoPoint_double point = {1, 1};
+  bool inserted = false;
+  bool moved = false;
+  enum GeoResult result = geo_grid_init_double(&grid, 2, slots, 2, objects, 2);
+  assert(result == GEO_SUCCESS);
+  assert(geo_grid_insert_double(&grid, 0, &point, &inserted) == GEO_SUCCESS);
+  assert(geo_grid_insert_double(&grid, 1, &point, &inserted) == GEO_SUCCESS);
+  result = geo_grid_move_double(&grid, 0, &point, &moved);
+  assert(result == GEO_ERR_FULL);
+}
+
+void geo_grid_remove_double_returns_geo_success_and_object_is_no_longer_found(void) {
+  struct GeoGrid_double grid;
+  struct GeoGridSlot_double slots[8];
+  size_t objects[4];
+  struct GeoPoint_double point = {1, 1};
+  size_t ids[4];
+  size_t ids_count = 0;
+  bool inserted = false;
+  bool removed = false;
+  enum GeoResult result = geo_grid_init_double(&grid, 2, slots, 8, objects, 4);
+  assert(result == GEO_SUCCESS);
+  assert(geo_grid_insert_double(&grid, 2, &point, &inserted) == GEO_SUCCESS);
+  result = geo_grid_remove_double(&grid, 2, &removed);
+  assert(result == GEO_SUCCESS);
+  assert(removed);
+  result = geo_grid_remove_double(&grid, 2, &removed);
+  assert(result == GEO_SUCCESS);
+  assert(!removed);
+  assert(geo_grid_query_radius_double(&grid, &point, 1, ids, 4, &ids_count) == GEO_SUCCESS);
+  assert(ids_count == 0);
+}
+
+void geo_grid_query_geometry_double_returns_geo_success_and_only_ids_inside_geometry(void) {
+  /*
+   * p3---------p2
+   * |     a     |   b
+   * |           |
+   * p0---c-----p1
+   */
+  struct GeoGrid_double grid;
+  struct GeoGridSlot_double slots[16];
+  size_t objects[8];
+  struct GeoPoint_double point0 = {0, 0};
+  struct GeoPoint_double point1 = {8, 0};
+  struct GeoPoint_double point2 = {8, 8};
+  struct GeoPoint_double point3 = {0, 8};
+  struct GeoSegment_double segment0 = {&point0, &point1};
+  struct GeoSegment_double segment1 = {&point1, &point2};
+  struct GeoSegment_double segment2 = {&point2, &point3};
+  struct GeoSegment_double segment3 = {&point3, &point0};
+  struct GeoSegment_double *segments[4];
+  struct GeoGeometry_double geometry;
+  struct GeoPoint_double a = {4, 6};
+  struct GeoPoint_double b = {10, 6};
+  struct GeoPoint_double c = {3, 0};
+  size_t ids[8];
+  size_t ids_count = 0;
+  bool inserted = false;
+  enum GeoResult result = geo_grid_init_double(&grid, 2, slots, 16, objects, 8);
+  segments[0] = &segment0;
+  segments[1] = &segment1;
+  segments[2] = &segment2;
+  segments[3] = &segment3;
+  geometry.segments = segments;
+  geometry.segments_count = 4;
+  assert(result == GEO_SUCCESS);
+  assert(geo_grid_insert_double(&grid, 0, &a, &inserted) == GEO_SUCCESS);
+  assert(geo_grid_insert_double(&grid, 1, &b, &inserted) == GEO_SUCCESS);
+  assert(geo_grid_insert_double(&grid, 2, &c, &inserted) == GEO_SUCCESS);
+  result = geo_grid_query_geometry_double(&grid, &geometry, true, ids, 8, &ids_count);
+  assert(result == GEO_SUCCESS);
+  assert(ids_count == 1);
+  assert(ids[0] == 0);
+  result = geo_grid_query_geometry_double(&grid, &geometry, false, ids, 8, &ids_count);
+  assert(result == GEO_SUCCESS);
+  assert(ids_count == 2);
+}
+
+/*----------------------------------
+ * geo_geometry_envelope_double tests
+ *----------------------------------
+ */
+void geo_geometry_envelope_double_returns_geo_err_null_pointer_when_geometry_is_null(void) {
+  struct GeoEnvelope_double envelope;
+  enum GeoResult result = geo_geometry_envelope_double(NULL, &envelope);
+  assert(result == GEO_ERR_NULL_POINTER);
+}
+
+void geo_geometry_envelope_double_returns_geo_success_and_sets_min_and_max_of_all_points(void) {
+  struct GeoPoint_double point0 = {1, -2};
+  struct GeoPoint_double point1 = {6, 0};
+  struct GeoPoint_double point2 = {-3, 5};
+  struct GeoSegment_double segment0 = {&point0, &point1};
+  struct GeoSegment_double segment1 = {&point1, &point2};
+  struct GeoSegment_double segment2 = {&point2, &point0};
+  struct GeoSegment_double *segments[3];
+  struct GeoGeometry_double geometry;
+  struct GeoEnvelope_double envelope;
+  enum GeoResult result = 0;
+  segments[0] = &segment0;
+  segments[1] = &segment1;
+  segments[2] = &segment2;
+  geometry.segments = segments;
+  geometry.segments_count = 3;
+  result = geo_geometry_envelope_double(&geometry, &envelope);
+  assert(result == GEO_SUCCESS);
+  assert(envelope.min.x == -3);
+  assert(envelope.min.y == -2);
+  assert(envelope.max.x == 6);
+  assert(envelope.max.y == 5);
+}
+
+/*----------------------------------
+ * geo_morton_key_double and geo_hilbert_key_double tests
+ *----------------------------------
+ */
+void geo_morton_key_double_returns_geo_err_out_of_range_when_envelope_max_is_less_than_min(void) {
+  struct GeoPoint_double points[1] = {{0, 0}};
+  struct GeoEnvelope_double envelope = {{0, 0}, {-1, 1}};
+  uint64_t keys[1];
+  enum GeoResult result = geo_morton_key_double(points, 1, &envelope, keys);
+  assert(result == GEO_ERR_OUT_OF_RANGE);
+}
+
+void geo_morton_key_double_returns_geo_success_and_interleaves_x_and_y_bits(void) {
+  struct GeoPoint_double points[4] = {{0, 0}, {8, 0}, {0, 8}, {8, 8}};
+  struct GeoEnvelope_double envelope = {{0, 0}, {8, 8}};
+  uint64_t keys[4];
+  enum GeoResult result = geo_morton_key_double(points, 4, &envelope, keys);
+  assert(result == GEO_SUCCESS);
+  assert(keys[0] == 0);
+  assert(keys[1] == 0x5555555555555555ULL);
+  assert(keys[2] == 0xAAAAAAAAAAAAAAAAULL);
+  assert(keys[3] == 0xFFFFFFFFFFFFFFFFULL);
+}
+
+void geo_morton_key_double_returns_geo_success_and_clamps_points_outside_envelope(void) {
+  struct GeoPoint_double points[2] = {{-5, -5}, {20, 20}};
+  struct GeoEnvelope_double envelope = {{0, 0}, {8, 8}};
+  uint64_t keys[2];
+  enum GeoResult result = geo_morton_key_double(points, 2, &envelope, keys);
+  assert(result == GEO_SUCCESS);
+  assert(keys[0] == 0);
+  assert(keys[1] == 0xFFFFFFFFFFFFFFFFULL);
+}
+
+void geo_hilbert_key_double_returns_geo_success_and_visits_quadrants_in_curve_order(void) {
+  /*
+   * 1---2
+   * |   |
+   * 0   3
+   */
+  struct GeoPoint_double points[4] = {{1, 1}, {1, 7}, {7, 7}, {7, 1}};
+  struct GeoEnvelope_double envelope = {{0, 0}, {8, 8}};
+  uint64_t keys[4];
+  enum GeoResult result = geo_hilbert_key_double(points, 4, &envelope, keys);
+  assert(result == GEO_SUCCESS);
+  assert(keys[0] < keys[1]);
+  assert(keys[1] < keys[2]);
+  assert(keys[2] < keys[3]);
+  assert((keys[0] >> 62) == 0);
+  assert((keys[3] >> 62) == 3);
+}
+
+/*----------------------------------
+ * geo_sort_points_by_key_double and geo_sort_geometries_by_key_double tests
+ *----------------------------------
+ */
+void geo_sort_points_by_key_double_returns_geo_err_null_pointer_when_keys_is_null(void) {
+  struct GeoPoint_double points[1] = {{0, 0}};
+  enum GeoResult result = geo_sort_points_by_key_double(points, NULL, 1, NULL);
+  assert(result == GEO_ERR_NULL_POINTER);
+}
+
+void geo_sort_points_by_key_double_returns_geo_success_and_orders_points_and_keys_by_key(void) {
+  struct GeoPool pool;
+  struct GeoExecutor executor;
+  struct GeoPoint_double points[100];
+  uint64_t keys[100];
+  enum GeoResult result = 0;
+  for (size_t iter = 0; iter < 100; ++iter) {
+    /* every key is unique and maps back to its point */
+    keys[iter] = ((uint64_t)((iter * 37) % 100) << 40) | iter;
+    points[iter].x = (int)iter;
+    points[iter].y = (int)(iter * 2);
+  }
+  result = geo_pool_init(&pool, 3);
+  assert(result == GEO_SUCCESS);
+  geo_pool_executor(&pool, &executor);
+  result = geo_sort_points_by_key_double(points, keys, 100, &executor);
+  assert(result == GEO_SUCCESS);
+  for (size_t iter = 0; iter < 100; ++iter) {
+    size_t original = (size_t)(keys[iter] & 0xFF);
+    assert(iter == 0 || keys[iter - 1] < keys[iter]);
+    assert(points[iter].x == (int)original);
+    assert(points[iter].y == (int)(original * 2));
+  }
+  geo_pool_destroy(&pool);
+}
+
+void geo_sort_geometries_by_key_double_returns_geo_success_and_orders_geometries_by_key(void) {
+  struct GeoGeometry_double geometry0;
+  struct GeoGeometry_double geometry1;
+  struct GeoGeometry_double geometry2;
+  struct GeoGeometry_double *geometries[3];
+  uint64_t keys[3] = {30, 10, 20};
+  enum GeoResult result = 0;
+  geometries[0] = &geometry0;
+  geometries[1] = &geometry1;
+  geometries[2] = &geometry2;
+  result = geo_sort_geometries_by_key_double(geometries, keys, 3, NULL);
+  assert(result == GEO_SUCCESS);
+  assert(geometries[0] == &geometry1);
+  assert(geometries[1] == &geometry2);
+  assert(geometries[2] == &geometry0);
+  assert(keys[0] == 10);
+  assert(keys[2] == 30);
+}
+
+/*----------------------------------
+ * geo_index_double tests
+ *----------------------------------
+ */
+void geo_index_build_size_double_returns_geo_err_too_small_when_any_geometry_has_less_than_3_segments(void) {
+  struct GeoPoint_double point0 = {0, 0};
+  struct GeoPoint_double point1 = {1, 0};
+  struct GeoSegment_double segment0 = {&point0, &point1};
+  struct GeoSegment_double segment1 = {&point1, &point0};
+  struct GeoSegment_double *segments[2];
+  struct GeoGeometry_double geometry;
+  struct GeoGeometry_double *geometries[1];
+  size_t size = 0;
+  enum GeoResult result = 0;
+  segments[0] = &segment0;
+  segments[1] = &segment1;
+  geometry.segments = segments;
+  geometry.segments_count = 2;
+  geometries[0] = &geometry;
+  result = geo_index_build_size_double(geometries, 1, &size);
+  assert(result == GEO_ERR_TOO_SMALL);
+}
+
+void geo_index_build_double_returns_geo_err_too_small_when_buffer_is_smaller_than_build_size(void) {
+  struct GeoPoint_double point0 = {0, 0};
+  struct GeoPoint_double point1 = {4, 0};
+  struct GeoPoint_double point2 = {0, 4};
+  struct GeoSegment_double segment0 = {&point0, &point1};
+  struct GeoSegment_double segment1 = {&point1, &point2};
+  struct GeoSegment_double segment2 = {&point2, &point0};
+  struct GeoSegment_double *segments[3];
+  struct GeoGeometry_double geometry;
+  struct GeoGeometry_double *geometries[1];
+  size_t size = 0;
+  void *buffer = NULL;
+  enum GeoResult result = 0;
+  segments[0] = &segment0;
+  segments[1] = &segment1;
+  segments[2] = &segment2;
+  geometry.segments = segments;
+  geometry.segments_count = 3;
+  geometries[0] = &geometry;
+  result = geo_index_build_size_double(geometries, 1, &size);
+  assert(result == GEO_SUCCESS);
+  buffer = malloc(size);
+  result = geo_index_build_double(geometries, 1, NULL, buffer, size - 1);
+  assert(result == GEO_ERR_TOO_SMALL);
+  free(buffer);
+}
+
+void geo_index_open_double_returns_geo_err_invalid_format_when_magic_does_not_match(void) {
+  struct GeoIndexHeader *header = malloc(sizeof(struct GeoIndexHeader));
+  struct GeoIndex_double index;
+  enum GeoResult result = 0;
+  memset(header, 0, sizeof(struct GeoIndexHeader));
+  memcpy(header->magic, "GEOINDEY", 8);
+  result = geo_index_open_double(&index, header, sizeof(struct GeoIndexHeader));
+  assert(result == GEO_ERR_INVALID_FORMAT);
+  free(header);
+}
+
+void geo_index_query_double_returns_geo_success_and_finds_geometries_built_into_index(void) {
+  /*
+   * 40 squares of side 2 along a diagonal, square i has its lower left corner
+   * at (3i, 3i).
+   */
+  struct GeoPoint_double points[40][4];
+  struct GeoSegment_double segments[40][4];
+  struct GeoSegment_double *segment_pointers[40][4];
+  struct GeoGeometry_double geometries[40];
+  struct GeoGeometry_double *geometry_pointers[40];
+  struct GeoIndex_double index;
+  struct GeoPoint_double inside = {31, 31};
+  struct GeoPoint_double on_edge = {30, 31};
+  struct GeoPoint_double outside = {32, 33};
+  struct GeoEnvelope_double envelope = {{0, 0}, {7, 7}};
+  size_t ids[40];
+  size_t ids_count = 0;
+  size_t size = 0;
+  void *buffer = NULL;
+  enum GeoResult result = 0;
+  for (size_t iter = 0; iter < 40; ++iter) {
+    int corner = (int)(iter * 3);
+    points[iter][0].x = corner;
+    points[iter][0].y = corner;
+    points[iter][1].x = corner + 2;
+    points[iter][1].y = corner;
+    points[iter][2].x = corner + 2;
+    points[iter][2].y = corner + 2;
+    points[iter][3].x = corner;
+    points[iter][3].y = corner + 2;
+    for (size_t side = 0; side < 4; ++side) {
+      segments[iter][side].start = &points[iter][side];
+      segments[iter][side].end = &points[iter][(side + 1) % 4];
+      segment_pointers[iter][side] = &segments[iter][side];
+    }
+    geometries[iter].segments = segment_pointers[iter];
+    geometries[iter].segments_count = 4;
+    geometry_pointers[iter] = &geometries[iter];
+  }
+  result = geo_index_build_size_double(geometry_pointers, 40, &size);
+  assert(result == GEO_SUCCESS);
+  buffer = malloc(size);
+  result = geo_index_build_double(geometry_pointers, 40, NULL, buffer, size);
+  assert(result == GEO_SUCCESS);
+  result = geo_index_open_double(&index, buffer, size);
+  assert(result == GEO_SUCCESS);
+  assert(index.entries_count == 40);
+
+  result = geo_index_query_point_double(&index, &inside, true, ids, 40, &ids_count);
+  assert(result == GEO_SUCCESS);
+  assert(ids_count == 1);
+  assert(ids[0] == 10);
+  result = geo_index_query_point_double(&index, &on_edge, true, ids, 40, &ids_count);
+  assert(result == GEO_SUCCESS);
+  assert(ids_count == 0);
+  result = geo_index_query_point_double(&index, &on_edge, false, ids, 40, &ids_count);
+  assert(result == GEO_SUCCESS);
+  assert(ids_count == 1);
+  result = geo_index_query_point_double(&index, &outside, false, ids, 40, &ids_count);
+  assert(result == GEO_SUCCESS);
+  assert(ids_count == 0);
+  result = geo_index_query_envelope_double(&index, &envelope, ids, 40, &ids_count);
+  assert(result == GEO_SUCCESS);
+  assert(ids_count == 3);
+  free(buffer);
+}
+
+/*----------------------------------
+ * geo_spatial_join_double tests
+ *----------------------------------
+ */
+/* square i has side 4 and its lower left corner at (5i, 0) */
+static void make_join_squares_double(struct GeoPoint_double (*points)[4],
+                                   struct GeoSegment_double (*segments)[4],
+                                   struct GeoSegment_double *(*segment_pointers)[4],
+                                   struct GeoGeometry_double *geometries,
+                                   struct GeoGeometry_double **geometry_pointers,
+                                   size_t count) {
+  for (size_t iter = 0; iter < count; ++iter) {
+    int corner = (int)(iter * 5);
+    points[iter][0].x = corner;
+    points[iter][0].y = 0;
+    points[iter][1].x = corner + 4;
+    points[iter][1].y = 0;
+    points[iter][2].x = corner + 4;
+    points[iter][2].y = 4;
+    points[iter][3].x = corner;
+    points[iter][3].y = 4;
+    for (size_t side = 0; side < 4; ++side) {
+      segments[iter][side].start = &points[iter][side];
+      segments[iter][side].end = &points[iter][(side + 1) % 4];
+      segment_pointers[iter][side] = &segments[iter][side];
+    }
+    geometries[iter].segments = segment_pointers[iter];
+    geometries[iter].segments_count = 4;
+    geometry_pointers[iter] = &geometries[iter];
+  }
+}
+
+void geo_spatial_join_double_returns_geo_err_null_pointer_when_pairs_count_is_null(void) {
+  struct GeoPoint_double points[1] = {{0, 0}};
+  enum GeoResult result = geo_spatial_join_double(points, 1, NULL, 0, false, NULL, NULL, NULL, 0, NULL);
+  assert(result == GEO_ERR_NULL_POINTER);
+}
+
+void geo_spatial_join_double_returns_geo_success_and_pairs_of_points_inside_few_geometries(void) {
+  struct GeoPoint_double points[2][4];
+  struct GeoSegment_double segments[2][4];
+  struct GeoSegment_double *segment_pointers[2][4];
+  struct GeoGeometry_double geometries[2];
+  struct GeoGeometry_double *geometry_pointers[2];
+  struct GeoPoint_double queries[4] = {{1, 1}, {7, 2}, {20, 2}, {5, 2}};
+  struct GeoJoinPair pairs[4];
+  size_t pairs_count = 0;
+  enum GeoResult result = 0;
+  make_join_squares_double(points, segments, segment_pointers, geometries, geometry_pointers, 2);
+  result = geo_spatial_join_double(queries, 4, geometry_pointers, 2, true, NULL, NULL, pairs, 4, &pairs_count);
+  assert(result == GEO_SUCCESS);
+  assert(pairs_count == 2);
+  assert(pairs[0].point == 0 && pairs[0].geometry == 0);
+  assert(pairs[1].point == 1 && pairs[1].geometry == 1);
+  result = geo_spatial_join_double(queries, 4, geometry_pointers, 2, false, NULL, NULL, pairs, 4, &pairs_count);
+  assert(result == GEO_SUCCESS);
+  assert(pairs_count == 3);
+  assert(pairs[2].point == 3 && pairs[2].geometry == 1);
+}
+
+void geo_spatial_join_double_returns_geo_success_and_pairs_count_larger_than_capacity_when_pairs_is_too_small(void) {
+  struct GeoPoint_double points[2][4];
+  struct GeoSegment_double segments[2][4];
+  struct GeoSegment_double *segment_pointers[2][4];
+  struct GeoGeometry_double geometries[2];
+  struct GeoGeometry_double *geometry_pointers[2];
+  struct GeoPoint_double queries[3] = {{1, 1}, {2, 2}, {6, 1}};
+  struct GeoJoinPair pairs[1];
+  size_t pairs_count = 0;
+  enum GeoResult result = 0;
+  make_join_squares_double(points, segments, segment_pointers, geometries, geometry_pointers, 2);
+  result = geo_spatial_join_double(queries, 3, geometry_pointers, 2, true, NULL, NULL, pairs, 1, &pairs_count);
+  assert(result == GEO_SUCCESS);
+  assert(pairs_count == 3);
+  assert(pairs[0].point == 0);
+}
+
+void geo_spatial_join_count_double_returns_geo_success_and_counts_per_geometry_when_using_multiple_threads_and_many_geometries(void) {
+  struct GeoPool pool;
+  struct GeoExecutor executor;
+  struct GeoPoint_double points[30][4];
+  struct GeoSegment_double segments[30][4];
+  struct GeoSegment_double *segment_pointers[30][4];
+  struct GeoGeometry_double geometries[30];
+  struct GeoGeometry_double *geometry_pointers[30];
+  struct GeoPoint_double queries[90];
+  size_t counts[30];
+  enum GeoResult result = 0;
+  make_join_squares_double(points, segments, segment_pointers, geometries, geometry_pointers, 30);
+  /* geometry i gets i % 3 points, the rest of the points fall in the gaps */
+  for (size_t iter = 0; iter < 90; ++iter) {
+    size_t geometry = iter / 3;
+    queries[iter].x = (int)(geometry * 5) + ((iter % 3) < (geometry % 3) ? 2 : 4 + 1);
+    queries[iter].y = 2;
+  }
+  result = geo_pool_init(&pool, 2);
+  assert(result == GEO_SUCCESS);
+  geo_pool_executor(&pool, &executor);
+  result = geo_spatial_join_count_double(queries, 90, geometry_pointers, 30, true, &executor, NULL, counts);
+  assert(result == GEO_SUCCESS);
+  for (size_t iter = 0; iter < 30; ++iter) {
+    assert(counts[iter] == iter % 3);
+  }
+  geo_pool_destroy(&pool);
+}
+
+/*
+ *----------------------------------
+ * geo_ring_view_double tests
+ *----------------------------------
+ */
+void geo_ring_view_is_closed_double_returns_geo_err_too_small_when_view_has_less_than_4_points(void) {
+  double coordinates[6] = {0, 0, 4, 0, 0, 0};
+  struct GeoRingView_double view = {coordinates, 3};
+  bool is_closed = false;
+  enum GeoResult result = geo_ring_view_is_closed_double(&view, &is_closed);
+  assert(result == GEO_ERR_TOO_SMALL);
+}
+
+void geo_ring_view_is_closed_double_returns_geo_success_and_false_when_last_point_differs(void) {
+  double coordinates[8] = {0, 0, 4, 0, 4, 4, 0, 4};
+  struct GeoRingView_double view = {coordinates, 4};
+  bool is_closed = true;
+  enum GeoResult result = geo_ring_view_is_closed_double(&view, &is_closed);
+  assert(result == GEO_SUCCESS);
+  assert(!is_closed);
+}
+
+void geo_ring_view_is_simple_double_returns_geo_success_and_matches_simple_and_bowtie_rings(void) {
+  double square[10] = {0, 0, 4, 0, 4, 4, 0, 4, 0, 0};
+  double bowtie[10] = {0, 0, 4, 4, 4, 0, 0, 4, 0, 0};
+  struct GeoRingView_double view = {square, 5};
+  bool is_simple = false;
+  enum GeoResult result = geo_ring_view_is_simple_double(&view, &is_simple);
+  assert(result == GEO_SUCCESS);
+  assert(is_simple);
+  view.coordinates = bowtie;
+  result = geo_ring_view_is_simple_double(&view, &is_simple);
+  assert(result == GEO_SUCCESS);
+  assert(!is_simple);
+}
+
+void geo_point_in_ring_view_double_returns_geo_success_and_respects_strict_on_the_boundary(void) {
+  double coordinates[10] = {0, 0, 4, 0, 4, 4, 0, 4, 0, 0};
+  struct GeoRingView_double view = {coordinates, 5};
+  struct GeoPoint_double inside = {1, 2};
+  struct GeoPoint_double edge = {4, 2};
+  struct GeoPoint_double outside = {5, 2};
+  bool is_inside = false;
+  assert(geo_point_in_ring_view_double(&inside, &view, true, &is_inside) == GEO_SUCCESS);
+  assert(is_inside);
+  assert(geo_point_in_ring_view_double(&edge, &view, true, &is_inside) == GEO_SUCCESS);
+  assert(!is_inside);
+  assert(geo_point_in_ring_view_double(&edge, &view, false, &is_inside) == GEO_SUCCESS);
+  assert(is_inside);
+  assert(geo_point_in_ring_view_double(&outside, &view, false, &is_inside) == GEO_SUCCESS);
+  assert(!is_inside);
+}
+
+void geo_ring_view_in_ring_view_double_returns_geo_success_and_true_when_child_is_inside(void) {
+  double outer[10] = {0, 0, 8, 0, 8, 8, 0, 8, 0, 0};
+  double inner[10] = {2, 2, 4, 2, 4, 4, 2, 4, 2, 2};
+  double crossing[10] = {6, 6, 10, 6, 10, 10, 6, 10, 6, 6};
+  struct GeoRingView_double parent = {outer, 5};
+  struct GeoRingView_double child = {inner, 5};
+  bool is_inside = false;
+  assert(geo_ring_view_in_ring_view_double(&parent, &child, true, &is_inside) == GEO_SUCCESS);
+  assert(is_inside);
+  child.coordinates = crossing;
+  assert(geo_ring_view_in_ring_view_double(&parent, &child, true, &is_inside) == GEO_SUCCESS);
+  assert(!is_inside);
+}
+
+void geo_point_in_polygon_view_double_returns_geo_success_and_false_inside_a_hole(void) {
+  double outer[10] = {0, 0, 8, 0, 8, 8, 0, 8, 0, 0};
+  double hole[10] = {2, 2, 2, 6, 6, 6, 6, 2, 2, 2};
+  struct GeoRingView_double rings[2] = {{outer, 5}, {hole, 5}};
+  struct GeoPolygonView_double polygon = {rings, 2};
+  struct GeoPoint_double in_hole = {4, 4};
+  struct GeoPoint_double on_hole = {2, 4};
+  struct GeoPoint_double in_polygon = {1, 4};
+  bool is_inside = true;
+  assert(geo_point_in_polygon_view_double(&in_hole, &polygon, false, &is_inside) == GEO_SUCCESS);
+  assert(!is_inside);
+  assert(geo_point_in_polygon_view_double(&on_hole, &polygon, true, &is_inside) == GEO_SUCCESS);
+  assert(!is_inside);
+  assert(geo_point_in_polygon_view_double(&on_hole, &polygon, false, &is_inside) == GEO_SUCCESS);
+  assert(is_inside);
+  assert(geo_point_in_polygon_view_double(&in_polygon, &polygon, true, &is_inside) == GEO_SUCCESS);
+  assert(is_inside);
+}
+
+void geo_ring_view_envelope_double_returns_geo_success_and_bounds_of_the_ring(void) {
+  double coordinates[10] = {1, 2, 5, 0, 7, 3, 2, 9, 1, 2};
+  struct GeoRingView_double view = {coordinates, 5};
+  struct GeoEnvelope_double envelope;
+  assert(geo_ring_view_envelope_double(&view, &envelope) == GEO_SUCCESS);
+  assert(envelope.min.x == 1 && envelope.min.y == 0);
+  assert(envelope.max.x == 7 && envelope.max.y == 9);
+}
+
+/*
+ *----------------------------------
+ * geo_wkb_read_double tests
+ *----------------------------------
+ */
+/* writes little endian WKB (the tests run on little endian hosts) */
+static size_t wkb_put_u32(unsigned char *blob, size_t offset, uint32_t value) {
+  memcpy(blob + offset, &value, sizeof(value));
+  return offset + sizeof(value);
+}
+
+static size_t wkb_put_square(unsigned char *blob, size_t offset, double corner, double side) {
+  double coordinates[10] = {corner, corner, corner + side, corner, corner + side, corner + side,
+                            corner, corner + side, corner, corner};
+  offset = wkb_put_u32(blob, offset, 5);
+  memcpy(blob + offset, coordinates, sizeof(coordinates));
+  return offset + sizeof(coordinates);
+}
+
+static size_t wkb_put_polygon_header(unsigned char *blob, size_t offset, uint32_t rings_count) {
+  blob[offset++] = 1;
+  offset = wkb_put_u32(blob, offset, 3);
+  return wkb_put_u32(blob, offset, rings_count);
+}
+
+void geo_wkb_read_double_returns_geo_success_and_views_into_the_blob_for_a_polygon_with_a_hole(void) {
+  unsigned char blob[256];
+  struct GeoPolygonView_double polygons[1];
+  struct GeoRingView_double rings[2];
+  size_t polygons_count = 0;
+  size_t rings_count = 0;
+  /* offset by one byte so the coordinates are unaligned */
+  size_t size = wkb_put_polygon_header(blob, 1, 2);
+  struct GeoPoint_double point = {1, 1};
+  bool is_inside = false;
+  size = wkb_put_square(blob, size, 0, 8);
+  size = wkb_put_square(blob, size, 2, 4);
+  assert(geo_wkb_read_double(blob + 1, size - 1, polygons, 1, &polygons_count, rings, 2,
+                             &rings_count) == GEO_SUCCESS);
+  assert(polygons_count == 1 && rings_count == 2);
+  assert(polygons[0].rings == rings && polygons[0].rings_count == 2);
+  assert(rings[0].coordinates == blob + 14 && rings[0].points_count == 5);
+  assert(geo_point_in_polygon_view_double(&point, &polygons[0], true, &is_inside) == GEO_SUCCESS);
+  assert(is_inside);
+  point.x = 3;
+  point.y = 3;
+  assert(geo_point_in_polygon_view_double(&point, &polygons[0], true, &is_inside) == GEO_SUCCESS);
+  assert(!is_inside);
+}
+
+void geo_wkb_read_double_returns_geo_err_too_small_and_required_counts_for_a_multi_polygon(void) {
+  unsigned char blob[512];
+  struct GeoPolygonView_double polygons[2];
+  struct GeoRingView_double rings[2];
+  size_t polygons_count = 0;
+  size_t rings_count = 0;
+  size_t size = 0;
+  blob[size++] = 1;
+  size = wkb_put_u32(blob, size, 6 | 0x20000000U);
+  size = wkb_put_u32(blob, size, 4326);
+  size = wkb_put_u32(blob, size, 2);
+  size = wkb_put_polygon_header(blob, size, 1);
+  size = wkb_put_square(blob, size, 0, 1);
+  size = wkb_put_polygon_header(blob, size, 1);
+  size = wkb_put_square(blob, size, 5, 1);
+  assert(geo_wkb_read_double(blob, size, NULL, 0, &polygons_count, NULL, 0, &rings_count) ==
+         GEO_ERR_TOO_SMALL);
+  assert(polygons_count == 2 && rings_count == 2);
+  assert(geo_wkb_read_double(blob, size, polygons, 2, &polygons_count, rings, 2, &rings_count) ==
+         GEO_SUCCESS);
+  assert(polygons[1].rings == &rings[1]);
+}
+
+void geo_wkb_read_double_returns_geo_err_invalid_format_when_blob_is_truncated(void) {
+  unsigned char blob[256];
+  struct GeoPolygonView_double polygons[1];
+  struct GeoRingView_double rings[1];
+  size_t polygons_count = 0;
+  size_t rings_count = 0;
+  size_t size = wkb_put_polygon_header(blob, 0, 1);
+  size = wkb_put_square(blob, size, 0, 1);
+  assert(geo_wkb_read_double(blob, size - 1, polygons, 1, &polygons_count, rings, 1,
+                             &rings_count) == GEO_ERR_INVALID_FORMAT);
+  assert(geo_wkb_read_double(blob, size + 1, polygons, 1, &polygons_count, rings, 1,
+                             &rings_count) == GEO_ERR_INVALID_FORMAT);
+}
+
+void geo_wkb_read_double_returns_geo_err_unsupported_for_other_byte_orders_and_types(void) {
+  unsigned char blob[64];
+  struct GeoPolygonView_double polygons[1];
+  struct GeoRingView_double rings[1];
+  size_t polygons_count = 0;
+  size_t rings_count = 0;
+  size_t size = wkb_put_polygon_header(blob, 0, 0);
+  blob[0] = 0;
+  assert(geo_wkb_read_double(blob, size, polygons, 1, &polygons_count, rings, 1,
+                             &rings_count) == GEO_ERR_UNSUPPORTED);
+  blob[0] = 1;
+  wkb_put_u32(blob, 1, 1003);
+  assert(geo_wkb_read_double(blob, size, polygons, 1, &polygons_count, rings, 1,
+                             &rings_count) == GEO_ERR_UNSUPPORTED);
+  wkb_put_u32(blob, 1, 1);
+  assert(geo_wkb_read_double(blob, size, polygons, 1, &polygons_count, rings, 1,
+                             &rings_count) == GEO_ERR_UNSUPPORTED);
+}
+
+/*
+ *----------------------------------
+ * geo_wkt_parse_double tests
+ *----------------------------------
+ */
+struct WktShapes_double {
+  size_t count;
+  enum GeoShapeType types[4];
+  size_t points_counts[4];
+  size_t parts_counts[4];
+  size_t polygons_counts[4];
+  bool closed;
+  bool inside;
+};
+
+static void collect_wkt_shape_double(void *context, struct GeoShape_double const *shape) {
+  struct WktShapes_double *shapes = (struct WktShapes_double *)context;
+  struct GeoPoint_double point = {2, 2};
+  bool is_closed = false;
+  assert(shapes->count < 4);
+  shapes->types[shapes->count] = shape->type;
+  shapes->points_counts[shapes->count] = shape->points_count;
+  shapes->parts_counts[shapes->count] = shape->parts_count;
+  shapes->polygons_counts[shapes->count] = shape->polygons_count;
+  if (shape->type == GEO_SHAPE_POLYGON) {
+    assert(geo_geometry_is_closed_double(&shape->parts[0], &is_closed) == GEO_SUCCESS);
+    assert(geo_point_in_geometry_double(&point, &shape->parts[0], true, &shapes->inside) == GEO_SUCCESS);
+    shapes->closed = is_closed;
+  }
+  if (shape->type == GEO_SHAPE_POINT && shape->points_count == 1) {
+    assert(shape->point.x == -3 && shape->point.y == 7);
+  }
+  ++shapes->count;
+}
+
+static char const wkt_text_double[] =
+    "POINT (-3 7)\n"
+    "polygon ((0 0, 4 0, 4 4, 0 4, 0 0), (1 1, 1 3, 3 3, 3 1, 1 1))\n"
+    "MULTIPOLYGON(((0 0,1 0,1 1,0 0)),((5 5,6 5,6 6,5 5),(5 5,6 5,6 6,5 5)))\n"
+    "LINESTRING EMPTY";
+
+static void check_wkt_shapes_double(struct WktShapes_double const *shapes) {
+  assert(shapes->count == 4);
+  assert(shapes->types[0] == GEO_SHAPE_POINT && shapes->points_counts[0] == 1);
+  assert(shapes->types[1] == GEO_SHAPE_POLYGON && shapes->points_counts[1] == 10);
+  assert(shapes->parts_counts[1] == 2 && shapes->polygons_counts[1] == 1);
+  assert(shapes->closed && shapes->inside);
+  assert(shapes->types[2] == GEO_SHAPE_MULTI_POLYGON && shapes->parts_counts[2] == 3);
+  assert(shapes->polygons_counts[2] == 2 && shapes->points_counts[2] == 12);
+  assert(shapes->types[3] == GEO_SHAPE_LINE_STRING && shapes->points_counts[3] == 0);
+}
+
+void geo_wkt_parse_double_returns_geo_success_and_emits_every_shape(void) {
+  unsigned char buffer[4096];
+  struct GeoArena arena;
+  struct GeoWktParser_double parser;
+  struct WktShapes_double shapes;
+  memset(&shapes, 0, sizeof(shapes));
+  geo_arena_init(&arena, buffer, sizeof(buffer));
+  assert(geo_wkt_parser_init_double(&parser, &arena, collect_wkt_shape_double, &shapes) == GEO_SUCCESS);
+  assert(geo_wkt_parse_double(&parser, wkt_text_double, sizeof(wkt_text_double) - 1) == GEO_SUCCESS);
+  assert(geo_wkt_parse_finish_double(&parser) == GEO_SUCCESS);
+  check_wkt_shapes_double(&shapes);
+}
+
+void geo_wkt_parse_double_returns_geo_success_for_every_chunk_split(void) {
+  unsigned char buffer[4096];
+  struct GeoArena arena;
+  struct GeoWktParser_double parser;
+  struct WktShapes_double shapes;
+  size_t size = sizeof(wkt_text_double) - 1;
+  for (size_t split = 0; split <= size; ++split) {
+    memset(&shapes, 0, sizeof(shapes));
+    geo_arena_init(&arena, buffer, sizeof(buffer));
+    geo_wkt_parser_init_double(&parser, &arena, collect_wkt_shape_double, &shapes);
+    assert(geo_wkt_parse_double(&parser, wkt_text_double, split) == GEO_SUCCESS);
+    assert(geo_wkt_parse_double(&parser, wkt_text_double + split, size - split) == GEO_SUCCESS);
+    assert(geo_wkt_parse_finish_double(&parser) == GEO_SUCCESS);
+    check_wkt_shapes_double(&shapes);
+  }
+}
+
+void geo_wkt_parse_double_returns_geo_err_invalid_format_and_offset_for_malformed_text(void) {
+  unsigned char buffer[1024];
+  struct GeoArena arena;
+  struct GeoWktParser_double parser;
+  struct WktShapes_double shapes;
+  char const text[] = "POINT (-3 7) LINESTRING (1 2,, 3 4)";
+  memset(&shapes, 0, sizeof(shapes));
+  geo_arena_init(&arena, buffer, sizeof(buffer));
+  geo_wkt_parser_init_double(&parser, &arena, collect_wkt_shape_double, &shapes);
+  assert(geo_wkt_parse_double(&parser, text, sizeof(text) - 1) == GEO_ERR_INVALID_FORMAT);
+  assert(parser.offset == 29);
+  assert(geo_wkt_parse_finish_double(&parser) == GEO_ERR_INVALID_FORMAT);
+}
+
+void geo_wkt_parse_finish_double_returns_geo_err_invalid_format_when_shape_is_unterminated(void) {
+  unsigned char buffer[1024];
+  struct GeoArena arena;
+  struct GeoWktParser_double parser;
+  struct WktShapes_double shapes;
+  char const text[] = "POLYGON ((0 0, 4 0, 4 4, 0 0)";
+  memset(&shapes, 0, sizeof(shapes));
+  geo_arena_init(&arena, buffer, sizeof(buffer));
+  geo_wkt_parser_init_double(&parser, &arena, collect_wkt_shape_double, &shapes);
+  assert(geo_wkt_parse_double(&parser, text, sizeof(text) - 1) == GEO_SUCCESS);
+  assert(geo_wkt_parse_finish_double(&parser) == GEO_ERR_INVALID_FORMAT);
+  assert(shapes.count == 0);
+}
+
+void geo_wkt_parse_double_returns_geo_err_unsupported_for_z_coordinates(void) {
+  unsigned char buffer[1024];
+  struct GeoArena arena;
+  struct GeoWktParser_double parser;
+  struct WktShapes_double shapes;
+  char const text[] = "POINT (1 2 3)";
+  memset(&shapes, 0, sizeof(shapes));
+  geo_arena_init(&arena, buffer, sizeof(buffer));
+  geo_wkt_parser_init_double(&parser, &arena, collect_wkt_shape_double, &shapes);
+  assert(geo_wkt_parse_double(&parser, text, sizeof(text) - 1) == GEO_ERR_UNSUPPORTED);
+}
+
+void geo_wkt_parse_double_returns_geo_err_full_when_arena_is_too_small(void) {
+  unsigned char buffer[32];
+  struct GeoArena arena;
+  struct GeoWktParser_double parser;
+  struct WktShapes_double shapes;
+  memset(&shapes, 0, sizeof(shapes));
+  geo_arena_init(&arena, buffer, sizeof(buffer));
+  geo_wkt_parser_init_double(&parser, &arena, collect_wkt_shape_double, &shapes);
+  assert(geo_wkt_parse_double(&parser, wkt_text_double, sizeof(wkt_text_double) - 1) == GEO_ERR_FULL);
+}
+
+/*
+ *----------------------------------
+ * geo_wkt_parse_fd_double tests
+ *----------------------------------
+ */
+struct WktSum_double {
+  struct GeoArena *arena;
+  double sum;
+};
+
+/* resets the arena after every shape so the whole file fits in a small one */
+static void sum_wkt_points_double(void *context, struct GeoShape_double const *shape) {
+  struct WktSum_double *total = (struct WktSum_double *)context;
+  for (size_t part = 0; part < shape->parts_count; ++part) {
+    for (size_t iter = 0; iter < shape->parts[part].segments_count; ++iter) {
+      total->sum += shape->parts[part].segments[iter]->start->x;
+    }
+  }
+  geo_arena_reset(total->arena);
+}
+
+void geo_wkt_parse_fd_double_returns_geo_success_and_reads_the_whole_file(void) {
+  static char text[1 << 19];
+  unsigned char buffer[1024];
+  struct GeoArena arena;
+  struct GeoWktParser_double parser;
+  struct WktSum_double total = {&arena, 0};
+  size_t size = 0;
+  int descriptor = -1;
+  /* larger than GEO_WKT_READ_SIZE so shapes cross read boundaries */
+  for (size_t iter = 0; iter < 10000; ++iter) {
+    size += (size_t)sprintf(text + size, "LINESTRING (0.25 1e-3, -1.5E1 2, 10.125 3)\n");
+  }
+  assert(geo_file_write("./bin/test_geo_wkt.txt", text, size) == GEO_SUCCESS);
+  descriptor = open("./bin/test_geo_wkt.txt", O_RDONLY);
+  assert(descriptor >= 0);
+  geo_arena_init(&arena, buffer, sizeof(buffer));
+  geo_wkt_parser_init_double(&parser, &arena, sum_wkt_points_double, &total);
+  assert(geo_wkt_parse_fd_double(&parser, descriptor) == GEO_SUCCESS);
+  close(descriptor);
+  remove("./bin/test_geo_wkt.txt");
+  assert(parser.offset == size);
+  assert(total.sum == 10000 * (0.25 - 15.0));
+}
+
+/*
+ *----------------------------------
+ * geo_json_parse_double tests
+ *----------------------------------
+ */
+struct JsonShapes_double {
+  size_t count;
+  enum GeoShapeType types[4];
+  size_t points_counts[4];
+  size_t parts_counts[4];
+  size_t polygons_counts[4];
+  double first_x[4];
+};
+
+static void collect_json_shape_double(void *context, struct GeoShape_double const *shape) {
+  struct JsonShapes_double *shapes = (struct JsonShapes_double *)context;
+  assert(shapes->count < 4);
+  shapes->types[shapes->count] = shape->type;
+  shapes->points_counts[shapes->count] = shape->points_count;
+  shapes->parts_counts[shapes->count] = shape->parts_count;
+  shapes->polygons_counts[shapes->count] = shape->polygons_count;
+  shapes->first_x[shapes->count] =
+      shape->parts_count > 0 ? shape->parts[0].segments[0]->start->x : shape->point.x;
+  ++shapes->count;
+}
+
+static char const json_text_double[] =
+    "{\"type\": \"FeatureCollection\", \"features\": [\n"
+    " {\"type\": \"Feature\", \"properties\": {\"name\": \"a \\\"type\\\"\", \"coordinates\": [9, 9],\n"
+    "  \"nested\": [{\"geometry\": null}, true, -1.5e3]},\n"
+    "  \"geometry\": {\"type\": \"Point\", \"coordinates\": [-3, 7, 100]}},\n"
+    " {\"type\": \"Feature\", \"geometry\": {\"coordinates\": [[[0, 0], [4, 0], [4, 4], [0, 4], [0, 0]],\n"
+    "  [[1, 1], [1, 3], [3, 3], [3, 1], [1, 1]]], \"type\": \"Polygon\"}, \"properties\": null},\n"
+    " {\"type\": \"Feature\", \"geometry\": null, \"properties\": {}},\n"
+    " {\"type\": \"Feature\", \"geometry\": {\"type\": \"MultiPolygon\", \"coordinates\": [\n"
+    "  [[[5, 5], [6, 5], [6, 6], [5, 5]]], [[[8, 8], [9, 8], [9, 9], [8, 8]]]]}},\n"
+    " {\"type\": \"Feature\", \"geometry\": {\"type\": \"LineString\", \"coordinates\": []}}\n"
+    "]}\n";
+
+static void check_json_shapes_double(struct JsonShapes_double const *shapes) {
+  assert(shapes->count == 4);
+  assert(shapes->types[0] == GEO_SHAPE_POINT && shapes->points_counts[0] == 1);
+  assert(shapes->first_x[0] == -3);
+  assert(shapes->types[1] == GEO_SHAPE_POLYGON && shapes->points_counts[1] == 10);
+  assert(shapes->parts_counts[1] == 2 && shapes->polygons_counts[1] == 1);
+  assert(shapes->types[2] == GEO_SHAPE_MULTI_POLYGON && shapes->parts_counts[2] == 2);
+  assert(shapes->polygons_counts[2] == 2 && shapes->first_x[2] == 5);
+  assert(shapes->types[3] == GEO_SHAPE_LINE_STRING && shapes->points_counts[3] == 0);
+}
+
+void geo_json_parse_double_returns_geo_success_and_emits_every_feature_geometry(void) {
+  unsigned char buffer[4096];
+  struct GeoArena arena;
+  struct GeoJsonParser_double parser;
+  struct JsonShapes_double shapes;
+  memset(&shapes, 0, sizeof(shapes));
+  geo_arena_init(&arena, buffer, sizeof(buffer));
+  assert(geo_json_parser_init_double(&parser, &arena, collect_json_shape_double, &shapes) == GEO_SUCCESS);
+  assert(geo_json_parse_double(&parser, json_text_double, sizeof(json_text_double) - 1) == GEO_SUCCESS);
+  assert(geo_json_parse_finish_double(&parser) == GEO_SUCCESS);
+  check_json_shapes_double(&shapes);
+}
+
+void geo_json_parse_double_returns_geo_success_for_every_chunk_split(void) {
+  unsigned char buffer[4096];
+  struct GeoArena arena;
+  struct GeoJsonParser_double parser;
+  struct JsonShapes_double shapes;
+  size_t size = sizeof(json_text_double) - 1;
+  for (size_t split = 0; split <= size; ++split) {
+    memset(&shapes, 0, sizeof(shapes));
+    geo_arena_init(&arena, buffer, sizeof(buffer));
+    geo_json_parser_init_double(&parser, &arena, collect_json_shape_double, &shapes);
+    assert(geo_json_parse_double(&parser, json_text_double, split) == GEO_SUCCESS);
+    assert(geo_json_parse_double(&parser, json_text_double + split, size - split) == GEO_SUCCESS);
+    assert(geo_json_parse_finish_double(&parser) == GEO_SUCCESS);
+    check_json_shapes_double(&shapes);
+  }
+}
+
+void geo_json_parse_double_returns_geo_success_for_bare_geometries_one_per_line(void) {
+  unsigned char buffer[1024];
+  struct GeoArena arena;
+  struct GeoJsonParser_double parser;
+  struct JsonShapes_double shapes;
+  char const text[] = "{\"type\":\"Point\",\"coordinates\":[1,2]}\n"
+                      "{\"type\":\"Feature\",\"geometry\":{\"type\":\"Point\",\"coordinates\":[3,4]}}\n";
+  memset(&shapes, 0, sizeof(shapes));
+  geo_arena_init(&arena, buffer, sizeof(buffer));
+  geo_json_parser_init_double(&parser, &arena, collect_json_shape_double, &shapes);
+  assert(geo_json_parse_double(&parser, text, sizeof(text) - 1) == GEO_SUCCESS);
+  assert(geo_json_parse_finish_double(&parser) == GEO_SUCCESS);
+  assert(shapes.count == 2 && shapes.first_x[0] == 1 && shapes.first_x[1] == 3);
+}
+
+void geo_json_parse_double_returns_geo_err_invalid_format_for_malformed_json(void) {
+  unsigned char buffer[1024];
+  struct GeoArena arena;
+  struct GeoJsonParser_double parser;
+  struct JsonShapes_double shapes;
+  char const *texts[] = {"{\"type\":\"Point\",\"coordinates\":[1,2],}",
+                         "{\"type\":\"Point\" \"coordinates\":[1,2]}",
+                         "{\"type\":\"Point\",\"coordinates\":[1,2]]",
+                         "{\"type\":\"Polygon\",\"coordinates\":[[1,2],[3,4]]}",
+                         "{\"type\":\"LineString\",\"coordinates\":[[1,2],[3,x]]}"};
+  for (size_t iter = 0; iter < sizeof(texts) / sizeof(texts[0]); ++iter) {
+    memset(&shapes, 0, sizeof(shapes));
+    geo_arena_init(&arena, buffer, sizeof(buffer));
+    geo_json_parser_init_double(&parser, &arena, collect_json_shape_double, &shapes);
+    assert(geo_json_parse_double(&parser, texts[iter], strlen(texts[iter])) == GEO_ERR_INVALID_FORMAT);
+    assert(shapes.count == 0);
+  }
+}
+
+void geo_json_parse_finish_double_returns_geo_err_invalid_format_when_json_is_truncated(void) {
+  unsigned char buffer[1024];
+  struct GeoArena arena;
+  struct GeoJsonParser_double parser;
+  struct JsonShapes_double shapes;
+  char const text[] = "{\"type\":\"Point\",\"coordinates\":[1,2]";
+  memset(&shapes, 0, sizeof(shapes));
+  geo_arena_init(&arena, buffer, sizeof(buffer));
+  geo_json_parser_init_double(&parser, &arena, collect_json_shape_double, &shapes);
+  assert(geo_json_parse_double(&parser, text, sizeof(text) - 1) == GEO_SUCCESS);
+  assert(geo_json_parse_finish_double(&parser) == GEO_ERR_INVALID_FORMAT);
+}
+
+void geo_json_parse_double_returns_geo_err_unsupported_for_geometry_collections(void) {
+  unsigned char buffer[1024];
+  struct GeoArena arena;
+  struct GeoJsonParser_double parser;
+  struct JsonShapes_double shapes;
+  char const text[] = "{\"type\":\"GeometryCollection\",\"geometries\":[]}";
+  memset(&shapes, 0, sizeof(shapes));
+  geo_arena_init(&arena, buffer, sizeof(buffer));
+  geo_json_parser_init_double(&parser, &arena, collect_json_shape_double, &shapes);
+  assert(geo_json_parse_double(&parser, text, sizeof(text) - 1) == GEO_ERR_UNSUPPORTED);
+}
+
+/*
+ *----------------------------------
+ * geo_index_compress_double tests
+ *----------------------------------
+ */
+void geo_index_ring_double_returns_geo_success_and_closed_ring_of_indexed_geometry(void) {
+  struct GeoPoint_double points[3][4];
+  struct GeoSegment_double segments[3][4];
+  struct GeoSegment_double *segment_pointers[3][4];
+  struct GeoGeometry_double geometries[3];
+  struct GeoGeometry_double *geometry_pointers[3];
+  struct GeoIndex_double index;
+  struct GeoRingView_double view;
+  struct GeoEnvelope_double envelope;
+  struct GeoPoint_double inside = {7, 2};
+  struct GeoPoint_double outside = {2, 2};
+  bool is_inside = false;
+  size_t size = 0;
+  void *buffer = NULL;
+  enum GeoResult result = 0;
+  make_join_squares_double(points, segments, segment_pointers, geometries, geometry_pointers, 3);
+  result = geo_index_build_size_double(geometry_pointers, 3, &size);
+  assert(result == GEO_SUCCESS);
+  buffer = malloc(size);
+  result = geo_index_build_double(geometry_pointers, 3, NULL, buffer, size);
+  assert(result == GEO_SUCCESS);
+  result = geo_index_open_double(&index, buffer, size);
+  assert(result == GEO_SUCCESS);
+  result = geo_index_ring_double(&index, 3, &view);
+  assert(result == GEO_ERR_OUT_OF_RANGE);
+  for (size_t iter = 0; iter < 3; ++iter) {
+    if (index.entries[iter].id == 1) {
+      result = geo_index_ring_double(&index, iter, &view);
+      assert(result == GEO_SUCCESS);
+    }
+  }
+  assert(view.points_count == 5);
+  result = geo_ring_view_is_closed_double(&view, &is_inside);
+  assert(result == GEO_SUCCESS);
+  assert(is_inside);
+  result = geo_ring_view_envelope_double(&view, &envelope);
+  assert(result == GEO_SUCCESS);
+  assert(envelope.min.x == 5 && envelope.max.x == 9);
+  result = geo_point_in_ring_view_double(&inside, &view, true, &is_inside);
+  assert(result == GEO_SUCCESS);
+  assert(is_inside);
+  result = geo_point_in_ring_view_double(&outside, &view, false, &is_inside);
+  assert(result == GEO_SUCCESS);
+  assert(!is_inside);
+  free(buffer);
+}
+
+void geo_index_compress_double_returns_geo_success_and_decompress_restores_original_file(void) {
+  struct GeoPoint_double points[30][4];
+  struct GeoSegment_double segments[30][4];
+  struct GeoSegment_double *segment_pointers[30][4];
+  struct GeoGeometry_double geometries[30];
+  struct GeoGeometry_double *geometry_pointers[30];
+  struct GeoIndex_double index;
+  size_t size = 0;
+  size_t compressed_size = 0;
+  size_t decompressed_size = 0;
+  void *buffer = NULL;
+  void *compressed = NULL;
+  void *decompressed = NULL;
+  enum GeoResult result = 0;
+  make_join_squares_double(points, segments, segment_pointers, geometries, geometry_pointers, 30);
+  result = geo_index_build_size_double(geometry_pointers, 30, &size);
+  assert(result == GEO_SUCCESS);
+  buffer = malloc(size);
+  result = geo_index_build_double(geometry_pointers, 30, NULL, buffer, size);
+  assert(result == GEO_SUCCESS);
+
+  result = geo_index_compress_double(buffer, size, NULL, 0, &compressed_size);
+  assert(result == GEO_ERR_TOO_SMALL);
+  assert(compressed_size < size);
+  compressed = malloc(compressed_size);
+  result = geo_index_compress_double(buffer, size, compressed, compressed_size, &compressed_size);
+  assert(result == GEO_SUCCESS);
+  result = geo_index_open_double(&index, compressed, compressed_size);
+  assert(result == GEO_ERR_UNSUPPORTED);
+  result = geo_index_compress_double(compressed, compressed_size, buffer, size, &decompressed_size);
+  assert(result == GEO_ERR_UNSUPPORTED);
+
+  result = geo_index_decompress_double(compressed, compressed_size, NULL, 0, &decompressed_size);
+  assert(result == GEO_ERR_TOO_SMALL);
+  assert(decompressed_size == size);
+  decompressed = malloc(decompressed_size);
+  result = geo_index_decompress_double(compressed, compressed_size, decompressed, decompressed_size, &decompressed_size);
+  assert(result == GEO_SUCCESS);
+  assert(memcmp(decompressed, buffer, size) == 0);
+  result = geo_index_decompress_double(buffer, size, decompressed, decompressed_size, &decompressed_size);
+  assert(result == GEO_ERR_INVALID_FORMAT);
+  free(decompressed);
+  free(compressed);
+  free(buffer);
+}
+
+void geo_index_decompress_double_returns_geo_err_invalid_format_when_points_section_is_truncated(void) {
+  struct GeoPoint_double points[2][4];
+  struct GeoSegment_double segments[2][4];
+  struct GeoSegment_double *segment_pointers[2][4];
+  struct GeoGeometry_double geometries[2];
+  struct GeoGeometry_double *geometry_pointers[2];
+  struct GeoIndexHeader *header = NULL;
+  size_t size = 0;
+  size_t compressed_size = 0;
+  size_t decompressed_size = 0;
+  void *buffer = NULL;
+  void *compressed = NULL;
+  void *decompressed = NULL;
+  enum GeoResult result = 0;
+  make_join_squares_double(points, segments, segment_pointers, geometries, geometry_pointers, 2);
+  result = geo_index_build_size_double(geometry_pointers, 2, &size);
+  assert(result == GEO_SUCCESS);
+  buffer = malloc(size);
+  result = geo_index_build_double(geometry_pointers, 2, NULL, buffer, size);
+  assert(result == GEO_SUCCESS);
+  compressed = malloc(size);
+  result = geo_index_compress_double(buffer, size, compressed, size, &compressed_size);
+  assert(result == GEO_SUCCESS);
+  header = compressed;
+  header->size = header->points_offset + 1;
+  decompressed = malloc(size);
+  result = geo_index_decompress_double(compressed, compressed_size, decompressed, size, &decompressed_size);
+  assert(result == GEO_ERR_INVALID_FORMAT);
+  free(decompressed);
+  free(compressed);
+  free(buffer);
+}
+
+/*
+ *----------------------------------
+ * geo_shp_double tests
+ *----------------------------------
+ */
+static void shp_put_be32(unsigned char *data, uint32_t value) {
+  data[0] = (unsigned char)(value >> 24);
+  data[1] = (unsigned char)(value >> 16);
+  data[2] = (unsigned char)(value >> 8);
+  data[3] = (unsigned char)value;
+}
+
+static void shp_put_header(unsigned char *data, size_t size) {
+  uint32_t version = 1000;
+  uint32_t type = 5;
+  memset(data, 0, 100);
+  shp_put_be32(data, 9994);
+  shp_put_be32(data + 24, (uint32_t)(size / 2));
+  memcpy(data + 28, &version, sizeof(version));
+  memcpy(data + 32, &type, sizeof(type));
+}
+
+/* a record of squares as parts, or a null shape when `parts_count` is 0 */
+static size_t shp_put_record(unsigned char *shp, size_t offset, unsigned char *shx, size_t record,
+                             double const *corners, double const *sides, uint32_t parts_count) {
+  uint32_t type = parts_count == 0 ? 0 : 5;
+  uint32_t points_count = parts_count * 5;
+  size_t content_size = parts_count == 0 ? 4 : 44 + (parts_count * 4) + (points_count * 16);
+  double box[4];
+  unsigned char *content = shp + offset + 8;
+  shp_put_be32(shx + 100 + (record * 8), (uint32_t)(offset / 2));
+  shp_put_be32(shx + 100 + (record * 8) + 4, (uint32_t)(content_size / 2));
+  shp_put_be32(shp + offset, (uint32_t)(record + 1));
+  shp_put_be32(shp + offset + 4, (uint32_t)(content_size / 2));
+  memcpy(content, &type, sizeof(type));
+  if (parts_count == 0) {
+    return offset + 8 + content_size;
+  }
+  box[0] = box[1] = corners[0];
+  box[2] = box[3] = corners[0] + sides[0];
+  memcpy(content + 4, box, sizeof(box));
+  memcpy(content + 36, &parts_count, sizeof(parts_count));
+  memcpy(content + 40, &points_count, sizeof(points_count));
+  for (uint32_t part = 0; part < parts_count; ++part) {
+    uint32_t start = part * 5;
+    double corner = corners[part];
+    double side = sides[part];
+    double coordinates[10] = {corner, corner, corner, corner + side, corner + side, corner + side,
+                              corner + side, corner, corner, corner};
+    memcpy(content + 44 + (part * 4), &start, sizeof(start));
+    memcpy(content + 44 + (parts_count * 4) + (part * sizeof(coordinates)), coordinates,
+           sizeof(coordinates));
+  }
+  return offset + 8 + content_size;
+}
+
+/* record 0 is a square of side 10 with a hole, record 1 a null shape, record 2 a square */
+static void shp_put_file(unsigned char *shp, size_t *shp_size, unsigned char *shx, size_t *shx_size) {
+  double corners[2] = {0, 4};
+  double sides[2] = {10, 2};
+  double corner = 20;
+  double side = 2;
+  size_t offset = shp_put_record(shp, 100, shx, 0, corners, sides, 2);
+  offset = shp_put_record(shp, offset, shx, 1, NULL, NULL, 0);
+  offset = shp_put_record(shp, offset, shx, 2, &corner, &side, 1);
+  *shp_size = offset;
+  *shx_size = 100 + (3 * 8);
+  shp_put_header(shp, *shp_size);
+  shp_put_header(shx, *shx_size);
+}
+
+void geo_shp_open_double_returns_geo_err_invalid_format_when_file_code_does_not_match(void) {
+  unsigned char shp[512];
+  unsigned char shx[128];
+  size_t shp_size = 0;
+  size_t shx_size = 0;
+  struct GeoShpFile file;
+  uint32_t type = 1;
+  shp_put_file(shp, &shp_size, shx, &shx_size);
+  shx[3] = 0;
+  assert(geo_shp_open_double(&file, shp, shp_size, shx, shx_size) == GEO_ERR_INVALID_FORMAT);
+  shp_put_file(shp, &shp_size, shx, &shx_size);
+  assert(geo_shp_open_double(&file, shp, shp_size - 2, shx, shx_size) == GEO_ERR_INVALID_FORMAT);
+  memcpy(shp + 32, &type, sizeof(type));
+  assert(geo_shp_open_double(&file, shp, shp_size, shx, shx_size) == GEO_ERR_UNSUPPORTED);
+}
+
+void geo_shp_record_rings_double_returns_geo_success_and_views_into_the_file(void) {
+  unsigned char shp[512];
+  unsigned char shx[128];
+  size_t shp_size = 0;
+  size_t shx_size = 0;
+  struct GeoShpFile file;
+  struct GeoRingView_double rings[2];
+  struct GeoEnvelope_double envelope;
+  struct GeoPoint_double point = {1, 1};
+  size_t rings_count = 0;
+  bool is_inside = false;
+  shp_put_file(shp, &shp_size, shx, &shx_size);
+  assert(geo_shp_open_double(&file, shp, shp_size, shx, shx_size) == GEO_SUCCESS);
+  assert(file.records_count == 3);
+
+  assert(geo_shp_record_envelope_double(&file, 2, &envelope) == GEO_SUCCESS);
+  assert(envelope.min.x == 20 && envelope.min.y == 20);
+  assert(envelope.max.x == 22 && envelope.max.y == 22);
+  assert(geo_shp_record_envelope_double(&file, 1, &envelope) == GEO_ERR_TOO_SMALL);
+  assert(geo_shp_record_envelope_double(&file, 3, &envelope) == GEO_ERR_OUT_OF_RANGE);
+
+  assert(geo_shp_record_rings_double(&file, 0, rings, 1, &rings_count) == GEO_ERR_TOO_SMALL);
+  assert(rings_count == 2);
+  assert(geo_shp_record_rings_double(&file, 0, rings, 2, &rings_count) == GEO_SUCCESS);
+  assert(rings_count == 2);
+  assert(rings[0].points_count == 5 && rings[1].points_count == 5);
+  assert(rings[0].coordinates == shp + 100 + 8 + 44 + 8);
+  assert(geo_point_in_ring_view_double(&point, &rings[0], true, &is_inside) == GEO_SUCCESS);
+  assert(is_inside);
+  assert(geo_shp_record_rings_double(&file, 1, rings, 2, &rings_count) == GEO_SUCCESS);
+  assert(rings_count == 0);
+}
+
+void geo_point_in_shp_record_double_returns_geo_success_and_uses_the_even_odd_rule_over_parts(void) {
+  unsigned char shp[512];
+  unsigned char shx[128];
+  size_t shp_size = 0;
+  size_t shx_size = 0;
+  struct GeoShpFile file;
+  struct GeoPoint_double inside = {1, 1};
+  struct GeoPoint_double in_hole = {5, 5};
+  struct GeoPoint_double on_hole_edge = {4, 5};
+  struct GeoPoint_double other = {21, 21};
+  bool is_inside = false;
+  shp_put_file(shp, &shp_size, shx, &shx_size);
+  assert(geo_shp_open_double(&file, shp, shp_size, shx, shx_size) == GEO_SUCCESS);
+  assert(geo_point_in_shp_record_double(&inside, &file, 0, true, &is_inside) == GEO_SUCCESS);
+  assert(is_inside);
+  assert(geo_point_in_shp_record_double(&in_hole, &file, 0, false, &is_inside) == GEO_SUCCESS);
+  assert(!is_inside);
+  assert(geo_point_in_shp_record_double(&on_hole_edge, &file, 0, true, &is_inside) == GEO_SUCCESS);
+  assert(!is_inside);
+  assert(geo_point_in_shp_record_double(&on_hole_edge, &file, 0, false, &is_inside) == GEO_SUCCESS);
+  assert(is_inside);
+  assert(geo_point_in_shp_record_double(&other, &file, 0, false, &is_inside) == GEO_SUCCESS);
+  assert(!is_inside);
+  assert(geo_point_in_shp_record_double(&other, &file, 1, false, &is_inside) == GEO_SUCCESS);
+  assert(!is_inside);
+  assert(geo_point_in_shp_record_double(&other, &file, 2, true, &is_inside) == GEO_SUCCESS);
+  assert(is_inside);
+}
+
+/*
+ *----------------------------------
+ * geo_fgb_double tests
+ *----------------------------------
+ */
+static size_t fgb_put(unsigned char *data, size_t size, void const *value, size_t value_size) {
+  memcpy(data + size, value, value_size);
+  return size + value_size;
+}
+
+/* vtable then a table of `count` fields, field i in an 8 byte slot when bit i of `present` is set */
+static size_t fgb_put_table(unsigned char *data, size_t *size, uint32_t present, uint16_t count) {
+  uint16_t vtable_size = (uint16_t)(4 + (count * 2));
+  uint16_t table_size = (uint16_t)(4 + (count * 8));
+  size_t vtable = *size;
+  size_t table = 0;
+  int32_t vtable_offset = 0;
+  *size = fgb_put(data, *size, &vtable_size, sizeof(vtable_size));
+  *size = fgb_put(data, *size, &table_size, sizeof(table_size));
+  for (uint16_t field = 0; field < count; ++field) {
+    uint16_t offset = (present >> field) & 1 ? (uint16_t)(4 + (field * 8)) : 0;
+    *size = fgb_put(data, *size, &offset, sizeof(offset));
+  }
+  table = *size;
+  vtable_offset = (int32_t)(table - vtable);
+  *size = fgb_put(data, *size, &vtable_offset, sizeof(vtable_offset));
+  memset(data + *size, 0, (size_t)count * 8);
+  *size += (size_t)count * 8;
+  return table;
+}
+
+static void fgb_put_reference(unsigned char *data, size_t table, uint16_t field, size_t target) {
+  uint32_t offset = (uint32_t)(target - (table + 4 + (field * 8)));
+  memcpy(data + table + 4 + (field * 8), &offset, sizeof(offset));
+}
+
+static size_t fgb_put_vector(unsigned char *data, size_t *size, void const *elements, size_t element_size,
+                             uint32_t count) {
+  size_t vector = *size;
+  *size = fgb_put(data, *size, &count, sizeof(count));
+  *size = fgb_put(data, *size, elements, element_size * count);
+  return vector;
+}
+
+/* a polygon geometry table of squares, the first is the outer ring, written after `table` */
+static size_t fgb_put_polygon(unsigned char *data, size_t *size, double const *corners, double const *sides,
+                              uint32_t rings_count, uint8_t type) {
+  double xy[40];
+  uint32_t ends[4];
+  size_t table = fgb_put_table(data, size, (rings_count > 1 ? 1U : 0U) | 2U | (type != 0 ? 64U : 0U), 8);
+  for (uint32_t ring = 0; ring < rings_count; ++ring) {
+    double square[10] = {corners[ring], corners[ring], corners[ring] + sides[ring], corners[ring],
+                         corners[ring] + sides[ring], corners[ring] + sides[ring], corners[ring],
+                         corners[ring] + sides[ring], corners[ring], corners[ring]};
+    memcpy(xy + (ring * 10), square, sizeof(square));
+    ends[ring] = (ring + 1) * 5;
+  }
+  data[table + 4 + (6 * 8)] = type;
+  if (rings_count > 1) {
+    fgb_put_reference(data, table, 0, fgb_put_vector(data, size, ends, sizeof(uint32_t), rings_count));
+  }
+  fgb_put_reference(data, table, 1, fgb_put_vector(data, size, xy, sizeof(double), rings_count * 10));
+  return table;
+}
+
+/* size prefixed feature with a geometry table, returns the position after it */
+static size_t fgb_put_feature(unsigned char *data, size_t size, double const *corners, double const *sides,
+                              uint32_t const *rings_counts, uint32_t polygons_count) {
+  size_t start = size;
+  size_t root = size + 4;
+  size_t feature = 0;
+  size_t geometry = 0;
+  uint32_t zero = 0;
+  uint32_t buffer_size = 0;
+  size = fgb_put(data, size, &zero, sizeof(zero));
+  size = fgb_put(data, size, &zero, sizeof(zero));
+  feature = fgb_put_table(data, &size, 1U, 1);
+  memcpy(data + root, &(uint32_t){(uint32_t)(feature - root)}, sizeof(uint32_t));
+  if (polygons_count == 1) {
+    geometry = fgb_put_polygon(data, &size, corners, sides, rings_counts[0], 3);
+  } else {
+    uint32_t parts[4];
+    size_t parts_vector = 0;
+    size_t part_tables[4];
+    geometry = fgb_put_table(data, &size, 64U | 128U, 8);
+    data[geometry + 4 + (6 * 8)] = 6;
+    parts_vector = size;
+    size += 4 + (polygons_count * 4);
+    for (uint32_t part = 0; part < polygons_count; ++part) {
+      part_tables[part] = fgb_put_polygon(data, &size, corners, sides, rings_counts[part], 3);
+      corners += rings_counts[part];
+      sides += rings_counts[part];
+      parts[part] = (uint32_t)(part_tables[part] - (parts_vector + 4 + (part * 4)));
+    }
+    memcpy(data + parts_vector, &polygons_count, sizeof(polygons_count));
+    memcpy(data + parts_vector + 4, parts, polygons_count * sizeof(uint32_t));
+    fgb_put_reference(data, geometry, 7, parts_vector);
+  }
+  fgb_put_reference(data, feature, 0, geometry);
+  buffer_size = (uint32_t)(size - root);
+  memcpy(data + start, &buffer_size, sizeof(buffer_size));
+  return size;
+}
+
+static void fgb_put_node(unsigned char *data, size_t position, double min, double max, uint64_t offset) {
+  double box[4] = {min, min, max, max};
+  memcpy(data + position, box, sizeof(box));
+  memcpy(data + position + sizeof(box), &offset, sizeof(offset));
+}
+
+/*
+ * a mixed file of 3 features with an index of node size 2: feature 0 is a square of side 10
+ * with a hole, feature 1 a square at 20 and feature 2 a multipolygon of squares at 30 and 40.
+ */
+static size_t fgb_put_file(unsigned char *data) {
+  static unsigned char const magic[8] = {'f', 'g', 'b', 3, 'f', 'g', 'b', 1};
+  double corners[5] = {0, 4, 20, 30, 40};
+  double sides[5] = {10, 2, 2, 2, 2};
+  uint32_t rings_counts[3] = {2, 1, 1};
+  uint64_t features_count = 3;
+  uint16_t node_size = 2;
+  size_t size = fgb_put(data, 0, magic, sizeof(magic));
+  size_t header = 0;
+  size_t index = 0;
+  size_t features = 0;
+  size_t offsets[3];
+  uint32_t header_size = 0;
+  size += 8;
+  header = fgb_put_table(data, &size, 256U | 512U, 10);
+  memcpy(data + header + 4 + (8 * 8), &features_count, sizeof(features_count));
+  memcpy(data + header + 4 + (9 * 8), &node_size, sizeof(node_size));
+  header_size = (uint32_t)(size - 12);
+  memcpy(data + 8, &header_size, sizeof(header_size));
+  memcpy(data + 12, &(uint32_t){(uint32_t)(header - 12)}, sizeof(uint32_t));
+  /* levels of 3, 2 and 1 nodes, root first */
+  index = size;
+  features = index + (6 * 40);
+  offsets[0] = 0;
+  offsets[1] = fgb_put_feature(data, features, corners, sides, rings_counts, 1) - features;
+  offsets[2] = fgb_put_feature(data, features + offsets[1], corners + 2, sides + 2, rings_counts + 1, 1) - features;
+  size = fgb_put_feature(data, features + offsets[2], corners + 3, sides + 3, rings_counts + 1, 2);
+  fgb_put_node(data, index, 0, 42, 1);
+  fgb_put_node(data, index + 40, 0, 22, 3);
+  fgb_put_node(data, index + 80, 30, 42, 5);
+  fgb_put_node(data, index + 120, 0, 10, offsets[0]);
+  fgb_put_node(data, index + 160, 20, 22, offsets[1]);
+  fgb_put_node(data, index + 200, 30, 42, offsets[2]);
+  return size;
+}
+
+void geo_fgb_open_double_returns_geo_err_invalid_format_when_magic_does_not_match(void) {
+  unsigned char data[2048];
+  struct GeoFgbFile file;
+  size_t size = fgb_put_file(data);
+  assert(geo_fgb_open_double(&file, data, size) == GEO_SUCCESS);
+  assert(file.features_count == 3);
+  assert(file.index_node_size == 2);
+  assert(file.nodes_count == 6);
+  assert(geo_fgb_open_double(&file, data, 100) == GEO_ERR_INVALID_FORMAT);
+  data[3] = 2;
+  assert(geo_fgb_open_double(&file, data, size) == GEO_ERR_INVALID_FORMAT);
+}
+
+void geo_fgb_query_envelope_double_returns_geo_success_and_ids_of_intersecting_features(void) {
+  unsigned char data[2048];
+  struct GeoFgbFile file;
+  struct GeoEnvelope_double envelope = {{9, 9}, {21, 21}};
+  struct GeoEnvelope_double far = {{100, 100}, {101, 101}};
+  size_t ids[3];
+  size_t ids_count = 0;
+  size_t size = fgb_put_file(data);
+  assert(geo_fgb_open_double(&file, data, size) == GEO_SUCCESS);
+  assert(geo_fgb_query_envelope_double(&file, &envelope, ids, 3, &ids_count) == GEO_SUCCESS);
+  assert(ids_count == 2);
+  assert(ids[0] == 0 && ids[1] == 1);
+  assert(geo_fgb_query_envelope_double(&file, &far, ids, 3, &ids_count) == GEO_SUCCESS);
+  assert(ids_count == 0);
+}
+
+void geo_fgb_query_point_double_returns_geo_success_and_ids_of_features_containing_the_point(void) {
+  unsigned char data[2048];
+  struct GeoFgbFile file;
+  struct GeoPoint_double inside = {1, 1};
+  struct GeoPoint_double in_hole = {5, 5};
+  struct GeoPoint_double in_second_part = {41, 41};
+  struct GeoPoint_double between_parts = {35, 35};
+  size_t ids[3];
+  size_t ids_count = 0;
+  size_t size = fgb_put_file(data);
+  assert(geo_fgb_open_double(&file, data, size) == GEO_SUCCESS);
+  assert(geo_fgb_query_point_double(&file, &inside, true, ids, 3, &ids_count) == GEO_SUCCESS);
+  assert(ids_count == 1 && ids[0] == 0);
+  assert(geo_fgb_query_point_double(&file, &in_hole, false, ids, 3, &ids_count) == GEO_SUCCESS);
+  assert(ids_count == 0);
+  assert(geo_fgb_query_point_double(&file, &in_second_part, true, ids, 3, &ids_count) == GEO_SUCCESS);
+  assert(ids_count == 1 && ids[0] == 2);
+  assert(geo_fgb_query_point_double(&file, &between_parts, false, ids, 3, &ids_count) == GEO_SUCCESS);
+  assert(ids_count == 0);
+}
+
+void geo_fgb_read_double_returns_geo_success_and_views_into_the_file(void) {
+  unsigned char data[2048];
+  struct GeoFgbFile file;
+  struct GeoPolygonView_double polygons[2];
+  struct GeoRingView_double rings[2];
+  struct GeoPoint_double point = {41, 41};
+  size_t polygons_count = 0;
+  size_t rings_count = 0;
+  bool is_inside = false;
+  size_t size = fgb_put_file(data);
+  assert(geo_fgb_open_double(&file, data, size) == GEO_SUCCESS);
+  assert(geo_fgb_read_double(&file, 0, polygons, 2, &polygons_count, rings, 1, &rings_count) ==
+         GEO_ERR_TOO_SMALL);
+  assert(polygons_count == 1 && rings_count == 2);
+  assert(geo_fgb_read_double(&file, 0, polygons, 2, &polygons_count, rings, 2, &rings_count) ==
+         GEO_SUCCESS);
+  assert(polygons[0].rings == rings && polygons[0].rings_count == 2);
+  assert(rings[1].points_count == 5);
+  assert((unsigned char const *)rings[0].coordinates > data &&
+         (unsigned char const *)rings[0].coordinates < data + size);
+  assert(geo_fgb_read_double(&file, 2, polygons, 2, &polygons_count, rings, 2, &rings_count) ==
+         GEO_SUCCESS);
+  assert(polygons_count == 2 && rings_count == 2);
+  assert(geo_point_in_polygon_view_double(&point, &polygons[1], true, &is_inside) == GEO_SUCCESS);
+  assert(is_inside);
+  assert(geo_fgb_read_double(&file, 3, polygons, 2, &polygons_count, rings, 2, &rings_count) ==
+         GEO_ERR_OUT_OF_RANGE);
+}
+
+void geo_fgb_query_envelope_double_returns_geo_success_and_no_ids_when_the_file_is_empty(void) {
+  unsigned char data[2048];
+  struct GeoFgbFile file;
+  struct GeoEnvelope_double envelope = {{0, 0}, {42, 42}};
+  struct GeoPolygonView_double polygons[1];
+  struct GeoRingView_double rings[1];
+  size_t ids[3];
+  size_t ids_count = 1;
+  size_t polygons_count = 0;
+  size_t rings_count = 0;
+  uint32_t header = 0;
+  uint64_t features_count = 0;
+  size_t size = fgb_put_file(data);
+  memcpy(&header, data + 12, sizeof(header));
+  memcpy(data + 12 + header + 4 + (8 * 8), &features_count, sizeof(features_count));
+  assert(geo_fgb_open_double(&file, data, size) == GEO_SUCCESS);
+  assert(geo_fgb_query_envelope_double(&file, &envelope, ids, 3, &ids_count) == GEO_SUCCESS);
+  assert(ids_count == 0);
+  assert(geo_fgb_read_double(&file, 0, polygons, 1, &polygons_count, rings, 1, &rings_count) ==
+         GEO_ERR_OUT_OF_RANGE);
+}
+
+/*
+ *----------------------------------
+ * geo_csv_read_points_double tests
+ *----------------------------------
+ */
+void geo_csv_read_points_double_returns_geo_success_and_columns_of_every_non_blank_line(void) {
+  char const text[] = "id,lat,lon\r\n1,2,3\r\n\r\n2, \"-4\" ,5\n3,6,-7";
+  double xs[3];
+  double ys[3];
+  size_t count = 0;
+  enum GeoResult result = geo_csv_read_points_double(text, sizeof(text) - 1, ',', 2, 1, true, NULL, NULL, NULL,
+                                                   0, &count);
+  assert(result == GEO_ERR_TOO_SMALL);
+  assert(count == 3);
+  result = geo_csv_read_points_double(text, sizeof(text) - 1, ',', 2, 1, true, NULL, xs, ys, 3, &count);
+  assert(result == GEO_SUCCESS);
+  assert(count == 3);
+  assert(xs[0] == 3 && ys[0] == 2);
+  assert(xs[1] == 5 && ys[1] == -4);
+  assert(xs[2] == -7 && ys[2] == 6);
+}
+
+void geo_csv_read_points_double_returns_geo_err_invalid_format_when_a_line_misses_a_column(void) {
+  char const text[] = "1\t2\n3\n";
+  char const bad_number[] = "1\tx\n";
+  double xs[2];
+  double ys[2];
+  size_t count = 0;
+  enum GeoResult result = geo_csv_read_points_double(text, sizeof(text) - 1, '\t', 0, 1, false, NULL, xs, ys, 2,
+                                                   &count);
+  assert(result == GEO_ERR_INVALID_FORMAT);
+  result = geo_csv_read_points_double(bad_number, sizeof(bad_number) - 1, '\t', 0, 1, false, NULL, xs, ys, 2,
+                                    &count);
+  assert(result == GEO_ERR_INVALID_FORMAT);
+}
+
+void geo_csv_read_points_double_returns_geo_success_and_points_in_file_order_when_using_multiple_threads(void) {
+  struct GeoPool pool;
+  struct GeoExecutor executor;
+  size_t lines = 100000;
+  char *text = malloc(lines * 16);
+  double *xs = malloc(lines * sizeof(double));
+  double *ys = malloc(lines * sizeof(double));
+  size_t size = 0;
+  size_t count = 0;
+  enum GeoResult result = 0;
+  for (size_t iter = 0; iter < lines; ++iter) {
+    size += (size_t)sprintf(text + size, "%d;%d\n", (int)iter, -(int)(iter % 1000));
+  }
+  result = geo_pool_init(&pool, 7);
+  assert(result == GEO_SUCCESS);
+  geo_pool_executor(&pool, &executor);
+  result = geo_csv_read_points_double(text, size, ';', 0, 1, false, &executor, xs, ys, lines, &count);
+  assert(result == GEO_SUCCESS);
+  assert(count == lines);
+  for (size_t iter = 0; iter < lines; ++iter) {
+    assert(xs[iter] == (double)iter);
+    assert(ys[iter] == -(double)(iter % 1000));
+  }
+  free(ys);
+  free(xs);
+  free(text);
+  geo_pool_destroy(&pool);
+}
+
+/*
+ *----------------------------------
+ * geo_points_soa_double tests
+ *----------------------------------
+ */
+void geo_convex_hull_soa_double_returns_geo_success_and_counterclockwise_hull_positions(void) {
+  /* a square with a point inside, one on an edge and a duplicate corner */
+  double xs[8] = {2, 0, 4, 1, 4, 0, 2, 4};
+  double ys[8] = {2, 0, 4, 3, 0, 4, 0, 4};
+  struct GeoPointsSoA_double points = {xs, ys, 8};
+  size_t convex_hull[8];
+  size_t convex_hull_size = 0;
+  enum GeoResult result = geo_convex_hull_soa_double(&points, NULL, NULL, convex_hull, &convex_hull_size);
+  assert(result == GEO_SUCCESS);
+  assert(convex_hull_size == 4);
+  assert(convex_hull[0] == 1);
+  assert(convex_hull[1] == 4);
+  assert(xs[convex_hull[2]] == 4 && ys[convex_hull[2]] == 4);
+  assert(convex_hull[3] == 5);
+  points.count = 2;
+  result = geo_convex_hull_soa_double(&points, NULL, NULL, convex_hull, &convex_hull_size);
+  assert(result == GEO_ERR_TOO_SMALL);
+}
+
+void geo_points_in_geometry_soa_double_returns_geo_success_and_same_answers_as_geo_point_in_geometry(void) {
+  struct GeoPoint_double corners[1][4];
+  struct GeoSegment_double segments[1][4];
+  struct GeoSegment_double *segment_pointers[1][4];
+  struct GeoGeometry_double geometries[1];
+  struct GeoGeometry_double *geometry_pointers[1];
+  /* a 21 x 21 grid around the square, more points than one block */
+  double xs[441];
+  double ys[441];
+  bool is_inside[441];
+  struct GeoPointsSoA_double points = {xs, ys, 441};
+  enum GeoResult result = 0;
+  make_join_squares_double(corners, segments, segment_pointers, geometries, geometry_pointers, 1);
+  for (size_t iter = 0; iter < 441; ++iter) {
+    xs[iter] = (double)(iter % 21) - 8;
+    ys[iter] = (double)(iter / 21) - 8;
+  }
+  for (int strict = 0; strict < 2; ++strict) {
+    result = geo_points_in_geometry_soa_double(&points, &geometries[0], strict, NULL, is_inside);
+    assert(result == GEO_SUCCESS);
+    for (size_t iter = 0; iter < 441; ++iter) {
+      struct GeoPoint_double point = {xs[iter], ys[iter]};
+      bool expected = false;
+      result = geo_point_in_geometry_double(&point, &geometries[0], strict, &expected);
+      assert(result == GEO_SUCCESS);
+      assert(is_inside[iter] == expected);
+    }
+  }
+  assert(is_inside[(10 * 21) + 10]);
+}
+
+void geo_squared_distance_soa_double_returns_geo_success_and_squared_distance_of_every_point(void) {
+  double xs[3] = {0, 3, -1};
+  double ys[3] = {0, 4, 2};
+  double distances[3];
+  struct GeoPointsSoA_double points = {xs, ys, 3};
+  struct GeoPoint_double point = {0, 0};
+  enum GeoResult result = geo_squared_distance_soa_double(&points, &point, distances);
+  assert(result == GEO_SUCCESS);
+  assert(distances[0] == 0);
+  assert(distances[1] == 25);
+  assert(distances[2] == 5);
+}
+
+/*
+ *----------------------------------
+ * geo_geometry_build_from_points_double tests
+ *----------------------------------
+ */
+void geo_geometry_build_from_points_double_returns_geo_success_and_geometry_in_one_arena_block(void) {
+  struct GeoPoint_double open[4] = {{0, 0}, {4, 0}, {4, 4}, {0, 4}};
+  struct GeoPoint_double closed[5] = {{0, 0}, {4, 0}, {4, 4}, {0, 4}, {0, 0}};
+  struct GeoPoint_double inside = {1, 1};
+  struct GeoGeometry_double geometry;
+  struct GeoArena arena;
+  unsigned char buffer[512];
+  size_t size = 0;
+  size_t used = 0;
+  bool is_true = false;
+  enum GeoResult result = geo_geometry_build_size_double(4, &size);
+  assert(result == GEO_SUCCESS);
+  assert(size <= sizeof(buffer));
+  geo_arena_init(&arena, buffer, sizeof(buffer));
+  result = geo_geometry_build_from_points_double(&arena, open, 4, &geometry);
+  assert(result == GEO_SUCCESS);
+  assert(arena.used <= size);
+  assert(geometry.segments_count == 4);
+  assert((unsigned char *)geometry.segments > buffer && (unsigned char *)geometry.segments < buffer + size);
+  assert(geometry.segments[3]->end == geometry.segments[0]->start);
+  assert(geo_geometry_is_closed_double(&geometry, &is_true) == GEO_SUCCESS && is_true);
+  assert(geo_geometry_is_simple_double(&geometry, &is_true) == GEO_SUCCESS && is_true);
+  assert(geo_point_in_geometry_double(&inside, &geometry, true, &is_true) == GEO_SUCCESS && is_true);
+
+  /* a closed input gives the same ring, reset reuses the block */
+  used = arena.used;
+  geo_arena_reset(&arena);
+  result = geo_geometry_build_from_points_double(&arena, closed, 5, &geometry);
+  assert(result == GEO_SUCCESS);
+  assert(arena.used == used);
+  assert(geometry.segments_count == 4);
+  assert(geometry.segments[3]->end->x == 0 && geometry.segments[3]->end->y == 0);
+}
+
+void geo_geometry_build_from_points_double_returns_geo_err_full_and_leaves_arena_when_it_does_not_fit(void) {
+  struct GeoPoint_double points[3] = {{0, 0}, {4, 0}, {4, 4}};
+  struct GeoGeometry_double geometry;
+  struct GeoArena arena;
+  unsigned char buffer[32];
+  enum GeoResult result = 0;
+  geo_arena_init(&arena, buffer, sizeof(buffer));
+  result = geo_geometry_build_from_points_double(&arena, points, 3, &geometry);
+  assert(result == GEO_ERR_FULL);
+  assert(arena.used == 0);
+  result = geo_geometry_build_from_points_double(&arena, points, 2, &geometry);
+  assert(result == GEO_ERR_TOO_SMALL);
+}
+
+/*
+ *----------------------------------
+ * geo_allocator_double tests
+ *----------------------------------
+ */
+struct CountingAllocator_double {
+  size_t allocations;
+  size_t outstanding;
+};
+
+static void *counting_allocate_double(void *context, size_t size) {
+  struct CountingAllocator_double *counting = context;
+  counting->allocations += 1;
+  counting->outstanding += size;
+  return malloc(size);
+}
+
+static void counting_release_double(void *context, void *memory, size_t size) {
+  struct CountingAllocator_double *counting = context;
+  counting->outstanding -= size;
+  free(memory);
+}
+
+void geo_spatial_join_count_double_returns_geo_err_null_pointer_when_allocator_has_no_functions(void) {
+  struct GeoPoint_double points[1] = {{0, 0}};
+  size_t counts[1] = {0};
+  struct GeoAllocator allocator = {NULL, NULL, NULL};
+  enum GeoResult result = geo_spatial_join_count_double(points, 1, NULL, 0, false, NULL, &allocator, counts);
+  assert(result == GEO_ERR_NULL_POINTER);
+}
+
+void geo_spatial_join_count_double_returns_geo_success_and_releases_everything_it_allocates(void) {
+  struct GeoPool pool;
+  struct GeoExecutor executor;
+  struct GeoPoint_double points[30][4];
+  struct GeoSegment_double segments[30][4];
+  struct GeoSegment_double *segment_pointers[30][4];
+  struct GeoGeometry_double geometries[30];
+  struct GeoGeometry_double *geometry_pointers[30];
+  struct GeoPoint_double queries[30];
+  size_t counts[30];
+  struct CountingAllocator_double counting = {0, 0};
+  struct GeoAllocator allocator = {counting_allocate_double, counting_release_double, NULL};
+  enum GeoResult result = 0;
+  allocator.context = &counting;
+  make_join_squares_double(points, segments, segment_pointers, geometries, geometry_pointers, 30);
+  for (size_t iter = 0; iter < 30; ++iter) {
+    queries[iter].x = (double)(iter * 5) + 2;
+    queries[iter].y = 2;
+  }
+  result = geo_pool_init(&pool, 2);
+  assert(result == GEO_SUCCESS);
+  geo_pool_executor(&pool, &executor);
+  result = geo_spatial_join_count_double(queries, 30, geometry_pointers, 30, true, &executor, &allocator, counts);
+  assert(result == GEO_SUCCESS);
+  for (size_t iter = 0; iter < 30; ++iter) {
+    assert(counts[iter] == 1);
+  }
+  assert(counting.allocations > 0);
+  assert(counting.outstanding == 0);
+  geo_pool_destroy(&pool);
+}
+
+void geo_convex_hull_soa_double_returns_geo_success_and_releases_everything_it_allocates(void) {
+  double xs[5] = {0, 4, 2, 4, 0};
+  double ys[5] = {0, 0, 2, 4, 4};
+  struct GeoPointsSoA_double points = {xs, ys, 5};
+  size_t convex_hull[5];
+  size_t convex_hull_size = 0;
+  struct CountingAllocator_double counting = {0, 0};
+  struct GeoAllocator allocator = {counting_allocate_double, counting_release_double, NULL};
+  enum GeoResult result = 0;
+  allocator.context = &counting;
+  result = geo_convex_hull_soa_double(&points, NULL, &allocator, convex_hull, &convex_hull_size);
+  assert(result == GEO_SUCCESS);
+  assert(convex_hull_size == 4);
+  assert(counting.allocations == 1);
+  assert(counting.outstanding == 0);
+}
+
+/*
+ *----------------------------------
+ * geo_stats double tests
+ *----------------------------------
+ */
+#ifdef GEO_STATS
+static void square_geometry_double(struct GeoPoint_double *corners, struct GeoSegment_double *segments,
+                                 struct GeoSegment_double **pointers, struct GeoGeometry_double *geometry) {
+  struct GeoPoint_double const square[4] = {{0, 0}, {4, 0}, {4, 4}, {0, 4}};
+  for (size_t iter = 0; iter < 4; ++iter) {
+    corners[iter] = square[iter];
+  }
+  for (size_t iter = 0; iter < 4; ++iter) {
+    segments[iter].start = &corners[iter];
+    segments[iter].end = &corners[(iter + 1) % 4];
+    pointers[iter] = &segments[iter];
+  }
+  geometry->segments = pointers;
+  geometry->segments_count = 4;
+}
+
+void geo_stats_snapshot_returns_geo_err_null_pointer_when_stats_is_null_double(void) {
+  enum GeoResult result = geo_stats_snapshot(NULL);
+  assert(result == GEO_ERR_NULL_POINTER);
+}
+
+void geo_segments_intersect_double_counts_one_call_and_four_orientations_when_segments_cross(void) {
+  struct GeoPoint_double start1 = {0, 0};
+  struct GeoPoint_double end1 = {2, 2};
+  struct GeoPoint_double start2 = {0, 2};
+  struct GeoPoint_double end2 = {2, 0};
+  struct GeoSegment_double segment1 = {&start1, &end1};
+  struct GeoSegment_double segment2 = {&start2, &end2};
+  struct GeoStats stats;
+  size_t intersections = 0;
+  geo_stats_reset();
+  enum GeoResult result = geo_segments_intersect_double(&segment1, &segment2, &intersections);
+  assert(result == GEO_SUCCESS);
+  assert(intersections == 1);
+  result = geo_stats_snapshot(&stats);
+  assert(result == GEO_SUCCESS);
+  assert(stats.segments_intersect_calls == 1);
+  assert(stats.orientation_calls == 4);
+  assert(stats.orientation_colinear == 0);
+}
+
+void geo_point_in_geometry_double_counts_one_call_and_every_edge_when_point_is_inside(void) {
+  struct GeoPoint_double corners[4];
+  struct GeoSegment_double segments[4];
+  struct GeoSegment_double *pointers[4];
+  struct GeoGeometry_double geometry;
+  struct GeoPoint_double point = {1, 1};
+  struct GeoStats stats;
+  bool is_inside = false;
+  square_geometry_double(corners, segments, pointers, &geometry);
+  geo_stats_reset();
+  enum GeoResult result = geo_point_in_geometry_double(&point, &geometry, true, &is_inside);
+  assert(result == GEO_SUCCESS);
+  assert(is_inside);
+  geo_stats_snapshot(&stats);
+  assert(stats.point_in_polygon_calls == 1);
+  assert(stats.point_in_polygon_edges == 4);
+}
+
+void geo_geometry_is_simple_double_counts_every_segment_pair_when_geometry_is_simple(void) {
+  struct GeoPoint_double corners[4];
+  struct GeoSegment_double segments[4];
+  struct GeoSegment_double *pointers[4];
+  struct GeoGeometry_double geometry;
+  struct GeoStats stats;
+  bool is_simple = false;
+  square_geometry_double(corners, segments, pointers, &geometry);
+  geo_stats_reset();
+  enum GeoResult result = geo_geometry_is_simple_double(&geometry, &is_simple);
+  assert(result == GEO_SUCCESS);
+  assert(is_simple);
+  geo_stats_snapshot(&stats);
+  assert(stats.is_simple_calls == 1);
+  assert(stats.is_simple_pairs == 6);
+  assert(stats.segments_intersect_calls == 6);
+}
+
+void geo_convex_hull_double_counts_one_call_and_its_comparisons(void) {
+  struct GeoPoint_double point1 = {0, 0};
+  struct GeoPoint_double point2 = {4, 0};
+  struct GeoPoint_double point3 = {4, 4};
+  struct GeoPoint_double point4 = {0, 4};
+  struct GeoPoint_double point5 = {2, 2};
+  struct GeoPoint_double *points[5] = {&point3, &point5, &point1, &point4, &point2};
+  struct GeoPoint_double *hull[5];
+  size_t hull_size = 0;
+  struct GeoStats stats;
+  geo_stats_reset();
+  enum GeoResult result = geo_convex_hull_double(points, hull, 5, &hull_size);
+  assert(result == GEO_SUCCESS);
+  assert(hull_size == 4);
+  geo_stats_snapshot(&stats);
+  assert(stats.convex_hull_calls == 1);
+  assert(stats.convex_hull_comparisons > 0);
+}
+
+void geo_stats_reset_double_zeroes_every_counter(void) {
+  struct GeoPoint_double corners[4];
+  struct GeoSegment_double segments[4];
+  struct GeoSegment_double *pointers[4];
+  struct GeoGeometry_double geometry;
+  struct GeoStats stats;
+  struct GeoStats zero;
+  bool is_simple = false;
+  memset(&zero, 0, sizeof(zero));
+  square_geometry_double(corners, segments, pointers, &geometry);
+  geo_geometry_is_simple_double(&geometry, &is_simple);
+  enum GeoResult result = geo_stats_reset();
+  assert(result == GEO_SUCCESS);
+  geo_stats_snapshot(&stats);
+  assert(memcmp(&stats, &zero, sizeof(stats)) == 0);
+}
+
+void geo_points_equal_double_counts_the_exit_each_comparison_takes(void) {
+  struct GeoPoint_double lhs = {1, 2};
+  struct GeoPoint_double rhs = {1, 2};
+  struct GeoPoint_double nan_point = {NAN, 2};
+  struct GeoPoint_double far = {1, 100};
+  struct GeoStats stats;
+  bool is_equal = false;
+  geo_stats_reset();
+  geo_points_equal_double(&lhs, &rhs, &is_equal);
+  assert(is_equal);
+  geo_points_equal_double(&nan_point, &rhs, &is_equal);
+  assert(!is_equal);
+  geo_points_equal_double(&lhs, &far, &is_equal);
+  assert(!is_equal);
+  geo_stats_snapshot(&stats);
+  assert(stats.equal_exact == 3);
+  assert(stats.equal_nan == 1);
+  assert(stats.equal_ulps == 1);
+  assert(stats.equal_absolute == 0);
+}
+#endif
+
+/*
+ *----------------------------------
+ * geo_trace double tests
+ *----------------------------------
+ */
+#ifdef GEO_TRACE
+struct TraceRecord_double {
+  size_t calls;
+  enum GeoTraceFunction function;
+  size_t size;
+};
+
+static void record_trace_double(void *context, enum GeoTraceFunction function, size_t size, uint64_t cycles) {
+  struct TraceRecord_double *record = context;
+  (void)cycles;
+  record->calls += 1;
+  record->function = function;
+  record->size = size;
+}
+
+void geo_trace_set_returns_geo_err_null_pointer_when_trace_is_null_double(void) {
+  struct GeoTracer tracer = {NULL, NULL};
+  enum GeoResult result = geo_trace_set(&tracer);
+  assert(result == GEO_ERR_NULL_POINTER);
+}
+
+void geo_point_in_geometry_double_reports_one_call_with_segments_count_when_traced(void) {
+  struct GeoPoint_double corners[4] = {{0, 0}, {4, 0}, {4, 4}, {0, 4}};
+  struct GeoSegment_double segments[4];
+  struct GeoSegment_double *pointers[4];
+  struct GeoGeometry_double geometry = {pointers, 4};
+  struct GeoPoint_double point = {1, 1};
+  struct TraceRecord_double record = {0, GEO_TRACE_FUNCTIONS_COUNT, 0};
+  struct GeoTracer tracer = {record_trace_double, NULL};
+  bool is_inside = false;
+  for (size_t iter = 0; iter < 4; ++iter) {
+    segments[iter].start = &corners[iter];
+    segments[iter].end = &corners[(iter + 1) % 4];
+    pointers[iter] = &segments[iter];
+  }
+  tracer.context = &record;
+  geo_trace_set(&tracer);
+  enum GeoResult result = geo_point_in_geometry_double(&point, &geometry, true, &is_inside);
+  geo_trace_set(NULL);
+  assert(result == GEO_SUCCESS);
+  assert(is_inside);
+  assert(record.calls == 1);
+  assert(record.function == GEO_TRACE_POINT_IN_GEOMETRY);
+  assert(record.size == 4);
+}
+
+void geo_geometry_is_simple_double_reports_only_the_outer_call_when_traced(void) {
+  struct GeoPoint_double corners[4] = {{0, 0}, {4, 0}, {4, 4}, {0, 4}};
+  struct GeoSegment_double segments[4];
+  struct GeoSegment_double *pointers[4];
+  struct GeoGeometry_double geometry = {pointers, 4};
+  struct TraceRecord_double record = {0, GEO_TRACE_FUNCTIONS_COUNT, 0};
+  struct GeoTracer tracer = {record_trace_double, NULL};
+  bool is_simple = false;
+  for (size_t iter = 0; iter < 4; ++iter) {
+    segments[iter].start = &corners[iter];
+    segments[iter].end = &corners[(iter + 1) % 4];
+    pointers[iter] = &segments[iter];
+  }
+  tracer.context = &record;
+  geo_trace_set(&tracer);
+  enum GeoResult result = geo_geometry_is_simple_double(&geometry, &is_simple);
+  geo_trace_set(NULL);
+  assert(result == GEO_SUCCESS);
+  assert(is_simple);
+  assert(record.calls == 1);
+  assert(record.function == GEO_TRACE_GEOMETRY_IS_SIMPLE);
+  assert(strcmp(geo_trace_function_name(record.function), "geo_geometry_is_simple") == 0);
+}
+
+void geo_segments_intersect_double_reports_nothing_when_tracer_is_removed(void) {
+  struct GeoPoint_double start1 = {0, 0};
+  struct GeoPoint_double end1 = {2, 2};
+  struct GeoPoint_double start2 = {0, 2};
+  struct GeoPoint_double end2 = {2, 0};
+  struct GeoSegment_double segment1 = {&start1, &end1};
+  struct GeoSegment_double segment2 = {&start2, &end2};
+  struct TraceRecord_double record = {0, GEO_TRACE_FUNCTIONS_COUNT, 0};
+  struct GeoTracer tracer = {record_trace_double, NULL};
+  size_t intersections = 0;
+  tracer.context = &record;
+  geo_trace_set(&tracer);
+  geo_segments_intersect_double(&segment1, &segment2, &intersections);
+  assert(record.calls == 1);
+  assert(record.size == 2);
+  geo_trace_set(NULL);
+  geo_segments_intersect_double(&segment1, &segment2, &intersections);
+  assert(record.calls == 1);
+}
+#endif
+
+/*
+ *----------------------------------
+ * geo_simd_select_double tests
+ *----------------------------------
+ */
+void geo_simd_select_double_returns_geo_err_unsupported_when_level_is_above_geo_simd_level(void) {
+  enum GeoSimdLevel level = GEO_SIMD_GENERIC;
+  enum GeoResult result = geo_simd_level(&level);
+  assert(result == GEO_SUCCESS);
+  result = geo_simd_select_double((enum GeoSimdLevel)(level + 1));
+  assert(result == GEO_ERR_UNSUPPORTED);
+}
+
+void geo_simd_select_double_gives_the_same_soa_answers_at_every_supported_level(void) {
+  struct GeoPoint_double corners[4] = {{0, 0}, {4, 0}, {4, 4}, {0, 4}};
+  struct GeoSegment_double segments[4];
+  struct GeoSegment_double *pointers[4];
+  struct GeoGeometry_double geometry = {pointers, 4};
+  struct GeoPoint_double origin = {1, 2};
+  /* a 21 x 21 grid around the square, more points than one block */
+  double xs[441];
+  double ys[441];
+  double distances[441];
+  bool is_inside[441];
+  struct GeoPointsSoA_double points = {xs, ys, 441};
+  enum GeoSimdLevel supported = GEO_SIMD_GENERIC;
+  enum GeoResult result = geo_simd_level(&supported);
+  assert(result == GEO_SUCCESS);
+  for (size_t iter = 0; iter < 4; ++iter) {
+    segments[iter].start = &corners[iter];
+    segments[iter].end = &corners[(iter + 1) % 4];
+    pointers[iter] = &segments[iter];
+  }
+  for (size_t iter = 0; iter < 441; ++iter) {
+    xs[iter] = (double)((int)(iter % 21) - 8);
+    ys[iter] = (double)((int)(iter / 21) - 8);
+  }
+  for (int level = GEO_SIMD_GENERIC; level <= (int)supported; ++level) {
+    result = geo_simd_select_double((enum GeoSimdLevel)level);
+    assert(result == GEO_SUCCESS);
+    result = geo_points_in_geometry_soa_double(&points, &geometry, false, NULL, is_inside);
+    assert(result == GEO_SUCCESS);
+    result = geo_squared_distance_soa_double(&points, &origin, distances);
+    assert(result == GEO_SUCCESS);
+    for (size_t iter = 0; iter < 441; ++iter) {
+      struct GeoPoint_double point = {xs[iter], ys[iter]};
+      double diff_x = xs[iter] - origin.x;
+      double diff_y = ys[iter] - origin.y;
+      bool expected = false;
+      result = geo_point_in_geometry_double(&point, &geometry, false, &expected);
+      assert(result == GEO_SUCCESS);
+      assert(is_inside[iter] == expected);
+      assert(!(distances[iter] < (diff_x * diff_x) + (diff_y * diff_y)) &&
+             !(distances[iter] > (diff_x * diff_x) + (diff_y * diff_y)));
+    }
+  }
+  geo_simd_select_double(supported);
+}
+
+void geo_simd_select_double_gives_the_same_soa_answers_near_slanted_edges(void) {
+  struct GeoPoint_double corners[5] = {{0, 0}, {7, 1}, {9, 6}, {3, 8}, {-2, 5}};
+  struct GeoSegment_double segments[5];
+  struct GeoSegment_double *pointers[5];
+  struct GeoGeometry_double geometry = {pointers, 5};
+  /* points on, just off and around every edge */
+  double xs[600];
+  double ys[600];
+  bool is_inside[600];
+  struct GeoPointsSoA_double points = {xs, ys, 600};
+  double const offsets[4] = {0, (double)1e-10, (double)-1e-3, (double)0.25};
+  enum GeoSimdLevel supported = GEO_SIMD_GENERIC;
+  enum GeoResult result = geo_simd_level(&supported);
+  assert(result == GEO_SUCCESS);
+  for (size_t iter = 0; iter < 5; ++iter) {
+    segments[iter].start = &corners[iter];
+    segments[iter].end = &corners[(iter + 1) % 5];
+    pointers[iter] = &segments[iter];
+  }
+  for (size_t iter = 0; iter < 600; ++iter) {
+    struct GeoPoint_double const *start = &corners[iter % 5];
+    struct GeoPoint_double const *end = &corners[(iter + 1) % 5];
+    double const along = (double)((iter / 20) % 30) / 20;
+    xs[iter] = start->x + ((end->x - start->x) * along) + offsets[(iter / 5) % 4];
+    ys[iter] = start->y + ((end->y - start->y) * along);
+  }
+  for (int level = GEO_SIMD_GENERIC; level <= (int)supported; ++level) {
+    result = geo_simd_select_double((enum GeoSimdLevel)level);
+    assert(result == GEO_SUCCESS);
+    for (int strict = 0; strict < 2; ++strict) {
+      result = geo_points_in_geometry_soa_double(&points, &geometry, strict, NULL, is_inside);
+      assert(result == GEO_SUCCESS);
+      for (size_t iter = 0; iter < 600; ++iter) {
+        struct GeoPoint_double point = {xs[iter], ys[iter]};
+        bool expected = false;
+        result = geo_point_in_geometry_double(&point, &geometry, strict, &expected);
+        assert(result == GEO_SUCCESS);
+        assert(is_inside[iter] == expected);
+      }
+    }
+  }
+  geo_simd_select_double(supported);
+}
+
+/*
+ *----------------------------------
+ * GeoExecutor double tests
+ *----------------------------------
+ */
+static bool refusing_submit_double(void *context, void (*job)(void *argument), void *argument) {
+  (void)context;
+  (void)job;
+  (void)argument;
+  return false;
+}
+
+/*
+ * a comb of `teeth` points along the top, alternating between y 0 and 2,
+ * closed along y -10. `coordinates` holds the closed ring as x, y pairs.
+ */
+static void make_comb_double(size_t teeth, struct GeoPoint_double *points, struct GeoSegment_double *segments,
+                             struct GeoSegment_double **segment_pointers, struct GeoGeometry_double *geometry,
+                             double *coordinates) {
+  size_t const count = teeth + 2;
+  for (size_t iter = 0; iter < teeth; ++iter) {
+    points[iter].x = (double)(iter * 2);
+    points[iter].y = (double)((iter % 2) * 2);
+  }
+  points[teeth].x = (double)((teeth - 1) * 2);
+  points[teeth].y = -10;
+  points[teeth + 1].x = 0;
+  points[teeth + 1].y = -10;
+  for (size_t iter = 0; iter < count; ++iter) {
+    segments[iter].start = &points[iter];
+    segments[iter].end = &points[(iter + 1) % count];
+    segment_pointers[iter] = &segments[iter];
+  }
+  geometry->segments = segment_pointers;
+  geometry->segments_count = count;
+  for (size_t iter = 0; iter <= count; ++iter) {
+    coordinates[iter * 2] = points[iter % count].x;
+    coordinates[(iter * 2) + 1] = points[iter % count].y;
+  }
+}
+
+void geo_points_in_geometry_soa_double_returns_geo_success_and_same_answers_with_an_executor(void) {
+  struct GeoPoint_double corners[1][4];
+  struct GeoSegment_double segments[1][4];
+  struct GeoSegment_double *segment_pointers[1][4];
+  struct GeoGeometry_double geometries[1];
+  struct GeoGeometry_double *geometry_pointers[1];
+  struct GeoPool pool;
+  struct GeoExecutor executor;
+  struct GeoExecutor refusing = {refusing_submit_double, NULL, 8};
+  size_t const count = 40000;
+  double *xs = malloc(count * sizeof(double));
+  double *ys = malloc(count * sizeof(double));
+  bool *serial = malloc(count * sizeof(bool));
+  bool *parallel = malloc(count * sizeof(bool));
+  struct GeoPointsSoA_double points = {xs, ys, count};
+  enum GeoResult result = 0;
+  make_join_squares_double(corners, segments, segment_pointers, geometries, geometry_pointers, 1);
+  for (size_t iter = 0; iter < count; ++iter) {
+    xs[iter] = (double)(iter % 200) - 100;
+    ys[iter] = (double)(iter / 200) - 100;
+  }
+  result = geo_pool_init(&pool, 3);
+  assert(result == GEO_SUCCESS);
+  geo_pool_executor(&pool, &executor);
+  assert(executor.concurrency == 4);
+  result = geo_points_in_geometry_soa_double(&points, &geometries[0], false, NULL, serial);
+  assert(result == GEO_SUCCESS);
+  result = geo_points_in_geometry_soa_double(&points, &geometries[0], false, &executor, parallel);
+  assert(result == GEO_SUCCESS);
+  assert(memcmp(serial, parallel, count * sizeof(bool)) == 0);
+  memset(parallel, 0, count * sizeof(bool));
+  result = geo_points_in_geometry_soa_double(&points, &geometries[0], false, &refusing, parallel);
+  assert(result == GEO_SUCCESS);
+  assert(memcmp(serial, parallel, count * sizeof(bool)) == 0);
+  geo_pool_destroy(&pool);
+  free(parallel);
+  free(serial);
+  free(ys);
+  free(xs);
+}
+
+void geo_convex_hull_soa_double_returns_geo_success_and_same_hull_with_an_executor(void) {
+  struct GeoPool pool;
+  struct GeoExecutor executor;
+  size_t const count = 50000;
+  double *xs = malloc(count * sizeof(double));
+  double *ys = malloc(count * sizeof(double));
+  size_t *serial = malloc(count * sizeof(size_t));
+  size_t *parallel = malloc(count * sizeof(size_t));
+  struct GeoPointsSoA_double points = {xs, ys, count};
+  size_t serial_size = 0;
+  size_t parallel_size = 0;
+  uint64_t seed = 42;
+  enum GeoResult result = 0;
+  /* duplicates and colinear points included */
+  for (size_t iter = 0; iter < count; ++iter) {
+    seed = (seed * 6364136223846793005ULL) + 1442695040888963407ULL;
+    xs[iter] = (double)((seed >> 33) % 1000);
+    ys[iter] = (double)((seed >> 13) % 1000);
+  }
+  result = geo_pool_init(&pool, 7);
+  assert(result == GEO_SUCCESS);
+  geo_pool_executor(&pool, &executor);
+  result = geo_convex_hull_soa_double(&points, NULL, NULL, serial, &serial_size);
+  assert(result == GEO_SUCCESS);
+  result = geo_convex_hull_soa_double(&points, &executor, NULL, parallel, &parallel_size);
+  assert(result == GEO_SUCCESS);
+  assert(serial_size >= 3);
+  assert(parallel_size == serial_size);
+  /* duplicate points may give a different position for the same vertex */
+  for (size_t iter = 0; iter < serial_size; ++iter) {
+    assert(xs[serial[iter]] == xs[parallel[iter]]);
+    assert(ys[serial[iter]] == ys[parallel[iter]]);
+  }
+  geo_pool_destroy(&pool);
+  free(parallel);
+  free(serial);
+  free(ys);
+  free(xs);
+}
+
+void geo_geometry_is_simple_parallel_double_returns_geo_success_and_same_answers_with_an_executor(void) {
+  size_t const teeth = 600;
+  struct GeoPoint_double *points = malloc((teeth + 2) * sizeof(struct GeoPoint_double));
+  struct GeoSegment_double *segments = malloc((teeth + 2) * sizeof(struct GeoSegment_double));
+  struct GeoSegment_double **segment_pointers = malloc((teeth + 2) * sizeof(struct GeoSegment_double *));
+  double *coordinates = malloc((teeth + 3) * 2 * sizeof(double));
+  struct GeoGeometry_double geometry;
+  struct GeoRingView_double view;
+  struct GeoPool pool;
+  struct GeoExecutor executor;
+  struct GeoExecutor refusing = {refusing_submit_double, NULL, 8};
+  bool is_simple = false;
+  enum GeoResult result = 0;
+  make_comb_double(teeth, points, segments, segment_pointers, &geometry, coordinates);
+  view.coordinates = coordinates;
+  view.points_count = teeth + 3;
+  result = geo_pool_init(&pool, 3);
+  assert(result == GEO_SUCCESS);
+  geo_pool_executor(&pool, &executor);
+  result = geo_geometry_is_simple_double(&geometry, &is_simple);
+  assert(result == GEO_SUCCESS);
+  assert(is_simple);
+  is_simple = false;
+  result = geo_geometry_is_simple_parallel_double(&geometry, &executor, &is_simple);
+  assert(result == GEO_SUCCESS);
+  assert(is_simple);
+  is_simple = false;
+  result = geo_geometry_is_simple_parallel_double(&geometry, &refusing, &is_simple);
+  assert(result == GEO_SUCCESS);
+  assert(is_simple);
+  is_simple = false;
+  result = geo_ring_view_is_simple_parallel_double(&view, &executor, &is_simple);
+  assert(result == GEO_SUCCESS);
+  assert(is_simple);
+  /* a tooth in the middle pushed through the bottom edge */
+  points[teeth / 2].y = -20;
+  coordinates[((teeth / 2) * 2) + 1] = -20;
+  result = geo_geometry_is_simple_double(&geometry, &is_simple);
+  assert(result == GEO_SUCCESS);
+  assert(!is_simple);
+  is_simple = true;
+  result = geo_geometry_is_simple_parallel_double(&geometry, &executor, &is_simple);
+  assert(result == GEO_SUCCESS);
+  assert(!is_simple);
+  is_simple = true;
+  result = geo_ring_view_is_simple_parallel_double(&view, &executor, &is_simple);
+  assert(result == GEO_SUCCESS);
+  assert(!is_simple);
+  geometry.segments[teeth / 2]->end = NULL;
+  result = geo_geometry_is_simple_parallel_double(&geometry, &executor, &is_simple);
+  assert(result == GEO_ERR_NULL_POINTER);
+  geo_pool_destroy(&pool);
+  free(coordinates);
+  free(segment_pointers);
+  free(segments);
+  free(points);
+}
+
+void geo_index_build_double_writes_the_same_bytes_with_an_executor(void) {
+  size_t const count = 10000;
+  struct GeoPoint_double (*points)[4] = malloc(count * sizeof(*points));
+  struct GeoSegment_double (*segments)[4] = malloc(count * sizeof(*segments));
+  struct GeoSegment_double *(*segment_pointers)[4] = malloc(count * sizeof(*segment_pointers));
+  struct GeoGeometry_double *geometries = malloc(count * sizeof(struct GeoGeometry_double));
+  struct GeoGeometry_double **geometry_pointers = malloc(count * sizeof(struct GeoGeometry_double *));
+  struct GeoPool pool;
+  struct GeoExecutor executor;
+  size_t size = 0;
+  void *serial = NULL;
+  void *parallel = NULL;
+  enum GeoResult result = 0;
+  make_join_squares_double(points, segments, segment_pointers, geometries, geometry_pointers, count);
+  result = geo_index_build_size_double(geometry_pointers, count, &size);
+  assert(result == GEO_SUCCESS);
+  serial = malloc(size);
+  parallel = malloc(size);
+  result = geo_pool_init(&pool, 3);
+  assert(result == GEO_SUCCESS);
+  geo_pool_executor(&pool, &executor);
+  result = geo_index_build_double(geometry_pointers, count, NULL, serial, size);
+  assert(result == GEO_SUCCESS);
+  result = geo_index_build_double(geometry_pointers, count, &executor, parallel, size);
+  assert(result == GEO_SUCCESS);
+  assert(memcmp(serial, parallel, size) == 0);
+  geo_pool_destroy(&pool);
+  free(parallel);
+  free(serial);
+  free(geometry_pointers);
+  free(geometries);
+  free(segment_pointers);
+  free(segments);
+  free(points);
+}
+
+void geo_points_in_geometry_soa_double_and_other_executor_functions_return_geo_err_null_pointer_when_submit_is_null(void) {
+  struct GeoPoint_double corners[1][4];
+  struct GeoSegment_double segments[1][4];
+  struct GeoSegment_double *segment_pointers[1][4];
+  struct GeoGeometry_double geometries[1];
+  struct GeoGeometry_double *geometry_pointers[1];
+  struct GeoExecutor const executor = {NULL, NULL, 4};
+  double xs[4] = {0, 1, 2, 3};
+  double ys[4] = {3, 0, 1, 2};
+  double coordinates[10] = {0, 0, 4, 0, 4, 4, 0, 4, 0, 0};
+  struct GeoPointsSoA_double points = {xs, ys, 4};
+  struct GeoRingView_double view = {coordinates, 5};
+  struct GeoPoint_double point = {1, 1};
+  uint64_t keys[1] = {0};
+  size_t hull[4];
+  size_t count = 0;
+  size_t counts[1];
+  bool flags[4];
+  unsigned char buffer[1024];
+  char const text[] = "1,2\n";
+  make_join_squares_double(corners, segments, segment_pointers, geometries, geometry_pointers, 1);
+  assert(geo_points_in_geometry_soa_double(&points, &geometries[0], false, &executor, flags) == GEO_ERR_NULL_POINTER);
+  assert(geo_convex_hull_soa_double(&points, &executor, NULL, hull, &count) == GEO_ERR_NULL_POINTER);
+  assert(geo_geometry_is_simple_parallel_double(&geometries[0], &executor, flags) == GEO_ERR_NULL_POINTER);
+  assert(geo_ring_view_is_simple_parallel_double(&view, &executor, flags) == GEO_ERR_NULL_POINTER);
+  assert(geo_sort_points_by_key_double(&point, keys, 1, &executor) == GEO_ERR_NULL_POINTER);
+  assert(geo_sort_geometries_by_key_double(geometry_pointers, keys, 1, &executor) == GEO_ERR_NULL_POINTER);
+  assert(geo_index_build_double(geometry_pointers, 1, &executor, buffer, sizeof(buffer)) == GEO_ERR_NULL_POINTER);
+  assert(geo_spatial_join_count_double(&point, 1, geometry_pointers, 1, false, &executor, NULL, counts) ==
+         GEO_ERR_NULL_POINTER);
+  assert(geo_spatial_join_double(&point, 1, geometry_pointers, 1, false, &executor, NULL, NULL, 0, &count) ==
+         GEO_ERR_NULL_POINTER);
+  assert(geo_csv_read_points_double(text, sizeof(text) - 1, ',', 0, 1, false, &executor, xs, ys, 4, &count) ==
+         GEO_ERR_NULL_POINTER);
+}
+
+void geo_convex_hull_soa_double_returns_geo_success_and_stays_inside_a_hull_buffer_of_every_point(void) {
+  /* the upper chain pushes (1, 0) before (0, 1) pops it again */
+  double xs[3] = {0, 1, 2};
+  double ys[3] = {1, 0, 1};
+  struct GeoPointsSoA_double points = {xs, ys, 3};
+  size_t *convex_hull = malloc(3 * sizeof(size_t));
+  size_t convex_hull_size = 0;
+  enum GeoResult result = geo_convex_hull_soa_double(&points, NULL, NULL, convex_hull, &convex_hull_size);
+  assert(result == GEO_SUCCESS);
+  assert(convex_hull_size == 3);
+  assert(convex_hull[0] == 0);
+  assert(convex_hull[1] == 1);
+  assert(convex_hull[2] == 2);
+  free(convex_hull);
+}
+
+void geo_convex_hull_soa_double_returns_geo_success_and_keeps_every_part_in_its_own_chain(void) {
+  struct GeoPool pool;
+  struct GeoExecutor executor;
+  size_t const count = 16384;
+  double *xs = malloc(count * sizeof(double));
+  double *ys = malloc(count * sizeof(double));
+  size_t *convex_hull = malloc(count * sizeof(size_t));
+  struct GeoPointsSoA_double points = {xs, ys, count};
+  size_t convex_hull_size = 0;
+  enum GeoResult result = 0;
+  /* every part of 4096 is the same parabola so its lower chain is the whole part */
+  for (size_t iter = 0; iter < count; ++iter) {
+    xs[iter] = (double)(iter % 4096);
+    ys[iter] = (double)((iter % 4096) * (iter % 4096));
+  }
+  result = geo_pool_init(&pool, 3);
+  assert(result == GEO_SUCCESS);
+  geo_pool_executor(&pool, &executor);
+  assert(executor.concurrency == 4);
+  result = geo_convex_hull_soa_double(&points, &executor, NULL, convex_hull, &convex_hull_size);
+  assert(result == GEO_SUCCESS);
+  assert(convex_hull_size == 4096);
+  for (size_t iter = 0; iter < convex_hull_size; ++iter) {
+    assert(xs[convex_hull[iter]] == (double)iter);
+  }
+  geo_pool_destroy(&pool);
+  free(convex_hull);
+  free(ys);
+  free(xs);
+}
+
 int main(void) {
   /* geo_points_equal_double tests */
   geo_points_equal_double_returns_geo_err_null_pointer_result_code_when_lhs_is_null();
@@ -2316,6 +4910,136 @@ int main(void) {
   geo_convex_hull_double_returns_geo_success_and_sets_hull_size_to_5_and_hull_has_points_in_ccw_order_when_given_point_cloud();
   geo_convex_hull_double_returns_geo_success_and_sets_hull_size_to_4_and_hull_has_points_in_ccw_order_using_furthest_colinear_point_when_given_point_cloud_with_colinear_points();
   geo_convex_hull_double_with_30_points_returns_geo_success_and_sets_hull_size_to_12_and_hull_has_points_in_ccw_order();
+  geo_convex_hull_double_returns_geo_success_and_sets_hull_size_to_4_when_start_point_is_repeated();
+  geo_convex_hull_double_returns_geo_success_and_leaves_out_the_start_point_repeated_before_a_left_turn();
+
+  /* geo_grid_double tests */
+  geo_grid_init_double_returns_geo_err_null_pointer_when_grid_is_null();
+  geo_grid_init_double_returns_geo_err_too_small_when_slots_count_is_not_a_power_of_2();
+  geo_grid_init_double_returns_geo_err_out_of_range_when_cell_size_is_not_positive();
+  geo_grid_insert_double_returns_geo_err_out_of_range_when_id_is_not_less_than_objects_count();
+  geo_grid_insert_double_returns_geo_success_and_inserted_set_to_false_when_id_is_already_present();
+  geo_grid_query_radius_double_returns_geo_success_and_only_ids_within_radius();
+  geo_grid_query_radius_double_returns_geo_success_and_ids_count_larger_than_capacity_when_ids_is_too_small();
+  geo_grid_move_double_returns_geo_success_and_object_is_only_found_at_new_position();
+  geo_grid_move_double_returns_geo_success_and_moved_set_to_false_when_id_is_not_present();
+  geo_grid_move_double_returns_geo_err_full_when_no_slot_is_free();
+  geo_grid_remove_double_returns_geo_success_and_object_is_no_longer_found();
+  geo_grid_query_geometry_double_returns_geo_success_and_only_ids_inside_geometry();
+
+  /* geo_geometry_envelope_double tests */
+  geo_geometry_envelope_double_returns_geo_err_null_pointer_when_geometry_is_null();
+  geo_geometry_envelope_double_returns_geo_success_and_sets_min_and_max_of_all_points();
+
+  /* geo_morton_key_double and geo_hilbert_key_double tests */
+  geo_morton_key_double_returns_geo_err_out_of_range_when_envelope_max_is_less_than_min();
+  geo_morton_key_double_returns_geo_success_and_interleaves_x_and_y_bits();
+  geo_morton_key_double_returns_geo_success_and_clamps_points_outside_envelope();
+  geo_hilbert_key_double_returns_geo_success_and_visits_quadrants_in_curve_order();
+
+  /* geo_sort_points_by_key_double and geo_sort_geometries_by_key_double tests */
+  geo_sort_points_by_key_double_returns_geo_err_null_pointer_when_keys_is_null();
+  geo_sort_points_by_key_double_returns_geo_success_and_orders_points_and_keys_by_key();
+  geo_sort_geometries_by_key_double_returns_geo_success_and_orders_geometries_by_key();
+
+  /* geo_index_double tests */
+  geo_index_build_size_double_returns_geo_err_too_small_when_any_geometry_has_less_than_3_segments();
+  geo_index_build_double_returns_geo_err_too_small_when_buffer_is_smaller_than_build_size();
+  geo_index_open_double_returns_geo_err_invalid_format_when_magic_does_not_match();
+  geo_index_query_double_returns_geo_success_and_finds_geometries_built_into_index();
+
+  /* geo_spatial_join_double tests */
+  geo_spatial_join_double_returns_geo_err_null_pointer_when_pairs_count_is_null();
+  geo_spatial_join_double_returns_geo_success_and_pairs_of_points_inside_few_geometries();
+  geo_spatial_join_double_returns_geo_success_and_pairs_count_larger_than_capacity_when_pairs_is_too_small();
+  geo_spatial_join_count_double_returns_geo_success_and_counts_per_geometry_when_using_multiple_threads_and_many_geometries();
+  /* geo_ring_view_double tests */
+  geo_ring_view_is_closed_double_returns_geo_err_too_small_when_view_has_less_than_4_points();
+  geo_ring_view_is_closed_double_returns_geo_success_and_false_when_last_point_differs();
+  geo_ring_view_is_simple_double_returns_geo_success_and_matches_simple_and_bowtie_rings();
+  geo_point_in_ring_view_double_returns_geo_success_and_respects_strict_on_the_boundary();
+  geo_ring_view_in_ring_view_double_returns_geo_success_and_true_when_child_is_inside();
+  geo_point_in_polygon_view_double_returns_geo_success_and_false_inside_a_hole();
+  geo_ring_view_envelope_double_returns_geo_success_and_bounds_of_the_ring();
+  /* geo_wkb_read_double tests */
+  geo_wkb_read_double_returns_geo_success_and_views_into_the_blob_for_a_polygon_with_a_hole();
+  geo_wkb_read_double_returns_geo_err_too_small_and_required_counts_for_a_multi_polygon();
+  geo_wkb_read_double_returns_geo_err_invalid_format_when_blob_is_truncated();
+  geo_wkb_read_double_returns_geo_err_unsupported_for_other_byte_orders_and_types();
+  /* geo_wkt_parse_double tests */
+  geo_wkt_parse_double_returns_geo_success_and_emits_every_shape();
+  geo_wkt_parse_double_returns_geo_success_for_every_chunk_split();
+  geo_wkt_parse_double_returns_geo_err_invalid_format_and_offset_for_malformed_text();
+  geo_wkt_parse_finish_double_returns_geo_err_invalid_format_when_shape_is_unterminated();
+  geo_wkt_parse_double_returns_geo_err_unsupported_for_z_coordinates();
+  geo_wkt_parse_double_returns_geo_err_full_when_arena_is_too_small();
+  /* geo_wkt_parse_fd_double tests */
+  geo_wkt_parse_fd_double_returns_geo_success_and_reads_the_whole_file();
+  /* geo_json_parse_double tests */
+  geo_json_parse_double_returns_geo_success_and_emits_every_feature_geometry();
+  geo_json_parse_double_returns_geo_success_for_every_chunk_split();
+  geo_json_parse_double_returns_geo_success_for_bare_geometries_one_per_line();
+  geo_json_parse_double_returns_geo_err_invalid_format_for_malformed_json();
+  geo_json_parse_finish_double_returns_geo_err_invalid_format_when_json_is_truncated();
+  geo_json_parse_double_returns_geo_err_unsupported_for_geometry_collections();
+  /* geo_index_compress_double tests */
+  geo_index_ring_double_returns_geo_success_and_closed_ring_of_indexed_geometry();
+  geo_index_compress_double_returns_geo_success_and_decompress_restores_original_file();
+  geo_index_decompress_double_returns_geo_err_invalid_format_when_points_section_is_truncated();
+  /* geo_shp_double tests */
+  geo_shp_open_double_returns_geo_err_invalid_format_when_file_code_does_not_match();
+  geo_shp_record_rings_double_returns_geo_success_and_views_into_the_file();
+  geo_point_in_shp_record_double_returns_geo_success_and_uses_the_even_odd_rule_over_parts();
+  /* geo_fgb_double tests */
+  geo_fgb_open_double_returns_geo_err_invalid_format_when_magic_does_not_match();
+  geo_fgb_query_envelope_double_returns_geo_success_and_ids_of_intersecting_features();
+  geo_fgb_query_point_double_returns_geo_success_and_ids_of_features_containing_the_point();
+  geo_fgb_read_double_returns_geo_success_and_views_into_the_file();
+  geo_fgb_query_envelope_double_returns_geo_success_and_no_ids_when_the_file_is_empty();
+  /* geo_csv_read_points_double tests */
+  geo_csv_read_points_double_returns_geo_success_and_columns_of_every_non_blank_line();
+  geo_csv_read_points_double_returns_geo_err_invalid_format_when_a_line_misses_a_column();
+  geo_csv_read_points_double_returns_geo_success_and_points_in_file_order_when_using_multiple_threads();
+  /* geo_points_soa_double tests */
+  geo_convex_hull_soa_double_returns_geo_success_and_counterclockwise_hull_positions();
+  geo_points_in_geometry_soa_double_returns_geo_success_and_same_answers_as_geo_point_in_geometry();
+  geo_squared_distance_soa_double_returns_geo_success_and_squared_distance_of_every_point();
+  /* geo_geometry_build_from_points_double tests */
+  geo_geometry_build_from_points_double_returns_geo_success_and_geometry_in_one_arena_block();
+  geo_geometry_build_from_points_double_returns_geo_err_full_and_leaves_arena_when_it_does_not_fit();
+  /* geo_allocator_double tests */
+  geo_spatial_join_count_double_returns_geo_err_null_pointer_when_allocator_has_no_functions();
+  geo_spatial_join_count_double_returns_geo_success_and_releases_everything_it_allocates();
+  geo_convex_hull_soa_double_returns_geo_success_and_releases_everything_it_allocates();
+#ifdef GEO_STATS
+  /* geo_stats tests */
+  geo_stats_snapshot_returns_geo_err_null_pointer_when_stats_is_null_double();
+  geo_segments_intersect_double_counts_one_call_and_four_orientations_when_segments_cross();
+  geo_point_in_geometry_double_counts_one_call_and_every_edge_when_point_is_inside();
+  geo_geometry_is_simple_double_counts_every_segment_pair_when_geometry_is_simple();
+  geo_convex_hull_double_counts_one_call_and_its_comparisons();
+  geo_stats_reset_double_zeroes_every_counter();
+  geo_points_equal_double_counts_the_exit_each_comparison_takes();
+#endif
+#ifdef GEO_TRACE
+  /* geo_trace tests */
+  geo_trace_set_returns_geo_err_null_pointer_when_trace_is_null_double();
+  geo_point_in_geometry_double_reports_one_call_with_segments_count_when_traced();
+  geo_geometry_is_simple_double_reports_only_the_outer_call_when_traced();
+  geo_segments_intersect_double_reports_nothing_when_tracer_is_removed();
+#endif
+  /* geo_simd_select tests */
+  geo_simd_select_double_returns_geo_err_unsupported_when_level_is_above_geo_simd_level();
+  geo_simd_select_double_gives_the_same_soa_answers_at_every_supported_level();
+  geo_simd_select_double_gives_the_same_soa_answers_near_slanted_edges();
+  /* GeoExecutor tests */
+  geo_points_in_geometry_soa_double_returns_geo_success_and_same_answers_with_an_executor();
+  geo_convex_hull_soa_double_returns_geo_success_and_same_hull_with_an_executor();
+  geo_geometry_is_simple_parallel_double_returns_geo_success_and_same_answers_with_an_executor();
+  geo_index_build_double_writes_the_same_bytes_with_an_executor();
+  geo_points_in_geometry_soa_double_and_other_executor_functions_return_geo_err_null_pointer_when_submit_is_null();
+  geo_convex_hull_soa_double_returns_geo_success_and_stays_inside_a_hull_buffer_of_every_point();
+  geo_convex_hull_soa_double_returns_geo_success_and_keeps_every_part_in_its_own_chain();
   printf("All double tests pass.\n");
   return 0;
 }
@@ -1,6 +1,7 @@
 #include "geo_long.h"
 #include <assert.h>
 #include <stdio.h>
+#include <string.h>
 
 /*----------------------------------
  * geo_points_equal_long tests
@@ -2174,6 +2175,1981 @@ void geo_convex_hull_long_with_30_points_returns_geo_success_and_sets_hull_size_
   assert(hull_size == 12);
 }
 
+void geo_convex_hull_long_returns_geo_success_and_sets_hull_size_to_4_when_start_point_is_repeated(void) {
+  size_t count = 7;
+  size_t hull_size = 0;
+  struct GeoPoint_long *hull[7];
+  struct GeoPoint_long *points[7];
+  struct GeoPoint_long cloud[7] = {{0, 0}, {2, 0}, {4, 0}, {4, 4}, {0, 4}, {0, 0}, {2, 2}};
+  for (size_t iter = 0; iter < count; ++iter) {
+    points[iter] = &cloud[iter];
+  }
+
+  enum GeoResult result = geo_convex_hull_long(points, hull, count, &hull_size);
+  assert(result == GEO_SUCCESS);
+  assert(hull_size == 4);
+  assert(hull[0]->x == 0 && hull[0]->y == 0);
+  assert(hull[1] == &cloud[2]);
+  assert(hull[2] == &cloud[3]);
+  assert(hull[3] == &cloud[4]);
+}
+
+void geo_convex_hull_long_returns_geo_success_and_leaves_out_the_start_point_repeated_before_a_left_turn(void) {
+  size_t count = 6;
+  size_t hull_size = 0;
+  struct GeoPoint_long *hull[6];
+  struct GeoPoint_long *points[6];
+  struct GeoPoint_long cloud[6] = {{0, 0}, {3, 3}, {1, 1}, {2, 2}, {0, 0}, {4, 0}};
+  for (size_t iter = 0; iter < count; ++iter) {
+    points[iter] = &cloud[iter];
+  }
+
+  enum GeoResult result = geo_convex_hull_long(points, hull, count, &hull_size);
+  assert(result == GEO_SUCCESS);
+  assert(hull_size == 3);
+  assert(hull[0]->x == 0 && hull[0]->y == 0);
+  assert(hull[1] == &cloud[5]);
+  assert(hull[2] == &cloud[1]);
+}
+
+/*----------------------------------
+ * geo_grid_long tests
+ *----------------------------------
+ */
+void geo_grid_init_long_returns_geo_err_null_pointer_when_grid_is_null(void) {
+  struct GeoGridSlot_long slots[8];
+  size_t objects[4];
+  enum GeoResult result = geo_grid_init_long(NULL, 1, slots, 8, objects, 4);
+  assert(result == GEO_ERR_NULL_POINTER);
+}
+
+void geo_grid_init_long_returns_geo_err_too_small_when_slots_count_is_not_a_power_of_2(void) {
+  struct GeoGrid_long grid;
+  struct GeoGridSlot_long slots[6];
+  size_t objects[4];
+  enum GeoResult result = geo_grid_init_long(&grid, 1, slots, 6, objects, 4);
+  assert(result == GEO_ERR_TOO_SMALL);
+}
+
+void geo_grid_init_long_returns_geo_err_out_of_range_when_cell_size_is_not_positive(void) {
+  struct GeoGrid_long grid;
+  struct GeoGridSlot_long slots[8];
+  size_t objects[4];
+  enum GeoResult result = geo_grid_init_long(&grid, 0, slots, 8, objects, 4);
+  assert(result == GEO_ERR_OUT_OF_RANGE);
+}
+
+void geo_grid_insert_long_returns_geo_err_out_of_range_when_id_is_not_less_than_objects_count(void) {
+  struct GeoGrid_long grid;
+  struct GeoGridSlot_long slots[8];
+  size_t objects[4];
+  struct GeoPoint_long point = {1, 1};
+  bool inserted = false;
+  enum GeoResult result = geo_grid_init_long(&grid, 2, slots, 8, objects, 4);
+  assert(result == GEO_SUCCESS);
+  result = geo_grid_insert_long(&grid, 4, &point, &inserted);
+  assert(result == GEO_ERR_OUT_OF_RANGE);
+}
+
+void geo_grid_insert_long_returns_geo_success_and_inserted_set_to_false_when_id_is_already_present(void) {
+  struct GeoGrid_long grid;
+  struct GeoGridSlot_long slots[8];
+  size_t objects[4];
+  struct GeoPoint_long point1 = {1, 1};
+  struct GeoPoint_long point2 = {5, 5};
+  size_t ids[4];
+  size_t ids_count = 0;
+  bool inserted = false;
+  enum GeoResult result = geo_grid_init_long(&grid, 2, slots, 8, objects, 4);
+  assert(result == GEO_SUCCESS);
+  result = geo_grid_insert_long(&grid, 1, &point1, &inserted);
+  assert(result == GEO_SUCCESS);
+  assert(inserted);
+  result = geo_grid_insert_long(&grid, 1, &point2, &inserted);
+  assert(result == GEO_SUCCESS);
+  assert(!inserted);
+  result = geo_grid_query_radius_long(&grid, &point2, 1, ids, 4, &ids_count);
+  assert(result == GEO_SUCCESS);
+  assert(ids_count == 0);
+}
+
+void geo_grid_query_radius_long_returns_geo_success_and_only_ids_within_radius(void) {
+  /*
+   * p0 and p1 are within 3 of the center (0, 0), p2 is not.
+   */
+  struct GeoGrid_long grid;
+  struct GeoGridSlot_long slots[16];
+  size_t objects[8];
+  struct GeoPoint_long center = {0, 0};
+  struct GeoPoint_long point0 = {1, 1};
+  struct GeoPoint_long point1 = {-2, 2};
+  struct GeoPoint_long point2 = {3, 3};
+  size_t ids[8];
+  size_t ids_count = 0;
+  bool inserted = false;
+  enum GeoResult result = geo_grid_init_long(&grid, 2, slots, 16, objects, 8);
+  assert(result == GEO_SUCCESS);
+  assert(geo_grid_insert_long(&grid, 0, &point0, &inserted) == GEO_SUCCESS);
+  assert(geo_grid_insert_long(&grid, 1, &point1, &inserted) == GEO_SUCCESS);
+  assert(geo_grid_insert_long(&grid, 2, &point2, &inserted) == GEO_SUCCESS);
+  result = geo_grid_query_radius_long(&grid, &center, 3, ids, 8, &ids_count);
+  assert(result == GEO_SUCCESS);
+  assert(ids_count == 2);
+  assert((ids[0] == 0 && ids[1] == 1) || (ids[0] == 1 && ids[1] == 0));
+}
+
+void geo_grid_query_radius_long_returns_geo_success_and_ids_count_larger_than_capacity_when_ids_is_too_small(void) {
+  struct GeoGrid_long grid;
+  struct GeoGridSlot_long slots[16];
+  size_t objects[8];
+  struct GeoPoint_long point = {1, 1};
+  size_t ids[1];
+  size_t ids_count = 0;
+  bool inserted = false;
+  enum GeoResult result = geo_grid_init_long(&grid, 2, slots, 16, objects, 8);
+  assert(result == GEO_SUCCESS);
+  assert(geo_grid_insert_long(&grid, 0, &point, &inserted) == GEO_SUCCESS);
+  assert(geo_grid_insert_long(&grid, 1, &point, &inserted) == GEO_SUCCESS);
+  result = geo_grid_query_radius_long(&grid, &point, 0, ids, 1, &ids_count);
+  assert(result == GEO_SUCCESS);
+  assert(ids_count == 2);
+}
+
+void geo_grid_move_long_returns_geo_success_and_object_is_only_found_at_new_position(void) {
+  struct GeoGrid_long grid;
+  struct GeoGridSlot_long slots[16];
+  size_t objects[8];
+  struct GeoPoint_long from = {1, 1};
+  struct GeoPoint_long to = {-40, 25};
+  size_t ids[8];
+  size_t ids_count = 0;
+  bool inserted = false;
+  bool moved = false;
+  enum GeoResult result = geo_grid_init_long(&grid, 2, slots, 16, objects, 8);
+  assert(result == GEO_SUCCESS);
+  assert(geo_grid_insert_long(&grid, 3, &from, &inserted) == GEO_SUCCESS);
+  result = geo_grid_move_long(&grid, 3, &to, &moved);
+  assert(result == GEO_SUCCESS);
+  assert(moved);
+  assert(geo_grid_query_radius_long(&grid, &from, 1, ids, 8, &ids_count) == GEO_SUCCESS);
+  assert(ids_count == 0);
+  assert(geo_grid_query_radius_long(&grid, &to, 1, ids, 8, &ids_count) == GEO_SUCCESS);
+  assert(ids_count == 1);
+  assert(ids[0] == 3);
+}
+
+void geo_grid_move_long_returns_geo_success_and_moved_set_to_false_when_id_is_not_present(void) {
+  struct GeoGrid_long grid;
+  struct GeoGridSlot_long slots[8];
+  size_t objects[4];
+  struct GeoPoint_long point = {1, 1};
+  size_t ids[4];
+  size_t ids_count = 0;
+  bool moved = true;
+  enum GeoResult result = geo_grid_init_long(&grid, 2, slots, 8, objects, 4);
+  assert(result == GEO_SUCCESS);
+  result = geo_grid_move_long(&grid, 0, &point, &moved);
+  assert(result == GEO_SUCCESS);
+  assert(!moved);
+  assert(geo_grid_query_radius_long(&grid, &point, 1, ids, 4, &ids_count) == GEO_SUCCESS);
+  assert(ids_count == 0);
+}
+
+void geo_grid_move_long_returns_geo_err_full_when_no_slot_is_free(void) {
+  struct GeoGrid_long grid;
+  struct GeoGridSlot_long slots[2];
+  size_t objects[2];
+  struct GeoPoint_long point = {1, 1};
+  bool inserted = false;
+  bool moved = false;
+  enum GeoResult result = geo_grid_init_long(&grid, 2, slots, 2, objects, 2);
+  assert(result == GEO_SUCCESS);
+  assert(geo_grid_insert_long(&grid, 0, &point, &inserted) == GEO_SUCCESS);
+  assert(geo_grid_insert_long(&grid, 1, &point, &inserted) == GEO_SUCCESS);
+  result = geo_grid_move_long(&grid, 0, &point, &moved);
+  assert(result == GEO_ERR_FULL);
+}
+
+void geo_grid_remove_long_returns_geo_success_and_object_is_no_longer_found(void) {
+  struct GeoGrid_long grid;
+  struct GeoGridSlot_long slots[8];
+  size_t objects[4];
+  struct GeoPoint_long point = {1, 1};
+  size_t ids[4];
+  size_t ids_count = 0;
+  bool inserted = false;
+  bool removed = false;
+  enum GeoResult result = geo_grid_init_long(&grid, 2, slots, 8, objects, 4);
+  assert(result == GEO_SUCCESS);
+  assert(geo_grid_insert_long(&grid, 2, &point, &inserted) == GEO_SUCCESS);
+  result = geo_grid_remove_long(&grid, 2, &removed);
+  assert(result == GEO_SUCCESS);
+  assert(removed);
+  result = geo_grid_remove_long(&grid, 2, &removed);
+  assert(result == GEO_SUCCESS);
+  assert(!removed);
+  assert(geo_grid_query_radius_long(&grid, &point, 1, ids, 4, &ids_count) == GEO_SUCCESS);
+  assert(ids_count == 0);
+}
+
+void geo_grid_query_geometry_long_returns_geo_success_and_only_ids_inside_geometry(void) {
+  /*
+   * p3---------p2
+   * |     a     |   b
+   * |           |
+   * p0---c-----p1
+   */
+  struct GeoGrid_long grid;
+  struct GeoGridSlot_long slots[16];
+  size_t objects[8];
+  struct GeoPoint_long point0 = {0, 0};
+  struct GeoPoint_long point1 = {8, 0};
+  struct GeoPoint_long point2 = {8, 8};
+  struct GeoPoint_long point3 = {0, 8};
+  struct GeoSegment_long segment0 = {&point0, &point1};
+  struct GeoSegment_long segment1 = {&point1, &point2};
+  struct GeoSegment_long segment2 = {&point2, &point3};
+  struct GeoSegment_long segment3 = {&point3, &point0};
+  struct GeoSegment_long *segments[4];
+  struct GeoGeometry_long geometry;
+  struct GeoPoint_long a = {4, 6};
+  struct GeoPoint_long b = {10, 6};
+  struct GeoPoint_long c = {3, 0};
+  size_t ids[8];
+  size_t ids_count = 0;
+  bool inserted = false;
+  enum GeoResult result = geo_grid_init_long(&grid, 2, slots, 16, objects, 8);
+  segments[0] = &segment0;
+  segments[1] = &segment1;
+  segments[2] = &segment2;
+  segments[3] = &segment3;
+  geometry.segments = segments;
+  geometry.segments_count = 4;
+  assert(result == GEO_SUCCESS);
+  assert(geo_grid_insert_long(&grid, 0, &a, &inserted) == GEO_SUCCESS);
+  assert(geo_grid_insert_long(&grid, 1, &b, &inserted) == GEO_SUCCESS);
+  assert(geo_grid_insert_long(&grid, 2, &c, &inserted) == GEO_SUCCESS);
+  result = geo_grid_query_geometry_long(&grid, &geometry, true, ids, 8, &ids_count);
+  assert(result == GEO_SUCCESS);
+  assert(ids_count == 1);
+  assert(ids[0] == 0);
+  result = geo_grid_query_geometry_long(&grid, &geometry, false, ids, 8, &ids_count);
+  assert(result == GEO_SUCCESS);
+  assert(ids_count == 2);
+}
+
+/*----------------------------------
+ * geo_geometry_envelope_long tests
+ *----------------------------------
+ */
+void geo_geometry_envelope_long_returns_geo_err_null_pointer_when_geometry_is_null(void) {
+  struct GeoEnvelope_long envelope;
+  enum GeoResult result = geo_geometry_envelope_long(NULL, &envelope);
+  assert(result == GEO_ERR_NULL_POINTER);
+}
+
+void geo_geometry_envelope_long_returns_geo_success_and_sets_min_and_max_of_all_points(void) {
+  struct GeoPoint_long point0 = {1, -2};
+  struct GeoPoint_long point1 = {6, 0};
+  struct GeoPoint_long point2 = {-3, 5};
+  struct GeoSegment_long segment0 = {&point0, &point1};
+  struct GeoSegment_long segment1 = {&point1, &point2};
+  struct GeoSegment_long segment2 = {&point2, &point0};
+  struct GeoSegment_long *segments[3];
+  struct GeoGeometry_long geometry;
+  struct GeoEnvelope_long envelope;
+  enum GeoResult result = 0;
+  segments[0] = &segment0;
+  segments[1] = &segment1;
+  segments[2] = &segment2;
+  geometry.segments = segments;
+  geometry.segments_count = 3;
+  result = geo_geometry_envelope_long(&geometry, &envelope);
+  assert(result == GEO_SUCCESS);
+  assert(envelope.min.x == -3);
+  assert(envelope.min.y == -2);
+  assert(envelope.max.x == 6);
+  assert(envelope.max.y == 5);
+}
+
+/*----------------------------------
+ * geo_morton_key_long and geo_hilbert_key_long tests
+ *----------------------------------
+ */
+void geo_morton_key_long_returns_geo_err_out_of_range_when_envelope_max_is_less_than_min(void) {
+  struct GeoPoint_long points[1] = {{0, 0}};
+  struct GeoEnvelope_long envelope = {{0, 0}, {-1, 1}};
+  uint64_t keys[1];
+  enum GeoResult result = geo_morton_key_long(points, 1, &envelope, keys);
+  assert(result == GEO_ERR_OUT_OF_RANGE);
+}
+
+void geo_morton_key_long_returns_geo_success_and_interleaves_x_and_y_bits(void) {
+  struct GeoPoint_long points[4] = {{0, 0}, {8, 0}, {0, 8}, {8, 8}};
+  struct GeoEnvelope_long envelope = {{0, 0}, {8, 8}};
+  uint64_t keys[4];
+  enum GeoResult result = geo_morton_key_long(points, 4, &envelope, keys);
+  assert(result == GEO_SUCCESS);
+  assert(keys[0] == 0);
+  assert(keys[1] == 0x5555555555555555ULL);
+  assert(keys[2] == 0xAAAAAAAAAAAAAAAAULL);
+  assert(keys[3] == 0xFFFFFFFFFFFFFFFFULL);
+}
+
+void geo_morton_key_long_returns_geo_success_and_clamps_points_outside_envelope(void) {
+  struct GeoPoint_long points[2] = {{-5, -5}, {20, 20}};
+  struct GeoEnvelope_long envelope = {{0, 0}, {8, 8}};
+  uint64_t keys[2];
+  enum GeoResult result = geo_morton_key_long(points, 2, &envelope, keys);
+  assert(result == GEO_SUCCESS);
+  assert(keys[0] == 0);
+  assert(keys[1] == 0xFFFFFFFFFFFFFFFFULL);
+}
+
+void geo_hilbert_key_long_returns_geo_success_and_visits_quadrants_in_curve_order(void) {
+  /*
+   * 1---2
+   * |   |
+   * 0   3
+   */
+  struct GeoPoint_long points[4] = {{1, 1}, {1, 7}, {7, 7}, {7, 1}};
+  struct GeoEnvelope_long envelope = {{0, 0}, {8, 8}};
+  uint64_t keys[4];
+  enum GeoResult result = geo_hilbert_key_long(points, 4, &envelope, keys);
+  assert(result == GEO_SUCCESS);
+  assert(keys[0] < keys[1]);
+  assert(keys[1] < keys[2]);
+  assert(keys[2] < keys[3]);
+  assert((keys[0] >> 62) == 0);
+  assert((keys[3] >> 62) == 3);
+}
+
+/*----------------------------------
+ * geo_sort_points_by_key_long and geo_sort_geometries_by_key_long tests
+ *----------------------------------
+ */
+void geo_sort_points_by_key_long_returns_geo_err_null_pointer_when_keys_is_null(void) {
+  struct GeoPoint_long points[1] = {{0, 0}};
+  enum GeoResult result = geo_sort_points_by_key_long(points, NULL, 1, NULL);
+  assert(result == GEO_ERR_NULL_POINTER);
+}
+
+void geo_sort_points_by_key_long_returns_geo_success_and_orders_points_and_keys_by_key(void) {
+  struct GeoPool pool;
+  struct GeoExecutor executor;
+  struct GeoPoint_long points[100];
+  uint64_t keys[100];
+  enum GeoResult result = 0;
+  for (size_t iter = 0; iter < 100; ++iter) {
+    /* every key is unique and maps back to its point */
+    keys[iter] = ((uint64_t)((iter * 37) % 100) << 40) | iter;
+    points[iter].x = (int)iter;
+    points[iter].y = (int)(iter * 2);
+  }
+  result = geo_pool_init(&pool, 3);
+  assert(result == GEO_SUCCESS);
+  geo_pool_executor(&pool, &executor);
+  result = geo_sort_points_by_key_long(points, keys, 100, &executor);
+  assert(result == GEO_SUCCESS);
+  for (size_t iter = 0; iter < 100; ++iter) {
+    size_t original = (size_t)(keys[iter] & 0xFF);
+    assert(iter == 0 || keys[iter - 1] < keys[iter]);
+    assert(points[iter].x == (int)original);
+    assert(points[iter].y == (int)(original * 2));
+  }
+  geo_pool_destroy(&pool);
+}
+
+void geo_sort_geometries_by_key_long_returns_geo_success_and_orders_geometries_by_key(void) {
+  struct GeoGeometry_long geometry0;
+  struct GeoGeometry_long geometry1;
+  struct GeoGeometry_long geometry2;
+  struct GeoGeometry_long *geometries[3];
+  uint64_t keys[3] = {30, 10, 20};
+  enum GeoResult result = 0;
+  geometries[0] = &geometry0;
+  geometries[1] = &geometry1;
+  geometries[2] = &geometry2;
+  result = geo_sort_geometries_by_key_long(geometries, keys, 3, NULL);
+  assert(result == GEO_SUCCESS);
+  assert(geometries[0] == &geometry1);
+  assert(geometries[1] == &geometry2);
+  assert(geometries[2] == &geometry0);
+  assert(keys[0] == 10);
+  assert(keys[2] == 30);
+}
+
+/*----------------------------------
+ * geo_index_long tests
+ *----------------------------------
+ */
+void geo_index_build_size_long_returns_geo_err_too_small_when_any_geometry_has_less_than_3_segments(void) {
+  struct GeoPoint_long point0 = {0, 0};
+  struct GeoPoint_long point1 = {1, 0};
+  struct GeoSegment_long segment0 = {&point0, &point1};
+  struct GeoSegment_long segment1 = {&point1, &point0};
+  struct GeoSegment_long *segments[2];
+  struct GeoGeometry_long geometry;
+  struct GeoGeometry_long *geometries[1];
+  size_t size = 0;
+  enum GeoResult result = 0;
+  segments[0] = &segment0;
+  segments[1] = &segment1;
+  geometry.segments = segments;
+  geometry.segments_count = 2;
+  geometries[0] = &geometry;
+  result = geo_index_build_size_long(geometries, 1, &size);
+  assert(result == GEO_ERR_TOO_SMALL);
+}
+
+void geo_index_build_long_returns_geo_err_too_small_when_buffer_is_smaller_than_build_size(void) {
+  struct GeoPoint_long point0 = {0, 0};
+  struct GeoPoint_long point1 = {4, 0};
+  struct GeoPoint_long point2 = {0, 4};
+  struct GeoSegment_long segment0 = {&point0, &point1};
+  struct GeoSegment_long segment1 = {&point1, &point2};
+  struct GeoSegment_long segment2 = {&point2, &point0};
+  struct GeoSegment_long *segments[3];
+  struct GeoGeometry_long geometry;
+  struct GeoGeometry_long *geometries[1];
+  size_t size = 0;
+  void *buffer = NULL;
+  enum GeoResult result = 0;
+  segments[0] = &segment0;
+  segments[1] = &segment1;
+  segments[2] = &segment2;
+  geometry.segments = segments;
+  geometry.segments_count = 3;
+  geometries[0] = &geometry;
+  result = geo_index_build_size_long(geometries, 1, &size);
+  assert(result == GEO_SUCCESS);
+  buffer = malloc(size);
+  result = geo_index_build_long(geometries, 1, NULL, buffer, size - 1);
+  assert(result == GEO_ERR_TOO_SMALL);
+  free(buffer);
+}
+
+void geo_index_open_long_returns_geo_err_invalid_format_when_magic_does_not_match(void) {
+  struct GeoIndexHeader *header = malloc(sizeof(struct GeoIndexHeader));
+  struct GeoIndex_long index;
+  enum GeoResult result = 0;
+  memset(header, 0, sizeof(struct GeoIndexHeader));
+  memcpy(header->magic, "GEOINDEY", 8);
+  result = geo_index_open_long(&index, header, sizeof(struct GeoIndexHeader));
+  assert(result == GEO_ERR_INVALID_FORMAT);
+  free(header);
+}
+
+void geo_index_query_long_returns_geo_success_and_finds_geometries_built_into_index(void) {
+  /*
+   * 40 squares of side 2 along a diagonal, square i has its lower left corner
+   * at (3i, 3i).
+   */
+  struct GeoPoint_long points[40][4];
+  struct GeoSegment_long segments[40][4];
+  struct GeoSegment_long *segment_pointers[40][4];
+  struct GeoGeometry_long geometries[40];
+  struct GeoGeometry_long *geometry_pointers[40];
+  struct GeoIndex_long index;
+  struct GeoPoint_long inside = {31, 31};
+  struct GeoPoint_long on_edge = {30, 31};
+  struct GeoPoint_long outside = {32, 33};
+  struct GeoEnvelope_long envelope = {{0, 0}, {7, 7}};
+  size_t ids[40];
+  size_t ids_count = 0;
+  size_t size = 0;
+  void *buffer = NULL;
+  enum GeoResult result = 0;
+  for (size_t iter = 0; iter < 40; ++iter) {
+    int corner = (int)(iter * 3);
+    points[iter][0].x = corner;
+    points[iter][0].y = corner;
+    points[iter][1].x = corner + 2;
+    points[iter][1].y = corner;
+    points[iter][2].x = corner + 2;
+    points[iter][2].y = corner + 2;
+    points[iter][3].x = corner;
+    points[iter][3].y = corner + 2;
+    for (size_t side = 0; side < 4; ++side) {
+      segments[iter][side].start = &points[iter][side];
+      segments[iter][side].end = &points[iter][(side + 1) % 4];
+      segment_pointers[iter][side] = &segments[iter][side];
+    }
+    geometries[iter].segments = segment_pointers[iter];
+    geometries[iter].segments_count = 4;
+    geometry_pointers[iter] = &geometries[iter];
+  }
+  result = geo_index_build_size_long(geometry_pointers, 40, &size);
+  assert(result == GEO_SUCCESS);
+  buffer = malloc(size);
+  result = geo_index_build_long(geometry_pointers, 40, NULL, buffer, size);
+  assert(result == GEO_SUCCESS);
+  result = geo_index_open_long(&index, buffer, size);
+  assert(result == GEO_SUCCESS);
+  assert(index.entries_count == 40);
+
+  result = geo_index_query_point_long(&index, &inside, true, ids, 40, &ids_count);
+  assert(result == GEO_SUCCESS);
+  assert(ids_count == 1);
+  assert(ids[0] == 10);
+  result = geo_index_query_point_long(&index, &on_edge, true, ids, 40, &ids_count);
+  assert(result == GEO_SUCCESS);
+  assert(ids_count == 0);
+  result = geo_index_query_point_long(&index, &on_edge, false, ids, 40, &ids_count);
+  assert(result == GEO_SUCCESS);
+  assert(ids_count == 1);
+  result = geo_index_query_point_long(&index, &outside, false, ids, 40, &ids_count);
+  assert(result == GEO_SUCCESS);
+  assert(ids_count == 0);
+  result = geo_index_query_envelope_long(&index, &envelope, ids, 40, &ids_count);
+  assert(result == GEO_SUCCESS);
+  assert(ids_count == 3);
+  free(buffer);
+}
+
+/*----------------------------------
+ * geo_spatial_join_long tests
+ *----------------------------------
+ */
+/* square i has side 4 and its lower left corner at (5i, 0) */
+static void make_join_squares_long(struct GeoPoint_long (*points)[4],
+                                   struct GeoSegment_long (*segments)[4],
+                                   struct GeoSegment_long *(*segment_pointers)[4],
+                                   struct GeoGeometry_long *geometries,
+                                   struct GeoGeometry_long **geometry_pointers,
+                                   size_t count) {
+  for (size_t iter = 0; iter < count; ++iter) {
+    int corner = (int)(iter * 5);
+    points[iter][0].x = corner;
+    points[iter][0].y = 0;
+    points[iter][1].x = corner + 4;
+    points[iter][1].y = 0;
+    points[iter][2].x = corner + 4;
+    points[iter][2].y = 4;
+    points[iter][3].x = corner;
+    points[iter][3].y = 4;
+    for (size_t side = 0; side < 4; ++side) {
+      segments[iter][side].start = &points[iter][side];
+      segments[iter][side].end = &points[iter][(side + 1) % 4];
+      segment_pointers[iter][side] = &segments[iter][side];
+    }
+    geometries[iter].segments = segment_pointers[iter];
+    geometries[iter].segments_count = 4;
+    geometry_pointers[iter] = &geometries[iter];
+  }
+}
+
+void geo_spatial_join_long_returns_geo_err_null_pointer_when_pairs_count_is_null(void) {
+  struct GeoPoint_long points[1] = {{0, 0}};
+  enum GeoResult result = geo_spatial_join_long(points, 1, NULL, 0, false, NULL, NULL, NULL, 0, NULL);
+  assert(result == GEO_ERR_NULL_POINTER);
+}
+
+void geo_spatial_join_long_returns_geo_success_and_pairs_of_points_inside_few_geometries(void) {
+  struct GeoPoint_long points[2][4];
+  struct GeoSegment_long segments[2][4];
+  struct GeoSegment_long *segment_pointers[2][4];
+  struct GeoGeometry_long geometries[2];
+  struct GeoGeometry_long *geometry_pointers[2];
+  struct GeoPoint_long queries[4] = {{1, 1}, {7, 2}, {20, 2}, {5, 2}};
+  struct GeoJoinPair pairs[4];
+  size_t pairs_count = 0;
+  enum GeoResult result = 0;
+  make_join_squares_long(points, segments, segment_pointers, geometries, geometry_pointers, 2);
+  result = geo_spatial_join_long(queries, 4, geometry_pointers, 2, true, NULL, NULL, pairs, 4, &pairs_count);
+  assert(result == GEO_SUCCESS);
+  assert(pairs_count == 2);
+  assert(pairs[0].point == 0 && pairs[0].geometry == 0);
+  assert(pairs[1].point == 1 && pairs[1].geometry == 1);
+  result = geo_spatial_join_long(queries, 4, geometry_pointers, 2, false, NULL, NULL, pairs, 4, &pairs_count);
+  assert(result == GEO_SUCCESS);
+  assert(pairs_count == 3);
+  assert(pairs[2].point == 3 && pairs[2].geometry == 1);
+}
+
+void geo_spatial_join_long_returns_geo_success_and_pairs_count_larger_than_capacity_when_pairs_is_too_small(void) {
+  struct GeoPoint_long points[2][4];
+  struct GeoSegment_long segments[2][4];
+  struct GeoSegment_long *segment_pointers[2][4];
+  struct GeoGeometry_long geometries[2];
+  struct GeoGeometry_long *geometry_pointers[2];
+  struct GeoPoint_long queries[3] = {{1, 1}, {2, 2}, {6, 1}};
+  struct GeoJoinPair pairs[1];
+  size_t pairs_count = 0;
+  enum GeoResult result = 0;
+  make_join_squares_long(points, segments, segment_pointers, geometries, geometry_pointers, 2);
+  result = geo_spatial_join_long(queries, 3, geometry_pointers, 2, true, NULL, NULL, pairs, 1, &pairs_count);
+  assert(result == GEO_SUCCESS);
+  assert(pairs_count == 3);
+  assert(pairs[0].point == 0);
+}
+
+void geo_spatial_join_count_long_returns_geo_success_and_counts_per_geometry_when_using_multiple_threads_and_many_geometries(void) {
+  struct GeoPool pool;
+  struct GeoExecutor executor;
+  struct GeoPoint_long points[30][4];
+  struct GeoSegment_long segments[30][4];
+  struct GeoSegment_long *segment_pointers[30][4];
+  struct GeoGeometry_long geometries[30];
+  struct GeoGeometry_long *geometry_pointers[30];
+  struct GeoPoint_long queries[90];
+  size_t counts[30];
+  enum GeoResult result = 0;
+  make_join_squares_long(points, segments, segment_pointers, geometries, geometry_pointers, 30);
+  /* geometry i gets i % 3 points, the rest of the points fall in the gaps */
+  for (size_t iter = 0; iter < 90; ++iter) {
+    size_t geometry = iter / 3;
+    queries[iter].x = (int)(geometry * 5) + ((iter % 3) < (geometry % 3) ? 2 : 4 + 1);
+    queries[iter].y = 2;
+  }
+  result = geo_pool_init(&pool, 2);
+  assert(result == GEO_SUCCESS);
+  geo_pool_executor(&pool, &executor);
+  result = geo_spatial_join_count_long(queries, 90, geometry_pointers, 30, true, &executor, NULL, counts);
+  assert(result == GEO_SUCCESS);
+  for (size_t iter = 0; iter < 30; ++iter) {
+    assert(counts[iter] == iter % 3);
+  }
+  geo_pool_destroy(&pool);
+}
+
+/*
+ *----------------------------------
+ * geo_ring_view_long tests
+ *----------------------------------
+ */
+void geo_ring_view_is_closed_long_returns_geo_err_too_small_when_view_has_less_than_4_points(void) {
+  long coordinates[6] = {0, 0, 4, 0, 0, 0};
+  struct GeoRingView_long view = {coordinates, 3};
+  bool is_closed = false;
+  enum GeoResult result = geo_ring_view_is_closed_long(&view, &is_closed);
+  assert(result == GEO_ERR_TOO_SMALL);
+}
+
+void geo_ring_view_is_closed_long_returns_geo_success_and_false_when_last_point_differs(void) {
+  long coordinates[8] = {0, 0, 4, 0, 4, 4, 0, 4};
+  struct GeoRingView_long view = {coordinates, 4};
+  bool is_closed = true;
+  enum GeoResult result = geo_ring_view_is_closed_long(&view, &is_closed);
+  assert(result == GEO_SUCCESS);
+  assert(!is_closed);
+}
+
+void geo_ring_view_is_simple_long_returns_geo_success_and_matches_simple_and_bowtie_rings(void) {
+  long square[10] = {0, 0, 4, 0, 4, 4, 0, 4, 0, 0};
+  long bowtie[10] = {0, 0, 4, 4, 4, 0, 0, 4, 0, 0};
+  struct GeoRingView_long view = {square, 5};
+  bool is_simple = false;
+  enum GeoResult result = geo_ring_view_is_simple_long(&view, &is_simple);
+  assert(result == GEO_SUCCESS);
+  assert(is_simple);
+  view.coordinates = bowtie;
+  result = geo_ring_view_is_simple_long(&view, &is_simple);
+  assert(result == GEO_SUCCESS);
+  assert(!is_simple);
+}
+
+void geo_point_in_ring_view_long_returns_geo_success_and_respects_strict_on_the_boundary(void) {
+  long coordinates[10] = {0, 0, 4, 0, 4, 4, 0, 4, 0, 0};
+  struct GeoRingView_long view = {coordinates, 5};
+  struct GeoPoint_long inside = {1, 2};
+  struct GeoPoint_long edge = {4, 2};
+  struct GeoPoint_long outside = {5, 2};
+  bool is_inside = false;
+  assert(geo_point_in_ring_view_long(&inside, &view, true, &is_inside) == GEO_SUCCESS);
+  assert(is_inside);
+  assert(geo_point_in_ring_view_long(&edge, &view, true, &is_inside) == GEO_SUCCESS);
+  assert(!is_inside);
+  assert(geo_point_in_ring_view_long(&edge, &view, false, &is_inside) == GEO_SUCCESS);
+  assert(is_inside);
+  assert(geo_point_in_ring_view_long(&outside, &view, false, &is_inside) == GEO_SUCCESS);
+  assert(!is_inside);
+}
+
+void geo_ring_view_in_ring_view_long_returns_geo_success_and_true_when_child_is_inside(void) {
+  long outer[10] = {0, 0, 8, 0, 8, 8, 0, 8, 0, 0};
+  long inner[10] = {2, 2, 4, 2, 4, 4, 2, 4, 2, 2};
+  long crossing[10] = {6, 6, 10, 6, 10, 10, 6, 10, 6, 6};
+  struct GeoRingView_long parent = {outer, 5};
+  struct GeoRingView_long child = {inner, 5};
+  bool is_inside = false;
+  assert(geo_ring_view_in_ring_view_long(&parent, &child, true, &is_inside) == GEO_SUCCESS);
+  assert(is_inside);
+  child.coordinates = crossing;
+  assert(geo_ring_view_in_ring_view_long(&parent, &child, true, &is_inside) == GEO_SUCCESS);
+  assert(!is_inside);
+}
+
+void geo_point_in_polygon_view_long_returns_geo_success_and_false_inside_a_hole(void) {
+  long outer[10] = {0, 0, 8, 0, 8, 8, 0, 8, 0, 0};
+  long hole[10] = {2, 2, 2, 6, 6, 6, 6, 2, 2, 2};
+  struct GeoRingView_long rings[2] = {{outer, 5}, {hole, 5}};
+  struct GeoPolygonView_long polygon = {rings, 2};
+  struct GeoPoint_long in_hole = {4, 4};
+  struct GeoPoint_long on_hole = {2, 4};
+  struct GeoPoint_long in_polygon = {1, 4};
+  bool is_inside = true;
+  assert(geo_point_in_polygon_view_long(&in_hole, &polygon, false, &is_inside) == GEO_SUCCESS);
+  assert(!is_inside);
+  assert(geo_point_in_polygon_view_long(&on_hole, &polygon, true, &is_inside) == GEO_SUCCESS);
+  assert(!is_inside);
+  assert(geo_point_in_polygon_view_long(&on_hole, &polygon, false, &is_inside) == GEO_SUCCESS);
+  assert(is_inside);
+  assert(geo_point_in_polygon_view_long(&in_polygon, &polygon, true, &is_inside) == GEO_SUCCESS);
+  assert(is_inside);
+}
+
+void geo_ring_view_envelope_long_returns_geo_success_and_bounds_of_the_ring(void) {
+  long coordinates[10] = {1, 2, 5, 0, 7, 3, 2, 9, 1, 2};
+  struct GeoRingView_long view = {coordinates, 5};
+  struct GeoEnvelope_long envelope;
+  assert(geo_ring_view_envelope_long(&view, &envelope) == GEO_SUCCESS);
+  assert(envelope.min.x == 1 && envelope.min.y == 0);
+  assert(envelope.max.x == 7 && envelope.max.y == 9);
+}
+
+/*
+ *----------------------------------
+ * geo_wkt_parse_long tests
+ *----------------------------------
+ */
+struct WktShapes_long {
+  size_t count;
+  enum GeoShapeType types[4];
+  size_t points_counts[4];
+  size_t parts_counts[4];
+  size_t polygons_counts[4];
+  bool closed;
+  bool inside;
+};
+
+static void collect_wkt_shape_long(void *context, struct GeoShape_long const *shape) {
+  struct WktShapes_long *shapes = (struct WktShapes_long *)context;
+  struct GeoPoint_long point = {2, 2};
+  bool is_closed = false;
+  assert(shapes->count < 4);
+  shapes->types[shapes->count] = shape->type;
+  shapes->points_counts[shapes->count] = shape->points_count;
+  shapes->parts_counts[shapes->count] = shape->parts_count;
+  shapes->polygons_counts[shapes->count] = shape->polygons_count;
+  if (shape->type == GEO_SHAPE_POLYGON) {
+    assert(geo_geometry_is_closed_long(&shape->parts[0], &is_closed) == GEO_SUCCESS);
+    assert(geo_point_in_geometry_long(&point, &shape->parts[0], true, &shapes->inside) == GEO_SUCCESS);
+    shapes->closed = is_closed;
+  }
+  if (shape->type == GEO_SHAPE_POINT && shape->points_count == 1) {
+    assert(shape->point.x == -3 && shape->point.y == 7);
+  }
+  ++shapes->count;
+}
+
+static char const wkt_text_long[] =
+    "POINT (-3 7)\n"
+    "polygon ((0 0, 4 0, 4 4, 0 4, 0 0), (1 1, 1 3, 3 3, 3 1, 1 1))\n"
+    "MULTIPOLYGON(((0 0,1 0,1 1,0 0)),((5 5,6 5,6 6,5 5),(5 5,6 5,6 6,5 5)))\n"
+    "LINESTRING EMPTY";
+
+static void check_wkt_shapes_long(struct WktShapes_long const *shapes) {
+  assert(shapes->count == 4);
+  assert(shapes->types[0] == GEO_SHAPE_POINT && shapes->points_counts[0] == 1);
+  assert(shapes->types[1] == GEO_SHAPE_POLYGON && shapes->points_counts[1] == 10);
+  assert(shapes->parts_counts[1] == 2 && shapes->polygons_counts[1] == 1);
+  assert(shapes->closed && shapes->inside);
+  assert(shapes->types[2] == GEO_SHAPE_MULTI_POLYGON && shapes->parts_counts[2] == 3);
+  assert(shapes->polygons_counts[2] == 2 && shapes->points_counts[2] == 12);
+  assert(shapes->types[3] == GEO_SHAPE_LINE_STRING && shapes->points_counts[3] == 0);
+}
+
+void geo_wkt_parse_long_returns_geo_success_and_emits_every_shape(void) {
+  unsigned char buffer[4096];
+  struct GeoArena arena;
+  struct GeoWktParser_long parser;
+  struct WktShapes_long shapes;
+  memset(&shapes, 0, sizeof(shapes));
+  geo_arena_init(&arena, buffer, sizeof(buffer));
+  assert(geo_wkt_parser_init_long(&parser, &arena, collect_wkt_shape_long, &shapes) == GEO_SUCCESS);
+  assert(geo_wkt_parse_long(&parser, wkt_text_long, sizeof(wkt_text_long) - 1) == GEO_SUCCESS);
+  assert(geo_wkt_parse_finish_long(&parser) == GEO_SUCCESS);
+  check_wkt_shapes_long(&shapes);
+}
+
+void geo_wkt_parse_long_returns_geo_success_for_every_chunk_split(void) {
+  unsigned char buffer[4096];
+  struct GeoArena arena;
+  struct GeoWktParser_long parser;
+  struct WktShapes_long shapes;
+  size_t size = sizeof(wkt_text_long) - 1;
+  for (size_t split = 0; split <= size; ++split) {
+    memset(&shapes, 0, sizeof(shapes));
+    geo_arena_init(&arena, buffer, sizeof(buffer));
+    geo_wkt_parser_init_long(&parser, &arena, collect_wkt_shape_long, &shapes);
+    assert(geo_wkt_parse_long(&parser, wkt_text_long, split) == GEO_SUCCESS);
+    assert(geo_wkt_parse_long(&parser, wkt_text_long + split, size - split) == GEO_SUCCESS);
+    assert(geo_wkt_parse_finish_long(&parser) == GEO_SUCCESS);
+    check_wkt_shapes_long(&shapes);
+  }
+}
+
+void geo_wkt_parse_long_returns_geo_err_invalid_format_and_offset_for_malformed_text(void) {
+  unsigned char buffer[1024];
+  struct GeoArena arena;
+  struct GeoWktParser_long parser;
+  struct WktShapes_long shapes;
+  char const text[] = "POINT (-3 7) LINESTRING (1 2,, 3 4)";
+  memset(&shapes, 0, sizeof(shapes));
+  geo_arena_init(&arena, buffer, sizeof(buffer));
+  geo_wkt_parser_init_long(&parser, &arena, collect_wkt_shape_long, &shapes);
+  assert(geo_wkt_parse_long(&parser, text, sizeof(text) - 1) == GEO_ERR_INVALID_FORMAT);
+  assert(parser.offset == 29);
+  assert(geo_wkt_parse_finish_long(&parser) == GEO_ERR_INVALID_FORMAT);
+}
+
+void geo_wkt_parse_finish_long_returns_geo_err_invalid_format_when_shape_is_unterminated(void) {
+  unsigned char buffer[1024];
+  struct GeoArena arena;
+  struct GeoWktParser_long parser;
+  struct WktShapes_long shapes;
+  char const text[] = "POLYGON ((0 0, 4 0, 4 4, 0 0)";
+  memset(&shapes, 0, sizeof(shapes));
+  geo_arena_init(&arena, buffer, sizeof(buffer));
+  geo_wkt_parser_init_long(&parser, &arena, collect_wkt_shape_long, &shapes);
+  assert(geo_wkt_parse_long(&parser, text, sizeof(text) - 1) == GEO_SUCCESS);
+  assert(geo_wkt_parse_finish_long(&parser) == GEO_ERR_INVALID_FORMAT);
+  assert(shapes.count == 0);
+}
+
+void geo_wkt_parse_long_returns_geo_err_unsupported_for_z_coordinates(void) {
+  unsigned char buffer[1024];
+  struct GeoArena arena;
+  struct GeoWktParser_long parser;
+  struct WktShapes_long shapes;
+  char const text[] = "POINT (1 2 3)";
+  memset(&shapes, 0, sizeof(shapes));
+  geo_arena_init(&arena, buffer, sizeof(buffer));
+  geo_wkt_parser_init_long(&parser, &arena, collect_wkt_shape_long, &shapes);
+  assert(geo_wkt_parse_long(&parser, text, sizeof(text) - 1) == GEO_ERR_UNSUPPORTED);
+}
+
+void geo_wkt_parse_long_returns_geo_err_full_when_arena_is_too_small(void) {
+  unsigned char buffer[32];
+  struct GeoArena arena;
+  struct GeoWktParser_long parser;
+  struct WktShapes_long shapes;
+  memset(&shapes, 0, sizeof(shapes));
+  geo_arena_init(&arena, buffer, sizeof(buffer));
+  geo_wkt_parser_init_long(&parser, &arena, collect_wkt_shape_long, &shapes);
+  assert(geo_wkt_parse_long(&parser, wkt_text_long, sizeof(wkt_text_long) - 1) == GEO_ERR_FULL);
+}
+
+/*
+ *----------------------------------
+ * geo_json_parse_long tests
+ *----------------------------------
+ */
+struct JsonShapes_long {
+  size_t count;
+  enum GeoShapeType types[4];
+  size_t points_counts[4];
+  size_t parts_counts[4];
+  size_t polygons_counts[4];
+  long first_x[4];
+};
+
+static void collect_json_shape_long(void *context, struct GeoShape_long const *shape) {
+  struct JsonShapes_long *shapes = (struct JsonShapes_long *)context;
+  assert(shapes->count < 4);
+  shapes->types[shapes->count] = shape->type;
+  shapes->points_counts[shapes->count] = shape->points_count;
+  shapes->parts_counts[shapes->count] = shape->parts_count;
+  shapes->polygons_counts[shapes->count] = shape->polygons_count;
+  shapes->first_x[shapes->count] =
+      shape->parts_count > 0 ? shape->parts[0].segments[0]->start->x : shape->point.x;
+  ++shapes->count;
+}
+
+static char const json_text_long[] =
+    "{\"type\": \"FeatureCollection\", \"features\": [\n"
+    " {\"type\": \"Feature\", \"properties\": {\"name\": \"a \\\"type\\\"\", \"coordinates\": [9, 9],\n"
+    "  \"nested\": [{\"geometry\": null}, true, -1.5e3]},\n"
+    "  \"geometry\": {\"type\": \"Point\", \"coordinates\": [-3, 7, 100]}},\n"
+    " {\"type\": \"Feature\", \"geometry\": {\"coordinates\": [[[0, 0], [4, 0], [4, 4], [0, 4], [0, 0]],\n"
+    "  [[1, 1], [1, 3], [3, 3], [3, 1], [1, 1]]], \"type\": \"Polygon\"}, \"properties\": null},\n"
+    " {\"type\": \"Feature\", \"geometry\": null, \"properties\": {}},\n"
+    " {\"type\": \"Feature\", \"geometry\": {\"type\": \"MultiPolygon\", \"coordinates\": [\n"
+    "  [[[5, 5], [6, 5], [6, 6], [5, 5]]], [[[8, 8], [9, 8], [9, 9], [8, 8]]]]}},\n"
+    " {\"type\": \"Feature\", \"geometry\": {\"type\": \"LineString\", \"coordinates\": []}}\n"
+    "]}\n";
+
+static void check_json_shapes_long(struct JsonShapes_long const *shapes) {
+  assert(shapes->count == 4);
+  assert(shapes->types[0] == GEO_SHAPE_POINT && shapes->points_counts[0] == 1);
+  assert(shapes->first_x[0] == -3);
+  assert(shapes->types[1] == GEO_SHAPE_POLYGON && shapes->points_counts[1] == 10);
+  assert(shapes->parts_counts[1] == 2 && shapes->polygons_counts[1] == 1);
+  assert(shapes->types[2] == GEO_SHAPE_MULTI_POLYGON && shapes->parts_counts[2] == 2);
+  assert(shapes->polygons_counts[2] == 2 && shapes->first_x[2] == 5);
+  assert(shapes->types[3] == GEO_SHAPE_LINE_STRING && shapes->points_counts[3] == 0);
+}
+
+void geo_json_parse_long_returns_geo_success_and_emits_every_feature_geometry(void) {
+  unsigned char buffer[4096];
+  struct GeoArena arena;
+  struct GeoJsonParser_long parser;
+  struct JsonShapes_long shapes;
+  memset(&shapes, 0, sizeof(shapes));
+  geo_arena_init(&arena, buffer, sizeof(buffer));
+  assert(geo_json_parser_init_long(&parser, &arena, collect_json_shape_long, &shapes) == GEO_SUCCESS);
+  assert(geo_json_parse_long(&parser, json_text_long, sizeof(json_text_long) - 1) == GEO_SUCCESS);
+  assert(geo_json_parse_finish_long(&parser) == GEO_SUCCESS);
+  check_json_shapes_long(&shapes);
+}
+
+void geo_json_parse_long_returns_geo_success_for_every_chunk_split(void) {
+  unsigned char buffer[4096];
+  struct GeoArena arena;
+  struct GeoJsonParser_long parser;
+  struct JsonShapes_long shapes;
+  size_t size = sizeof(json_text_long) - 1;
+  for (size_t split = 0; split <= size; ++split) {
+    memset(&shapes, 0, sizeof(shapes));
+    geo_arena_init(&arena, buffer, sizeof(buffer));
+    geo_json_parser_init_long(&parser, &arena, collect_json_shape_long, &shapes);
+    assert(geo_json_parse_long(&parser, json_text_long, split) == GEO_SUCCESS);
+    assert(geo_json_parse_long(&parser, json_text_long + split, size - split) == GEO_SUCCESS);
+    assert(geo_json_parse_finish_long(&parser) == GEO_SUCCESS);
+    check_json_shapes_long(&shapes);
+  }
+}
+
+void geo_json_parse_long_returns_geo_success_for_bare_geometries_one_per_line(void) {
+  unsigned char buffer[1024];
+  struct GeoArena arena;
+  struct GeoJsonParser_long parser;
+  struct JsonShapes_long shapes;
+  char const text[] = "{\"type\":\"Point\",\"coordinates\":[1,2]}\n"
+                      "{\"type\":\"Feature\",\"geometry\":{\"type\":\"Point\",\"coordinates\":[3,4]}}\n";
+  memset(&shapes, 0, sizeof(shapes));
+  geo_arena_init(&arena, buffer, sizeof(buffer));
+  geo_json_parser_init_long(&parser, &arena, collect_json_shape_long, &shapes);
+  assert(geo_json_parse_long(&parser, text, sizeof(text) - 1) == GEO_SUCCESS);
+  assert(geo_json_parse_finish_long(&parser) == GEO_SUCCESS);
+  assert(shapes.count == 2 && shapes.first_x[0] == 1 && shapes.first_x[1] == 3);
+}
+
+void geo_json_parse_long_returns_geo_err_invalid_format_for_malformed_json(void) {
+  unsigned char buffer[1024];
+  struct GeoArena arena;
+  struct GeoJsonParser_long parser;
+  struct JsonShapes_long shapes;
+  char const *texts[] = {"{\"type\":\"Point\",\"coordinates\":[1,2],}",
+                         "{\"type\":\"Point\" \"coordinates\":[1,2]}",
+                         "{\"type\":\"Point\",\"coordinates\":[1,2]]",
+                         "{\"type\":\"Polygon\",\"coordinates\":[[1,2],[3,4]]}",
+                         "{\"type\":\"LineString\",\"coordinates\":[[1,2],[3,x]]}"};
+  for (size_t iter = 0; iter < sizeof(texts) / sizeof(texts[0]); ++iter) {
+    memset(&shapes, 0, sizeof(shapes));
+    geo_arena_init(&arena, buffer, sizeof(buffer));
+    geo_json_parser_init_long(&parser, &arena, collect_json_shape_long, &shapes);
+    assert(geo_json_parse_long(&parser, texts[iter], strlen(texts[iter])) == GEO_ERR_INVALID_FORMAT);
+    assert(shapes.count == 0);
+  }
+}
+
+void geo_json_parse_finish_long_returns_geo_err_invalid_format_when_json_is_truncated(void) {
+  unsigned char buffer[1024];
+  struct GeoArena arena;
+  struct GeoJsonParser_long parser;
+  struct JsonShapes_long shapes;
+  char const text[] = "{\"type\":\"Point\",\"coordinates\":[1,2]";
+  memset(&shapes, 0, sizeof(shapes));
+  geo_arena_init(&arena, buffer, sizeof(buffer));
+  geo_json_parser_init_long(&parser, &arena, collect_json_shape_long, &shapes);
+  assert(geo_json_parse_long(&parser, text, sizeof(text) - 1) == GEO_SUCCESS);
+  assert(geo_json_parse_finish_long(&parser) == GEO_ERR_INVALID_FORMAT);
+}
+
+void geo_json_parse_long_returns_geo_err_unsupported_for_geometry_collections(void) {
+  unsigned char buffer[1024];
+  struct GeoArena arena;
+  struct GeoJsonParser_long parser;
+  struct JsonShapes_long shapes;
+  char const text[] = "{\"type\":\"GeometryCollection\",\"geometries\":[]}";
+  memset(&shapes, 0, sizeof(shapes));
+  geo_arena_init(&arena, buffer, sizeof(buffer));
+  geo_json_parser_init_long(&parser, &arena, collect_json_shape_long, &shapes);
+  assert(geo_json_parse_long(&parser, text, sizeof(text) - 1) == GEO_ERR_UNSUPPORTED);
+}
+
+/*
+ *----------------------------------
+ * geo_index_compress_long tests
+ *----------------------------------
+ */
+void geo_index_ring_long_returns_geo_success_and_closed_ring_of_indexed_geometry(void) {
+  struct GeoPoint_long points[3][4];
+  struct GeoSegment_long segments[3][4];
+  struct GeoSegment_long *segment_pointers[3][4];
+  struct GeoGeometry_long geometries[3];
+  struct GeoGeometry_long *geometry_pointers[3];
+  struct GeoIndex_long index;
+  struct GeoRingView_long view;
+  struct GeoEnvelope_long envelope;
+  struct GeoPoint_long inside = {7, 2};
+  struct GeoPoint_long outside = {2, 2};
+  bool is_inside = false;
+  size_t size = 0;
+  void *buffer = NULL;
+  enum GeoResult result = 0;
+  make_join_squares_long(points, segments, segment_pointers, geometries, geometry_pointers, 3);
+  result = geo_index_build_size_long(geometry_pointers, 3, &size);
+  assert(result == GEO_SUCCESS);
+  buffer = malloc(size);
+  result = geo_index_build_long(geometry_pointers, 3, NULL, buffer, size);
+  assert(result == GEO_SUCCESS);
+  result = geo_index_open_long(&index, buffer, size);
+  assert(result == GEO_SUCCESS);
+  result = geo_index_ring_long(&index, 3, &view);
+  assert(result == GEO_ERR_OUT_OF_RANGE);
+  for (size_t iter = 0; iter < 3; ++iter) {
+    if (index.entries[iter].id == 1) {
+      result = geo_index_ring_long(&index, iter, &view);
+      assert(result == GEO_SUCCESS);
+    }
+  }
+  assert(view.points_count == 5);
+  result = geo_ring_view_is_closed_long(&view, &is_inside);
+  assert(result == GEO_SUCCESS);
+  assert(is_inside);
+  result = geo_ring_view_envelope_long(&view, &envelope);
+  assert(result == GEO_SUCCESS);
+  assert(envelope.min.x == 5 && envelope.max.x == 9);
+  result = geo_point_in_ring_view_long(&inside, &view, true, &is_inside);
+  assert(result == GEO_SUCCESS);
+  assert(is_inside);
+  result = geo_point_in_ring_view_long(&outside, &view, false, &is_inside);
+  assert(result == GEO_SUCCESS);
+  assert(!is_inside);
+  free(buffer);
+}
+
+void geo_index_compress_long_returns_geo_success_and_decompress_restores_original_file(void) {
+  struct GeoPoint_long points[30][4];
+  struct GeoSegment_long segments[30][4];
+  struct GeoSegment_long *segment_pointers[30][4];
+  struct GeoGeometry_long geometries[30];
+  struct GeoGeometry_long *geometry_pointers[30];
+  struct GeoIndex_long index;
+  size_t size = 0;
+  size_t compressed_size = 0;
+  size_t decompressed_size = 0;
+  void *buffer = NULL;
+  void *compressed = NULL;
+  void *decompressed = NULL;
+  enum GeoResult result = 0;
+  make_join_squares_long(points, segments, segment_pointers, geometries, geometry_pointers, 30);
+  result = geo_index_build_size_long(geometry_pointers, 30, &size);
+  assert(result == GEO_SUCCESS);
+  buffer = malloc(size);
+  result = geo_index_build_long(geometry_pointers, 30, NULL, buffer, size);
+  assert(result == GEO_SUCCESS);
+
+  result = geo_index_compress_long(buffer, size, NULL, 0, &compressed_size);
+  assert(result == GEO_ERR_TOO_SMALL);
+  assert(compressed_size < size);
+  compressed = malloc(compressed_size);
+  result = geo_index_compress_long(buffer, size, compressed, compressed_size, &compressed_size);
+  assert(result == GEO_SUCCESS);
+  result = geo_index_open_long(&index, compressed, compressed_size);
+  assert(result == GEO_ERR_UNSUPPORTED);
+  result = geo_index_compress_long(compressed, compressed_size, buffer, size, &decompressed_size);
+  assert(result == GEO_ERR_UNSUPPORTED);
+
+  result = geo_index_decompress_long(compressed, compressed_size, NULL, 0, &decompressed_size);
+  assert(result == GEO_ERR_TOO_SMALL);
+  assert(decompressed_size == size);
+  decompressed = malloc(decompressed_size);
+  result = geo_index_decompress_long(compressed, compressed_size, decompressed, decompressed_size, &decompressed_size);
+  assert(result == GEO_SUCCESS);
+  assert(memcmp(decompressed, buffer, size) == 0);
+  result = geo_index_decompress_long(buffer, size, decompressed, decompressed_size, &decompressed_size);
+  assert(result == GEO_ERR_INVALID_FORMAT);
+  free(decompressed);
+  free(compressed);
+  free(buffer);
+}
+
+void geo_index_decompress_long_returns_geo_err_invalid_format_when_points_section_is_truncated(void) {
+  struct GeoPoint_long points[2][4];
+  struct GeoSegment_long segments[2][4];
+  struct GeoSegment_long *segment_pointers[2][4];
+  struct GeoGeometry_long geometries[2];
+  struct GeoGeometry_long *geometry_pointers[2];
+  struct GeoIndexHeader *header = NULL;
+  size_t size = 0;
+  size_t compressed_size = 0;
+  size_t decompressed_size = 0;
+  void *buffer = NULL;
+  void *compressed = NULL;
+  void *decompressed = NULL;
+  enum GeoResult result = 0;
+  make_join_squares_long(points, segments, segment_pointers, geometries, geometry_pointers, 2);
+  result = geo_index_build_size_long(geometry_pointers, 2, &size);
+  assert(result == GEO_SUCCESS);
+  buffer = malloc(size);
+  result = geo_index_build_long(geometry_pointers, 2, NULL, buffer, size);
+  assert(result == GEO_SUCCESS);
+  compressed = malloc(size);
+  result = geo_index_compress_long(buffer, size, compressed, size, &compressed_size);
+  assert(result == GEO_SUCCESS);
+  header = compressed;
+  header->size = header->points_offset + 1;
+  decompressed = malloc(size);
+  result = geo_index_decompress_long(compressed, compressed_size, decompressed, size, &decompressed_size);
+  assert(result == GEO_ERR_INVALID_FORMAT);
+  free(decompressed);
+  free(compressed);
+  free(buffer);
+}
+
+/*
+ *----------------------------------
+ * geo_csv_read_points_long tests
+ *----------------------------------
+ */
+void geo_csv_read_points_long_returns_geo_success_and_columns_of_every_non_blank_line(void) {
+  char const text[] = "id,lat,lon\r\n1,2,3\r\n\r\n2, \"-4\" ,5\n3,6,-7";
+  long xs[3];
+  long ys[3];
+  size_t count = 0;
+  enum GeoResult result = geo_csv_read_points_long(text, sizeof(text) - 1, ',', 2, 1, true, NULL, NULL, NULL,
+                                                   0, &count);
+  assert(result == GEO_ERR_TOO_SMALL);
+  assert(count == 3);
+  result = geo_csv_read_points_long(text, sizeof(text) - 1, ',', 2, 1, true, NULL, xs, ys, 3, &count);
+  assert(result == GEO_SUCCESS);
+  assert(count == 3);
+  assert(xs[0] == 3 && ys[0] == 2);
+  assert(xs[1] == 5 && ys[1] == -4);
+  assert(xs[2] == -7 && ys[2] == 6);
+}
+
+void geo_csv_read_points_long_returns_geo_err_invalid_format_when_a_line_misses_a_column(void) {
+  char const text[] = "1\t2\n3\n";
+  char const bad_number[] = "1\tx\n";
+  long xs[2];
+  long ys[2];
+  size_t count = 0;
+  enum GeoResult result = geo_csv_read_points_long(text, sizeof(text) - 1, '\t', 0, 1, false, NULL, xs, ys, 2,
+                                                   &count);
+  assert(result == GEO_ERR_INVALID_FORMAT);
+  result = geo_csv_read_points_long(bad_number, sizeof(bad_number) - 1, '\t', 0, 1, false, NULL, xs, ys, 2,
+                                    &count);
+  assert(result == GEO_ERR_INVALID_FORMAT);
+}
+
+void geo_csv_read_points_long_returns_geo_success_and_points_in_file_order_when_using_multiple_threads(void) {
+  struct GeoPool pool;
+  struct GeoExecutor executor;
+  size_t lines = 100000;
+  char *text = malloc(lines * 16);
+  long *xs = malloc(lines * sizeof(long));
+  long *ys = malloc(lines * sizeof(long));
+  size_t size = 0;
+  size_t count = 0;
+  enum GeoResult result = 0;
+  for (size_t iter = 0; iter < lines; ++iter) {
+    size += (size_t)sprintf(text + size, "%d;%d\n", (int)iter, -(int)(iter % 1000));
+  }
+  result = geo_pool_init(&pool, 7);
+  assert(result == GEO_SUCCESS);
+  geo_pool_executor(&pool, &executor);
+  result = geo_csv_read_points_long(text, size, ';', 0, 1, false, &executor, xs, ys, lines, &count);
+  assert(result == GEO_SUCCESS);
+  assert(count == lines);
+  for (size_t iter = 0; iter < lines; ++iter) {
+    assert(xs[iter] == (long)iter);
+    assert(ys[iter] == -(long)(iter % 1000));
+  }
+  free(ys);
+  free(xs);
+  free(text);
+  geo_pool_destroy(&pool);
+}
+
+/*
+ *----------------------------------
+ * geo_points_soa_long tests
+ *----------------------------------
+ */
+void geo_convex_hull_soa_long_returns_geo_success_and_counterclockwise_hull_positions(void) {
+  /* a square with a point inside, one on an edge and a duplicate corner */
+  long xs[8] = {2, 0, 4, 1, 4, 0, 2, 4};
+  long ys[8] = {2, 0, 4, 3, 0, 4, 0, 4};
+  struct GeoPointsSoA_long points = {xs, ys, 8};
+  size_t convex_hull[8];
+  size_t convex_hull_size = 0;
+  enum GeoResult result = geo_convex_hull_soa_long(&points, NULL, NULL, convex_hull, &convex_hull_size);
+  assert(result == GEO_SUCCESS);
+  assert(convex_hull_size == 4);
+  assert(convex_hull[0] == 1);
+  assert(convex_hull[1] == 4);
+  assert(xs[convex_hull[2]] == 4 && ys[convex_hull[2]] == 4);
+  assert(convex_hull[3] == 5);
+  points.count = 2;
+  result = geo_convex_hull_soa_long(&points, NULL, NULL, convex_hull, &convex_hull_size);
+  assert(result == GEO_ERR_TOO_SMALL);
+}
+
+void geo_points_in_geometry_soa_long_returns_geo_success_and_same_answers_as_geo_point_in_geometry(void) {
+  struct GeoPoint_long corners[1][4];
+  struct GeoSegment_long segments[1][4];
+  struct GeoSegment_long *segment_pointers[1][4];
+  struct GeoGeometry_long geometries[1];
+  struct GeoGeometry_long *geometry_pointers[1];
+  /* a 21 x 21 grid around the square, more points than one block */
+  long xs[441];
+  long ys[441];
+  bool is_inside[441];
+  struct GeoPointsSoA_long points = {xs, ys, 441};
+  enum GeoResult result = 0;
+  make_join_squares_long(corners, segments, segment_pointers, geometries, geometry_pointers, 1);
+  for (size_t iter = 0; iter < 441; ++iter) {
+    xs[iter] = (long)(iter % 21) - 8;
+    ys[iter] = (long)(iter / 21) - 8;
+  }
+  for (int strict = 0; strict < 2; ++strict) {
+    result = geo_points_in_geometry_soa_long(&points, &geometries[0], strict, NULL, is_inside);
+    assert(result == GEO_SUCCESS);
+    for (size_t iter = 0; iter < 441; ++iter) {
+      struct GeoPoint_long point = {xs[iter], ys[iter]};
+      bool expected = false;
+      result = geo_point_in_geometry_long(&point, &geometries[0], strict, &expected);
+      assert(result == GEO_SUCCESS);
+      assert(is_inside[iter] == expected);
+    }
+  }
+  assert(is_inside[(10 * 21) + 10]);
+}
+
+void geo_squared_distance_soa_long_returns_geo_success_and_squared_distance_of_every_point(void) {
+  long xs[3] = {0, 3, -1};
+  long ys[3] = {0, 4, 2};
+  long distances[3];
+  struct GeoPointsSoA_long points = {xs, ys, 3};
+  struct GeoPoint_long point = {0, 0};
+  enum GeoResult result = geo_squared_distance_soa_long(&points, &point, distances);
+  assert(result == GEO_SUCCESS);
+  assert(distances[0] == 0);
+  assert(distances[1] == 25);
+  assert(distances[2] == 5);
+}
+
+/*
+ *----------------------------------
+ * geo_geometry_build_from_points_long tests
+ *----------------------------------
+ */
+void geo_geometry_build_from_points_long_returns_geo_success_and_geometry_in_one_arena_block(void) {
+  struct GeoPoint_long open[4] = {{0, 0}, {4, 0}, {4, 4}, {0, 4}};
+  struct GeoPoint_long closed[5] = {{0, 0}, {4, 0}, {4, 4}, {0, 4}, {0, 0}};
+  struct GeoPoint_long inside = {1, 1};
+  struct GeoGeometry_long geometry;
+  struct GeoArena arena;
+  unsigned char buffer[512];
+  size_t size = 0;
+  size_t used = 0;
+  bool is_true = false;
+  enum GeoResult result = geo_geometry_build_size_long(4, &size);
+  assert(result == GEO_SUCCESS);
+  assert(size <= sizeof(buffer));
+  geo_arena_init(&arena, buffer, sizeof(buffer));
+  result = geo_geometry_build_from_points_long(&arena, open, 4, &geometry);
+  assert(result == GEO_SUCCESS);
+  assert(arena.used <= size);
+  assert(geometry.segments_count == 4);
+  assert((unsigned char *)geometry.segments > buffer && (unsigned char *)geometry.segments < buffer + size);
+  assert(geometry.segments[3]->end == geometry.segments[0]->start);
+  assert(geo_geometry_is_closed_long(&geometry, &is_true) == GEO_SUCCESS && is_true);
+  assert(geo_geometry_is_simple_long(&geometry, &is_true) == GEO_SUCCESS && is_true);
+  assert(geo_point_in_geometry_long(&inside, &geometry, true, &is_true) == GEO_SUCCESS && is_true);
+
+  /* a closed input gives the same ring, reset reuses the block */
+  used = arena.used;
+  geo_arena_reset(&arena);
+  result = geo_geometry_build_from_points_long(&arena, closed, 5, &geometry);
+  assert(result == GEO_SUCCESS);
+  assert(arena.used == used);
+  assert(geometry.segments_count == 4);
+  assert(geometry.segments[3]->end->x == 0 && geometry.segments[3]->end->y == 0);
+}
+
+void geo_geometry_build_from_points_long_returns_geo_err_full_and_leaves_arena_when_it_does_not_fit(void) {
+  struct GeoPoint_long points[3] = {{0, 0}, {4, 0}, {4, 4}};
+  struct GeoGeometry_long geometry;
+  struct GeoArena arena;
+  unsigned char buffer[32];
+  enum GeoResult result = 0;
+  geo_arena_init(&arena, buffer, sizeof(buffer));
+  result = geo_geometry_build_from_points_long(&arena, points, 3, &geometry);
+  assert(result == GEO_ERR_FULL);
+  assert(arena.used == 0);
+  result = geo_geometry_build_from_points_long(&arena, points, 2, &geometry);
+  assert(result == GEO_ERR_TOO_SMALL);
+}
+
+/*
+ *----------------------------------
+ * geo_allocator_long tests
+ *----------------------------------
+ */
+struct CountingAllocator_long {
+  size_t allocations;
+  size_t outstanding;
+};
+
+static void *counting_allocate_long(void *context, size_t size) {
+  struct CountingAllocator_long *counting = context;
+  counting->allocations += 1;
+  counting->outstanding += size;
+  return malloc(size);
+}
+
+static void counting_release_long(void *context, void *memory, size_t size) {
+  struct CountingAllocator_long *counting = context;
+  counting->outstanding -= size;
+  free(memory);
+}
+
+void geo_spatial_join_count_long_returns_geo_err_null_pointer_when_allocator_has_no_functions(void) {
+  struct GeoPoint_long points[1] = {{0, 0}};
+  size_t counts[1] = {0};
+  struct GeoAllocator allocator = {NULL, NULL, NULL};
+  enum GeoResult result = geo_spatial_join_count_long(points, 1, NULL, 0, false, NULL, &allocator, counts);
+  assert(result == GEO_ERR_NULL_POINTER);
+}
+
+void geo_spatial_join_count_long_returns_geo_success_and_releases_everything_it_allocates(void) {
+  struct GeoPool pool;
+  struct GeoExecutor executor;
+  struct GeoPoint_long points[30][4];
+  struct GeoSegment_long segments[30][4];
+  struct GeoSegment_long *segment_pointers[30][4];
+  struct GeoGeometry_long geometries[30];
+  struct GeoGeometry_long *geometry_pointers[30];
+  struct GeoPoint_long queries[30];
+  size_t counts[30];
+  struct CountingAllocator_long counting = {0, 0};
+  struct GeoAllocator allocator = {counting_allocate_long, counting_release_long, NULL};
+  enum GeoResult result = 0;
+  allocator.context = &counting;
+  make_join_squares_long(points, segments, segment_pointers, geometries, geometry_pointers, 30);
+  for (size_t iter = 0; iter < 30; ++iter) {
+    queries[iter].x = (long)(iter * 5) + 2;
+    queries[iter].y = 2;
+  }
+  result = geo_pool_init(&pool, 2);
+  assert(result == GEO_SUCCESS);
+  geo_pool_executor(&pool, &executor);
+  result = geo_spatial_join_count_long(queries, 30, geometry_pointers, 30, true, &executor, &allocator, counts);
+  assert(result == GEO_SUCCESS);
+  for (size_t iter = 0; iter < 30; ++iter) {
+    assert(counts[iter] == 1);
+  }
+  assert(counting.allocations > 0);
+  assert(counting.outstanding == 0);
+  geo_pool_destroy(&pool);
+}
+
+void geo_convex_hull_soa_long_returns_geo_success_and_releases_everything_it_allocates(void) {
+  long xs[5] = {0, 4, 2, 4, 0};
+  long ys[5] = {0, 0, 2, 4, 4};
+  struct GeoPointsSoA_long points = {xs, ys, 5};
+  size_t convex_hull[5];
+  size_t convex_hull_size = 0;
+  struct CountingAllocator_long counting = {0, 0};
+  struct GeoAllocator allocator = {counting_allocate_long, counting_release_long, NULL};
+  enum GeoResult result = 0;
+  allocator.context = &counting;
+  result = geo_convex_hull_soa_long(&points, NULL, &allocator, convex_hull, &convex_hull_size);
+  assert(result == GEO_SUCCESS);
+  assert(convex_hull_size == 4);
+  assert(counting.allocations == 1);
+  assert(counting.outstanding == 0);
+}
+
+/*
+ *----------------------------------
+ * geo_stats long tests
+ *----------------------------------
+ */
+#ifdef GEO_STATS
+static void square_geometry_long(struct GeoPoint_long *corners, struct GeoSegment_long *segments,
+                                 struct GeoSegment_long **pointers, struct GeoGeometry_long *geometry) {
+  struct GeoPoint_long const square[4] = {{0, 0}, {4, 0}, {4, 4}, {0, 4}};
+  for (size_t iter = 0; iter < 4; ++iter) {
+    corners[iter] = square[iter];
+  }
+  for (size_t iter = 0; iter < 4; ++iter) {
+    segments[iter].start = &corners[iter];
+    segments[iter].end = &corners[(iter + 1) % 4];
+    pointers[iter] = &segments[iter];
+  }
+  geometry->segments = pointers;
+  geometry->segments_count = 4;
+}
+
+void geo_stats_snapshot_returns_geo_err_null_pointer_when_stats_is_null_long(void) {
+  enum GeoResult result = geo_stats_snapshot(NULL);
+  assert(result == GEO_ERR_NULL_POINTER);
+}
+
+void geo_segments_intersect_long_counts_one_call_and_four_orientations_when_segments_cross(void) {
+  struct GeoPoint_long start1 = {0, 0};
+  struct GeoPoint_long end1 = {2, 2};
+  struct GeoPoint_long start2 = {0, 2};
+  struct GeoPoint_long end2 = {2, 0};
+  struct GeoSegment_long segment1 = {&start1, &end1};
+  struct GeoSegment_long segment2 = {&start2, &end2};
+  struct GeoStats stats;
+  size_t intersections = 0;
+  geo_stats_reset();
+  enum GeoResult result = geo_segments_intersect_long(&segment1, &segment2, &intersections);
+  assert(result == GEO_SUCCESS);
+  assert(intersections == 1);
+  result = geo_stats_snapshot(&stats);
+  assert(result == GEO_SUCCESS);
+  assert(stats.segments_intersect_calls == 1);
+  assert(stats.orientation_calls == 4);
+  assert(stats.orientation_colinear == 0);
+}
+
+void geo_point_in_geometry_long_counts_one_call_and_every_edge_when_point_is_inside(void) {
+  struct GeoPoint_long corners[4];
+  struct GeoSegment_long segments[4];
+  struct GeoSegment_long *pointers[4];
+  struct GeoGeometry_long geometry;
+  struct GeoPoint_long point = {1, 1};
+  struct GeoStats stats;
+  bool is_inside = false;
+  square_geometry_long(corners, segments, pointers, &geometry);
+  geo_stats_reset();
+  enum GeoResult result = geo_point_in_geometry_long(&point, &geometry, true, &is_inside);
+  assert(result == GEO_SUCCESS);
+  assert(is_inside);
+  geo_stats_snapshot(&stats);
+  assert(stats.point_in_polygon_calls == 1);
+  assert(stats.point_in_polygon_edges == 4);
+}
+
+void geo_geometry_is_simple_long_counts_every_segment_pair_when_geometry_is_simple(void) {
+  struct GeoPoint_long corners[4];
+  struct GeoSegment_long segments[4];
+  struct GeoSegment_long *pointers[4];
+  struct GeoGeometry_long geometry;
+  struct GeoStats stats;
+  bool is_simple = false;
+  square_geometry_long(corners, segments, pointers, &geometry);
+  geo_stats_reset();
+  enum GeoResult result = geo_geometry_is_simple_long(&geometry, &is_simple);
+  assert(result == GEO_SUCCESS);
+  assert(is_simple);
+  geo_stats_snapshot(&stats);
+  assert(stats.is_simple_calls == 1);
+  assert(stats.is_simple_pairs == 6);
+  assert(stats.segments_intersect_calls == 6);
+}
+
+void geo_convex_hull_long_counts_one_call_and_its_comparisons(void) {
+  struct GeoPoint_long point1 = {0, 0};
+  struct GeoPoint_long point2 = {4, 0};
+  struct GeoPoint_long point3 = {4, 4};
+  struct GeoPoint_long point4 = {0, 4};
+  struct GeoPoint_long point5 = {2, 2};
+  struct GeoPoint_long *points[5] = {&point3, &point5, &point1, &point4, &point2};
+  struct GeoPoint_long *hull[5];
+  size_t hull_size = 0;
+  struct GeoStats stats;
+  geo_stats_reset();
+  enum GeoResult result = geo_convex_hull_long(points, hull, 5, &hull_size);
+  assert(result == GEO_SUCCESS);
+  assert(hull_size == 4);
+  geo_stats_snapshot(&stats);
+  assert(stats.convex_hull_calls == 1);
+  assert(stats.convex_hull_comparisons > 0);
+}
+
+void geo_stats_reset_long_zeroes_every_counter(void) {
+  struct GeoPoint_long corners[4];
+  struct GeoSegment_long segments[4];
+  struct GeoSegment_long *pointers[4];
+  struct GeoGeometry_long geometry;
+  struct GeoStats stats;
+  struct GeoStats zero;
+  bool is_simple = false;
+  memset(&zero, 0, sizeof(zero));
+  square_geometry_long(corners, segments, pointers, &geometry);
+  geo_geometry_is_simple_long(&geometry, &is_simple);
+  enum GeoResult result = geo_stats_reset();
+  assert(result == GEO_SUCCESS);
+  geo_stats_snapshot(&stats);
+  assert(memcmp(&stats, &zero, sizeof(stats)) == 0);
+}
+#endif
+
+/*
+ *----------------------------------
+ * geo_trace long tests
+ *----------------------------------
+ */
+#ifdef GEO_TRACE
+struct TraceRecord_long {
+  size_t calls;
+  enum GeoTraceFunction function;
+  size_t size;
+};
+
+static void record_trace_long(void *context, enum GeoTraceFunction function, size_t size, uint64_t cycles) {
+  struct TraceRecord_long *record = context;
+  (void)cycles;
+  record->calls += 1;
+  record->function = function;
+  record->size = size;
+}
+
+void geo_trace_set_returns_geo_err_null_pointer_when_trace_is_null_long(void) {
+  struct GeoTracer tracer = {NULL, NULL};
+  enum GeoResult result = geo_trace_set(&tracer);
+  assert(result == GEO_ERR_NULL_POINTER);
+}
+
+void geo_point_in_geometry_long_reports_one_call_with_segments_count_when_traced(void) {
+  struct GeoPoint_long corners[4] = {{0, 0}, {4, 0}, {4, 4}, {0, 4}};
+  struct GeoSegment_long segments[4];
+  struct GeoSegment_long *pointers[4];
+  struct GeoGeometry_long geometry = {pointers, 4};
+  struct GeoPoint_long point = {1, 1};
+  struct TraceRecord_long record = {0, GEO_TRACE_FUNCTIONS_COUNT, 0};
+  struct GeoTracer tracer = {record_trace_long, NULL};
+  bool is_inside = false;
+  for (size_t iter = 0; iter < 4; ++iter) {
+    segments[iter].start = &corners[iter];
+    segments[iter].end = &corners[(iter + 1) % 4];
+    pointers[iter] = &segments[iter];
+  }
+  tracer.context = &record;
+  geo_trace_set(&tracer);
+  enum GeoResult result = geo_point_in_geometry_long(&point, &geometry, true, &is_inside);
+  geo_trace_set(NULL);
+  assert(result == GEO_SUCCESS);
+  assert(is_inside);
+  assert(record.calls == 1);
+  assert(record.function == GEO_TRACE_POINT_IN_GEOMETRY);
+  assert(record.size == 4);
+}
+
+void geo_geometry_is_simple_long_reports_only_the_outer_call_when_traced(void) {
+  struct GeoPoint_long corners[4] = {{0, 0}, {4, 0}, {4, 4}, {0, 4}};
+  struct GeoSegment_long segments[4];
+  struct GeoSegment_long *pointers[4];
+  struct GeoGeometry_long geometry = {pointers, 4};
+  struct TraceRecord_long record = {0, GEO_TRACE_FUNCTIONS_COUNT, 0};
+  struct GeoTracer tracer = {record_trace_long, NULL};
+  bool is_simple = false;
+  for (size_t iter = 0; iter < 4; ++iter) {
+    segments[iter].start = &corners[iter];
+    segments[iter].end = &corners[(iter + 1) % 4];
+    pointers[iter] = &segments[iter];
+  }
+  tracer.context = &record;
+  geo_trace_set(&tracer);
+  enum GeoResult result = geo_geometry_is_simple_long(&geometry, &is_simple);
+  geo_trace_set(NULL);
+  assert(result == GEO_SUCCESS);
+  assert(is_simple);
+  assert(record.calls == 1);
+  assert(record.function == GEO_TRACE_GEOMETRY_IS_SIMPLE);
+  assert(strcmp(geo_trace_function_name(record.function), "geo_geometry_is_simple") == 0);
+}
+
+void geo_segments_intersect_long_reports_nothing_when_tracer_is_removed(void) {
+  struct GeoPoint_long start1 = {0, 0};
+  struct GeoPoint_long end1 = {2, 2};
+  struct GeoPoint_long start2 = {0, 2};
+  struct GeoPoint_long end2 = {2, 0};
+  struct GeoSegment_long segment1 = {&start1, &end1};
+  struct GeoSegment_long segment2 = {&start2, &end2};
+  struct TraceRecord_long record = {0, GEO_TRACE_FUNCTIONS_COUNT, 0};
+  struct GeoTracer tracer = {record_trace_long, NULL};
+  size_t intersections = 0;
+  tracer.context = &record;
+  geo_trace_set(&tracer);
+  geo_segments_intersect_long(&segment1, &segment2, &intersections);
+  assert(record.calls == 1);
+  assert(record.size == 2);
+  geo_trace_set(NULL);
+  geo_segments_intersect_long(&segment1, &segment2, &intersections);
+  assert(record.calls == 1);
+}
+#endif
+
+/*
+ *----------------------------------
+ * geo_simd_select_long tests
+ *----------------------------------
+ */
+void geo_simd_select_long_returns_geo_err_unsupported_when_level_is_above_geo_simd_level(void) {
+  enum GeoSimdLevel level = GEO_SIMD_GENERIC;
+  enum GeoResult result = geo_simd_level(&level);
+  assert(result == GEO_SUCCESS);
+  result = geo_simd_select_long((enum GeoSimdLevel)(level + 1));
+  assert(result == GEO_ERR_UNSUPPORTED);
+}
+
+void geo_simd_select_long_gives_the_same_soa_answers_at_every_supported_level(void) {
+  struct GeoPoint_long corners[4] = {{0, 0}, {4, 0}, {4, 4}, {0, 4}};
+  struct GeoSegment_long segments[4];
+  struct GeoSegment_long *pointers[4];
+  struct GeoGeometry_long geometry = {pointers, 4};
+  struct GeoPoint_long origin = {1, 2};
+  /* a 21 x 21 grid around the square, more points than one block */
+  long xs[441];
+  long ys[441];
+  long distances[441];
+  bool is_inside[441];
+  struct GeoPointsSoA_long points = {xs, ys, 441};
+  enum GeoSimdLevel supported = GEO_SIMD_GENERIC;
+  enum GeoResult result = geo_simd_level(&supported);
+  assert(result == GEO_SUCCESS);
+  for (size_t iter = 0; iter < 4; ++iter) {
+    segments[iter].start = &corners[iter];
+    segments[iter].end = &corners[(iter + 1) % 4];
+    pointers[iter] = &segments[iter];
+  }
+  for (size_t iter = 0; iter < 441; ++iter) {
+    xs[iter] = (long)((int)(iter % 21) - 8);
+    ys[iter] = (long)((int)(iter / 21) - 8);
+  }
+  for (int level = GEO_SIMD_GENERIC; level <= (int)supported; ++level) {
+    result = geo_simd_select_long((enum GeoSimdLevel)level);
+    assert(result == GEO_SUCCESS);
+    result = geo_points_in_geometry_soa_long(&points, &geometry, false, NULL, is_inside);
+    assert(result == GEO_SUCCESS);
+    result = geo_squared_distance_soa_long(&points, &origin, distances);
+    assert(result == GEO_SUCCESS);
+    for (size_t iter = 0; iter < 441; ++iter) {
+      struct GeoPoint_long point = {xs[iter], ys[iter]};
+      long diff_x = xs[iter] - origin.x;
+      long diff_y = ys[iter] - origin.y;
+      bool expected = false;
+      result = geo_point_in_geometry_long(&point, &geometry, false, &expected);
+      assert(result == GEO_SUCCESS);
+      assert(is_inside[iter] == expected);
+      assert(!(distances[iter] < (diff_x * diff_x) + (diff_y * diff_y)) &&
+             !(distances[iter] > (diff_x * diff_x) + (diff_y * diff_y)));
+    }
+  }
+  geo_simd_select_long(supported);
+}
+
+/*
+ *----------------------------------
+ * GeoExecutor long tests
+ *----------------------------------
+ */
+static bool refusing_submit_long(void *context, void (*job)(void *argument), void *argument) {
+  (void)context;
+  (void)job;
+  (void)argument;
+  return false;
+}
+
+/*
+ * a comb of `teeth` points along the top, alternating between y 0 and 2,
+ * closed along y -10. `coordinates` holds the closed ring as x, y pairs.
+ */
+static void make_comb_long(size_t teeth, struct GeoPoint_long *points, struct GeoSegment_long *segments,
+                             struct GeoSegment_long **segment_pointers, struct GeoGeometry_long *geometry,
+                             long *coordinates) {
+  size_t const count = teeth + 2;
+  for (size_t iter = 0; iter < teeth; ++iter) {
+    points[iter].x = (long)(iter * 2);
+    points[iter].y = (long)((iter % 2) * 2);
+  }
+  points[teeth].x = (long)((teeth - 1) * 2);
+  points[teeth].y = -10;
+  points[teeth + 1].x = 0;
+  points[teeth + 1].y = -10;
+  for (size_t iter = 0; iter < count; ++iter) {
+    segments[iter].start = &points[iter];
+    segments[iter].end = &points[(iter + 1) % count];
+    segment_pointers[iter] = &segments[iter];
+  }
+  geometry->segments = segment_pointers;
+  geometry->segments_count = count;
+  for (size_t iter = 0; iter <= count; ++iter) {
+    coordinates[iter * 2] = points[iter % count].x;
+    coordinates[(iter * 2) + 1] = points[iter % count].y;
+  }
+}
+
+void geo_points_in_geometry_soa_long_returns_geo_success_and_same_answers_with_an_executor(void) {
+  struct GeoPoint_long corners[1][4];
+  struct GeoSegment_long segments[1][4];
+  struct GeoSegment_long *segment_pointers[1][4];
+  struct GeoGeometry_long geometries[1];
+  struct GeoGeometry_long *geometry_pointers[1];
+  struct GeoPool pool;
+  struct GeoExecutor executor;
+  struct GeoExecutor refusing = {refusing_submit_long, NULL, 8};
+  size_t const count = 40000;
+  long *xs = malloc(count * sizeof(long));
+  long *ys = malloc(count * sizeof(long));
+  bool *serial = malloc(count * sizeof(bool));
+  bool *parallel = malloc(count * sizeof(bool));
+  struct GeoPointsSoA_long points = {xs, ys, count};
+  enum GeoResult result = 0;
+  make_join_squares_long(corners, segments, segment_pointers, geometries, geometry_pointers, 1);
+  for (size_t iter = 0; iter < count; ++iter) {
+    xs[iter] = (long)(iter % 200) - 100;
+    ys[iter] = (long)(iter / 200) - 100;
+  }
+  result = geo_pool_init(&pool, 3);
+  assert(result == GEO_SUCCESS);
+  geo_pool_executor(&pool, &executor);
+  assert(executor.concurrency == 4);
+  result = geo_points_in_geometry_soa_long(&points, &geometries[0], false, NULL, serial);
+  assert(result == GEO_SUCCESS);
+  result = geo_points_in_geometry_soa_long(&points, &geometries[0], false, &executor, parallel);
+  assert(result == GEO_SUCCESS);
+  assert(memcmp(serial, parallel, count * sizeof(bool)) == 0);
+  memset(parallel, 0, count * sizeof(bool));
+  result = geo_points_in_geometry_soa_long(&points, &geometries[0], false, &refusing, parallel);
+  assert(result == GEO_SUCCESS);
+  assert(memcmp(serial, parallel, count * sizeof(bool)) == 0);
+  geo_pool_destroy(&pool);
+  free(parallel);
+  free(serial);
+  free(ys);
+  free(xs);
+}
+
+void geo_convex_hull_soa_long_returns_geo_success_and_same_hull_with_an_executor(void) {
+  struct GeoPool pool;
+  struct GeoExecutor executor;
+  size_t const count = 50000;
+  long *xs = malloc(count * sizeof(long));
+  long *ys = malloc(count * sizeof(long));
+  size_t *serial = malloc(count * sizeof(size_t));
+  size_t *parallel = malloc(count * sizeof(size_t));
+  struct GeoPointsSoA_long points = {xs, ys, count};
+  size_t serial_size = 0;
+  size_t parallel_size = 0;
+  uint64_t seed = 42;
+  enum GeoResult result = 0;
+  /* duplicates and colinear points included */
+  for (size_t iter = 0; iter < count; ++iter) {
+    seed = (seed * 6364136223846793005ULL) + 1442695040888963407ULL;
+    xs[iter] = (long)((seed >> 33) % 1000);
+    ys[iter] = (long)((seed >> 13) % 1000);
+  }
+  result = geo_pool_init(&pool, 7);
+  assert(result == GEO_SUCCESS);
+  geo_pool_executor(&pool, &executor);
+  result = geo_convex_hull_soa_long(&points, NULL, NULL, serial, &serial_size);
+  assert(result == GEO_SUCCESS);
+  result = geo_convex_hull_soa_long(&points, &executor, NULL, parallel, &parallel_size);
+  assert(result == GEO_SUCCESS);
+  assert(serial_size >= 3);
+  assert(parallel_size == serial_size);
+  /* duplicate points may give a different position for the same vertex */
+  for (size_t iter = 0; iter < serial_size; ++iter) {
+    assert(xs[serial[iter]] == xs[parallel[iter]]);
+    assert(ys[serial[iter]] == ys[parallel[iter]]);
+  }
+  geo_pool_destroy(&pool);
+  free(parallel);
+  free(serial);
+  free(ys);
+  free(xs);
+}
+
+void geo_geometry_is_simple_parallel_long_returns_geo_success_and_same_answers_with_an_executor(void) {
+  size_t const teeth = 600;
+  struct GeoPoint_long *points = malloc((teeth + 2) * sizeof(struct GeoPoint_long));
+  struct GeoSegment_long *segments = malloc((teeth + 2) * sizeof(struct GeoSegment_long));
+  struct GeoSegment_long **segment_pointers = malloc((teeth + 2) * sizeof(struct GeoSegment_long *));
+  long *coordinates = malloc((teeth + 3) * 2 * sizeof(long));
+  struct GeoGeometry_long geometry;
+  struct GeoRingView_long view;
+  struct GeoPool pool;
+  struct GeoExecutor executor;
+  struct GeoExecutor refusing = {refusing_submit_long, NULL, 8};
+  bool is_simple = false;
+  enum GeoResult result = 0;
+  make_comb_long(teeth, points, segments, segment_pointers, &geometry, coordinates);
+  view.coordinates = coordinates;
+  view.points_count = teeth + 3;
+  result = geo_pool_init(&pool, 3);
+  assert(result == GEO_SUCCESS);
+  geo_pool_executor(&pool, &executor);
+  result = geo_geometry_is_simple_long(&geometry, &is_simple);
+  assert(result == GEO_SUCCESS);
+  assert(is_simple);
+  is_simple = false;
+  result = geo_geometry_is_simple_parallel_long(&geometry, &executor, &is_simple);
+  assert(result == GEO_SUCCESS);
+  assert(is_simple);
+  is_simple = false;
+  result = geo_geometry_is_simple_parallel_long(&geometry, &refusing, &is_simple);
+  assert(result == GEO_SUCCESS);
+  assert(is_simple);
+  is_simple = false;
+  result = geo_ring_view_is_simple_parallel_long(&view, &executor, &is_simple);
+  assert(result == GEO_SUCCESS);
+  assert(is_simple);
+  /* a tooth in the middle pushed through the bottom edge */
+  points[teeth / 2].y = -20;
+  coordinates[((teeth / 2) * 2) + 1] = -20;
+  result = geo_geometry_is_simple_long(&geometry, &is_simple);
+  assert(result == GEO_SUCCESS);
+  assert(!is_simple);
+  is_simple = true;
+  result = geo_geometry_is_simple_parallel_long(&geometry, &executor, &is_simple);
+  assert(result == GEO_SUCCESS);
+  assert(!is_simple);
+  is_simple = true;
+  result = geo_ring_view_is_simple_parallel_long(&view, &executor, &is_simple);
+  assert(result == GEO_SUCCESS);
+  assert(!is_simple);
+  geometry.segments[teeth / 2]->end = NULL;
+  result = geo_geometry_is_simple_parallel_long(&geometry, &executor, &is_simple);
+  assert(result == GEO_ERR_NULL_POINTER);
+  geo_pool_destroy(&pool);
+  free(coordinates);
+  free(segment_pointers);
+  free(segments);
+  free(points);
+}
+
+void geo_index_build_long_writes_the_same_bytes_with_an_executor(void) {
+  size_t const count = 10000;
+  struct GeoPoint_long (*points)[4] = malloc(count * sizeof(*points));
+  struct GeoSegment_long (*segments)[4] = malloc(count * sizeof(*segments));
+  struct GeoSegment_long *(*segment_pointers)[4] = malloc(count * sizeof(*segment_pointers));
+  struct GeoGeometry_long *geometries = malloc(count * sizeof(struct GeoGeometry_long));
+  struct GeoGeometry_long **geometry_pointers = malloc(count * sizeof(struct GeoGeometry_long *));
+  struct GeoPool pool;
+  struct GeoExecutor executor;
+  size_t size = 0;
+  void *serial = NULL;
+  void *parallel = NULL;
+  enum GeoResult result = 0;
+  make_join_squares_long(points, segments, segment_pointers, geometries, geometry_pointers, count);
+  result = geo_index_build_size_long(geometry_pointers, count, &size);
+  assert(result == GEO_SUCCESS);
+  serial = malloc(size);
+  parallel = malloc(size);
+  result = geo_pool_init(&pool, 3);
+  assert(result == GEO_SUCCESS);
+  geo_pool_executor(&pool, &executor);
+  result = geo_index_build_long(geometry_pointers, count, NULL, serial, size);
+  assert(result == GEO_SUCCESS);
+  result = geo_index_build_long(geometry_pointers, count, &executor, parallel, size);
+  assert(result == GEO_SUCCESS);
+  assert(memcmp(serial, parallel, size) == 0);
+  geo_pool_destroy(&pool);
+  free(parallel);
+  free(serial);
+  free(geometry_pointers);
+  free(geometries);
+  free(segment_pointers);
+  free(segments);
+  free(points);
+}
+
+void geo_points_in_geometry_soa_long_and_other_executor_functions_return_geo_err_null_pointer_when_submit_is_null(void) {
+  struct GeoPoint_long corners[1][4];
+  struct GeoSegment_long segments[1][4];
+  struct GeoSegment_long *segment_pointers[1][4];
+  struct GeoGeometry_long geometries[1];
+  struct GeoGeometry_long *geometry_pointers[1];
+  struct GeoExecutor const executor = {NULL, NULL, 4};
+  long xs[4] = {0, 1, 2, 3};
+  long ys[4] = {3, 0, 1, 2};
+  long coordinates[10] = {0, 0, 4, 0, 4, 4, 0, 4, 0, 0};
+  struct GeoPointsSoA_long points = {xs, ys, 4};
+  struct GeoRingView_long view = {coordinates, 5};
+  struct GeoPoint_long point = {1, 1};
+  uint64_t keys[1] = {0};
+  size_t hull[4];
+  size_t count = 0;
+  size_t counts[1];
+  bool flags[4];
+  unsigned char buffer[1024];
+  char const text[] = "1,2\n";
+  make_join_squares_long(corners, segments, segment_pointers, geometries, geometry_pointers, 1);
+  assert(geo_points_in_geometry_soa_long(&points, &geometries[0], false, &executor, flags) == GEO_ERR_NULL_POINTER);
+  assert(geo_convex_hull_soa_long(&points, &executor, NULL, hull, &count) == GEO_ERR_NULL_POINTER);
+  assert(geo_geometry_is_simple_parallel_long(&geometries[0], &executor, flags) == GEO_ERR_NULL_POINTER);
+  assert(geo_ring_view_is_simple_parallel_long(&view, &executor, flags) == GEO_ERR_NULL_POINTER);
+  assert(geo_sort_points_by_key_long(&point, keys, 1, &executor) == GEO_ERR_NULL_POINTER);
+  assert(geo_sort_geometries_by_key_long(geometry_pointers, keys, 1, &executor) == GEO_ERR_NULL_POINTER);
+  assert(geo_index_build_long(geometry_pointers, 1, &executor, buffer, sizeof(buffer)) == GEO_ERR_NULL_POINTER);
+  assert(geo_spatial_join_count_long(&point, 1, geometry_pointers, 1, false, &executor, NULL, counts) ==
+         GEO_ERR_NULL_POINTER);
+  assert(geo_spatial_join_long(&point, 1, geometry_pointers, 1, false, &executor, NULL, NULL, 0, &count) ==
+         GEO_ERR_NULL_POINTER);
+  assert(geo_csv_read_points_long(text, sizeof(text) - 1, ',', 0, 1, false, &executor, xs, ys, 4, &count) ==
+         GEO_ERR_NULL_POINTER);
+}
+
+void geo_convex_hull_soa_long_returns_geo_success_and_stays_inside_a_hull_buffer_of_every_point(void) {
+  /* the upper chain pushes (1, 0) before (0, 1) pops it again */
+  long xs[3] = {0, 1, 2};
+  long ys[3] = {1, 0, 1};
+  struct GeoPointsSoA_long points = {xs, ys, 3};
+  size_t *convex_hull = malloc(3 * sizeof(size_t));
+  size_t convex_hull_size = 0;
+  enum GeoResult result = geo_convex_hull_soa_long(&points, NULL, NULL, convex_hull, &convex_hull_size);
+  assert(result == GEO_SUCCESS);
+  assert(convex_hull_size == 3);
+  assert(convex_hull[0] == 0);
+  assert(convex_hull[1] == 1);
+  assert(convex_hull[2] == 2);
+  free(convex_hull);
+}
+
+void geo_convex_hull_soa_long_returns_geo_success_and_keeps_every_part_in_its_own_chain(void) {
+  struct GeoPool pool;
+  struct GeoExecutor executor;
+  size_t const count = 16384;
+  long *xs = malloc(count * sizeof(long));
+  long *ys = malloc(count * sizeof(long));
+  size_t *convex_hull = malloc(count * sizeof(size_t));
+  struct GeoPointsSoA_long points = {xs, ys, count};
+  size_t convex_hull_size = 0;
+  enum GeoResult result = 0;
+  /* every part of 4096 is the same parabola so its lower chain is the whole part */
+  for (size_t iter = 0; iter < count; ++iter) {
+    xs[iter] = (long)(iter % 4096);
+    ys[iter] = (long)((iter % 4096) * (iter % 4096));
+  }
+  result = geo_pool_init(&pool, 3);
+  assert(result == GEO_SUCCESS);
+  geo_pool_executor(&pool, &executor);
+  assert(executor.concurrency == 4);
+  result = geo_convex_hull_soa_long(&points, &executor, NULL, convex_hull, &convex_hull_size);
+  assert(result == GEO_SUCCESS);
+  assert(convex_hull_size == 4096);
+  for (size_t iter = 0; iter < convex_hull_size; ++iter) {
+    assert(xs[convex_hull[iter]] == (long)iter);
+  }
+  geo_pool_destroy(&pool);
+  free(convex_hull);
+  free(ys);
+  free(xs);
+}
+
 int main(void) {
   /* geo_points_equal_long tests */
   geo_points_equal_long_returns_geo_err_null_pointer_result_code_when_lhs_is_null();
@@ -2256,6 +4232,117 @@ int main(void) {
   geo_convex_hull_long_returns_geo_success_and_sets_hull_size_to_5_and_hull_has_points_in_ccw_order_when_given_point_cloud();
   geo_convex_hull_long_returns_geo_success_and_sets_hull_size_to_4_and_hull_has_points_in_ccw_order_using_furthest_colinear_point_when_given_point_cloud_with_colinear_points();
   geo_convex_hull_long_with_30_points_returns_geo_success_and_sets_hull_size_to_12_and_hull_has_points_in_ccw_order();
+  geo_convex_hull_long_returns_geo_success_and_sets_hull_size_to_4_when_start_point_is_repeated();
+  geo_convex_hull_long_returns_geo_success_and_leaves_out_the_start_point_repeated_before_a_left_turn();
+
+  /* geo_grid_long tests */
+  geo_grid_init_long_returns_geo_err_null_pointer_when_grid_is_null();
+  geo_grid_init_long_returns_geo_err_too_small_when_slots_count_is_not_a_power_of_2();
+  geo_grid_init_long_returns_geo_err_out_of_range_when_cell_size_is_not_positive();
+  geo_grid_insert_long_returns_geo_err_out_of_range_when_id_is_not_less_than_objects_count();
+  geo_grid_insert_long_returns_geo_success_and_inserted_set_to_false_when_id_is_already_present();
+  geo_grid_query_radius_long_returns_geo_success_and_only_ids_within_radius();
+  geo_grid_query_radius_long_returns_geo_success_and_ids_count_larger_than_capacity_when_ids_is_too_small();
+  geo_grid_move_long_returns_geo_success_and_object_is_only_found_at_new_position();
+  geo_grid_move_long_returns_geo_success_and_moved_set_to_false_when_id_is_not_present();
+  geo_grid_move_long_returns_geo_err_full_when_no_slot_is_free();
+  geo_grid_remove_long_returns_geo_success_and_object_is_no_longer_found();
+  geo_grid_query_geometry_long_returns_geo_success_and_only_ids_inside_geometry();
+
+  /* geo_geometry_envelope_long tests */
+  geo_geometry_envelope_long_returns_geo_err_null_pointer_when_geometry_is_null();
+  geo_geometry_envelope_long_returns_geo_success_and_sets_min_and_max_of_all_points();
+
+  /* geo_morton_key_long and geo_hilbert_key_long tests */
+  geo_morton_key_long_returns_geo_err_out_of_range_when_envelope_max_is_less_than_min();
+  geo_morton_key_long_returns_geo_success_and_interleaves_x_and_y_bits();
+  geo_morton_key_long_returns_geo_success_and_clamps_points_outside_envelope();
+  geo_hilbert_key_long_returns_geo_success_and_visits_quadrants_in_curve_order();
+
+  /* geo_sort_points_by_key_long and geo_sort_geometries_by_key_long tests */
+  geo_sort_points_by_key_long_returns_geo_err_null_pointer_when_keys_is_null();
+  geo_sort_points_by_key_long_returns_geo_success_and_orders_points_and_keys_by_key();
+  geo_sort_geometries_by_key_long_returns_geo_success_and_orders_geometries_by_key();
+
+  /* geo_index_long tests */
+  geo_index_build_size_long_returns_geo_err_too_small_when_any_geometry_has_less_than_3_segments();
+  geo_index_build_long_returns_geo_err_too_small_when_buffer_is_smaller_than_build_size();
+  geo_index_open_long_returns_geo_err_invalid_format_when_magic_does_not_match();
+  geo_index_query_long_returns_geo_success_and_finds_geometries_built_into_index();
+
+  /* geo_spatial_join_long tests */
+  geo_spatial_join_long_returns_geo_err_null_pointer_when_pairs_count_is_null();
+  geo_spatial_join_long_returns_geo_success_and_pairs_of_points_inside_few_geometries();
+  geo_spatial_join_long_returns_geo_success_and_pairs_count_larger_than_capacity_when_pairs_is_too_small();
+  geo_spatial_join_count_long_returns_geo_success_and_counts_per_geometry_when_using_multiple_threads_and_many_geometries();
+  /* geo_ring_view_long tests */
+  geo_ring_view_is_closed_long_returns_geo_err_too_small_when_view_has_less_than_4_points();
+  geo_ring_view_is_closed_long_returns_geo_success_and_false_when_last_point_differs();
+  geo_ring_view_is_simple_long_returns_geo_success_and_matches_simple_and_bowtie_rings();
+  geo_point_in_ring_view_long_returns_geo_success_and_respects_strict_on_the_boundary();
+  geo_ring_view_in_ring_view_long_returns_geo_success_and_true_when_child_is_inside();
+  geo_point_in_polygon_view_long_returns_geo_success_and_false_inside_a_hole();
+  geo_ring_view_envelope_long_returns_geo_success_and_bounds_of_the_ring();
+  /* geo_wkt_parse_long tests */
+  geo_wkt_parse_long_returns_geo_success_and_emits_every_shape();
+  geo_wkt_parse_long_returns_geo_success_for_every_chunk_split();
+  geo_wkt_parse_long_returns_geo_err_invalid_format_and_offset_for_malformed_text();
+  geo_wkt_parse_finish_long_returns_geo_err_invalid_format_when_shape_is_unterminated();
+  geo_wkt_parse_long_returns_geo_err_unsupported_for_z_coordinates();
+  geo_wkt_parse_long_returns_geo_err_full_when_arena_is_too_small();
+  /* geo_json_parse_long tests */
+  geo_json_parse_long_returns_geo_success_and_emits_every_feature_geometry();
+  geo_json_parse_long_returns_geo_success_for_every_chunk_split();
+  geo_json_parse_long_returns_geo_success_for_bare_geometries_one_per_line();
+  geo_json_parse_long_returns_geo_err_invalid_format_for_malformed_json();
+  geo_json_parse_finish_long_returns_geo_err_invalid_format_when_json_is_truncated();
+  geo_json_parse_long_returns_geo_err_unsupported_for_geometry_collections();
+  /* geo_index_compress_long tests */
+  geo_index_ring_long_returns_geo_success_and_closed_ring_of_indexed_geometry();
+  geo_index_compress_long_returns_geo_success_and_decompress_restores_original_file();
+  geo_index_decompress_long_returns_geo_err_invalid_format_when_points_section_is_truncated();
+  /* geo_csv_read_points_long tests */
+  geo_csv_read_points_long_returns_geo_success_and_columns_of_every_non_blank_line();
+  geo_csv_read_points_long_returns_geo_err_invalid_format_when_a_line_misses_a_column();
+  geo_csv_read_points_long_returns_geo_success_and_points_in_file_order_when_using_multiple_threads();
+  /* geo_points_soa_long tests */
+  geo_convex_hull_soa_long_returns_geo_success_and_counterclockwise_hull_positions();
+  geo_points_in_geometry_soa_long_returns_geo_success_and_same_answers_as_geo_point_in_geometry();
+  geo_squared_distance_soa_long_returns_geo_success_and_squared_distance_of_every_point();
+  /* geo_geometry_build_from_points_long tests */
+  geo_geometry_build_from_points_long_returns_geo_success_and_geometry_in_one_arena_block();
+  geo_geometry_build_from_points_long_returns_geo_err_full_and_leaves_arena_when_it_does_not_fit();
+  /* geo_allocator_long tests */
+  geo_spatial_join_count_long_returns_geo_err_null_pointer_when_allocator_has_no_functions();
+  geo_spatial_join_count_long_returns_geo_success_and_releases_everything_it_allocates();
+  geo_convex_hull_soa_long_returns_geo_success_and_releases_everything_it_allocates();
+#ifdef GEO_STATS
+  /* geo_stats tests */
+  geo_stats_snapshot_returns_geo_err_null_pointer_when_stats_is_null_long();
+  geo_segments_intersect_long_counts_one_call_and_four_orientations_when_segments_cross();
+  geo_point_in_geometry_long_counts_one_call_and_every_edge_when_point_is_inside();
+  geo_geometry_is_simple_long_counts_every_segment_pair_when_geometry_is_simple();
+  geo_convex_hull_long_counts_one_call_and_its_comparisons();
+  geo_stats_reset_long_zeroes_every_counter();
+#endif
+#ifdef GEO_TRACE
+  /* geo_trace tests */
+  geo_trace_set_returns_geo_err_null_pointer_when_trace_is_null_long();
+  geo_point_in_geometry_long_reports_one_call_with_segments_count_when_traced();
+  geo_geometry_is_simple_long_reports_only_the_outer_call_when_traced();
+  geo_segments_intersect_long_reports_nothing_when_tracer_is_removed();
+#endif
+  /* geo_simd_select tests */
+  geo_simd_select_long_returns_geo_err_unsupported_when_level_is_above_geo_simd_level();
+  geo_simd_select_long_gives_the_same_soa_answers_at_every_supported_level();
+  /* GeoExecutor tests */
+  geo_points_in_geometry_soa_long_returns_geo_success_and_same_answers_with_an_executor();
+  geo_convex_hull_soa_long_returns_geo_success_and_same_hull_with_an_executor();
+  geo_geometry_is_simple_parallel_long_returns_geo_success_and_same_answers_with_an_executor();
+  geo_index_build_long_writes_the_same_bytes_with_an_executor();
+  geo_points_in_geometry_soa_long_and_other_executor_functions_return_geo_err_null_pointer_when_submit_is_null();
+  geo_convex_hull_soa_long_returns_geo_success_and_stays_inside_a_hull_buffer_of_every_point();
+  geo_convex_hull_soa_long_returns_geo_success_and_keeps_every_part_in_its_own_chain();
   printf("All long tests pass.\n");
   return 0;
 }